@@ -281,7 +281,9 @@ void Integrator::loadCoach(int coachRtdbID)
 		if( (coachLt=DB_get( coachRtdbID , COACH_INFO , &coach )) == -1 )
 			cerr << "[Integrator] : integrate - db_get COACH_INFO error" << endl;
 
-	world->coach = coach;  //needed for setplays
+	// the basestation bumps seq on every change, skip the copy when it did not change
+	if( coach.seq == 0 || coach.seq != world->coach.seq )
+		world->coach = coach;  //needed for setplays
 
 	// TODO if there no coach clear finfo information
 	// Load formation
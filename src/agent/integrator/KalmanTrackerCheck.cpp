@@ -0,0 +1,632 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA AGENT
+ *
+ * CAMBADA AGENT is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA AGENT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Check of the trackers built on LinearKalman against the hand written ones
+// they replaced (copied below as Legacy*), fed with the same readings:
+//   ball and obstacle tracks with random speed changes, visibility losses
+//   and prediction only cycles, the estimates and the variances must match
+//   the integrator ball filter (util::KalmanFilter), whose velocity comes
+//   from a regression over the filtered positions, on the same kind of tracks
+//   robot pose with odometry and vision over the whole heading range
+// then the cost of an obstacle track cycle (predict + observe) is measured,
+// the best of alternating runs of both
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include "BallPositionKalman.h"
+#include "ObstaclePositionKalman.h"
+#include "RobotPositionKalmanFilter.h"
+#include "KalmanFilter.h"
+#include "LinearRegression.h"
+#include "WorldStateDefs.h"
+#include "MersenneTwister.h"
+#include "CheckReport.h"
+
+using namespace cambada;
+using namespace cambada::geom;
+
+MTRand randomGenerator(2015);
+
+// The old ball filter, hard coded (position, velocity) model, float state
+class LegacyBallKalman
+{
+public:
+	LegacyBallKalman(double dev) : lastMeasure(Vec::zero_vector), lastVel(Vec::zero_vector),
+		lastCycleVisible(false), lastTime(0), hardDeviationCount(0), readingDeviation(dev)
+	{
+		R = dev * dev;
+		Q[0][0] = (dev/3) * (dev/3); Q[0][1] = 0.0; Q[1][0] = 0.0; Q[1][1] = (dev*2) * (dev*2);
+		P[0][0] = 1.0; P[0][1] = 0.0; P[1][0] = 0.0; P[1][1] = 1.0;
+	}
+
+	Vec filterPosition(Vec readPosition, unsigned long instant)
+	{
+		if (!lastCycleVisible)
+		{
+			resetFilter(readPosition, instant);
+			lastCycleVisible = true;
+			return readPosition;
+		}
+
+		double deltaT = (instant - lastTime)/1000.0;
+		Vec positionPrediction = lastMeasure + deltaT*lastVel;
+		Vec velocityPrediction = lastVel;
+
+		double predictedP[2][2];
+		predictedP[0][0] = P[0][0] + deltaT*P[1][0] + (P[0][1] + deltaT*P[1][1])*deltaT + Q[0][0];
+		predictedP[0][1] = P[0][1] + deltaT*P[1][1] + Q[0][1];
+		predictedP[1][0] = P[1][0] + P[1][1]*deltaT + Q[1][0];
+		predictedP[1][1] = P[1][1] + Q[1][1];
+
+		double S = predictedP[0][0] + R;
+		double K[2] = { predictedP[0][0] * 1/S, predictedP[1][0] * 1/S };
+		Vec residual = readPosition - positionPrediction;
+
+		P[0][0] = (1.0 - K[0])*predictedP[0][0];
+		P[0][1] = (1.0 - K[0])*predictedP[0][1];
+		P[1][0] = -K[1]*predictedP[0][0] + predictedP[1][0];
+		P[1][1] = -K[1]*predictedP[0][1] + predictedP[1][1];
+
+		lastMeasure = positionPrediction + K[0]*residual;
+		lastVel = velocityPrediction + K[1]*residual;
+		lastTime = instant;
+
+		if (fabs(lastMeasure.length() - readPosition.length()) > (readingDeviation + 0.15))
+			hardDeviationCount++;
+		else
+			hardDeviationCount = 0;
+
+		return lastMeasure;
+	}
+
+	void resetFilter(Vec setAsLast, unsigned long instant)
+	{
+		lastMeasure = setAsLast;
+		lastVel = Vec::zero_vector;
+		if ((instant - lastTime) > 1000)
+		{
+			P[0][0] = 1.0; P[0][1] = 0.0; P[1][0] = 0.0; P[1][1] = 1.0;
+		}
+		lastTime = instant;
+		hardDeviationCount = 0;
+	}
+
+	void setNotVisible() { lastCycleVisible = false; }
+
+	bool hardDeviation()
+	{
+		if (hardDeviationCount >= 3)
+		{
+			hardDeviationCount = 0;
+			return true;
+		}
+		return false;
+	}
+
+private:
+	Vec lastMeasure, lastVel;
+	bool lastCycleVisible;
+	unsigned long lastTime;
+	int hardDeviationCount;
+	double readingDeviation;
+	double R, Q[2][2], P[2][2];
+};
+
+// The old obstacle filter, split in predict and observe phases
+class LegacyObstacleKalman
+{
+public:
+	LegacyObstacleKalman(double dev) : lastMeasure(Vec::zero_vector), lastVel(Vec::zero_vector),
+		firstExecution(true), lastTime(0), onlyPredictionCount(0)
+	{
+		R = dev * dev;
+		Q[0][0] = (dev/2) * (dev/2); Q[0][1] = 0.0; Q[1][0] = 0.0; Q[1][1] = (dev*2) * (dev*2);
+		P[0][0] = 1.0; P[0][1] = 0.0; P[1][0] = 0.0; P[1][1] = 1.0;
+		modelMatrix[0][0] = 1.0; modelMatrix[0][1] = 0.0; modelMatrix[1][0] = 0.0; modelMatrix[1][1] = 1.0;
+		memcpy(predictedP, P, sizeof(predictedP));
+	}
+
+	void update_PredictPhase(unsigned long instant)
+	{
+		if (!firstExecution)
+		{
+			modelMatrix[0][1] = (instant - lastTime)/1000.0;
+
+			positionPrediction = modelMatrix[0][0]*lastMeasure + modelMatrix[0][1]*lastVel;
+			velocityPrediction = modelMatrix[1][0]*lastMeasure + modelMatrix[1][1]*lastVel;
+			lastMeasure = positionPrediction;
+			lastVel = velocityPrediction;
+
+			double FP[2][2];
+			FP[0][0] = modelMatrix[0][0]*P[0][0] + modelMatrix[0][1]*P[1][0];
+			FP[0][1] = modelMatrix[0][0]*P[0][1] + modelMatrix[0][1]*P[1][1];
+			FP[1][0] = modelMatrix[1][0]*P[0][0] + modelMatrix[1][1]*P[1][0];
+			FP[1][1] = modelMatrix[1][0]*P[0][1] + modelMatrix[1][1]*P[1][1];
+
+			predictedP[0][0] = FP[0][0]*modelMatrix[0][0] + FP[0][1]*modelMatrix[0][1] + Q[0][0];
+			predictedP[0][1] = FP[0][0]*modelMatrix[1][0] + FP[0][1]*modelMatrix[1][1] + Q[0][1];
+			predictedP[1][0] = FP[1][0]*modelMatrix[0][0] + FP[1][1]*modelMatrix[0][1] + Q[1][0];
+			predictedP[1][1] = FP[1][0]*modelMatrix[1][0] + FP[1][1]*modelMatrix[1][1] + Q[1][1];
+
+			onlyPredictionCount++;
+		}
+		lastTime = instant;
+	}
+
+	void update_ObservationPhase(Vec readPosition)
+	{
+		if (firstExecution)
+		{
+			lastMeasure = readPosition;
+			firstExecution = false;
+			return;
+		}
+
+		double S = predictedP[0][0] + R;
+		double K[2] = { predictedP[0][0] * 1/S, predictedP[1][0] * 1/S };
+		Vec residual = readPosition - positionPrediction;
+
+		P[0][0] = (1.0 - K[0])*predictedP[0][0];
+		P[0][1] = (1.0 - K[0])*predictedP[0][1];
+		P[1][0] = -K[1]*predictedP[0][0] + predictedP[1][0];
+		P[1][1] = -K[1]*predictedP[0][1] + predictedP[1][1];
+
+		lastMeasure = positionPrediction + K[0]*residual;
+		lastVel = velocityPrediction + K[1]*residual;
+
+		onlyPredictionCount = 0;
+	}
+
+	int getOnlyPredictionCount() { return onlyPredictionCount; }
+	double getPositionVariance() { return P[0][0]; }
+	double getVelocityVariance() { return P[1][1]; }
+	Vec getFilterPosition() { return lastMeasure; }
+	Vec getFilterVelocity() { return lastVel; }
+
+private:
+	Vec lastMeasure, lastVel;
+	bool firstExecution;
+	unsigned long lastTime;
+	int onlyPredictionCount;
+	double R, Q[2][2], P[2][2], modelMatrix[2][2], predictedP[2][2];
+	Vec positionPrediction, velocityPrediction;
+};
+
+// The old integrator ball filter, the next prediction starts from the
+// velocity of the regression
+class LegacyKalmanFilter
+{
+public:
+	LegacyKalmanFilter(double dev, struct timeval instant) : linearRegression(BALL_POSITION_BUFFER_SIZE),
+		lastPosition(Vec::zero_vector), lastVelocity(Vec::zero_vector), lastCycleVisible(false),
+		hardDeviationCount(0), readingDeviation(dev)
+	{
+		lastTime = instant.tv_sec*1000 + instant.tv_usec/1000;
+		R = dev * dev;
+		Q[0][0] = (dev/3) * (dev/3); Q[0][1] = 0.0; Q[1][0] = 0.0; Q[1][1] = (dev*2) * (dev*2);
+		P[0][0] = 1.0; P[0][1] = 0.0; P[1][0] = 0.0; P[1][1] = 1.0;
+	}
+
+	void updateFilter(Vec readPosition, struct timeval instant)
+	{
+		unsigned long instant_seconds = instant.tv_sec*1000 + instant.tv_usec/1000;
+
+		if (!lastCycleVisible)
+		{
+			resetFilter(readPosition, instant);
+			lastCycleVisible = true;
+			return;
+		}
+
+		double deltaT = (instant_seconds - lastTime)/1000.0;
+		Vec positionPrediction = lastPosition + deltaT*lastVelocity;
+		Vec velocityPrediction = lastVelocity;
+
+		double predictedP[2][2];
+		predictedP[0][0] = P[0][0] + deltaT*P[1][0] + (P[0][1] + deltaT*P[1][1])*deltaT + Q[0][0];
+		predictedP[0][1] = P[0][1] + deltaT*P[1][1] + Q[0][1];
+		predictedP[1][0] = P[1][0] + P[1][1]*deltaT + Q[1][0];
+		predictedP[1][1] = P[1][1] + Q[1][1];
+
+		double S = predictedP[0][0] + R;
+		double K[2] = { predictedP[0][0] * 1/S, predictedP[1][0] * 1/S };
+		Vec residual = readPosition - positionPrediction;
+
+		P[0][0] = (1.0 - K[0])*predictedP[0][0];
+		P[0][1] = (1.0 - K[0])*predictedP[0][1];
+		P[1][0] = -K[1]*predictedP[0][0] + predictedP[1][0];
+		P[1][1] = -K[1]*predictedP[0][1] + predictedP[1][1];
+
+		lastPosition = positionPrediction + K[0]*residual;
+		lastVelocity = velocityPrediction + K[1]*residual;
+		lastTime = instant_seconds;
+
+		if (fabs(lastPosition.length() - readPosition.length()) > (readingDeviation + 0.15))
+			hardDeviationCount++;
+		else
+			hardDeviationCount = 0;
+
+		if (hardDeviation())
+			linearRegression.resetToNSamples(BALL_POSITION_RESET_SIZE);
+		linearRegression.putNewValues(lastPosition*1000, instant);
+
+		lastVelocity = linearRegression.getDeclivity();
+	}
+
+	void resetFilter(Vec initialPosition, struct timeval instant)
+	{
+		lastPosition = initialPosition;
+		lastVelocity = Vec::zero_vector;
+
+		unsigned long instant_seconds = instant.tv_sec*1000 + instant.tv_usec/1000;
+		if ((instant_seconds - lastTime) > 1000)
+		{
+			P[0][0] = 1.0; P[0][1] = 0.0; P[1][0] = 0.0; P[1][1] = 1.0;
+		}
+
+		lastTime = instant_seconds;
+		hardDeviationCount = 0;
+		linearRegression.resetToNSamples(0);
+	}
+
+	void setNotVisible()
+	{
+		linearRegression.clearBuffs();
+		lastCycleVisible = false;
+	}
+
+	bool hardDeviation()
+	{
+		if (hardDeviationCount < (int)(3*33/MOTION_TICK + 0.5))
+			return false;
+		hardDeviationCount = 0;
+		return true;
+	}
+
+	Vec getPosition() { return lastPosition; }
+	Vec getVelocity() { return lastVelocity; }
+
+private:
+	util::LinearRegression linearRegression;
+	Vec lastPosition, lastVelocity;
+	bool lastCycleVisible;
+	unsigned long lastTime;
+	int hardDeviationCount;
+	double readingDeviation;
+	double R, Q[2][2], P[2][2];
+};
+
+// The old robot pose filter, the three components fused one by one
+class LegacyRobotKalman
+{
+public:
+	void set(Vec p, Angle h, Vec vp, double vh)
+	{
+		pos = p;
+		heading = h.get_rad();
+		if (heading > M_PI)
+			heading -= M_2PI;
+		var_pos = vp;
+		var_heading = vh;
+	}
+
+	void update(Vec delta_pos, Angle delta_heading, Vec vis_pos, Angle vis_heading, Vec var_vis_pos, double var_vis_heading)
+	{
+		update(delta_pos, delta_heading, true);
+
+		double v1 = var_pos.x, v2 = var_vis_pos.x;
+		pos.x = (v2 * pos.x + v1 * vis_pos.x) / (v1 + v2);
+		var_pos.x = (v1 * v2) / (v1 + v2);
+
+		v1 = var_pos.y; v2 = var_vis_pos.y;
+		pos.y = (v2 * pos.y + v1 * vis_pos.y) / (v1 + v2);
+		var_pos.y = (v1 * v2) / (v1 + v2);
+
+		v1 = var_heading; v2 = var_vis_heading;
+		double vis_head = vis_heading.get_rad();
+		if (heading - vis_head <= -M_PI)
+			vis_head -= M_2PI;
+		heading = (v2 * heading + v1 * vis_head) / (v1 + v2);
+		var_heading = (v1 * v2) / (v1 + v2);
+
+		wrap();
+	}
+
+	void update(Vec delta_pos, Angle delta_heading, bool vis_available = false)
+	{
+		Vec std_delta_pos(std::max(0.375 * fabs(delta_pos.x), 100.0), std::max(0.375 * fabs(delta_pos.y), 100.0));
+		if (vis_available)
+			delta_pos *= 0.75;
+
+		double delta_head_pi = delta_heading.get_rad();
+		if (delta_head_pi > M_PI)
+			delta_head_pi -= M_2PI;
+
+		double std_delta_head = std::max(0.375 * fabs(delta_head_pi), 0.05);
+		double delta_head = (vis_available ? 0.75 : 1.0) * delta_head_pi;
+
+		var_pos.x += std_delta_pos.x * std_delta_pos.x;
+		pos.x += delta_pos.x;
+		var_pos.y += std_delta_pos.y * std_delta_pos.y;
+		pos.y += delta_pos.y;
+		var_heading += std_delta_head;
+		heading += delta_head;
+
+		wrap();
+	}
+
+	double get(Vec& p, Angle& h) const
+	{
+		p = pos;
+		h.set_rad(heading);
+		double sum_var = var_pos.x + var_pos.y + 1e6*var_heading;
+		return 2e5 / (2e5 + sum_var);
+	}
+
+private:
+	void wrap()
+	{
+		if (heading > M_PI)
+			heading -= M_2PI;
+		if (heading <= -M_PI)
+			heading += M_2PI;
+	}
+
+	Vec pos;
+	double heading;
+	Vec var_pos;
+	double var_heading;
+};
+
+// the old state is float, so the difference is relative to the size
+static bool near(double a, double legacy, double tol)
+{
+	return fabs(a - legacy) <= tol * std::max(fabs(legacy), 1.0);
+}
+
+static void checkBallAndObstacle()
+{
+	for (int run = 0; run < 100; run++)
+	{
+		double dev = 0.02 + randomGenerator.rand(0.2);
+		util::BallPositionKalman ball(dev);
+		LegacyBallKalman legacyBall(dev);
+		ObstaclePositionKalman obstacle(dev);
+		LegacyObstacleKalman legacyObstacle(dev);
+
+		unsigned long t = 1000000 + randomGenerator.randInt(1000);
+		Vec p(randomGenerator.randNorm(0, 3), randomGenerator.randNorm(0, 3));
+		Vec v(randomGenerator.randNorm(0, 2), randomGenerator.randNorm(0, 2));
+
+		for (int i = 0; i < 2000; i++)
+		{
+			unsigned long dt = 30 + randomGenerator.randInt(10);
+			t += dt;
+			p += v * (dt / 1000.0);
+			if (randomGenerator.randInt(100) == 0)
+				v = Vec(randomGenerator.randNorm(0, 2), randomGenerator.randNorm(0, 2));
+			Vec m = p + Vec(randomGenerator.randNorm(0, dev), randomGenerator.randNorm(0, dev));
+
+			if (randomGenerator.randInt(300) == 0)
+			{
+				ball.setNotVisible();
+				legacyBall.setNotVisible();
+			}
+			Vec a = ball.filterPosition(m, t), b = legacyBall.filterPosition(m, t);
+			CHECK(near(a.x, b.x, 1e-5) && near(a.y, b.y, 1e-5),
+				"run %d cycle %d: ball (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+			CHECK(ball.hardDeviation() == legacyBall.hardDeviation(), "run %d cycle %d: ball hard deviation differs", run, i);
+
+			// some cycles without the obstacle in sight
+			obstacle.update_PredictPhase(t);
+			legacyObstacle.update_PredictPhase(t);
+			if (randomGenerator.randInt(10) != 0)
+			{
+				obstacle.update_ObservationPhase(m);
+				legacyObstacle.update_ObservationPhase(m);
+			}
+
+			a = obstacle.getFilterPosition();
+			b = legacyObstacle.getFilterPosition();
+			CHECK(near(a.x, b.x, 1e-5) && near(a.y, b.y, 1e-5),
+				"run %d cycle %d: obstacle (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+			a = obstacle.getFilterVelocity();
+			b = legacyObstacle.getFilterVelocity();
+			CHECK(near(a.x, b.x, 1e-4) && near(a.y, b.y, 1e-4),
+				"run %d cycle %d: obstacle velocity (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+			CHECK(near(obstacle.getPositionVariance(), legacyObstacle.getPositionVariance(), 1e-9)
+				&& near(obstacle.getVelocityVariance(), legacyObstacle.getVelocityVariance(), 1e-9),
+				"run %d cycle %d: obstacle variance %g, legacy %g", run, i,
+				obstacle.getPositionVariance(), legacyObstacle.getPositionVariance());
+			CHECK(obstacle.getOnlyPredictionCount() == legacyObstacle.getOnlyPredictionCount(),
+				"run %d cycle %d: prediction only count differs", run, i);
+		}
+	}
+}
+
+static void checkBallFilter()
+{
+	for (int run = 0; run < 100; run++)
+	{
+		double dev = 0.02 + randomGenerator.rand(0.2);
+		struct timeval tv;
+		tv.tv_sec = 1000 + randomGenerator.randInt(1000);
+		tv.tv_usec = 0;
+		util::KalmanFilter filter(dev, tv);
+		LegacyKalmanFilter legacy(dev, tv);
+
+		Vec p(randomGenerator.randNorm(0, 3), randomGenerator.randNorm(0, 3));
+		Vec v(randomGenerator.randNorm(0, 2), randomGenerator.randNorm(0, 2));
+
+		for (int i = 0; i < 2000; i++)
+		{
+			unsigned long dt = 30 + randomGenerator.randInt(10);
+			tv.tv_usec += dt * 1000;
+			tv.tv_sec += tv.tv_usec / 1000000;
+			tv.tv_usec %= 1000000;
+			p += v * (dt / 1000.0);
+			if (randomGenerator.randInt(100) == 0)
+				v = Vec(randomGenerator.randNorm(0, 2), randomGenerator.randNorm(0, 2));
+			// the odd jump, for the hard deviation reset of the regression
+			if (randomGenerator.randInt(200) == 0)
+				p += Vec(randomGenerator.randNorm(0, 1), randomGenerator.randNorm(0, 1));
+			Vec m = p + Vec(randomGenerator.randNorm(0, dev), randomGenerator.randNorm(0, dev));
+
+			if (randomGenerator.randInt(300) == 0)
+			{
+				filter.setNotVisible();
+				legacy.setNotVisible();
+			}
+			filter.updateFilter(m, tv);
+			legacy.updateFilter(m, tv);
+
+			Vec a = filter.getPosition(), b = legacy.getPosition();
+			CHECK(near(a.x, b.x, 1e-5) && near(a.y, b.y, 1e-5),
+				"run %d cycle %d: ball filter (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+			// the regression differentiates the positions, in float mm, which
+			// magnifies the rounding of the old float state
+			a = filter.getVelocity();
+			b = legacy.getVelocity();
+			CHECK(near(a.x, b.x, 1e-3) && near(a.y, b.y, 1e-3),
+				"run %d cycle %d: ball filter velocity (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+		}
+	}
+}
+
+static void checkRobot()
+{
+	for (int run = 0; run < 100; run++)
+	{
+		loc::RobotPositionKalmanFilter robot;
+		LegacyRobotKalman legacy;
+
+		Vec p(randomGenerator.randNorm(0, 3000), randomGenerator.randNorm(0, 3000));
+		double h = randomGenerator.rand(M_2PI) - M_PI;
+		robot.set(p, Angle::rad_angle(h), Vec(1e10, 1e10), 400);
+		legacy.set(p, Angle::rad_angle(h), Vec(1e10, 1e10), 400);
+
+		for (int i = 0; i < 2000; i++)
+		{
+			Vec d(randomGenerator.randNorm(0, 50), randomGenerator.randNorm(0, 50));
+			double dh = randomGenerator.randNorm(0, 0.05);
+			p += d;
+			h += dh;
+
+			if (randomGenerator.randInt(2) != 0)
+			{
+				Vec vp = p + Vec(randomGenerator.randNorm(0, 100), randomGenerator.randNorm(0, 100));
+				Angle vh = Angle::rad_angle(fmod(h + 100 * M_PI, M_2PI) - M_PI);
+				robot.update(d, Angle::rad_angle(dh), vp, vh, Vec(1e4, 1e4), 0.01);
+				legacy.update(d, Angle::rad_angle(dh), vp, vh, Vec(1e4, 1e4), 0.01);
+			}
+			else
+			{
+				robot.update(d, Angle::rad_angle(dh));
+				legacy.update(d, Angle::rad_angle(dh));
+			}
+
+			Vec a, b;
+			Angle ha, hb;
+			double qa = robot.get(a, ha), qb = legacy.get(b, hb);
+			double dha = fabs(ha.get_rad() - hb.get_rad());
+			if (dha > M_PI)
+				dha = M_2PI - dha;
+
+			CHECK(near(a.x, b.x, 1e-5) && near(a.y, b.y, 1e-5),
+				"run %d cycle %d: robot (%g, %g), legacy (%g, %g)", run, i, a.x, a.y, b.x, b.y);
+			CHECK(dha <= 1e-5, "run %d cycle %d: robot heading %g, legacy %g", run, i, ha.get_rad(), hb.get_rad());
+			CHECK(near(qa, qb, 1e-6), "run %d cycle %d: robot quality %g, legacy %g", run, i, qa, qb);
+		}
+	}
+}
+
+static double now()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+template<class Track>
+static double runTracks(std::vector<Track>& tracks, unsigned long& t, int cycles)
+{
+	double start = now();
+	for (int c = 0; c < cycles; c++)
+	{
+		t += 33;
+		for (unsigned int i = 0; i < tracks.size(); i++)
+		{
+			tracks[i].update_PredictPhase(t);
+			tracks[i].update_ObservationPhase(Vec(i + c * 0.001, 1));
+		}
+	}
+	return now() - start;
+}
+
+static void benchmarkObstacles()
+{
+	const int nTracks = 64, cycles = 5000, repeat = 15;
+	std::vector<ObstaclePositionKalman> tracks(nTracks, ObstaclePositionKalman(0.1));
+	std::vector<LegacyObstacleKalman> legacyTracks(nTracks, LegacyObstacleKalman(0.1));
+	unsigned long t = 1000, legacyT = 1000;
+	double best = HUGE_VAL, legacyBest = HUGE_VAL;
+
+	for (int rep = 0; rep < repeat; rep++)
+	{
+		// alternate the order so that neither always runs warm
+		if (rep & 1)
+		{
+			legacyBest = std::min(legacyBest, runTracks(legacyTracks, legacyT, cycles));
+			best = std::min(best, runTracks(tracks, t, cycles));
+		}
+		else
+		{
+			best = std::min(best, runTracks(tracks, t, cycles));
+			legacyBest = std::min(legacyBest, runTracks(legacyTracks, legacyT, cycles));
+		}
+	}
+
+	printf("obstacle track cycle: %.1f ns, legacy %.1f ns\n",
+		best * 1e9 / cycles / nTracks, legacyBest * 1e9 / cycles / nTracks);
+}
+
+int main()
+{
+	checkBallAndObstacle();
+	checkRobot();
+
+	// the ball filter reports every reset on stderr
+	freopen("/dev/null", "w", stderr);
+	checkBallFilter();
+
+	if (errors > 0)
+		return checkReport("kalman trackers");
+
+	benchmarkObstacles();
+
+	return checkReport("kalman trackers");
+}
@@ -43,29 +43,13 @@ ObstaclePositionKalman::ObstaclePositionKalman( double readingDeviation )
 
 void ObstaclePositionKalman::init()
 {
-	lastMeasure	= Vec::zero_vector;
-	lastVel		= Vec::zero_vector;
-	
 	struct timeval tmpTime;
 	gettimeofday( &tmpTime , NULL );
 	
 	lastTime = tmpTime.tv_sec*1000 + tmpTime.tv_usec/1000;
 
-	covarMatrix[0][0] = 1.0;
-	covarMatrix[0][1] = 0.0;
-	covarMatrix[1][0] = 0.0;
-	covarMatrix[1][1] = 1.0;
-	
-	modelMatrix[0][0] = 1.0;
-	modelMatrix[0][1] = 0.0;
-	modelMatrix[1][0] = 0.0;
-	modelMatrix[1][1] = 1.0;
-	
-	Q[0][0] = 0.0;
-	Q[0][1] = 0.0;
-	Q[1][0] = 0.0;
-	Q[1][1] = 0.0;
-	
+	kalman.identity( covarMatrix );
+
 	firstExecution = true;
 	obstacleID = 0;
 	onlyPredictionCount = 0;
@@ -81,11 +65,11 @@ void ObstaclePositionKalman::setNoise( double readingDeviation )
 {
 	this->readingDeviation = readingDeviation;
 
-	R = readingDeviation * readingDeviation;
-	Q[0][0] = (readingDeviation/2) * (readingDeviation/2);
-	Q[0][1] = 0.0;
-	Q[1][0] = 0.0;
-	Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
+	kalman.R[0][0] = readingDeviation * readingDeviation;
+	kalman.Q[0][0] = (readingDeviation/2) * (readingDeviation/2);
+	kalman.Q[0][1] = 0.0;
+	kalman.Q[1][0] = 0.0;
+	kalman.Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
 }
 
 
@@ -100,36 +84,11 @@ void ObstaclePositionKalman::update_PredictPhase(unsigned long instant)
 	//	fprintf(stderr,"deltaT: %f\n",deltaT);
 		
 		//refresh the model matrix with the correct deltaT
-		modelMatrix[0][1] = deltaT;
+		kalman.F[0][1] = deltaT;
 
-		//calculate the predicted position of the ball
-		positionPrediction = modelMatrix[0][0]*lastMeasure + modelMatrix[0][1]*lastVel;
-		//calculate the predicted velocity of the ball (with the base model is always the same)
-		velocityPrediction = modelMatrix[1][0]*lastMeasure + modelMatrix[1][1]*lastVel;
-
-		//consider the prediction as the state, because there can be the case that the observation phase does not exist and only the prediction is made
-		lastMeasure = positionPrediction;
-		lastVel = velocityPrediction;
-		
-//		fprintf(stderr,"modelMat:  %f, %f\n           %f, %f\n", modelMatrix[0][0], modelMatrix[0][1], modelMatrix[1][0], modelMatrix[1][1]);
-
-		//calculate the predicted covariance matrix for the current sample F*P*F' + Q
-		double FP[2][2];	//F*P
-		FP[0][0] = modelMatrix[0][0]*covarMatrix[0][0] + modelMatrix[0][1]*covarMatrix[1][0];
-		FP[0][1] = modelMatrix[0][0]*covarMatrix[0][1] + modelMatrix[0][1]*covarMatrix[1][1];
-		FP[1][0] = modelMatrix[1][0]*covarMatrix[0][0] + modelMatrix[1][1]*covarMatrix[1][0];
-		FP[1][1] = modelMatrix[1][0]*covarMatrix[0][1] + modelMatrix[1][1]*covarMatrix[1][1];
-		
-//		fprintf(stderr,"FPmatrix:  %f, %f\n           %f, %f\n", FP[0][0], FP[0][1], FP[1][0], FP[1][1]);
-//		fprintf(stderr,"Qmatrix:  %f, %f\n          %f, %f  -  readingDev: %f\n", Q[0][0], Q[0][1], Q[1][0], Q[1][1],readingDeviation);
-		
-		//(F*P)*F' + Q
-		predictedP[0][0] = FP[0][0]*modelMatrix[0][0] + FP[0][1]*modelMatrix[0][1] + Q[0][0];
-		predictedP[0][1] = FP[0][0]*modelMatrix[1][0] + FP[0][1]*modelMatrix[1][1] + Q[0][1];
-		predictedP[1][0] = FP[1][0]*modelMatrix[0][0] + FP[1][1]*modelMatrix[0][1] + Q[1][0];
-		predictedP[1][1] = FP[1][0]*modelMatrix[1][0] + FP[1][1]*modelMatrix[1][1] + Q[1][1];
-		
-//		fprintf(stderr,"predictedP:  %f, %f\n             %f, %f\n", predictedP[0][0], predictedP[0][1], predictedP[1][0], predictedP[1][1]);
+		//predict the position and velocity and their covariance F*P*F' + Q, P being the last corrected one
+		//the prediction is the state, because there can be the case that the observation phase does not exist and only the prediction is made
+		kalman.predictFrom( covarMatrix );
 		
 		onlyPredictionCount++;
 	}
@@ -146,36 +105,27 @@ void ObstaclePositionKalman::update_ObservationPhase( Vec readPosition )
 {
 	if (firstExecution)
 	{
-		lastMeasure = readPosition;
+		kalman.x[0][0] = readPosition.x;
+		kalman.x[0][1] = readPosition.y;
 		firstExecution = false;
 		return;
 	}
-	//calculate innovation covariation S, based on the predicted P; S = H*P*H' + R (being H = [1 0], S = P[0][0] + R)
-	S = predictedP[0][0] + R;
-	
-	//calculate the optimal kalman gain for this cycle K = predictedP*H'*inv(s)
-	kalmanGain[0] = predictedP[0][0] * 1/S;	//multiplication by H = [1 0]' is 1st column of tempP
-	kalmanGain[1] = predictedP[1][0] * 1/S;
-	
-	//calculate the measurement innovation
-	Vec residual = readPosition - positionPrediction;
-
-	//based on the kalman gain (and therefore the predicted covariance for the current cycle), refresh the base covariance matrix for next cycle; P = (I-K*H)*P
-	double tmp[2][2];	//I - K*H, K*H returns a [2][2] matrix with K in 1st column and zeros in 2nd
-	tmp[0][0] = 1.0 - kalmanGain[0];
-	tmp[0][1] = 0.0;	//I[0][1] 0.0 - K*H[0][1] 0.0
-	tmp[1][0] = 0.0 - kalmanGain[1];
-	tmp[1][1] = 1.0;	//I[0][1] 1.0 - K*H[0][1] 0.0
-	
-	//(I - K*H) * P
-	covarMatrix[0][0] = tmp[0][0]*predictedP[0][0] + tmp[0][1]*predictedP[1][0];
-	covarMatrix[0][1] = tmp[0][0]*predictedP[0][1] + tmp[0][1]*predictedP[1][1];
-	covarMatrix[1][0] = tmp[1][0]*predictedP[0][0] + tmp[1][1]*predictedP[1][0];
-	covarMatrix[1][1] = tmp[1][0]*predictedP[0][1] + tmp[1][1]*predictedP[1][1];
-
-	//finaly calculate the filtered position to return (and some residual velocity refresh), also used as base to the next cycle prediction
-	lastMeasure	= positionPrediction + kalmanGain[0]*residual;
-	lastVel		= velocityPrediction + kalmanGain[1]*residual;
+
+	//correct the prediction with the observed position (H = [1 0])
+	double measure[1][2] = { { readPosition.x, readPosition.y } };
+	if ( !kalman.updateDirect( measure ) )
+	{
+		//no usable covariance, restart from the observation
+		kalman.identity( covarMatrix );
+		resetFilter( readPosition, lastTime );
+		return;
+	}
+
+	//the filtered position (and some residual velocity refresh) is also the base to the next cycle prediction
+	covarMatrix[0][0] = kalman.P[0][0];
+	covarMatrix[0][1] = kalman.P[0][1];
+	covarMatrix[1][0] = kalman.P[1][0];
+	covarMatrix[1][1] = kalman.P[1][1];
 	
 	//protection so that speed doesn't go out of hand
 //	if ( fabs(lastVel.x) > 10.0 || fabs(lastVel.y) > 10.0 )
@@ -188,8 +138,10 @@ void ObstaclePositionKalman::update_ObservationPhase( Vec readPosition )
 
 void ObstaclePositionKalman::resetFilter( Vec setAsLast, unsigned long instant )
 {
-	lastMeasure	= setAsLast;
-	lastVel		= Vec::zero_vector;
+	kalman.x[0][0] = setAsLast.x;
+	kalman.x[0][1] = setAsLast.y;
+	kalman.x[1][0] = 0.0;
+	kalman.x[1][1] = 0.0;
 	
 // 	struct timeval tmpTime;
 // 	gettimeofday( &tmpTime , NULL );
@@ -197,12 +149,7 @@ void ObstaclePositionKalman::resetFilter( Vec setAsLast, unsigned long instant )
 	unsigned long actualTime = instant;
 	
 	if ( (actualTime - lastTime) > 1000 )
-	{
-		covarMatrix[0][0]	= 1.0;
-		covarMatrix[0][1]	= 0.0;
-		covarMatrix[1][0]	= 0.0;
-		covarMatrix[1][1]	= 1.0;
-	}
+		kalman.identity( covarMatrix );
 
 	lastTime = actualTime;
 	
@@ -228,12 +175,12 @@ double ObstaclePositionKalman::getVelocityVariance()
 
 Vec ObstaclePositionKalman::getFilterPosition()
 {
-	return lastMeasure;
+	return Vec( kalman.x[0][0], kalman.x[0][1] );
 }
 
 Vec ObstaclePositionKalman::getFilterVelocity()
 {
-	return lastVel;
+	return Vec( kalman.x[1][0], kalman.x[1][1] );
 }
 
 void ObstaclePositionKalman::setID()
@@ -267,8 +214,8 @@ vector<Vec> ObstaclePositionKalman::getStateVector()
 {
 	vector<Vec> result;
 
-	result.push_back(lastMeasure);
-	result.push_back(lastVel);
+	result.push_back(getFilterPosition());
+	result.push_back(getFilterVelocity());
 
 	return result;
 }
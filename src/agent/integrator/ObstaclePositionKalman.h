@@ -24,6 +24,7 @@
 #define _KALMAN_
 
 #include "Vec.h"
+#include "LinearKalman.h"
 #include <sys/time.h>
 #include <vector>
 
@@ -31,7 +32,7 @@ using namespace std;
 
 namespace cambada {
 	
-/*! Filters a position based on a kalman filter. Built specifically for dynamic objects position, the model is hardcoded to minimize running time. It assumes the usual sensor setup, track object through a (Position, Velocity) state, where only Position is observable.
+/*! Filters a position based on a kalman filter. Built specifically for dynamic objects position, on a util::LinearKalman. It assumes the usual sensor setup, track object through a (Position, Velocity) state, where only Position is observable.
 \brief Kalman filter implementation*/
 class ObstaclePositionKalman
 {
@@ -97,9 +98,6 @@ public:
 	vector<geom::Vec> getStateVector();
 
 private:
-	geom::Vec lastMeasure;					/*!<Last position estimation of the filter (updated by \link filterPosition \endlink).*/
-	geom::Vec lastVel;						/*!<Last velocity estimation of the filter (updated by \link filterPosition \endlink).*/
-
 	bool firstExecution;				/*!<An indication of the first time the filter is run, so the initial state can be set without filter advancement.*/
 	unsigned long lastTime;				/*!<The last timestamp an update was made to the filter state.*/
 	
@@ -111,18 +109,9 @@ private:
 
 	double readingDeviation;			/*!<The deviation of the measurements (vision sensor error, for sensor model).*/
 
-	double R;				//R = readingDeviation^2
-	double Q[2][2];			//Q = (readingDeviation/WHATEVER)^2 in main diagonal
+	util::LinearKalman<2, 1, 2> kalman;	/*!<(position, velocity) of x and y, only the position is observed.*/
+	double covarMatrix[2][2];			/*!<P after the last observation, every prediction starts from it.*/
 
-	double S;					//covariance innovation
-	double covarMatrix[2][2];	//P
-	double modelMatrix[2][2];	//F
-	double kalmanGain[2];		//K
-	
-	geom::Vec positionPrediction;				/*!<\todo*/
-	geom::Vec velocityPrediction;				/*!<\todo*/
-	double predictedP[2][2];			/*!<F*P*F' + Q*/
-	
 	/*!Method to initialize the internal attributes.*/
 	void init();
 };
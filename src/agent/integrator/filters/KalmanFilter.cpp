@@ -37,16 +37,6 @@ KalmanFilter::KalmanFilter( double readingDeviation, struct timeval instant )
 
 	setNoise(readingDeviation);
 
-	covarMatrix[0][0]	= 1.0;
-	covarMatrix[0][1]	= 0.0;
-	covarMatrix[1][0]	= 0.0;
-	covarMatrix[1][1]	= 1.0;
-
-	modelMatrix[0][0]	= 1.0;
-	modelMatrix[0][1]	= 0.0;
-	modelMatrix[1][0]	= 0.0;
-	modelMatrix[1][1]	= 1.0;
-
 	lastCycleVisible	= false;
 	hardDeviationCount = 0;
 }
@@ -59,11 +49,11 @@ void KalmanFilter::setNoise( double readingDeviation )
 {
 	this->readingDeviation = readingDeviation;
 
-	R = readingDeviation * readingDeviation;
-	Q[0][0] = (readingDeviation/3) * (readingDeviation/3);
-	Q[0][1] = 0.0;
-	Q[1][0] = 0.0;
-	Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
+	kalman.R[0][0] = readingDeviation * readingDeviation;
+	kalman.Q[0][0] = (readingDeviation/3) * (readingDeviation/3);
+	kalman.Q[0][1] = 0.0;
+	kalman.Q[1][0] = 0.0;
+	kalman.Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
 }
 
 void KalmanFilter::updateFilter( Vec readPosition, struct timeval instant )
@@ -86,53 +76,24 @@ void KalmanFilter::updateFilter( Vec readPosition, struct timeval instant )
 	// fprintf(stderr,"deltaT: %f\n",deltaT);
 
 	//refresh the model matrix with the correct deltaT
-	modelMatrix[0][1] = deltaT;
-
-	//calculate the predicted position of the ball
-	Vec positionPrediction = modelMatrix[0][0]*lastPosition + modelMatrix[0][1]*lastVelocity;
-
-	//calculate the predicted velocity of the ball (with the base model is always the same)
-	Vec velocityPrediction = modelMatrix[1][0]*lastPosition + modelMatrix[1][1]*lastVelocity;
-
-	//calculate the predicted covariance matrix for the current sample F*P*F' + Q
-	double FP[2][2];	//F*P
-	FP[0][0] = modelMatrix[0][0]*covarMatrix[0][0] + modelMatrix[0][1]*covarMatrix[1][0];
-	FP[0][1] = modelMatrix[0][0]*covarMatrix[0][1] + modelMatrix[0][1]*covarMatrix[1][1];
-	FP[1][0] = modelMatrix[1][0]*covarMatrix[0][0] + modelMatrix[1][1]*covarMatrix[1][0];
-	FP[1][1] = modelMatrix[1][0]*covarMatrix[0][1] + modelMatrix[1][1]*covarMatrix[1][1];
-
-	double predictedP[2][2];	//(F*P)*F' + Q
-	predictedP[0][0] = FP[0][0]*modelMatrix[0][0] + FP[0][1]*modelMatrix[0][1] + Q[0][0];
-	predictedP[0][1] = FP[0][0]*modelMatrix[1][0] + FP[0][1]*modelMatrix[1][1] + Q[0][1];
-	predictedP[1][0] = FP[1][0]*modelMatrix[0][0] + FP[1][1]*modelMatrix[0][1] + Q[1][0];
-	predictedP[1][1] = FP[1][0]*modelMatrix[1][0] + FP[1][1]*modelMatrix[1][1] + Q[1][1];
-
-	//calculate innovation covariation S, based on the predicted P; S = H*P*H' + R (being H = [1 0], S = P[0][0] + R)
-	S = predictedP[0][0] + R;
-
-	//calculate the optimal kalman gain for this cycle K = predictedP*H'*inv(s)
-	kalmanGain[0] = predictedP[0][0] * 1/S;	//multiplication by H = [1 0]' is 1st column of tempP
-	kalmanGain[1] = predictedP[1][0] * 1/S;
-
-	//calculate the measurement innovation
-	Vec residual = readPosition - positionPrediction;
-
-	//based on the kalman gain (and therefore the predicted covariance for the current cycle), refresh the base covariance matrix for next cycle; P = (I-K*H)*P
-	double tmp[2][2];	//I - K*H, K*H returns a [2][2] matrix with K in 1st column and zeros in 2nd
-	tmp[0][0] = 1.0 - kalmanGain[0];
-	tmp[0][1] = 0.0;	//I[0][1] 0.0 - K*H[0][1] 0.0
-	tmp[1][0] = 0.0 - kalmanGain[1];
-	tmp[1][1] = 1.0;	//I[0][1] 1.0 - K*H[0][1] 0.0
-
-	//(I - K*H) * P
-	covarMatrix[0][0] = tmp[0][0]*predictedP[0][0] + tmp[0][1]*predictedP[1][0];
-	covarMatrix[0][1] = tmp[0][0]*predictedP[0][1] + tmp[0][1]*predictedP[1][1];
-	covarMatrix[1][0] = tmp[1][0]*predictedP[0][0] + tmp[1][1]*predictedP[1][0];
-	covarMatrix[1][1] = tmp[1][0]*predictedP[0][1] + tmp[1][1]*predictedP[1][1];
-
-	//finaly calculate the filtered position to return (and some residual velocity refresh), also used as base to the next cycle prediction
-	lastPosition	= positionPrediction + kalmanGain[0]*residual;
-	lastVelocity	= velocityPrediction + kalmanGain[1]*residual;
+	kalman.F[0][1] = deltaT;
+
+	//predict the position and velocity of the ball and their covariance F*P*F' + Q
+	kalman.predict();
+
+	//correct them with the measured position (H = [1 0])
+	double measure[1][2] = { { readPosition.x, readPosition.y } };
+	if ( !kalman.updateDirect( measure ) )
+	{
+		//no usable covariance, restart from the measure
+		kalman.identity( kalman.P );
+		resetFilter( readPosition, instant );
+		return;
+	}
+
+	//finaly take the filtered position to return (and some residual velocity refresh)
+	lastPosition	= Vec( kalman.x[0][0], kalman.x[0][1] );
+	lastVelocity	= Vec( kalman.x[1][0], kalman.x[1][1] );
 	lastTime 		= instant_seconds;
 
 	//protection so that speed doesn't go out of hand
@@ -159,7 +120,10 @@ void KalmanFilter::updateFilter( Vec readPosition, struct timeval instant )
 		//myprintf("KALMAN_FILTER: BALL buffer added %f,%f\n", (lastPosition*1000).x, (lastPosition*1000).y);
 	}
 
+	//the velocity of the regression is also the base to the next cycle prediction
 	lastVelocity = linearRegression.getDeclivity();
+	kalman.x[1][0] = lastVelocity.x;
+	kalman.x[1][1] = lastVelocity.y;
 
 	// fprintf(stderr,"KALMAN_FILTER: KalmanSpeed %f, %f\n", lastVel.x, lastVel.y);
 }
@@ -171,18 +135,17 @@ void KalmanFilter::resetFilter( Vec initialPosition, struct timeval instant )
 
 	lastPosition	= initialPosition;
 	lastVelocity	= Vec::zero_vector;
+	kalman.x[0][0] = initialPosition.x;
+	kalman.x[0][1] = initialPosition.y;
+	kalman.x[1][0] = 0.0;
+	kalman.x[1][1] = 0.0;
 
 	// struct timeval tmpTime;
 	// gettimeofday( &tmpTime , NULL );
 	unsigned long instant_seconds = instant.tv_sec*1000 + instant.tv_usec/1000;
 
 	if ( (instant_seconds - lastTime) > 1000 )
-	{
-		covarMatrix[0][0]	= 1.0;
-		covarMatrix[0][1]	= 0.0;
-		covarMatrix[1][0]	= 0.0;
-		covarMatrix[1][1]	= 1.0;
-	}
+		kalman.identity( kalman.P );
 
 	lastTime = instant_seconds;
 	hardDeviationCount = 0;
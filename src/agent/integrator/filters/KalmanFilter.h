@@ -26,6 +26,7 @@
 #include "LinearRegression.h"
 #include "Vec.h"
 #include "Filter.h"
+#include "LinearKalman.h"
 #include <sys/time.h>
 
 namespace cambada {
@@ -73,12 +74,7 @@ private:
 	int hardDeviationCount;				/*!<Counter for keeping the number of hard deviations found (for reset purposes).*/
 	double readingDeviation;			/*!<The deviation of the measurements (vision sensor error, for sensor model).*/
 
-	double R;							//R = readingDeviation^2
-	double Q[2][2];						//Q = (readingDeviation/WHATEVER)^2 in main diagonal
-	double S;							//covariance innovation
-	double covarMatrix[2][2];			//P
-	double modelMatrix[2][2];			//F
-	double kalmanGain[2];				//K
+	LinearKalman<2, 1, 2> kalman;		/*!<(position, velocity) of x and y, only the position is measured.*/
 };
 
 }/* namespace util */
@@ -39,31 +39,21 @@ void RobotPositionKalmanFilter::update (Vec delta_pos, Angle delta_heading, Vec
 #endif
 
 	// Variances and positions with one another charge
-	double v1, v2;
-	
-	v1 = var_pos.x;
-	v2 = var_vis_pos.x;
-
-	pos.x = (v2 * pos.x + v1 * vis_pos.x) / (v1 + v2);
-	var_pos.x = (v1 * v2) / (v1 + v2);
-	
-	v1 = var_pos.y;
-	v2 = var_vis_pos.y;
+	kalman.R[0][0] = var_vis_pos.x;
+	kalman.R[1][1] = var_vis_pos.y;
+	kalman.R[2][2] = var_vis_heading;
 
-	pos.y = (v2 * pos.y + v1 * vis_pos.y) / (v1 + v2);
-	var_pos.y = (v1 * v2) / (v1 + v2);
-	
-	v1 = var_heading;
-	v2 = var_vis_heading;
-	
 	double vis_head= vis_heading.get_rad();
 	
-	if (heading - vis_head <= -M_PI)
+	if (kalman.x[2][0] - vis_head <= -M_PI)
 		vis_head -= M_2PI;
-	
-	heading = (v2 * heading + v1 * vis_head) / (v1 + v2);
-	var_heading = (v1 * v2) / (v1 + v2);
 
+	// without a usable variance keep the odometry estimate
+	double innovation[3][1] = { { vis_pos.x - kalman.x[0][0] }, { vis_pos.y - kalman.x[1][0] }, { vis_head - kalman.x[2][0] } };
+	if (!kalman.updateDirectInnovation (innovation))
+		return;
+
+	double& heading = kalman.x[2][0];
 	if (heading > M_PI)
 		heading -= M_2PI;
 
@@ -71,14 +61,14 @@ void RobotPositionKalmanFilter::update (Vec delta_pos, Angle delta_heading, Vec
 		heading += M_2PI;
 
 #if DEBUG_KFILTER
-  //WorldModel::get_main_world_model().log_stream() << "KFilter Fusion: " << pos.x << ' ' << pos.y << ' ' << heading*180/M_PI << ' ' << sqrt(var_pos.x) << ' ' << sqrt(var_pos.y) << ' ' << sqrt(var_heading) << '\n';
+  //WorldModel::get_main_world_model().log_stream() << "KFilter Fusion: " << kalman.x[0][0] << ' ' << kalman.x[1][0] << ' ' << heading*180/M_PI << ' ' << sqrt(kalman.P[0][0]) << ' ' << sqrt(kalman.P[1][1]) << ' ' << sqrt(kalman.P[2][2]) << '\n';
 #endif
 }
 
 void RobotPositionKalmanFilter::update (Vec delta_pos, Angle delta_heading, bool vis_available) throw () 
 {
 #if DEBUG_KFILTER
- // WorldModel::get_main_world_model().log_stream() << "KFilter Ausgangspunkt: " << pos.x << ' ' << pos.y << ' ' << heading*180/M_PI << ' ' << sqrt(var_pos.x) << ' ' << sqrt(var_pos.y) << ' ' << sqrt(var_heading) << '\n';
+ // WorldModel::get_main_world_model().log_stream() << "KFilter Ausgangspunkt: " << kalman.x[0][0] << ' ' << kalman.x[1][0] << ' ' << kalman.x[2][0]*180/M_PI << ' ' << sqrt(kalman.P[0][0]) << ' ' << sqrt(kalman.P[1][1]) << ' ' << sqrt(kalman.P[2][2]) << '\n';
 #endif
 
 	//JLA: delta_pos = delta_pos.rotate (Angle::rad_angle(heading));  // theoretically not completely correctly, acceptance: Rush to the heading estimation small 
@@ -108,43 +98,45 @@ void RobotPositionKalmanFilter::update (Vec delta_pos, Angle delta_heading, bool
 #endif
 
 	// Variances and positions with one another charge
-	var_pos.x += std_delta_pos.x * std_delta_pos.x;
-	pos.x += delta_pos.x;
-
-	var_pos.y += std_delta_pos.y * std_delta_pos.y;
-	pos.y += delta_pos.y;
+	kalman.Q[0][0] = std_delta_pos.x * std_delta_pos.x;
+	kalman.Q[1][1] = std_delta_pos.y * std_delta_pos.y;
+	kalman.Q[2][2] = std_delta_head;
 
-	var_heading += std_delta_head;
 //ORI:	heading += delta_head;
 //	heading -= delta_head;
-	heading += delta_head;
+	double delta[3][1] = { { delta_pos.x }, { delta_pos.y }, { delta_head } };
+	kalman.predict (delta);
 
+	double& heading = kalman.x[2][0];
 	if (heading > M_PI)
 		heading -= M_2PI;
 
 	if (heading <= -M_PI)
 		heading += M_2PI;
 #if DEBUG_KFILTER
-//WorldModel::get_main_world_model().log_stream() << "KFilter Odometrie: " << pos.x << ' ' << pos.y << ' ' << heading*180/M_PI << ' ' << sqrt(var_pos.x) << ' ' << sqrt(var_pos.y) << ' ' << sqrt(var_heading) << '\n';
+//WorldModel::get_main_world_model().log_stream() << "KFilter Odometrie: " << kalman.x[0][0] << ' ' << kalman.x[1][0] << ' ' << heading*180/M_PI << ' ' << sqrt(kalman.P[0][0]) << ' ' << sqrt(kalman.P[1][1]) << ' ' << sqrt(kalman.P[2][2]) << '\n';
 #endif
 }
 
 void RobotPositionKalmanFilter::set (Vec p, Angle h, Vec vp, double vh) throw () 
 {
-	pos=p;
-	heading=h.get_rad();
-	if (heading>M_PI)
-		heading -= M_2PI;
-	var_pos=vp;
-	var_heading=vh;
+	kalman.x[0][0]=p.x;
+	kalman.x[1][0]=p.y;
+	kalman.x[2][0]=h.get_rad();
+	if (kalman.x[2][0]>M_PI)
+		kalman.x[2][0] -= M_2PI;
+	kalman.identity(kalman.P);
+	kalman.P[0][0]=vp.x;
+	kalman.P[1][1]=vp.y;
+	kalman.P[2][2]=vh;
 }
 
 double RobotPositionKalmanFilter::get (Vec& p, Angle& h) const throw () 
 {
-	p=pos;
-	h.set_rad(heading);
+	p=Vec(kalman.x[0][0], kalman.x[1][0]);
+	h.set_rad(kalman.x[2][0]);
 	
-	double sum_var = var_pos.x+var_pos.y+1e6*var_heading;  // Acceptance 0,1 rad deviation weighs as much as 10 cm
+	double sum_var = kalman.P[0][0]+kalman.P[1][1]+1e6*kalman.P[2][2];  // Acceptance 0,1 rad deviation weighs as much as 10 cm
 	return 2e5 / (2e5 + sum_var);  // plausible indistinct ones function 
 }
 
@@ -152,10 +144,11 @@ double RobotPositionKalmanFilter::get (Vec& p, Angle& h) const throw ()
 
 void RobotPositionKalmanFilter::mirror () throw () 
 {
-	pos *= -1;
-	heading += M_PI;
-	if (heading > M_PI)
-		heading -= M_2PI;
+	kalman.x[0][0] *= -1;
+	kalman.x[1][0] *= -1;
+	kalman.x[2][0] += M_PI;
+	if (kalman.x[2][0] > M_PI)
+		kalman.x[2][0] -= M_2PI;
 }
 
 }
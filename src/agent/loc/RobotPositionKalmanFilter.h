@@ -21,6 +21,7 @@
 
 #include "Vec.h"
 #include "RobotLocation.h"
+#include "LinearKalman.h"
 
 using namespace cambada::geom;
 
@@ -31,10 +32,9 @@ namespace loc {
 	 * considered only the position, not the speed*/
 	class RobotPositionKalmanFilter {
 	private:
-		Vec pos;			// Robot position in mm
-		double heading;		// Heading in rad; Convention: heading always in the interval [- pi, pi]
-		Vec var_pos;		// Variance of the robot position in mm^2
-		double var_heading;	// Variance of the heading in rad^2
+		/* State (x, y) in mm and heading in rad, measured directly;
+		 * Convention: heading always in the interval [- pi, pi] */
+		util::LinearKalman<3, 3> kalman;
 	public:
 		/* Set initials for a position; one hands over: 
 		 * arg1: Position in ABSOLUTE CARTESIAN COORDINATES 
@@ -66,10 +66,10 @@ namespace loc {
 		double get (Vec&, Angle&) const throw ();
 
 		/* The variances for the position supply (in mm^2) */
-		Vec get_position_variance () const throw () { return var_pos; }
+		Vec get_position_variance () const throw () { return Vec(kalman.P[0][0], kalman.P[1][1]); }
 
 		/** The variances for the heading supply (in rad^2) */
-		double get_heading_variance () const throw () { return var_heading; }
+		double get_heading_variance () const throw () { return kalman.P[2][2]; }
 
 	
 		/** The position reflect */
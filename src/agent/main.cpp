@@ -42,8 +42,8 @@ using namespace std;
 using namespace cambada;
 
 Cambada* agent = NULL;
-bool EXIT = false;
-bool		WAIT	= true;
+volatile bool EXIT = false;
+volatile bool RECONFIGURE = false;
 char		pname[64]	= "agent";
 
 sigset_t configControlLoopSignals(void);
@@ -64,12 +64,13 @@ int main( int argc , char* argv[] )
 	strcat(pname, getenv("AGENT"));
 	int pmanstat = -1;
 
-	sigset_t sig7mask = configControlLoopSignals();
+	configControlLoopSignals();
 
 	while(pmanstat < 0 && !EXIT )
 	{
 		// PMAN initializations (attach to existing process table)
-		if((pmanstat = PMAN_init(SHMEM_OCAM_PMAN_KEY, SEM_OCAM_PMAN_KEY, NULL, 0, PMAN_ATTACH)))
+		if((pmanstat = PMAN_init(SHMEM_OCAM_PMAN_KEY + DB_get_namespace()*RTDB_NAMESPACE_STRIDE,
+		                         SEM_OCAM_PMAN_KEY + DB_get_namespace()*RTDB_NAMESPACE_STRIDE, NULL, 0, PMAN_ATTACH)))
 		{
 			CMD_Vel_SET(0.0,0.0,0.0,false);
 			CMD_Grabber_SET(0);
@@ -112,10 +113,33 @@ int main( int argc , char* argv[] )
 		}
 	}
 
-	WAIT = false;
 	while( !EXIT )
 	{
-	   sigsuspend(&sig7mask);
+		if( RECONFIGURE )
+		{
+			RECONFIGURE = false;
+			if( agent->reconfigure() )
+				EXIT = false;
+		}
+
+#if USE_PMAN
+		int waitStat = PMAN_wait(pname);
+		if( waitStat < 0 )
+		{
+			// No process table, or this process is not in it anymore
+			fprintf(stderr, "cambada_agent : [%s]: PMAN_wait failed (return code %d), stopping\n", pname, waitStat);
+			break;
+		}
+
+		// Interrupted by a signal: check the flags
+		if( waitStat != 0 )
+			continue;
+
+		agent->thinkAndAct();
+		PMAN_epilogue(pname);
+#else
+		pause();
+#endif
 	}
 
 	CMD_Vel_SET(0.0,0.0,0.0,false);
@@ -128,7 +152,6 @@ int main( int argc , char* argv[] )
 
 	sigset_t sigusrmask;
 	sigemptyset(&sigusrmask);
-	sigaddset(&sigusrmask, PMAN_ACTIVATE_SIG);
 	sigaddset(&sigusrmask, SIGINT);
 	sigaddset(&sigusrmask, SIGTERM);
 	sigaddset(&sigusrmask, SIGHUP);
@@ -146,33 +169,11 @@ int main( int argc , char* argv[] )
 void controlLoop(int sig )
 {
 
-	if( sig == SIGINT ) {
-		EXIT = true;
-	} else if( sig == SIGTERM ) {
-		EXIT = true;
-	}
-
-	if( WAIT )
-		return;
-
-	if( sig == PMAN_ACTIVATE_SIG )
-	{
-		agent->thinkAndAct();
-
-#if USE_PMAN
-		PMAN_epilogue(pname);
-#endif
-	}
-	else
+	// Only sets flags, the work is done in the main loop
 	if( sig == SIGHUP )
-	{
-		if( agent->reconfigure() )
-			EXIT = false;
-	}
+		RECONFIGURE = true;
 	else
-	{
 		EXIT = true;
-	}
 
 }
 
@@ -183,7 +184,6 @@ sigset_t configControlLoopSignals(void)
 
 	// Install handler
 	sigemptyset( &sigusrmask );
-	sigaddset( &sigusrmask , PMAN_ACTIVATE_SIG );
 	sigaddset( &sigusrmask , SIGINT );
 	sigaddset( &sigusrmask , SIGTERM );
 	sigaddset( &sigusrmask , SIGHUP );
@@ -194,7 +194,6 @@ sigset_t configControlLoopSignals(void)
 	sigact.sa_mask = sigemptymask;
 	sigact.sa_handler = (void (*)(int))controlLoop;
 
-	sigaction(PMAN_ACTIVATE_SIG, &sigact, NULL);
 	sigaction(SIGINT, &sigact, NULL);
 	sigaction(SIGTERM, &sigact, NULL);
 	sigaction(SIGHUP, &sigact, NULL);
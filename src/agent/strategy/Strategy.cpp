@@ -311,9 +311,9 @@ void Strategy::distanceRestrictions()
 			LineSegment ballMe = LineSegment(ball,
 					ball + line.setLength(distance));
 
-			vector<Vec> inter1 = intersect(ballMe, penaltyL);
-			vector<Vec> inter2 = intersect(ballMe, penaltyF);
-			vector<Vec> inter3 = intersect(ballMe, penaltyR);
+			Intersections inter1 = intersect(ballMe, penaltyL);
+			Intersections inter2 = intersect(ballMe, penaltyF);
+			Intersections inter3 = intersect(ballMe, penaltyR);
 
 			vector<Vec> allInter;
 			unsigned int i = 0;
@@ -371,9 +371,9 @@ void Strategy::distanceRestrictions()
 			LineSegment penaltyF(p2, p3);
 			LineSegment penaltyR(p3, p4);
 
-			vector<Vec> inter1 = intersect(penaltyL, ballDistance);
-			vector<Vec> inter2 = intersect(penaltyF, ballDistance);
-			vector<Vec> inter3 = intersect(penaltyR, ballDistance);
+			Intersections inter1 = intersect(penaltyL, ballDistance);
+			Intersections inter2 = intersect(penaltyF, ballDistance);
+			Intersections inter3 = intersect(penaltyR, ballDistance);
 
 			vector<Vec> allInter;
 			unsigned int i = 0;
@@ -459,10 +459,10 @@ void Strategy::distanceRestrictions()
 			LineSegment line3(p3, p4);
 			LineSegment line4(p4, p1);
 
-			vector<Vec> inter1 = intersect(line1, ballDistance);
-			vector<Vec> inter2 = intersect(line2, ballDistance);
-			vector<Vec> inter3 = intersect(line3, ballDistance);
-			vector<Vec> inter4 = intersect(line4, ballDistance);
+			Intersections inter1 = intersect(line1, ballDistance);
+			Intersections inter2 = intersect(line2, ballDistance);
+			Intersections inter3 = intersect(line3, ballDistance);
+			Intersections inter4 = intersect(line4, ballDistance);
 
 			vector<Vec> allInter;
 			unsigned int i = 0;
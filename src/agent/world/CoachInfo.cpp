@@ -54,6 +54,8 @@ CoachInfo::CoachInfo()
 
 	taxiPos = Vec::zero_vector;
 	taxiOri = false;
+
+	seq = 0;
 }
 
 }
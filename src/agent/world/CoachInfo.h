@@ -101,6 +101,8 @@ public:
 	char taxiRobotSN[N_CAMBADAS]; // robot SN for taxi
 	Vec taxiPos; // position for taxi
 	bool taxiOri; // when true, taxi is for orientation
+
+	unsigned int seq; // bumped by the basestation on every change, 0 if not published by it
 };
 
 }
@@ -23,22 +23,47 @@
 #ifndef GRIDVIEW_H_
 #define GRIDVIEW_H_
 
+#include <stddef.h>
+
 #include "Vec.h"
 
-namespace cambada{
+#define GRIDVIEW_TILE		8		// tile side, in cells
+#define GRIDVIEW_TILES_X	8		// tiles along x (up to 64 cells)
+#define GRIDVIEW_TILES_Y	11		// tiles along y (up to 88 cells)
+#define GRIDVIEW_TILES		(GRIDVIEW_TILES_X * GRIDVIEW_TILES_Y)
+#define GRIDVIEW_TILE_CELLS	(GRIDVIEW_TILE * GRIDVIEW_TILE)
 
-class CellVal
-{
-public:
-	geom::Vec pos;
-	float val;
-};
+namespace cambada{
 
+/* Height map shared through the RtDB, split in tiles
+ *
+ * The cell positions are implicit (origin + index * scale). The writer
+ * bumps tileVersion of every tile with a changed value, so a reader can
+ * read the header with DB_get_range and then only the tiles whose
+ * version moved (at tileOffset()).
+ */
 class GridView
 {
 public:
-	int count;
-	CellVal grid[5000];
+	int count;						// cells in use, 0 when there is no map
+	int width;						// cells along x
+	int length;						// cells along y
+	float scale;					// cell side (m)
+	float originX, originY;			// centre of cell (0,0)
+	int version;					// bumped on every write with changes
+	int tileVersion[GRIDVIEW_TILES];
+	float tile[GRIDVIEW_TILES][GRIDVIEW_TILE_CELLS];
+
+	static int tileIndex(int x, int y) { return (y / GRIDVIEW_TILE) * GRIDVIEW_TILES_X + x / GRIDVIEW_TILE; }
+	static int cellIndex(int x, int y) { return (y % GRIDVIEW_TILE) * GRIDVIEW_TILE + x % GRIDVIEW_TILE; }
+
+	/* Bytes before the tile data, the part to read to know what changed */
+	static int headerSize() { return offsetof(GridView, tile); }
+	static int tileOffset(int t) { return headerSize() + t * GRIDVIEW_TILE_CELLS * (int)sizeof(float); }
+
+	float& val(int x, int y) { return tile[tileIndex(x, y)][cellIndex(x, y)]; }
+	float val(int x, int y) const { return tile[tileIndex(x, y)][cellIndex(x, y)]; }
+	geom::Vec pos(int x, int y) const { return geom::Vec(originX + x * scale, originY + y * scale); }
 };
 
 }
@@ -259,7 +259,7 @@ Vec WorldState::getAvoidAdjustedPosition(Vec targetRel, bool moveFree, bool avBa
 			else
 				endLine = Line( Vec(-field->halfWidth,-field->halfLength), Vec(field->halfWidth,-field->halfLength) );
 
-			vector<Vec> sidePoints;
+			Intersections sidePoints;
 			if ( (sidePoints = intersect(sideLine, sideLineTester)).size() == 2 )	//create obstacles between the 2 points on the sideline
 			{
 				Vec tempObst = sidePoints[0];
@@ -281,7 +281,7 @@ Vec WorldState::getAvoidAdjustedPosition(Vec targetRel, bool moveFree, bool avBa
 				}
 			}
 
-			vector<Vec> endPoints;
+			Intersections endPoints;
 			if ( (endPoints = intersect(endLine, sideLineTester)).size() == 2 )
 			{
 				Vec tempObst = endPoints[0];
@@ -578,25 +578,20 @@ double WorldState::getBallPathAlignment()
 bool WorldState::isMovingOutside(Vec movePos,Vec& clippedPos)
 {
 
-	vector<LineSegment> borderLines;
-
 	LineSegment leftLine = LineSegment(Vec(-field->halfWidth,-field->halfLength),Vec(-field->halfWidth,field->halfLength));
 	LineSegment rightLine = LineSegment(Vec(field->halfWidth,-field->halfLength),Vec(field->halfWidth,field->halfLength));
 	LineSegment ourLine = LineSegment(Vec(-field->halfWidth,-field->halfLength),Vec(field->halfWidth,-field->halfLength));
 	LineSegment theirLine = LineSegment(Vec(-field->halfWidth,field->halfLength),Vec(field->halfWidth,field->halfLength));
 
-	borderLines.push_back(leftLine);
-	borderLines.push_back(rightLine);
-	borderLines.push_back(ourLine);
-	borderLines.push_back(theirLine);
+	const LineSegment borderLines[4] = { leftLine, rightLine, ourLine, theirLine };
 
 	Vec ballPos = me->ball.pos;
 
 	LineSegment movingPath = LineSegment(ballPos,movePos);
 
-	for(unsigned int i=0;i<borderLines.size();i++)
+	for(unsigned int i=0;i<4;i++)
 	{
-		vector<Vec> intersections = intersect(movingPath,borderLines[i]);
+		Intersections intersections = intersect(movingPath,borderLines[i]);
 		if(intersections.size())
 		{
 			clippedPos = intersections[0];
@@ -721,20 +716,9 @@ bool WorldState::obstaclesInFront(float distance) {
 
 	Vec p1 = Vec(0,robotCenter2grabber);
 	Vec p2 = Vec(0,distance);
-	LineSegment me2front = LineSegment(p1, p2);
-
-	for(unsigned int i = 0; i < obstacles.size(); i++) {
-		Vec obstCenter = abs2rel(obstacles.at(i).obstacleInfo.absCenter);
-
-		Vec perpPoint = me2front.closestPoint(obstCenter); // perpendicular point
-		if(perpPoint != p1 && perpPoint != p2)
-		{
-			if((perpPoint - obstCenter).length() < 0.45) // check distance
-				return true;
-		}
-	}
+	LineSegment me2front = LineSegment(rel2abs(p1), rel2abs(p2));	// tested in absolute coordinates, as the obstacles
 
-	return false;
+	return obstaclesBeside(me2front, 0.45);
 }
 
 bool WorldState::obstaclesToTheirGoal(float distance, Vec position) {
@@ -749,15 +733,26 @@ bool WorldState::obstaclesToTheirGoal(float distance, Vec position) {
 	Vec p2 = position + pos2goal.setLength(distance);
 	LineSegment p2goal = LineSegment(p1, p2);
 
-	for(unsigned int i = 0; i < obstacles.size(); i++) {
-		Vec obstCenter = obstacles.at(i).obstacleInfo.absCenter;
+	return obstaclesBeside(p2goal, 0.45);
+}
 
-		Vec perpPoint = p2goal.closestPoint(obstCenter); // perpendicular point
-		if(perpPoint != p1 && perpPoint != p2)
-		{
-			if((perpPoint - obstCenter).length() < 0.45) // check distance
-				return true;
+bool WorldState::obstaclesBeside(const LineSegment& segment, double distance)
+{
+	// obstacle centers as coordinate arrays, for the batched segment test
+	const unsigned int chunk = 32;
+	double x[chunk], y[chunk], tau[chunk], dist2[chunk];
+
+	for(unsigned int first = 0; first < obstacles.size(); first += chunk) {
+		unsigned int n = min<unsigned int>(chunk, obstacles.size() - first);
+		for(unsigned int i = 0; i < n; i++) {
+			x[i] = obstacles[first+i].obstacleInfo.absCenter.x;
+			y[i] = obstacles[first+i].obstacleInfo.absCenter.y;
 		}
+
+		closest_points(segment, x, y, n, tau, dist2);
+		for(unsigned int i = 0; i < n; i++)
+			if(tau[i] > 0.0 && tau[i] < 1.0 && dist2[i] < distance*distance) // perpendicular point inside the segment, check distance
+				return true;
 	}
 
 	return false;
@@ -282,6 +282,10 @@ private:
 
 	void ok2kick_update();
 
+	/* true if an obstacle center is closer than distance to the segment,
+	 * with its perpendicular point between the segment ends */
+	bool obstaclesBeside(const LineSegment& segment, double distance);
+
 };
 
 } /* namespace cambada */
@@ -39,17 +39,27 @@
 #include "multicast.h"
 
 #include "rtdb_comm.h"
+#include "wire.h"
 
 #include "MersenneTwister.h"
 
 
 #define BUFFER_SIZE 1400
+#define RECORDS_SIZE 8192	// shared records of an agent, as in the RtDB (not packed)
 
 #define TTUP_US 100E3 // 10Hz -> 100E3, 20Hz -> 50E3
 #define COMM_DELAY_MS 2
 #define COMM_DELAY_US COMM_DELAY_MS*1E3
 #define MIN_UPDATE_DELAY_US 1E3
 
+// Records equal to the last ones sent go in the frame without data, only
+// with their life; a changed record is sent in full in COMM_CHANGE_REPEAT
+// frames, and every record in full every COMM_KEYFRAME_PERIOD frames, so
+// that receivers that lost frames catch up
+#define COMM_UNCHANGED			-1	// size of a record sent without data
+#define COMM_CHANGE_REPEAT		3
+#define COMM_KEYFRAME_PERIOD	10	// 1s at 10Hz
+
 // #define DEBUG
 // #define FILEDEBUG
 #define UNSYNC
@@ -132,6 +142,13 @@ int myNumber;
 
 struct _agent agent[MAX_AGENTS];
 
+// last data received from each agent, for records sent without data
+char lastRecv[MAX_AGENTS][RECORDS_SIZE];
+int lastRecvUsed[MAX_AGENTS];
+int lastRecvOffset[MAX_AGENTS][MAX_RECS];
+int lastRecvSize[MAX_AGENTS][MAX_RECS];
+char lastRecvValid[MAX_AGENTS][MAX_RECS];
+
 int RUNNING_AGENTS;
 
 
@@ -300,7 +317,8 @@ void *receiveDataThread(void *arg)
 	struct _frameHeader frameHeader;
 
 	int size;
-	
+	long long recvData[RECORDS_SIZE / sizeof(long long)];	// unpacked record
+
 
 	while(!end)
 	{
@@ -325,7 +343,11 @@ void *receiveDataThread(void *arg)
 			// TODO
       // correction when frameCounter overflows
 			if ((agent[agentNumber].lastFrameCounter + 1) != frameHeader.counter)
+			{
 				lostPackets[agentNumber] = frameHeader.counter - (agent[agentNumber].lastFrameCounter + 1);
+				// a lost frame may have had changes, wait for the next full copies
+				memset(lastRecvValid[agentNumber], NO, sizeof(lastRecvValid[agentNumber]));
+			}
 			agent[agentNumber].lastFrameCounter = frameHeader.counter;
 
       // state team view from received agent
@@ -348,14 +370,48 @@ void *receiveDataThread(void *arg)
 
         life += COMM_DELAY_MS;
 
-				// data
-				if((size = DB_comm_put (agentNumber, rec.id, rec.size, recvBuffer + indexBuffer, life)) != (int)rec.size)
+				if ((rec.id < 0) || (rec.id >= MAX_RECS))
 				{
-					PERR("Error in frame/rtdb: from = %d, item = %d, received size = %d, local size = %d", agentNumber, rec.id, rec.size, size);
+					PERR("Error in frame: from = %d, invalid item = %d", agentNumber, rec.id);
+					break;
+				}
+
+				// unchanged, refresh the life of the last data received
+				if (rec.size == COMM_UNCHANGED)
+				{
+					if (lastRecvValid[agentNumber][rec.id] == YES)
+						DB_comm_put (agentNumber, rec.id, lastRecvSize[agentNumber][rec.id],
+								lastRecv[agentNumber] + lastRecvOffset[agentNumber][rec.id], life);
+					continue;
+				}
+
+				// packed data
+				if ((rec.size < 0) || (indexBuffer + rec.size > recvLen) ||
+						((size = wire_unpack(rec.id, (unsigned char*)recvBuffer + indexBuffer, rec.size, recvData, sizeof(recvData))) < 0))
+				{
+					PERR("Error in frame: from = %d, item = %d, packed size = %d", agentNumber, rec.id, rec.size);
+					break;
+				}
+
+				if(DB_comm_put (agentNumber, rec.id, size, recvData, life) != size)
+				{
+					PERR("Error in frame/rtdb: from = %d, item = %d, received size = %d", agentNumber, rec.id, size);
 					break;
 				}
 				PDEBUG("Receive from %d\n", agentNumber);
 
+				if ((lastRecvSize[agentNumber][rec.id] == 0) && (lastRecvUsed[agentNumber] + size <= RECORDS_SIZE))
+				{
+					lastRecvOffset[agentNumber][rec.id] = lastRecvUsed[agentNumber];
+					lastRecvSize[agentNumber][rec.id] = size;
+					lastRecvUsed[agentNumber] += size;
+				}
+				if (lastRecvSize[agentNumber][rec.id] == size)
+				{
+					memcpy(lastRecv[agentNumber] + lastRecvOffset[agentNumber][rec.id], recvData, size);
+					lastRecvValid[agentNumber][rec.id] = YES;
+				}
+
 				indexBuffer += rec.size;
 			}
 
@@ -389,6 +445,13 @@ int main(int argc, char *argv[])
 	int indexBuffer;
 	int sharedRecs;
 	RTDBconf_var rec[MAX_RECS];
+	long long recData[RECORDS_SIZE / sizeof(long long)];	// record to pack
+	char lastSent[RECORDS_SIZE];		// last data sent of each record
+	unsigned int lastChange[MAX_RECS];	// frame of the last change of each record
+	int sentOffset;
+	int sizeIndex;
+	int size;
+	bool keyframe;
 	unsigned int frameCounter = 0;
 	int i, j;
 	int life;
@@ -469,6 +532,16 @@ int main(int argc, char *argv[])
 		return -1;
 	}
 
+	for (i = 0, size = 0; i < sharedRecs; i++)
+		size += rec[i].size;
+	if (size > RECORDS_SIZE)
+	{
+		PERR("Shared records bigger than RECORDS_SIZE (%d bytes)", size);
+		DB_free();
+		closeSocket(sckt);
+		return -1;
+	}
+
 #ifdef FILEDEBUG
 	if ((filedebug = fopen("log.txt", "w")) == NULL)
 	{
@@ -484,12 +557,22 @@ int main(int argc, char *argv[])
 	{
 		lostPackets[i]=0;
 		agent[i].lastFrameCounter = 0;
+		lastRecvUsed[i] = 0;
+		for (j=0; j<MAX_RECS; j++)
+		{
+			lastRecvSize[i][j] = 0;
+			lastRecvValid[i][j] = NO;
+		}
 		agent[i].state = NOT_RUNNING;
 		agent[i].removeCounter = 0;
 	}
 	myNumber = Whoami();
 	agent[myNumber].state = RUNNING;
 
+	bzero(lastSent, RECORDS_SIZE);
+	for (i=0; i<MAX_RECS; i++)
+		lastChange[i] = 0;
+
 	/* receive thread */
 	pthread_attr_init (&thread_attr);
 	pthread_attr_setinheritsched (&thread_attr, PTHREAD_INHERIT_SCHED);
@@ -571,25 +654,58 @@ int main(int argc, char *argv[])
 		memcpy(sendBuffer + indexBuffer, &frameHeader, sizeof(frameHeader));
 		indexBuffer += sizeof(frameHeader);
 
+		keyframe = (frameHeader.counter % COMM_KEYFRAME_PERIOD) == 0;
+		sentOffset = 0;
+
 		for(i = 0; i < sharedRecs; i++)
 		{
+			if (indexBuffer + (int)(sizeof(rec[i].id) + sizeof(rec[i].size) + sizeof(life)) > BUFFER_SIZE)
+			{
+				indexBuffer = BUFFER_SIZE + 1;
+				break;
+			}
+
 			// id
 			memcpy(sendBuffer + indexBuffer, &rec[i].id, sizeof(rec[i].id));
 			indexBuffer += sizeof(rec[i].id);
 
-			// size
-			memcpy(sendBuffer + indexBuffer, &rec[i].size, sizeof(rec[i].size));
+			// packed size, written after the data
+			sizeIndex = indexBuffer;
 			indexBuffer += sizeof(rec[i].size);
 
-			// life and data
-			life = DB_get(myNumber, rec[i].id, sendBuffer + indexBuffer + sizeof(life));
+			// life
+			life = DB_get(myNumber, rec[i].id, recData);
 			memcpy(sendBuffer + indexBuffer, &life, sizeof(life));
-			indexBuffer = indexBuffer + sizeof(life) + rec[i].size;
+			indexBuffer += sizeof(life);
+
+			if (memcmp(lastSent + sentOffset, recData, rec[i].size) != 0)
+			{
+				memcpy(lastSent + sentOffset, recData, rec[i].size);
+				lastChange[i] = frameHeader.counter;
+			}
+			sentOffset += rec[i].size;
+
+			if (keyframe || (frameHeader.counter - lastChange[i] < COMM_CHANGE_REPEAT))
+			{
+				// data
+				if ((size = wire_pack(rec[i].id, recData, rec[i].size, (unsigned char*)sendBuffer + indexBuffer, BUFFER_SIZE - indexBuffer)) < 0)
+				{
+					indexBuffer = BUFFER_SIZE + 1;
+					break;
+				}
+				indexBuffer += size;
+			}
+			else
+			{
+				// same data as the last frames, send only the life
+				size = COMM_UNCHANGED;
+			}
+			memcpy(sendBuffer + sizeIndex, &size, sizeof(size));
 		}
 
 		if (indexBuffer > BUFFER_SIZE)
 		{
-			PERR("Pretended frame is bigger that the available buffer.");
+			PERR("Pretended frame is bigger that the available buffer, or a record does not match rtdb_items.h.");
 			PERR("Please increase the buffer size or reduce the number of disseminated records");
 			break;
 		}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA COMM
+ *
+ * CAMBADA COMM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA COMM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// the wire section of rtdb_items.h, with the packers of the shared items
+#define RTDB_ITEMS_WIRE
+#include "rtdb_items.h"
+
+using namespace cambada;
+
+// fixed point steps
+#define WIRE_POS_STEP		0.001f	// m, 18 bits: +-131m
+#define WIRE_POS_BITS		18
+#define WIRE_VEL_STEP		0.001f	// m/s, 16 bits: +-32m/s
+#define WIRE_VEL_BITS		16
+#define WIRE_ANGLE_STEP		0.0001f	// rad, 17 bits: +-6.5rad
+#define WIRE_ANGLE_BITS		17
+#define WIRE_ANGVEL_STEP	0.001f	// rad/s, 16 bits: +-32rad/s
+#define WIRE_ANGVEL_BITS	16
+#define WIRE_BATTERY_STEP	0.01f	// V, 13 bits: +-40V
+#define WIRE_BATTERY_BITS	13
+#define WIRE_ENUM_BITS		5	// BehaviourID, RoleID and WSGameState have less than 32 values
+
+
+static void putPos(BitWriter &w, const Vec &v)
+{
+	w.putFixed(v.x, WIRE_POS_STEP, WIRE_POS_BITS);
+	w.putFixed(v.y, WIRE_POS_STEP, WIRE_POS_BITS);
+}
+
+static void getPos(BitReader &r, Vec &v)
+{
+	v.x = r.getFixed(WIRE_POS_STEP, WIRE_POS_BITS);
+	v.y = r.getFixed(WIRE_POS_STEP, WIRE_POS_BITS);
+}
+
+static void putVel(BitWriter &w, const Vec &v)
+{
+	w.putFixed(v.x, WIRE_VEL_STEP, WIRE_VEL_BITS);
+	w.putFixed(v.y, WIRE_VEL_STEP, WIRE_VEL_BITS);
+}
+
+static void getVel(BitReader &r, Vec &v)
+{
+	v.x = r.getFixed(WIRE_VEL_STEP, WIRE_VEL_BITS);
+	v.y = r.getFixed(WIRE_VEL_STEP, WIRE_VEL_BITS);
+}
+
+
+//	*************************
+//	ROBOT_WS: 76 bytes plus 5.5 per obstacle, instead of sizeof(Robot)
+//
+int Wire<Robot>::pack(const void *data, unsigned char *buf, int max)
+{
+	const Robot *robot = (const Robot*)data;
+	BitWriter w(buf, max);
+	int i, nObst;
+
+	w.putSigned(robot->number, 8);
+	w.put(robot->behaviour, WIRE_ENUM_BITS);
+	w.put(robot->role, WIRE_ENUM_BITS);
+	w.putSigned(robot->coordinationFlag[0], 16);
+	w.putSigned(robot->coordinationFlag[1], 16);
+	w.put(robot->currentGameState, WIRE_ENUM_BITS);
+	putPos(w, robot->coordinationVec);
+	w.put(robot->teamColor, 2);
+	w.put(robot->goalColor, 2);
+	w.putSigned(robot->stuck, 8);
+	w.putBool(robot->roleAuto);
+	w.putBool(robot->running);
+	w.putBool(robot->coaching);
+	w.putBool(robot->justKicked);
+	w.putBool(robot->handicappedGrabber);
+	w.put(robot->opponentDribbling, 8);
+	for (i = 0; i < N_BATTERIES; i++)
+		w.putFixed(robot->battery[i], WIRE_BATTERY_STEP, WIRE_BATTERY_BITS);
+	w.putFixed(robot->orientation, WIRE_ANGLE_STEP, WIRE_ANGLE_BITS);
+	w.putFixed(robot->angVelocity, WIRE_ANGVEL_STEP, WIRE_ANGVEL_BITS);
+	for (i = 0; i < 4; i++)
+		putPos(w, robot->debugPoints[i]);
+	putPos(w, robot->pos);
+	putVel(w, robot->vel);
+
+	putPos(w, robot->ball.pos);
+	putPos(w, robot->ball.posRel);
+	putVel(w, robot->ball.vel);
+	w.putFixed(robot->ball.height, WIRE_POS_STEP, WIRE_POS_BITS);
+	w.putBool(robot->ball.own);
+	w.putBool(robot->ball.engaged);
+	w.putBool(robot->ball.visible);
+	w.putBool(robot->ball.airborne);
+	w.putBool(robot->ball.hasMoved);
+
+	putPos(w, robot->passLine.p1);
+	putPos(w, robot->passLine.p2);
+
+	// only the valid obstacles
+	nObst = robot->nObst;
+	if (nObst > MAX_SHARED_OBSTACLES)
+		nObst = MAX_SHARED_OBSTACLES;
+	w.put(nObst, 8);
+	for (i = 0; i < nObst; i++)
+	{
+		putPos(w, robot->obstacles[i].absCenter);
+		w.put(robot->obstacles[i].id, 8);
+	}
+
+	return w.finish();
+}
+
+int Wire<Robot>::unpack(const unsigned char *buf, int len, void *data)
+{
+	Robot *robot = (Robot*)data;
+	BitReader r(buf, len);
+	int i;
+
+	// the obstacles not sent are left cleared
+	memset(data, 0, sizeof(Robot));
+
+	robot->number = r.getSigned(8);
+	robot->behaviour = (BehaviourID)r.get(WIRE_ENUM_BITS);
+	robot->role = (RoleID)r.get(WIRE_ENUM_BITS);
+	robot->coordinationFlag[0] = r.getSigned(16);
+	robot->coordinationFlag[1] = r.getSigned(16);
+	robot->currentGameState = (WSGameState)r.get(WIRE_ENUM_BITS);
+	getPos(r, robot->coordinationVec);
+	robot->teamColor = (WSColor)r.get(2);
+	robot->goalColor = (WSColor)r.get(2);
+	robot->stuck = r.getSigned(8);
+	robot->roleAuto = r.getBool();
+	robot->running = r.getBool();
+	robot->coaching = r.getBool();
+	robot->justKicked = r.getBool();
+	robot->handicappedGrabber = r.getBool();
+	robot->opponentDribbling = r.get(8);
+	for (i = 0; i < N_BATTERIES; i++)
+		robot->battery[i] = r.getFixed(WIRE_BATTERY_STEP, WIRE_BATTERY_BITS);
+	robot->orientation = r.getFixed(WIRE_ANGLE_STEP, WIRE_ANGLE_BITS);
+	robot->angVelocity = r.getFixed(WIRE_ANGVEL_STEP, WIRE_ANGVEL_BITS);
+	for (i = 0; i < 4; i++)
+		getPos(r, robot->debugPoints[i]);
+	getPos(r, robot->pos);
+	getVel(r, robot->vel);
+
+	getPos(r, robot->ball.pos);
+	getPos(r, robot->ball.posRel);
+	getVel(r, robot->ball.vel);
+	robot->ball.height = r.getFixed(WIRE_POS_STEP, WIRE_POS_BITS);
+	robot->ball.own = r.getBool();
+	robot->ball.engaged = r.getBool();
+	robot->ball.visible = r.getBool();
+	robot->ball.airborne = r.getBool();
+	robot->ball.hasMoved = r.getBool();
+
+	getPos(r, robot->passLine.p1);
+	getPos(r, robot->passLine.p2);
+
+	robot->nObst = r.get(8);
+	if (robot->nObst > MAX_SHARED_OBSTACLES)
+		return -1;
+	for (i = 0; i < robot->nObst; i++)
+	{
+		getPos(r, robot->obstacles[i].absCenter);
+		robot->obstacles[i].id = r.get(8);
+	}
+
+	return r.ok() ? 0 : -1;
+}
+
+
+static const RTDBwire_item* wire_item(int id)
+{
+	unsigned int i;
+
+	for (i = 0; i < sizeof(rtdb::wire) / sizeof(rtdb::wire[0]); i++)
+		if (rtdb::wire[i].id == id)
+			return &rtdb::wire[i];
+
+	return NULL;
+}
+
+int wire_pack(int id, const void *data, int size, unsigned char *buf, int max)
+{
+	const RTDBwire_item *item;
+
+	if ((item = wire_item(id)) != NULL)
+		return (size == item->size) ? item->pack(data, buf, max) : -1;
+
+	if (max < size)
+		return -1;
+	memcpy(buf, data, size);
+	return size;
+}
+
+int wire_unpack(int id, const unsigned char *buf, int len, void *data, int max)
+{
+	const RTDBwire_item *item;
+
+	if ((item = wire_item(id)) != NULL)
+	{
+		if ((max < item->size) || (item->unpack(buf, len, data) != 0))
+			return -1;
+		return item->size;
+	}
+
+	if ((len < 0) || (max < len))
+		return -1;
+	memcpy(data, buf, len);
+	return len;
+}
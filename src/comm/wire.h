@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA COMM
+ *
+ * CAMBADA COMM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA COMM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WIRE_H
+#define __WIRE_H
+
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "Robot.h"
+
+// Encoding of the shared records in the comm frames.
+//
+// xrtdb writes, in rtdb_items.h, the packer and the unpacker of each shared
+// item. By default a record goes as it is in the RtDB; the datatypes with a
+// Wire specialization are packed field by field, with fixed point values,
+// one bit per bool and only the valid part of the arrays.
+
+
+//	*************************
+//	BitWriter: writes fields of any number of bits in a buffer
+//
+class BitWriter
+{
+public:
+	BitWriter(unsigned char *buf, int size) : buf(buf), size(size), used(0), acc(0), nacc(0), overflow(false) {}
+
+	void put(uint32_t value, int bits)
+	{
+		acc |= (uint64_t)(value & mask(bits)) << nacc;
+		nacc += bits;
+		while (nacc >= 8)
+		{
+			if (used < size)
+				buf[used] = (unsigned char)acc;
+			else
+				overflow = true;
+			used++;
+			acc >>= 8;
+			nacc -= 8;
+		}
+	}
+
+	void putBool(bool value) { put(value ? 1 : 0, 1); }
+
+	// two's complement, clamped to the range of bits
+	void putSigned(int32_t value, int bits)
+	{
+		int32_t max = (int32_t)mask(bits - 1);
+
+		if (value > max)
+			value = max;
+		if (value < -max - 1)
+			value = -max - 1;
+		put((uint32_t)value, bits);
+	}
+
+	// value / step, rounded and clamped to the range of bits
+	void putFixed(float value, float step, int bits)
+	{
+		float q = value / step;
+		float max = (float)mask(bits - 1);
+
+		if (!(q == q))
+			q = 0.0f;
+		if (q > max)
+			q = max;
+		if (q < -max - 1.0f)
+			q = -max - 1.0f;
+		putSigned((int32_t)lrintf(q), bits);
+	}
+
+	//	Output:
+	//		number of bytes used, -1 if the buffer was too small
+	int finish()
+	{
+		if (nacc > 0)
+			put(0, 8 - nacc);
+		return overflow ? -1 : used;
+	}
+
+	static uint32_t mask(int bits) { return (bits >= 32) ? 0xffffffffu : ((1u << bits) - 1); }
+
+private:
+	unsigned char *buf;
+	int size;
+	int used;
+	uint64_t acc;
+	int nacc;
+	bool overflow;
+};
+
+
+//	*************************
+//	BitReader: reads the fields written by BitWriter
+//		note: reading past the end returns zeros and sets the error
+//
+class BitReader
+{
+public:
+	BitReader(const unsigned char *buf, int size) : buf(buf), size(size), used(0), acc(0), nacc(0), error(false) {}
+
+	uint32_t get(int bits)
+	{
+		uint32_t value;
+
+		while (nacc < bits)
+		{
+			if (used < size)
+				acc |= (uint64_t)buf[used] << nacc;
+			else
+				error = true;
+			used++;
+			nacc += 8;
+		}
+		value = (uint32_t)acc & BitWriter::mask(bits);
+		acc >>= bits;
+		nacc -= bits;
+		return value;
+	}
+
+	bool getBool() { return get(1) != 0; }
+
+	int32_t getSigned(int bits)
+	{
+		uint32_t value = get(bits);
+
+		if ((bits < 32) && (value & (1u << (bits - 1))))
+			value |= ~BitWriter::mask(bits);
+		return (int32_t)value;
+	}
+
+	float getFixed(float step, int bits) { return getSigned(bits) * step; }
+
+	// all the data was read, and nothing more
+	bool ok() const { return !error && (used == size); }
+
+private:
+	const unsigned char *buf;
+	int size;
+	int used;
+	uint64_t acc;
+	int nacc;
+	bool error;
+};
+
+
+//	*************************
+//	RTDBwire_item: packer and unpacker of a shared item
+//
+//	pack:
+//		const void *data = record, as in the RtDB
+//		unsigned char *buf, int max = frame space
+//		returns the number of bytes written, -1 if it does not fit
+//	unpack:
+//		const unsigned char *buf, int len = packed record
+//		void *data = record, as in the RtDB
+//		returns 0, -1 if the packed record is not valid
+//
+typedef struct
+{
+	int id;
+	int size;
+	int (*pack)(const void *data, unsigned char *buf, int max);
+	int (*unpack)(const unsigned char *buf, int len, void *data);
+} RTDBwire_item;
+
+
+// default: the record as it is
+template<typename T>
+struct Wire
+{
+	static int pack(const void *data, unsigned char *buf, int max)
+	{
+		if (max < (int)sizeof(T))
+			return -1;
+		memcpy(buf, data, sizeof(T));
+		return sizeof(T);
+	}
+
+	static int unpack(const unsigned char *buf, int len, void *data)
+	{
+		if (len != (int)sizeof(T))
+			return -1;
+		memcpy(data, buf, sizeof(T));
+		return 0;
+	}
+};
+
+template<>
+struct Wire<cambada::Robot>
+{
+	static int pack(const void *data, unsigned char *buf, int max);
+	static int unpack(const unsigned char *buf, int len, void *data);
+};
+
+
+//	*************************
+//	wire_pack: pack a record in a frame
+//		note: the items without packer go as they are
+//
+//	Input:
+//		int id = item
+//		const void *data, int size = record, as in the RtDB
+//		unsigned char *buf, int max = frame space
+//	Output:
+//		number of bytes written
+//		-1 = does not fit, or size is not the one of rtdb_items.h
+//
+int wire_pack(int id, const void *data, int size, unsigned char *buf, int max);
+
+
+//	*************************
+//	wire_unpack: unpack a record of a frame
+//
+//	Input:
+//		int id = item
+//		const unsigned char *buf, int len = packed record
+//		void *data, int max = space for the record
+//	Output:
+//		size of the record
+//		-1 = packed record not valid
+//
+int wire_unpack(int id, const unsigned char *buf, int len, void *data, int max);
+
+#endif
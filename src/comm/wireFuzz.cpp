@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA COMM
+ *
+ * CAMBADA COMM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA COMM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Round trip check of the comm packers with random and malformed records:
+//   unpack(pack(r)) is r within the fixed point steps
+//   pack(unpack(pack(r))) is pack(r)
+//   truncated, overlong or random packed records are rejected or read
+//   without going out of the buffers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "wire.h"
+#include "rtdb_user.h"
+
+#include "MersenneTwister.h"
+#include "CheckReport.h"
+
+using namespace cambada;
+
+#define BUFFER_SIZE 1400
+#define GUARD 0x5a
+
+MTRand randomGenerator;
+
+
+static float randomFloat(float range)
+{
+	return (float)((randomGenerator.rand() * 2.0 - 1.0) * range);
+}
+
+static void randomVec(Vec &v, float range)
+{
+	v.x = randomFloat(range);
+	v.y = randomFloat(range);
+}
+
+// a robot inside the ranges of the fixed point fields
+static void randomRobot(Robot *robot)
+{
+	int i;
+
+	memset((void*)robot, 0, sizeof(Robot));
+	robot->number = randomGenerator.randInt(N_AGENTS);
+	robot->behaviour = (BehaviourID)randomGenerator.randInt(bTouchBall);
+	robot->role = (RoleID)randomGenerator.randInt(rGoaliePenalty);
+	robot->coordinationFlag[0] = randomGenerator.randInt(60) - 30;
+	robot->coordinationFlag[1] = randomGenerator.randInt(60) - 30;
+	robot->currentGameState = (WSGameState)randomGenerator.randInt(postOpponentGoal);
+	randomVec(robot->coordinationVec, 20.0f);
+	robot->teamColor = (WSColor)randomGenerator.randInt(3);
+	robot->goalColor = (WSColor)randomGenerator.randInt(3);
+	robot->stuck = randomGenerator.randInt(2);
+	robot->roleAuto = randomGenerator.randInt(1);
+	robot->running = randomGenerator.randInt(1);
+	robot->coaching = randomGenerator.randInt(1);
+	robot->justKicked = randomGenerator.randInt(1);
+	robot->handicappedGrabber = randomGenerator.randInt(1);
+	robot->opponentDribbling = randomGenerator.randInt(255);
+	for (i = 0; i < N_BATTERIES; i++)
+		robot->battery[i] = (float)randomGenerator.rand(30.0);
+	robot->orientation = randomFloat(2.0f * M_PI);
+	robot->angVelocity = randomFloat(20.0f);
+	for (i = 0; i < 4; i++)
+		randomVec(robot->debugPoints[i], 120.0f);
+	randomVec(robot->pos, 12.0f);
+	randomVec(robot->vel, 5.0f);
+	randomVec(robot->ball.pos, 12.0f);
+	randomVec(robot->ball.posRel, 20.0f);
+	randomVec(robot->ball.vel, 15.0f);
+	robot->ball.height = (float)randomGenerator.rand(3.0);
+	robot->ball.own = randomGenerator.randInt(1);
+	robot->ball.engaged = randomGenerator.randInt(1);
+	robot->ball.visible = randomGenerator.randInt(1);
+	robot->ball.airborne = randomGenerator.randInt(1);
+	robot->ball.hasMoved = randomGenerator.randInt(1);
+	randomVec(robot->passLine.p1, 12.0f);
+	randomVec(robot->passLine.p2, 12.0f);
+	robot->nObst = randomGenerator.randInt(MAX_SHARED_OBSTACLES);
+	for (i = 0; i < robot->nObst; i++)
+	{
+		randomVec(robot->obstacles[i].absCenter, 12.0f);
+		robot->obstacles[i].id = randomGenerator.randInt(255);
+	}
+}
+
+static bool near(float a, float b, float step)
+{
+	return fabsf(a - b) <= step * 0.5f + fabsf(a) * 1E-6f;
+}
+
+static bool nearVec(const Vec &a, const Vec &b, float step)
+{
+	return near(a.x, b.x, step) && near(a.y, b.y, step);
+}
+
+static void compareRobots(const Robot *a, const Robot *b)
+{
+	int i;
+
+	CHECK(a->number == b->number, "number");
+	CHECK(a->behaviour == b->behaviour, "behaviour");
+	CHECK(a->role == b->role, "role");
+	CHECK(a->coordinationFlag[0] == b->coordinationFlag[0], "coordinationFlag");
+	CHECK(a->coordinationFlag[1] == b->coordinationFlag[1], "coordinationFlag");
+	CHECK(a->currentGameState == b->currentGameState, "currentGameState");
+	CHECK(nearVec(a->coordinationVec, b->coordinationVec, 0.001f), "coordinationVec");
+	CHECK(a->teamColor == b->teamColor, "teamColor");
+	CHECK(a->goalColor == b->goalColor, "goalColor");
+	CHECK(a->stuck == b->stuck, "stuck");
+	CHECK(a->roleAuto == b->roleAuto, "roleAuto");
+	CHECK(a->running == b->running, "running");
+	CHECK(a->coaching == b->coaching, "coaching");
+	CHECK(a->justKicked == b->justKicked, "justKicked");
+	CHECK(a->handicappedGrabber == b->handicappedGrabber, "handicappedGrabber");
+	CHECK(a->opponentDribbling == b->opponentDribbling, "opponentDribbling");
+	for (i = 0; i < N_BATTERIES; i++)
+		CHECK(near(a->battery[i], b->battery[i], 0.01f), "battery %d: %f %f", i, a->battery[i], b->battery[i]);
+	CHECK(near(a->orientation, b->orientation, 0.0001f), "orientation %f %f", a->orientation, b->orientation);
+	CHECK(near(a->angVelocity, b->angVelocity, 0.001f), "angVelocity");
+	for (i = 0; i < 4; i++)
+		CHECK(nearVec(a->debugPoints[i], b->debugPoints[i], 0.001f), "debugPoints %d", i);
+	CHECK(nearVec(a->pos, b->pos, 0.001f), "pos");
+	CHECK(nearVec(a->vel, b->vel, 0.001f), "vel");
+	CHECK(nearVec(a->ball.pos, b->ball.pos, 0.001f), "ball.pos");
+	CHECK(nearVec(a->ball.posRel, b->ball.posRel, 0.001f), "ball.posRel");
+	CHECK(nearVec(a->ball.vel, b->ball.vel, 0.001f), "ball.vel");
+	CHECK(near(a->ball.height, b->ball.height, 0.001f), "ball.height");
+	CHECK(a->ball.own == b->ball.own, "ball.own");
+	CHECK(a->ball.engaged == b->ball.engaged, "ball.engaged");
+	CHECK(a->ball.visible == b->ball.visible, "ball.visible");
+	CHECK(a->ball.airborne == b->ball.airborne, "ball.airborne");
+	CHECK(a->ball.hasMoved == b->ball.hasMoved, "ball.hasMoved");
+	CHECK(nearVec(a->passLine.p1, b->passLine.p1, 0.001f), "passLine.p1");
+	CHECK(nearVec(a->passLine.p2, b->passLine.p2, 0.001f), "passLine.p2");
+	CHECK(a->nObst == b->nObst, "nObst %d %d", a->nObst, b->nObst);
+	for (i = 0; (i < a->nObst) && (i < MAX_SHARED_OBSTACLES); i++)
+	{
+		CHECK(nearVec(a->obstacles[i].absCenter, b->obstacles[i].absCenter, 0.001f), "obstacle %d", i);
+		CHECK(a->obstacles[i].id == b->obstacles[i].id, "obstacle id %d", i);
+	}
+}
+
+// pack, unpack and pack again
+static int roundTrip(int id, const void *data, int size, void *out, unsigned char *packed)
+{
+	unsigned char repacked[BUFFER_SIZE];
+	int n, m;
+
+	n = wire_pack(id, data, size, packed, BUFFER_SIZE);
+	CHECK(n > 0, "item %d: pack", id);
+	if (n <= 0)
+		return -1;
+
+	CHECK(wire_unpack(id, packed, n, out, size) == size, "item %d: unpack", id);
+
+	m = wire_pack(id, out, size, repacked, BUFFER_SIZE);
+	CHECK((m == n) && (memcmp(packed, repacked, n) == 0), "item %d: pack(unpack(pack)) differs", id);
+
+	return n;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = (argc > 1) ? atoi(argv[1]) : 100000;
+	long long robotData[sizeof(Robot) / sizeof(long long) + 1];
+	long long outData[sizeof(Robot) / sizeof(long long) + 1];
+	Robot *robot = (Robot*)robotData;
+	Robot *out = (Robot*)outData;
+	unsigned char packed[BUFFER_SIZE + 16];
+	unsigned char raw[64], rawOut[64];
+	int it, i, n, len, minPacked = BUFFER_SIZE, maxPacked = 0;
+	long long totalPacked = 0;
+
+	for (it = 0; it < iterations; it++)
+	{
+		// valid robots
+		randomRobot(robot);
+		if ((n = roundTrip(ROBOT_WS, robot, sizeof(Robot), out, packed)) < 0)
+			continue;
+		compareRobots(robot, out);
+		totalPacked += n;
+		if (n < minPacked)
+			minPacked = n;
+		if (n > maxPacked)
+			maxPacked = n;
+
+		// truncated or overlong packed records
+		len = randomGenerator.randInt(n - 1);
+		CHECK(wire_unpack(ROBOT_WS, packed, len, out, sizeof(Robot)) == -1, "truncated to %d of %d accepted", len, n);
+		packed[n] = randomGenerator.randInt(255);
+		CHECK(wire_unpack(ROBOT_WS, packed, n + 1, out, sizeof(Robot)) == -1, "overlong accepted");
+
+		// frame space too small: refused, nothing written after it
+		len = randomGenerator.randInt(n - 1);
+		memset(packed, GUARD, sizeof(packed));
+		CHECK(wire_pack(ROBOT_WS, robot, sizeof(Robot), packed, len) == -1, "pack in %d of %d bytes", len, n);
+		for (i = len; i < (int)sizeof(packed); i++)
+			CHECK(packed[i] == GUARD, "pack wrote past %d bytes", len);
+
+		// out of range values are clamped, and stable after one trip
+		robot->pos.x = randomFloat(1E6f);
+		robot->ball.vel.y = randomFloat(1E6f);
+		robot->battery[0] = randomFloat(1E3f);
+		robot->orientation = (it & 1) ? NAN : randomFloat(1E3f);
+		robot->nObst = 200 + randomGenerator.randInt(55);
+		if ((n = roundTrip(ROBOT_WS, robot, sizeof(Robot), out, packed)) > 0)
+			CHECK(out->nObst == MAX_SHARED_OBSTACLES, "nObst not clamped");
+
+		// random packed records: rejected or read within the buffers
+		len = randomGenerator.randInt(BUFFER_SIZE);
+		for (i = 0; i < len; i++)
+			packed[i] = randomGenerator.randInt(255);
+		if (wire_unpack(ROBOT_WS, packed, len, out, sizeof(Robot)) == (int)sizeof(Robot))
+		{
+			CHECK(out->nObst <= MAX_SHARED_OBSTACLES, "random record with %d obstacles", out->nObst);
+			roundTrip(ROBOT_WS, out, sizeof(Robot), robot, packed);
+		}
+
+		// items without packer go as they are
+		for (i = 0; i < (int)sizeof(raw); i++)
+			raw[i] = randomGenerator.randInt(255);
+		len = 1 + randomGenerator.randInt(sizeof(raw) - 1);
+		CHECK(wire_pack(N_ITEMS + 1, raw, len, packed, BUFFER_SIZE) == len, "raw pack");
+		CHECK((wire_unpack(N_ITEMS + 1, packed, len, rawOut, sizeof(rawOut)) == len) && (memcmp(raw, rawOut, len) == 0), "raw unpack");
+		CHECK(wire_unpack(N_ITEMS + 1, packed, len, rawOut, len - 1) == -1, "raw unpack overflow");
+	}
+
+	printf("%d iterations, ROBOT_WS: %d bytes in the RtDB, packed in %d to %d, %.1f on average\n",
+			iterations, (int)sizeof(Robot), minPacked, maxPacked, (double)totalPacked / iterations);
+	return checkReport("wire codecs");
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2015, CAMBADA <cambada@ua.pt>
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * It is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+/*
+ * Microbenchmark of the geometry kernels
+ *
+ * Each benchmark runs its kernel on a fixed set of random inputs, with the
+ * iteration count doubled until a run takes at least the minimum time, and
+ * reports the time and the heap allocations per iteration (operator new is
+ * counted here). The segment against many circles cases compare a loop of
+ * LineSegment::distance with the batched intersects().
+ *
+ * Usage: geom-bench [filter] [min seconds]
+ *   filter: run only the benchmarks whose name contains it
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <sys/time.h>
+
+#include "geometry.h"
+
+using namespace cambada::geom;
+
+static unsigned long allocations = 0;
+
+void* operator new (size_t size) throw (std::bad_alloc)
+{
+	allocations++;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete (void* p) throw ()
+{
+	free(p);
+}
+
+#define INPUTS		1024
+#define MAX_CIRCLES	256
+
+static Line lines[INPUTS];
+static LineSegment segments[INPUTS];
+static Circle circles[INPUTS];
+static Arc arcs[INPUTS];
+
+static double cx[MAX_CIRCLES], cy[MAX_CIRCLES], cr[MAX_CIRCLES];
+static bool hit[MAX_CIRCLES];
+
+/* keeps the results alive */
+static volatile double sink;
+
+static double rnd(double min, double max)
+{
+	return min + (max - min) * (rand() / (double)RAND_MAX);
+}
+
+static Vec rndVec()
+{
+	return Vec(rnd(-6, 6), rnd(-9, 9));
+}
+
+static void setup()
+{
+	srand(2015);
+	for (unsigned int i = 0; i < INPUTS; i++)
+	{
+		Vec a = rndVec(), b = rndVec();
+		lines[i] = Line(a, b + Vec(0.01, 0));
+		segments[i] = LineSegment(a, b);
+		circles[i] = Circle(rndVec(), rnd(0.2, 4));
+		arcs[i] = Arc(rndVec(), rnd(0.5, 4), Angle::deg_angle(rnd(0, 360)), Angle::deg_angle(rnd(0, 360)));
+	}
+	for (unsigned int i = 0; i < MAX_CIRCLES; i++)
+	{
+		cx[i] = rnd(-6, 6);
+		cy[i] = rnd(-9, 9);
+		cr[i] = 0.25;
+	}
+}
+
+static void BM_IntersectLineCircle(unsigned long iterations)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		unsigned int i = it % INPUTS;
+		Intersections r = intersect(lines[i], circles[(i * 7) % INPUTS]);
+		s += r.size() ? r[0].x : 0;
+	}
+	sink = s;
+}
+
+static void BM_IntersectCircleCircle(unsigned long iterations)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		unsigned int i = it % INPUTS;
+		Intersections r = intersect(circles[i], circles[(i * 7 + 1) % INPUTS]);
+		s += r.size() ? r[0].x : 0;
+	}
+	sink = s;
+}
+
+static void BM_IntersectSegmentSegment(unsigned long iterations)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		unsigned int i = it % INPUTS;
+		Intersections r = intersect(segments[i], segments[(i * 7 + 1) % INPUTS]);
+		s += r.size() ? r[0].x : 0;
+	}
+	sink = s;
+}
+
+/* parallel segments, the case that used to throw and catch an exception */
+static void BM_IntersectSegmentSegmentParallel(unsigned long iterations)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		unsigned int i = it % INPUTS;
+		Intersections r = intersect(segments[i], segments[i].translate(Vec(0.5, 0.5)));
+		s += r.size();
+	}
+	sink = s;
+}
+
+static void BM_IntersectSegmentArc(unsigned long iterations)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		unsigned int i = it % INPUTS;
+		Intersections r = intersect(segments[i], arcs[(i * 7) % INPUTS]);
+		s += r.size() ? r[0].x : 0;
+	}
+	sink = s;
+}
+
+static void segmentCirclesScalar(unsigned long iterations, unsigned int n)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+	{
+		LineSegment& seg = segments[it % INPUTS];
+		unsigned int count = 0;
+		for (unsigned int c = 0; c < n; c++)
+			count += (seg.distance(Vec(cx[c], cy[c])) <= cr[c]);
+		s += count;
+	}
+	sink = s;
+}
+
+static void segmentCirclesBatch(unsigned long iterations, unsigned int n)
+{
+	double s = 0;
+	for (unsigned long it = 0; it < iterations; it++)
+		s += intersects(segments[it % INPUTS], cx, cy, cr, n, hit);
+	sink = s;
+}
+
+static void BM_SegmentCircles16_Scalar(unsigned long iterations) { segmentCirclesScalar(iterations, 16); }
+static void BM_SegmentCircles16_Batch(unsigned long iterations) { segmentCirclesBatch(iterations, 16); }
+static void BM_SegmentCircles256_Scalar(unsigned long iterations) { segmentCirclesScalar(iterations, 256); }
+static void BM_SegmentCircles256_Batch(unsigned long iterations) { segmentCirclesBatch(iterations, 256); }
+
+struct Benchmark
+{
+	const char* name;
+	void (*run)(unsigned long);
+};
+
+#define BENCHMARK(f) { #f, f }
+
+static const Benchmark benchmarks[] = {
+	BENCHMARK(BM_IntersectLineCircle),
+	BENCHMARK(BM_IntersectCircleCircle),
+	BENCHMARK(BM_IntersectSegmentSegment),
+	BENCHMARK(BM_IntersectSegmentSegmentParallel),
+	BENCHMARK(BM_IntersectSegmentArc),
+	BENCHMARK(BM_SegmentCircles16_Scalar),
+	BENCHMARK(BM_SegmentCircles16_Batch),
+	BENCHMARK(BM_SegmentCircles256_Scalar),
+	BENCHMARK(BM_SegmentCircles256_Batch),
+};
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* filter = (argc > 1) ? argv[1] : "";
+	double minTime = (argc > 2) ? atof(argv[2]) : 0.2;
+
+	setup();
+
+	printf("%-40s %12s %12s %12s\n", "Benchmark", "Time", "Iterations", "Allocs/it");
+	for (unsigned int b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+	{
+		if (strstr(benchmarks[b].name, filter) == NULL)
+			continue;
+
+		unsigned long iterations = 1000;
+		double elapsed;
+		unsigned long allocs;
+		for (;;)
+		{
+			unsigned long a0 = allocations;
+			double t0 = now();
+			benchmarks[b].run(iterations);
+			elapsed = now() - t0;
+			allocs = allocations - a0;
+			if (elapsed >= minTime || iterations >= (1ul << 40))
+				break;
+			iterations *= 2;
+		}
+
+		printf("%-40s %9.1f ns %12lu %12.2f\n", benchmarks[b].name,
+			elapsed * 1e9 / iterations, iterations, allocs / (double)iterations);
+	}
+
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2015, CAMBADA <cambada@ua.pt>
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * It is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+/*
+ * Correctness check of the batched segment kernels
+ *
+ * closest_points and intersects are compared with the scalar routines they
+ * stand for: LineSegment::closestPoint and distance, and the intersection
+ * of the segment line with each circle (intersect(Line, Circle)) kept when
+ * it lies on the segment, or an end point inside the circle.
+ *
+ * Random segments and circles are checked away from the touching distance,
+ * where rounding decides. The special cases are built on integer
+ * coordinates, so that they are exact in float: circles tangent to the
+ * segment or through an end point, segments parallel to the axes, circles
+ * on the segment line past the ends, zero radius circles and zero length
+ * segments (there the scalar routines divide by zero, the kernels take the
+ * end point).
+ *
+ * Usage: geom-check [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "geometry.h"
+#include "CheckReport.h"
+
+using namespace cambada::geom;
+
+#define BATCH	16
+
+static double uniform (double a, double b)
+{
+	return a + (b - a) * (rand() / (double)RAND_MAX);
+}
+
+static int integer (int a, int b)
+{
+	return a + rand() % (b - a + 1);
+}
+
+/* The segment against one circle with the scalar routines */
+static bool scalarHit (const LineSegment& s, const Vec& c, double r)
+{
+	if ((s.p1 - c).length() <= r || (s.p2 - c).length() <= r)
+		return true;
+	if (s.p1 == s.p2)
+		return false;
+
+	Intersections is = intersect (Line (s.p1, s.p2), Circle (c, r));
+	for (unsigned int i = 0; i < is.size(); i++)
+	{
+		double tv = (s.p1.x != s.p2.x ? (is[i].x - s.p1.x) / (s.p2.x - s.p1.x)
+			: (is[i].y - s.p1.y) / (s.p2.y - s.p1.y));
+		if (tv >= 0 && tv <= 1)
+			return true;
+	}
+	return false;
+}
+
+/* Both kernels on a batch, against the scalar routines.
+ * exact: the batch is on integer coordinates, no tolerance at the border */
+static void checkBatch (const char* what, LineSegment s, const double* x, const double* y, const double* r,
+	unsigned int n, bool exact)
+{
+	double tau[BATCH], dist2[BATCH];
+	bool hit[BATCH];
+	unsigned int i, count = 0;
+
+	closest_points (s, x, y, n, tau, dist2);
+	unsigned int hits = intersects (s, x, y, r, n, hit);
+	CHECK (intersects (s, x, y, r, n, NULL) == hits, "%s: the count depends on the hit array", what);
+
+	double length = (s.p2 - s.p1).length();
+	for (i = 0; i < n; i++)
+	{
+		Vec p (x[i], y[i]);
+		count += hit[i];
+
+		CHECK (tau[i] >= 0 && tau[i] <= 1, "%s: tau %g out of the segment", what, tau[i]);
+
+		// the closest point, and its distance
+		Vec closest, onSegment = s.p1 + tau[i] * (s.p2 - s.p1);
+		double distance;
+		if (length == 0)
+		{
+			closest = s.p1;
+			distance = (p - s.p1).length();
+			CHECK (tau[i] == 0, "%s: zero length segment, tau %g", what, tau[i]);
+		}
+		else
+		{
+			closest = s.closestPoint (p);
+			distance = s.distance (p);
+		}
+
+		double tolerance = 1e-5 * (1 + length + (p - s.p1).length());
+		CHECK ((onSegment - closest).length() <= tolerance,
+			"%s: closest point (%g, %g), scalar (%g, %g)", what, onSegment.x, onSegment.y, closest.x, closest.y);
+		CHECK (fabs (sqrt (dist2[i]) - distance) <= tolerance,
+			"%s: distance %g, scalar %g", what, sqrt (dist2[i]), distance);
+		if (exact)
+			CHECK (dist2[i] == (p - closest).squared_length(),
+				"%s: squared distance %g, exact %g", what, dist2[i], (p - closest).squared_length());
+
+		// touching is decided by rounding unless the inputs are exact
+		if (!exact && fabs (distance - r[i]) <= tolerance)
+			continue;
+
+		bool scalar = scalarHit (s, p, r[i]);
+		CHECK (hit[i] == scalar, "%s: (%g, %g)-(%g, %g) against (%g, %g) r %g: hit %d, scalar %d",
+			what, s.p1.x, s.p1.y, s.p2.x, s.p2.y, p.x, p.y, r[i], hit[i], scalar);
+		if (length > 0)
+			CHECK (hit[i] == (distance <= r[i]), "%s: hit %d, distance %g r %g", what, hit[i], distance, r[i]);
+	}
+
+	CHECK (hits == count, "%s: %u hits counted, %u marked", what, hits, count);
+}
+
+static void checkRandom ()
+{
+	double x[BATCH], y[BATCH], r[BATCH];
+
+	for (int run = 0; run < 20000; run++)
+	{
+		LineSegment s (Vec (uniform (-9, 9), uniform (-6, 6)), Vec (uniform (-9, 9), uniform (-6, 6)));
+		for (unsigned int i = 0; i < BATCH; i++)
+		{
+			x[i] = (float)uniform (-9, 9);
+			y[i] = (float)uniform (-6, 6);
+			r[i] = uniform (0, 3);
+		}
+		checkBatch ("random", s, x, y, r, BATCH, false);
+	}
+}
+
+/* Circles exactly tangent to the segment, through an end point, or missing
+ * by one, for segments parallel to the axes */
+static void checkTangent ()
+{
+	double x[BATCH], y[BATCH], r[BATCH];
+	bool touching[BATCH], hit[BATCH];
+
+	for (int run = 0; run < 2000; run++)
+	{
+		int a = integer (-8, 0), b = integer (1, 8), c = integer (-5, 5);
+		bool vertical = run & 1;
+		LineSegment s = vertical ? LineSegment (Vec (c, a), Vec (c, b)) : LineSegment (Vec (a, c), Vec (b, c));
+
+		for (unsigned int i = 0; i < BATCH; i++)
+		{
+			int along, across, radius;
+			switch (i % 4)
+			{
+				case 0:		// tangent inside the segment
+					radius = integer (1, 4);
+					along = integer (a, b);
+					across = (i & 4) ? radius : -radius;
+					touching[i] = true;
+					break;
+				case 1:		// through an end point, on a 3-4-5 triangle
+					radius = 5;
+					along = (i & 4) ? b + 3 : a - 3;
+					across = (i & 8) ? 4 : -4;
+					touching[i] = true;
+					break;
+				case 2:		// one short of tangent
+					radius = integer (1, 4);
+					along = integer (a, b);
+					across = radius + 1;
+					touching[i] = false;
+					break;
+				default:	// zero radius, on the segment or just off it
+					radius = 0;
+					along = integer (a - 1, b + 1);
+					across = (i & 4) ? 0 : 1;
+					touching[i] = across == 0 && along >= a && along <= b;
+					break;
+			}
+
+			x[i] = vertical ? c + across : along;
+			y[i] = vertical ? along : c + across;
+			r[i] = radius;
+		}
+
+		checkBatch ("tangent", s, x, y, r, BATCH, true);
+
+		intersects (s, x, y, r, BATCH, hit);
+		for (unsigned int i = 0; i < BATCH; i++)
+			CHECK (hit[i] == touching[i], "tangent case %u: (%g, %g) r %g, hit %d", i % 4, x[i], y[i], r[i], hit[i]);
+	}
+}
+
+/* Circles centred on the segment line, before, on and past the ends */
+static void checkCollinear ()
+{
+	double x[BATCH], y[BATCH], r[BATCH];
+
+	for (int run = 0; run < 2000; run++)
+	{
+		int dx = integer (-3, 3), dy = integer (-3, 3);
+		if (dx == 0 && dy == 0)
+			dx = 1;
+		Vec p1 (integer (-5, 5), integer (-5, 5));
+		int steps = integer (1, 3);
+		LineSegment s (p1, p1 + steps * Vec (dx, dy));
+
+		for (unsigned int i = 0; i < BATCH; i++)
+		{
+			int k = integer (-4, steps + 4);
+			x[i] = p1.x + k * dx;
+			y[i] = p1.y + k * dy;
+			r[i] = integer (0, 2) * sqrt ((double)(dx * dx + dy * dy));
+		}
+
+		checkBatch ("collinear", s, x, y, r, BATCH, false);
+	}
+}
+
+/* Segments reduced to a point */
+static void checkZeroLength ()
+{
+	double x[BATCH], y[BATCH], r[BATCH];
+
+	for (int run = 0; run < 2000; run++)
+	{
+		Vec p (integer (-5, 5), integer (-5, 5));
+		LineSegment s (p, p);
+
+		for (unsigned int i = 0; i < BATCH; i++)
+		{
+			x[i] = p.x + integer (-4, 4);
+			y[i] = p.y + integer (-4, 4);
+			r[i] = integer (0, 5);
+		}
+
+		checkBatch ("zero length", s, x, y, r, BATCH, true);
+	}
+}
+
+int main (int argc, char* argv[])
+{
+	srand (argc > 1 ? atoi (argv[1]) : 2015);
+
+	double x = 1, y = 1, r = 1;
+	CHECK (intersects (LineSegment (Vec (0, 0), Vec (1, 0)), &x, &y, &r, 0, NULL) == 0, "empty batch");
+
+	checkRandom ();
+	checkTangent ();
+	checkCollinear ();
+	checkZeroLength ();
+
+	return checkReport ("batched segment kernels");
+}
@@ -30,6 +30,21 @@ namespace geom {
   }
 
 
+  // Schnittpunkt der Geraden durch (a1,a2) und (b1,b2); false bei parallelen Geraden.
+  // Ohne Ausnahmen, fuer die Linienstuecke, bei denen parallele Geraden haeufig sind
+  inline bool intersect_lines (const Vec& a1, const Vec& a2, const Vec& b1, const Vec& b2, Vec& is) {
+    Vec d1=a2-a1;
+    Vec d2=b2-b1;
+    double det=d1.x*d2.y-d2.x*d1.y;
+    if (det==0)
+      return false;
+    Vec dp=b1-a1;
+    double tau=(d2.y*dp.x-d2.x*dp.y)/det;
+    is=(1.0-tau)*a1+tau*a2;
+    return true;
+  }
+
+
   const Line Line::def (Vec::zero_vector,Vec::unit_vector_y);
 
 Line::Line () throw () : p1 (Vec::zero_vector), p2 (Vec::unit_vector_x) {;}
@@ -159,17 +174,13 @@ bool Circle::is_inside (const Vec p) const throw () {
 }
 
 Vec intersect (const Line& ln1, const Line& ln2) throw (std::invalid_argument) {
-  Vec d1=ln1.p2-ln1.p1;
-  Vec d2=ln2.p2-ln2.p1;
-  double det=d1.x*d2.y-d2.x*d1.y;
-  if (det==0)
+  Vec is;
+  if (!intersect_lines (ln1.p1, ln1.p2, ln2.p1, ln2.p2, is))
     throw std::invalid_argument("parallel lines in intersect");
-  Vec dp=ln2.p1-ln1.p1;
-  double tau=(d2.y*dp.x-d2.x*dp.y)/det;
-  return (1.0-tau)*ln1.p1+tau*ln1.p2;
+  return is;
 }
 
-std::vector<Vec> intersect (const Line& ln, const Circle& cc) throw (std::bad_alloc) {
+Intersections intersect (const Line& ln, const Circle& cc) throw () {
   double d_len2 = (ln.p1-ln.p2).squared_length();
   double p1_len2 = ln.p1.squared_length();
   double c_len2 = cc.center.squared_length();
@@ -181,80 +192,112 @@ std::vector<Vec> intersect (const Line& ln, const Circle& cc) throw (std::bad_al
   double c_term = p1_len2+c_len2-2.0*p1_c-cc.radius*cc.radius;
 
   double rad = l_term*l_term-4.0*d_len2*c_term;
+  Intersections ret;
   if (rad<0) {
-    std::vector<Vec> ret (0);
     return ret;
   } else if (rad==0) {
-    std::vector<Vec> ret (1);
     double tau = -l_term/(2.0*d_len2);
-    ret[0]=(1.0-tau)*ln.p1+tau*ln.p2;
+    ret.push_back ((1.0-tau)*ln.p1+tau*ln.p2);
     return ret;
   } else {
-    std::vector<Vec> ret (2);
     double root = std::sqrt(rad);
     double tau = (-l_term+root)/(2.0*d_len2);
-    ret[0]=(1.0-tau)*ln.p1+tau*ln.p2;
+    ret.push_back ((1.0-tau)*ln.p1+tau*ln.p2);
     tau = (-l_term-root)/(2.0*d_len2);
-    ret[1]=(1.0-tau)*ln.p1+tau*ln.p2;
+    ret.push_back ((1.0-tau)*ln.p1+tau*ln.p2);
     return ret;
   }
 }
 
-std::vector<Vec> intersect (const Circle& cc1, const Circle& cc2) throw (std::bad_alloc) {
+Intersections intersect (const Circle& cc1, const Circle& cc2) throw () {
   Vec d = (cc2.center-cc1.center);
   double d_len2 = d.squared_length();
   double d_len = std::sqrt (d_len2);
+  Intersections ret;
   if ((d_len>(cc1.radius+cc2.radius)) || (d_len<std::abs(cc1.radius-cc2.radius))) {
-    std::vector<Vec> ret (0);
     return ret;
   } else if (d_len==(cc1.radius+cc2.radius)) {
-    std::vector<Vec> ret (1);
     if ((cc1.radius==0)&&(cc2.radius==0))
-      ret[0]=cc1.center;
+      ret.push_back (cc1.center);
     else
-      ret[0]=cc1.center+(cc1.radius/(cc1.radius+cc2.radius))*d;
+      ret.push_back (cc1.center+(cc1.radius/(cc1.radius+cc2.radius))*d);
     return ret;
   } else if (d_len==(cc1.radius-cc2.radius)) {
-    std::vector<Vec> ret (1);
-    ret[0]=cc1.center+(cc1.radius/d_len)*d;
+    ret.push_back (cc1.center+(cc1.radius/d_len)*d);
     return ret;
   } else if (d_len==(cc2.radius-cc1.radius)) {
-    std::vector<Vec> ret (1);
-    ret[0]=cc1.center-(cc1.radius/d_len)*d;
+    ret.push_back (cc1.center-(cc1.radius/d_len)*d);
     return ret;
   } else {
-    std::vector<Vec> ret (2);
     Vec d_norm = (1.0/d_len)*d;
     Vec d_ortho (-d_norm.y, d_norm.x);
     double tau = (cc1.radius*cc1.radius+d_len2-cc2.radius*cc2.radius)/(2.0*d_len);
     double rho = std::sqrt(cc1.radius*cc1.radius-tau*tau);
-    ret[0]=cc1.center+tau*d_norm+rho*d_ortho;
-    ret[1]=cc1.center+tau*d_norm-rho*d_ortho;
+    ret.push_back (cc1.center+tau*d_norm+rho*d_ortho);
+    ret.push_back (cc1.center+tau*d_norm-rho*d_ortho);
     return ret;
   }
 }
 
-std::vector<Vec> tangent_point (const Circle& cc, const Vec& p) throw (std::bad_alloc, std::invalid_argument) {
+Intersections tangent_point (const Circle& cc, const Vec& p) throw (std::invalid_argument) {
   Vec d = (p-cc.center);
   double d_len = d.length();
+  Intersections ret;
   if (d_len<cc.radius)
     throw std::invalid_argument ("no tangent possible in tangent_point");
   else if (d_len==cc.radius) {
-    std::vector<Vec> ret (1);
-    ret[0]=p;
+    ret.push_back (p);
     return ret;
   } else {
-    std::vector<Vec> ret (2);
     Vec d_norm = (1.0/d_len)*d;
     Vec d_ortho (-d_norm.y,d_norm.x);
     double tau = (cc.radius*cc.radius)/d_len;
     double rho = std::sqrt(cc.radius*cc.radius-tau*tau);
-    ret[0]=cc.center+tau*d_norm+rho*d_ortho;
-    ret[1]=cc.center+tau*d_norm-rho*d_ortho;
+    ret.push_back (cc.center+tau*d_norm+rho*d_ortho);
+    ret.push_back (cc.center+tau*d_norm-rho*d_ortho);
     return ret;
   }
 }
 
+void closest_points (const LineSegment& l, const double* px, const double* py, unsigned int n, double* tau, double* dist2) throw () {
+  const double ax = l.p1.x, ay = l.p1.y;
+  const double dx = l.p2.x-ax, dy = l.p2.y-ay;
+  const double d_len2 = dx*dx+dy*dy;
+  const double d_inv = (d_len2>0 ? 1.0/d_len2 : 0.0);  // Linienstueck ist ein Punkt: tau = 0
+  for (unsigned int i=0; i<n; i++) {
+    // the ends decided on the dot product, inside the distance from the cross
+    // product, so that points on the segment give exactly 0
+    double vx = px[i]-ax, vy = py[i]-ay;
+    double dot = vx*dx+vy*dy;
+    double cross = vx*dy-vy*dx;
+    double wx = vx-dx, wy = vy-dy;
+    double t = dot*d_inv;
+    double d2 = cross*cross/d_len2;
+    tau[i] = (dot<=0 ? 0 : (dot>=d_len2 ? 1 : t));
+    dist2[i] = (dot<=0 ? vx*vx+vy*vy : (dot>=d_len2 ? wx*wx+wy*wy : d2));
+  }
+}
+
+unsigned int intersects (const LineSegment& l, const double* cx, const double* cy, const double* r, unsigned int n, bool* hit) throw () {
+  const double ax = l.p1.x, ay = l.p1.y;
+  const double dx = l.p2.x-ax, dy = l.p2.y-ay;
+  const double d_len2 = dx*dx+dy*dy;
+  unsigned int count = 0;
+  for (unsigned int i=0; i<n; i++) {
+    // as closest_points, without the division: cross^2/d_len2 <= r^2
+    double vx = cx[i]-ax, vy = cy[i]-ay;
+    double dot = vx*dx+vy*dy;
+    double cross = vx*dy-vy*dx;
+    double wx = vx-dx, wy = vy-dy;
+    double r2 = r[i]*r[i];
+    bool h = (dot<=0 ? vx*vx+vy*vy<=r2 : (dot>=d_len2 ? wx*wx+wy*wy<=r2 : cross*cross<=r2*d_len2));
+    count += h;
+    if (hit)
+      hit[i] = h;
+  }
+  return count;
+}
+
 Vec Line::perpendicular_point (const Vec& p) throw () {
   Vec d=p2-p1;
   return p1+((p*d-p1*d)/(d.squared_length()))*d;
@@ -352,23 +395,23 @@ bool Arc::is_inside(Vec p)
 }
 
 
-std::vector<Vec> intersect (const Line& l, const Arc& a) throw (std::bad_alloc) {
-  std::vector<Vec> res = intersect (l, Circle (a.center, a.radius));
+Intersections intersect (const Line& l, const Arc& a) throw () {
+  Intersections res = intersect (l, Circle (a.center, a.radius));
   unsigned int i=0;
   while (i<res.size())
     if (!(res[i]-a.center).angle().in_between (a.start, a.end))
-      res.erase (res.begin()+i);
+      res.erase (i);
     else
       i++;
   return res;
 }
 
-std::vector<Vec> intersect (const Arc& a, const Line& l) throw (std::bad_alloc) {
+Intersections intersect (const Arc& a, const Line& l) throw () {
   return intersect (l,a);
 }
 
-std::vector<Vec> intersect (const LineSegment& l, const Arc& a) throw (std::bad_alloc) {
-  std::vector<Vec> res = intersect (Line (l.p1, l.p2), a);
+Intersections intersect (const LineSegment& l, const Arc& a) throw () {
+  Intersections res = intersect (Line (l.p1, l.p2), a);
   unsigned int i=0;
   while (i<res.size()) {
     double tv;
@@ -377,56 +420,44 @@ std::vector<Vec> intersect (const LineSegment& l, const Arc& a) throw (std::bad_
     else
       tv = (res[i].y-l.p1.y)/(l.p2.y-l.p1.y);
     if (tv>1 || tv<0)
-      res.erase (res.begin()+i);
+      res.erase (i);
     else
       i++;
   }
   return res;
 }
 
-std::vector<Vec> intersect (const Arc& a, const LineSegment& l) throw (std::bad_alloc) {
+Intersections intersect (const Arc& a, const LineSegment& l) throw () {
   return intersect (l,a);
 }
     
-std::vector<Vec> intersect (const LineSegment& l1, const Line& l2) throw (std::bad_alloc) {
+Intersections intersect (const LineSegment& l1, const Line& l2) throw () {
+  Intersections res;
   Vec is;
-  try{
-    is = intersect (Line (l1.p1, l1.p2), l2);
-  }catch(std::invalid_argument&){
-    std::vector<Vec> leer (0);
-    return leer;
-  }
+  if (!intersect_lines (l1.p1, l1.p2, l2.p1, l2.p2, is))
+    return res;
   double tv = teilverhaeltnis (l1.p1, l1.p2, is);
-  if (tv<0 || tv>1) {
-    std::vector<Vec> leer (0);
-    return leer;
-  }
-  std::vector<Vec> nleer (1);
-  nleer[0]=is;
-  return nleer;
+  if (tv<0 || tv>1)
+    return res;
+  res.push_back (is);
+  return res;
 }
 
-std::vector<Vec> intersect (const Line& l1, const LineSegment& l2) throw (std::bad_alloc) {
+Intersections intersect (const Line& l1, const LineSegment& l2) throw () {
   return intersect (l2,l1);
 }
 
-std::vector<Vec> intersect (const LineSegment& l1, const LineSegment& l2) throw (std::bad_alloc) {
+Intersections intersect (const LineSegment& l1, const LineSegment& l2) throw () {
+  Intersections res;
   Vec is;
-  try{
-    is = intersect (Line (l1.p1,l1.p2), Line(l2.p1,l2.p2));
-  }catch(std::invalid_argument&){
-    std::vector<Vec> leer (0);
-    return leer;
-  }
+  if (!intersect_lines (l1.p1, l1.p2, l2.p1, l2.p2, is))
+    return res;
   double tv1 = teilverhaeltnis (l1.p1, l1.p2, is);
   double tv2 = teilverhaeltnis (l2.p1, l2.p2, is);
-  if (tv1<0 || tv1>1 || tv2<0 || tv2>1) {
-    std::vector<Vec> leer (0);
-    return leer;
-  }
-  std::vector<Vec> nleer (1);
-  nleer[0]=is;
-  return nleer;
+  if (tv1<0 || tv1>1 || tv2<0 || tv2>1)
+    return res;
+  res.push_back (is);
+  return res;
 }
 
 
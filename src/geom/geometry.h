@@ -41,6 +41,38 @@ namespace geom {
   class Quadrangle;
   class Halfplane;
 
+  /** Schnittpunkte, hoechstens zwei; ohne Heap gespeichert, da die Abfragen in
+      engen Schleifen laufen. Fuer Aufrufer mit std::vector<Vec> wird implizit konvertiert */
+  class Intersections {
+  public:
+    Intersections () throw () : n(0) {;}
+
+    unsigned int size () const throw () { return n; }
+    bool empty () const throw () { return n==0; }
+    const Vec& operator[] (unsigned int i) const throw () { return p[i]; }
+    Vec& operator[] (unsigned int i) throw () { return p[i]; }
+    /** wie std::vector::at; wirft out_of_range */
+    const Vec& at (unsigned int i) const throw (std::out_of_range) {
+      if (i>=n)
+        throw std::out_of_range ("Intersections::at");
+      return p[i];
+    }
+    const Vec* begin () const throw () { return p; }
+    const Vec* end () const throw () { return p+n; }
+
+    void push_back (const Vec& v) throw () { p[n++]=v; }
+    void erase (unsigned int i) throw () {
+      for (n--; i<n; i++)
+        p[i]=p[i+1];
+    }
+
+    operator std::vector<Vec> () const throw (std::bad_alloc) { return std::vector<Vec> (p, p+n); }
+
+  private:
+    Vec p[2];
+    unsigned int n;
+  };
+
   /* Objekte mit Frame2d multiplizieren (Bewegung) */
   Line operator* (const Frame2d&, const Line&) throw ();
   LineSegment operator* (const Frame2d&, const LineSegment&) throw ();
@@ -53,21 +85,30 @@ namespace geom {
   /** Schnittpunkt zweier Geraden; bei parallelen Geraden wird Ausnahme geworfen */
   Vec intersect (const Line&, const Line&) throw (std::invalid_argument);
   /** Schnittpunkte zwischen Geraden/Geradenstuecken */
-  std::vector<Vec> intersect (const LineSegment&, const Line&) throw (std::bad_alloc);
-  std::vector<Vec> intersect (const Line&, const LineSegment&) throw (std::bad_alloc);
-  std::vector<Vec> intersect (const LineSegment&, const LineSegment&) throw (std::bad_alloc);
+  Intersections intersect (const LineSegment&, const Line&) throw ();
+  Intersections intersect (const Line&, const LineSegment&) throw ();
+  Intersections intersect (const LineSegment&, const LineSegment&) throw ();
   /** Schnittpunkte zwischen Gerade und Kreislinie */
-  std::vector<Vec> intersect (const Line&, const Circle&) throw (std::bad_alloc);
-  inline std::vector<Vec> intersect (const Circle& c, const Line& l) throw (std::bad_alloc) { return intersect (l,c); }
+  Intersections intersect (const Line&, const Circle&) throw ();
+  inline Intersections intersect (const Circle& c, const Line& l) throw () { return intersect (l,c); }
   /** Schnittpunkte zweier Kreise; bei konzentrischen Kreisen wird Ausnahme geworfen */
-  std::vector<Vec> intersect (const Circle&, const Circle&) throw (std::bad_alloc);
+  Intersections intersect (const Circle&, const Circle&) throw ();
   /** Schnittpunkte zwischen Gerade und Kreisbogen */
-  std::vector<Vec> intersect (const Line&, const Arc&) throw (std::bad_alloc);
-  std::vector<Vec> intersect (const Arc&, const Line&) throw (std::bad_alloc);
-  std::vector<Vec> intersect (const LineSegment&, const Arc&) throw (std::bad_alloc);
-  std::vector<Vec> intersect (const Arc&, const LineSegment&) throw (std::bad_alloc);
+  Intersections intersect (const Line&, const Arc&) throw ();
+  Intersections intersect (const Arc&, const Line&) throw ();
+  Intersections intersect (const LineSegment&, const Arc&) throw ();
+  Intersections intersect (const Arc&, const LineSegment&) throw ();
   /** Tangentiale Punkte berechnen; wirft Ausnahme, falls Pount innerhalb des Kreises */
-  std::vector<Vec> tangent_point (const Circle&, const Vec&) throw (std::bad_alloc, std::invalid_argument);
+  Intersections tangent_point (const Circle&, const Vec&) throw (std::invalid_argument);
+
+  /** Ein Linienstueck gegen viele Punkte, deren Koordinaten als getrennte Felder
+      (px[i], py[i]) uebergeben werden, damit die Schleife vektorisiert wird.
+      Fuer jeden Punkt: tau[i] die Lage des naechsten Punktes auf dem Linienstueck
+      (0 bei p1, 1 bei p2), dist2[i] das Quadrat des Abstands zu ihm */
+  void closest_points (const LineSegment&, const double* px, const double* py, unsigned int n, double* tau, double* dist2) throw ();
+  /** Ein Linienstueck gegen viele Kreise (cx[i], cy[i], r[i]): liefert die Anzahl
+      der beruehrten oder geschnittenen Kreisscheiben, hit[i] fuer jeden (falls nicht NULL) */
+  unsigned int intersects (const LineSegment&, const double* cx, const double* cy, const double* r, unsigned int n, bool* hit) throw ();
 
 
   /** ein Bereich der zweidimensionalen Ebene */
@@ -83,8 +124,8 @@ namespace geom {
   class Line {
   protected:
     friend Vec intersect (const Line&, const Line&) throw (std::invalid_argument);
-    friend std::vector<Vec> intersect (const Line&, const Circle&) throw (std::bad_alloc);
-    friend std::vector<Vec> intersect (const Line&, const Arc&) throw (std::bad_alloc);
+    friend Intersections intersect (const Line&, const Circle&) throw ();
+    friend Intersections intersect (const Line&, const Arc&) throw ();
     friend Vec perpendicular_point (const Vec&, const Line&) throw ();
     friend Line operator* (const Frame2d&, const Line&) throw ();
 
@@ -127,9 +168,9 @@ namespace geom {
 
   /** Klasse LineSegment modelliert ein Linienstueck mit Anfangs- und Endpunkt */
   class LineSegment {
-    friend std::vector<Vec> intersect (const LineSegment&, const Arc&) throw (std::bad_alloc);
-    friend std::vector<Vec> intersect (const LineSegment&, const Line&) throw (std::bad_alloc);
-    friend std::vector<Vec> intersect (const LineSegment&, const LineSegment&) throw (std::bad_alloc);
+    friend Intersections intersect (const LineSegment&, const Arc&) throw ();
+    friend Intersections intersect (const LineSegment&, const Line&) throw ();
+    friend Intersections intersect (const LineSegment&, const LineSegment&) throw ();
     friend LineSegment operator* (const Frame2d&, const LineSegment&) throw ();
 
   public:
@@ -170,8 +211,8 @@ namespace geom {
   /** Klasse modelliert einen Kreisbogen */
   class Arc {
   private:
-    friend std::vector<Vec> intersect (const Line&, const Arc&) throw (std::bad_alloc);
-    friend std::vector<Vec> intersect (const LineSegment&, const Arc&) throw (std::bad_alloc);
+    friend Intersections intersect (const Line&, const Arc&) throw ();
+    friend Intersections intersect (const LineSegment&, const Arc&) throw ();
     friend Arc operator* (const Frame2d&, const Arc&) throw ();
 
     Vec center;
@@ -198,9 +239,9 @@ namespace geom {
   /** Klasse Circle modelliert einen Kreis im 2-dimensionalen */
   class Circle : public Area {
   private:
-    friend std::vector<Vec> intersect (const Line&, const Circle&) throw (std::bad_alloc);
-    friend std::vector<Vec> intersect (const Circle&, const Circle&) throw (std::bad_alloc);
-    friend std::vector<Vec> tangent_point (const Circle&, const Vec&) throw (std::bad_alloc, std::invalid_argument);
+    friend Intersections intersect (const Line&, const Circle&) throw ();
+    friend Intersections intersect (const Circle&, const Circle&) throw ();
+    friend Intersections tangent_point (const Circle&, const Vec&) throw (std::invalid_argument);
     friend Circle operator* (const Frame2d&, const Circle&) throw ();
 
   public:
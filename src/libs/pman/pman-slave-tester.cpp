@@ -71,25 +71,27 @@ int main(int argc, char* argv[])
 	}
 
     /* install signal handler */
-    sigset_t sigusrmask;
-    sigemptyset( &sigusrmask );
-	sigaddset( &sigusrmask , PMAN_ACTIVATE_SIG );
-
     struct sigaction sigact;
 	sigact.sa_flags = 0;
     sigemptyset(&sigact.sa_mask);
     void signalHandler(int sigid);
     sigact.sa_handler = signalHandler;
 
-	sigaction(PMAN_ACTIVATE_SIG, &sigact, NULL);
 	sigaction(SIGINT, &sigact, NULL);
     
     /* main loop */
     while (running)
 	{
-        /* wait for signal */
-	    pause();
-        fprintf(stdout, "%s: after pause: %d\n", pname, timer.elapsed());
+        /* wait for activation; 1 is a signal, check running */
+        if ((pmanstat = PMAN_wait(pname)) < 0)
+        {
+            fprintf(stderr, "PMAN slave : [%s]: PMAN_wait failed (return code %d)\n",
+                    pname, pmanstat);
+            exit(EXIT_FAILURE);
+        }
+        if (pmanstat != 0)
+            continue;
+        fprintf(stdout, "%s: after wait: %d\n", pname, timer.elapsed());
 
         /* do some work */
         for (int i = 0; i < 1000000; i++) { running = running+1-1; }
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA PMAN
+ *
+ * CAMBADA PMAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA PMAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * PMAN tick microbenchmark
+ *
+ * Registers N processes with assorted periods and phases and measures the
+ * cost of PMAN_tick against the old PMAN_tick: under the PMAN semaphore,
+ * a scan of the table testing (ticks - phase) % period on every slot and
+ * marking the due processes active. It skipped the processes not attached.
+ * The slots past nslots are not scanned, nor is the release timed, which
+ * favours the scan.
+ * The processes are either not attached (scheduling only) or all attached
+ * to this process (scheduling + release; nobody waits on them, so every
+ * activation also pays the liveness check of PMAN_release).
+ * The dense runs have mostly short periods, so many processes are due each
+ * tick; in the sparse runs the periods are long and few are.
+ *
+ * Usage: pman-tick-bench [ticks]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "pman.h"
+#include "sem_utils.h"
+
+#define BENCH_KEY	0x9f11		/* Shared memory and semaphore key */
+
+extern int pman_sem_id;
+
+static const int dense_periods[] = { 1, 2, 3, 5, 10, 33, 100, 1000 };
+static const int sparse_periods[] = { 100, 250, 500, 1000, 3000 };
+
+static int bench_qos(int pindex)
+{
+	(void)pindex;
+	return 0;
+}
+
+/* PMAN_tick before the timing wheel, without the release; returns the processes due */
+static int scan_tick(int ticks)
+{
+	int i, ndue=0;
+
+	sem_pwait(pman_sem_id);
+
+	for(i=0;i<p_table->nslots;i++)
+	{
+		if(p_table->proc[i].PROC_id != PMAN_NOPID)
+		{
+			if( ((ticks - p_table->proc[i].PROC_phase) % p_table->proc[i].PROC_period) == 0 )
+			{
+				if(p_table->proc[i].PROC_qosupdflag)
+				{
+					(*p_table->QoSupd)(i);
+					p_table->proc[i].PROC_qosupdflag=0;
+				}
+				p_table->proc[i].PROC_status = PROC_S_ACTIV;
+				ndue++;
+			}
+		}
+	}
+
+	sem_psignal(pman_sem_id);
+
+	return ndue;
+}
+
+static long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+static int bench(int nprocs, int attach, int sparse, int nticks)
+{
+	const int *periods = sparse ? sparse_periods : dense_periods;
+	int nperiods = sparse ? sizeof(sparse_periods)/sizeof(sparse_periods[0]) : sizeof(dense_periods)/sizeof(dense_periods[0]);
+	int i, t, stat, period, qos=0;
+	long long t0, t_tick, t_scan;
+	unsigned long long nact=0, nscan=0;
+	char pname[PNAME_LEN+1];
+
+	stat = PMAN_init2(BENCH_KEY, BENCH_KEY, (void *)bench_qos, sizeof(qos), PMAN_NEW);
+	if(stat != 0 && stat != -15) // -15: can't set the priority, not needed here
+	{
+		fprintf(stderr, "pman-tick-bench: PMAN_init failed (return code %d)\n", stat);
+		return -1;
+	}
+
+	for(i=0;i<nprocs;i++)
+	{
+		period = periods[i % nperiods];
+		sprintf(pname, "p%d", i);
+		if((stat = PMAN_procadd(pname, attach ? getpid() : PMAN_NOPID, period, i % period, 0, &qos, sizeof(qos))) != 0)
+		{
+			fprintf(stderr, "pman-tick-bench: PMAN_procadd failed (return code %d)\n", stat);
+			break;
+		}
+	}
+
+	/* Timing wheel */
+	t0 = now_ns();
+	for(t=0;t<nticks;t++)
+		PMAN_tick();
+	t_tick = now_ns() - t0;
+
+	for(i=0;i<p_table->nslots;i++)
+		nact += p_table->proc[i].PROC_nact;
+
+	/* Table scan (old PMAN_tick) */
+	t0 = now_ns();
+	for(t=0;t<nticks;t++)
+		nscan += scan_tick(t);
+	t_scan = now_ns() - t0;
+
+	printf("%6d processes, %s, %s: PMAN_tick %9.1f ns/tick, scan %8.1f ns/tick (%6.1f due/tick)\n",
+			nprocs, sparse ? "sparse" : "dense ", attach ? "attached  " : "unattached",
+			(double)t_tick/nticks, (double)t_scan/nticks, (double)nscan/nticks);
+
+	if(attach && nscan != nact)
+		fprintf(stderr, "pman-tick-bench: %llu activations, scan found %llu\n", nact, nscan);
+
+	/* PMAN_close sends SIGINT to the registered processes (this one) */
+	signal(SIGINT, SIG_IGN);
+	PMAN_close(PMAN_CLFREE);
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	int n, sparse, nticks = argc > 1 ? atoi(argv[1]) : 10000;
+
+	for(sparse=0;sparse<2;sparse++)
+		for(n=20;n<=2000;n*=10)
+			if(bench(n, 0, sparse, nticks) || bench(n, 1, sparse, nticks))
+				return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA PMAN
+ *
+ * CAMBADA PMAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA PMAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * pman-trace: statistics and trace of a running PMAN process table
+ *
+ * Attaches to the process table of the omni camera (the one the agent
+ * runs on), prints the response time statistics of every process and
+ * exports the trace kept in the table in the Chrome trace event format,
+ * then leaves the table as it was.
+ *
+ * The table is found as the agent finds it, from RTDB_NAMESPACE and AGENT;
+ * -n and -r select another namespace or robot.
+ *
+ * Usage: pman-trace [-n namespace] [-r robot] [-s] [trace.json]
+ *   -s  statistics only, no trace file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/shm.h>
+
+#include "pman.h"
+#include "pmandefs.h"
+#include "rtdbdefs.h"
+
+int main(int argc, char* argv[])
+{
+	/* Same defaults as DB_get_namespace and PMAN_init */
+	int ns = getenv("RTDB_NAMESPACE") ? atoi(getenv("RTDB_NAMESPACE")) : 0;
+	int robot = getenv("AGENT") ? atoi(getenv("AGENT")) : 0;
+	int opt, stat, statsOnly = 0;
+	char *fname = "pman-trace.json";
+	key_t key;
+
+	while((opt = getopt(argc, argv, "n:r:s")) != -1)
+	{
+		switch(opt)
+		{
+		case 'n': ns = atoi(optarg); break;
+		case 'r': robot = atoi(optarg); break;
+		case 's': statsOnly = 1; break;
+		default:
+			fprintf(stderr, "Usage: %s [-n namespace] [-r robot] [-s] [trace.json]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if(optind < argc)
+		fname = argv[optind];
+
+	/* Keys of PMAN_init for this robot; PMAN_ATTACH would create a missing table */
+	key = SHMEM_OCAM_PMAN_KEY + ns*RTDB_NAMESPACE_STRIDE + 2*robot;
+	if(shmget(key, 0, 0) == -1)
+	{
+		fprintf(stderr, "pman-trace: no process table at key 0x%x\n", key);
+		return EXIT_FAILURE;
+	}
+	if((stat = PMAN_init2(key, SEM_OCAM_PMAN_KEY - SHMEM_OCAM_PMAN_KEY + key, NULL, 0, PMAN_ATTACH)) != 0)
+	{
+		fprintf(stderr, "pman-trace: PMAN_init failed (return code %d)\n", stat);
+		return EXIT_FAILURE;
+	}
+
+	PMAN_print_stats();
+
+#ifdef PMAN_TRACE
+	if(!statsOnly)
+	{
+		stat = PMAN_trace_export(fname);
+		if(stat == 0)
+			printf("pman-trace: trace written to %s\n", fname);
+		else if(stat == -2)
+			printf("pman-trace: the trace is empty\n");
+		else
+			fprintf(stderr, "pman-trace: PMAN_trace_export failed (return code %d)\n", stat);
+	}
+#endif
+
+	PMAN_close(PMAN_CLLEAVE);
+
+	return stat == 0 || stat == -2 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
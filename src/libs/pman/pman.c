@@ -39,6 +39,9 @@
 #include <signal.h>
 #include <sched.h>
 
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
 #include <errno.h>
 
 #include <sem_utils.h>
@@ -66,6 +69,199 @@ int pamn_shmem_id_LUT[ MAX_MASTER_INSTANCE ];               // shared memory id
 PROC_TABLE_TYPE* pman_p_table_LUT[ MAX_MASTER_INSTANCE ];   // proc table address look up table
 
 
+/*
+ * Activation words
+ *
+ * Each process has an activation counter (PROC_futex) in the shared table.
+ * PMAN_release increments it and wakes the process with FUTEX_WAKE; the
+ * process sleeps in PMAN_wait with FUTEX_WAIT until the counter differs from
+ * the last value it consumed (PROC_futex_seen). The table lives in SysV
+ * shared memory, so the futexes are not process private.
+ */
+static int pman_futex_wait(int *addr, int val)
+{
+	return syscall(SYS_futex, addr, FUTEX_WAIT, val, NULL, NULL, 0);
+}
+
+static int pman_futex_wake(int *addr)
+{
+	return syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+
+/*
+ * Finds a process by name, without taking the table semaphore (names only
+ * change on PMAN_procadd/PMAN_procdel)
+ *
+ * Returns: index of the process, PMAN_NOINDEX if not found
+ */
+static int pman_find(char *p_name)
+{
+	static int last = PMAN_NOINDEX; // Clients look up their own name on every instance
+	int i;
+
+	if( last != PMAN_NOINDEX && last < p_table->nslots && strcmp(p_table->proc[last].PROC_name,p_name) == 0)
+		return last;
+
+	for(i=0;i<p_table->nslots;i++)
+		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
+			return (last = i);
+
+	return PMAN_NOINDEX;
+}
+
+
+/*
+ * Atomic bitmap operations
+ *
+ * Returns: whether bit i was set before
+ */
+static int pman_mask_set(unsigned long *mask, int i)
+{
+	return (__sync_fetch_and_or(&mask[PMAN_MASK_WORD(i)], PMAN_MASK_BIT(i)) & PMAN_MASK_BIT(i)) != 0;
+}
+
+static int pman_mask_clear(unsigned long *mask, int i)
+{
+	return (__sync_fetch_and_and(&mask[PMAN_MASK_WORD(i)], ~PMAN_MASK_BIT(i)) & PMAN_MASK_BIT(i)) != 0;
+}
+
+
+/*
+ * Initializes slot i of the process table (first use of the slot)
+ */
+static void pman_slot_init(int i)
+{
+	int j;
+	PROC_TYPE *proc = &p_table->proc[i];
+
+	memset(proc, 0, sizeof(PROC_TYPE));
+
+	proc->PROC_id = PMAN_NOPID;
+	for(j=0;j<PMAN_MAX_SUCC;j++)
+		proc->PROC_succ_index[j]=PMAN_NOINDEX;
+
+	proc->PROC_qosdata= sizeof(PROC_TABLE_TYPE)+i*p_table->qos_sz;
+
+	proc->PROC_wheel_prev = PMAN_NOINDEX;
+	proc->PROC_wheel_next = PMAN_NOINDEX;
+
+	proc->PROC_status = PROC_S_EMPTY;
+}
+
+
+/*
+ * Timing wheel
+ *
+ * Process i is in the list of slot PROC_next_tick % PMAN_WHEEL_SIZE, so a tick
+ * only visits the processes due on it (and those with periods longer than
+ * the wheel that fall on the same slot). Called with the table semaphore.
+ */
+static void pman_wheel_add(int i)
+{
+	PROC_TYPE *proc = &p_table->proc[i];
+	int slot = proc->PROC_next_tick % PMAN_WHEEL_SIZE;
+
+	proc->PROC_wheel_prev = PMAN_NOINDEX;
+	proc->PROC_wheel_next = p_table->wheel[slot];
+	if(p_table->wheel[slot] != PMAN_NOINDEX)
+		p_table->proc[p_table->wheel[slot]].PROC_wheel_prev = i;
+	p_table->wheel[slot] = i;
+}
+
+static void pman_wheel_del(int i)
+{
+	PROC_TYPE *proc = &p_table->proc[i];
+
+	if(proc->PROC_wheel_prev != PMAN_NOINDEX)
+		p_table->proc[proc->PROC_wheel_prev].PROC_wheel_next = proc->PROC_wheel_next;
+	else if(p_table->wheel[proc->PROC_next_tick % PMAN_WHEEL_SIZE] == i)
+		p_table->wheel[proc->PROC_next_tick % PMAN_WHEEL_SIZE] = proc->PROC_wheel_next;
+
+	if(proc->PROC_wheel_next != PMAN_NOINDEX)
+		p_table->proc[proc->PROC_wheel_next].PROC_wheel_prev = proc->PROC_wheel_prev;
+
+	proc->PROC_wheel_prev = PMAN_NOINDEX;
+	proc->PROC_wheel_next = PMAN_NOINDEX;
+}
+
+/*
+ * (Re)schedules process i on the first tick from now where
+ * (tick - phase) % period == 0. Processes without period are not scheduled.
+ */
+static void pman_wheel_schedule(int i)
+{
+	PROC_TYPE *proc = &p_table->proc[i];
+	int period = proc->PROC_period;
+
+	pman_wheel_del(i);
+	if(period <= 0)
+		return;
+
+	proc->PROC_next_tick = p_table->ticks + ((proc->PROC_phase - p_table->ticks) % period + period) % period;
+	pman_wheel_add(i);
+}
+
+
+/*
+ * Monotonic time, in us (trace and response times)
+ */
+static long long pman_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec*1000000LL + ts.tv_nsec/1000;
+}
+
+
+#ifdef PMAN_TRACE
+/*
+ * Records a trace event. The slot is reserved with an atomic op, so
+ * it may be called without the table semaphore.
+ */
+static void pman_trace_evt(int pindex, int etype, long long etime)
+{
+	int last, next, first;
+
+	do {
+		last = p_table->evt_lastindex;
+		next = (last+1) % PMAN_TRACE_SIZE;
+	} while( !__sync_bool_compare_and_swap(&p_table->evt_lastindex, last, next) );
+
+	p_table->evt_trace[last].pindex=pindex;
+	p_table->evt_trace[last].etype=etype;
+	p_table->evt_trace[last].etime=etime;
+
+	/* Buffer full, drop the oldest event */
+	first = p_table->evt_firstindex;
+	if(next == first)
+		__sync_bool_compare_and_swap(&p_table->evt_firstindex, first, (first+1) % PMAN_TRACE_SIZE);
+}
+
+/*
+ * Writes a process name as a JSON string, escaping quotes, backslashes
+ * and control characters
+ */
+static void pman_json_name(FILE *f, const char *name)
+{
+	int k;
+
+	fputc('"', f);
+	for(k=0;k<PNAME_LEN+1 && name[k];k++)
+	{
+		if(name[k] == '"' || name[k] == '\\')
+			fprintf(f, "\\%c", name[k]);
+		else if((unsigned char)name[k] < 0x20)
+			fprintf(f, "\\u%04x", (unsigned char)name[k]);
+		else
+			fputc(name[k], f);
+	}
+	fputc('"', f);
+}
+#endif
+
+
 /*
  * Initializes the process table
  *
@@ -93,10 +289,9 @@ int PMAN_init(key_t shmem_pman_key, key_t sem_pman_key, void * QoSfun, int QoSda
 
 int PMAN_init2(key_t shmem_pman_key, key_t sem_pman_key, void * QoSfun, int QoSdata_sz, int create_flags)
 {
-	int i,j,sstat;
+	int i,sstat;
 	union dsemun sem_union;
 	struct sched_param proc_sched;
-	struct timeval tv;
 
 	PMAN_DBG("\n [PMAN_init]: shmem_pman_key %x / sem_pman_key %x, QoSfun:%p, QoSdata_sz:%d, create_flags:%d",
 			shmem_pman_key, sem_pman_key, QoSfun, QoSdata_sz, create_flags);
@@ -128,44 +323,28 @@ int PMAN_init2(key_t shmem_pman_key, key_t sem_pman_key, void * QoSfun, int QoSd
 				(void*)p_table+sizeof(PROC_TABLE_TYPE),(void*)p_table+sizeof(PROC_TABLE_TYPE)+PROC_TABLE_SIZE*QoSdata_sz-1);
 
 
-		/* Init process table */
+		/* Init process table (the process slots are initialized on first use) */
 		p_table->nprocs = 0;
+		p_table->nslots = 0;
 		p_table->ticks = 0;
+		p_table->qos_sz = QoSdata_sz;
 		p_table->QoSupd = QoSfun;
 		p_table->DdlnExcpt = NULL;
 
-		for(i=0;i<PROC_TABLE_SIZE;i++)
+		for(i=0;i<(int)PMAN_MASK_WORDS;i++)
 		{
-			p_table->proc[i].PROC_name[0]=0;
-			p_table->proc[i].PROC_id = PMAN_NOPID;
-			p_table->proc[i].PROC_period = 0;
-			p_table->proc[i].PROC_phase = 0;
-			p_table->proc[i].PROC_deadline = 0;
-
-			for(j=0;j<PMAN_MAX_PRED;j++)
-				p_table->proc[i].PROC_pred_name[j][0]=0;
-			for(j=0;j<PMAN_MAX_SUCC;j++)
-				p_table->proc[i].PROC_succ_index[j]=PMAN_NOINDEX;
-			p_table->proc[i].PROC_pred_mask=0;
-			p_table->proc[i].PROC_pred_met=0;
-
-			p_table->proc[i].PROC_qosdata= sizeof(PROC_TABLE_TYPE)+i*QoSdata_sz;
-
-			p_table->proc[i].PROC_qosupdflag=0;
-
-			tv.tv_sec=tv.tv_usec =0;
-			p_table->proc[i].PROC_last_start = tv;
-			p_table->proc[i].PROC_last_finish = tv;
+			p_table->attach_mask[i] = 0;
+			p_table->pend_mask[i] = 0;
+			p_table->ready_mask[i] = 0;
+		}
 
-			p_table->proc[i].PROC_status = PROC_S_EMPTY;
-			p_table->proc[i].PROC_nact = 0;
-			p_table->proc[i].PROC_ndm = 0;
+		for(i=0;i<PMAN_WHEEL_SIZE;i++)
+			p_table->wheel[i] = PMAN_NOINDEX;
 
 #ifdef PMAN_TRACE
-			p_table->evt_firstindex = 0;
-			p_table->evt_lastindex = 0;
+		p_table->evt_firstindex = 0;
+		p_table->evt_lastindex = 0;
 #endif
-		}
 
 
 		/* Create and init semaphore */
@@ -259,7 +438,7 @@ int PMAN_close(int close_flags)
 		sem_pwait(pman_sem_id);
 
 		/* Kills every registered processes */
-		for(i=0;i<PROC_TABLE_SIZE;i++)
+		for(i=0;i<p_table->nslots;i++)
 			if(p_table->proc[i].PROC_id != PMAN_NOPID)
 			{
 				sstat=kill(p_table->proc[i].PROC_id, SIGINT);
@@ -342,7 +521,7 @@ int PMAN_procadd(char * p_name, int p_id,int p_period, int p_phase, int p_deadli
 	free_index = -1;
 	//unused: dup_flag = 0;
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 	{
 		if(p_table->proc[i].PROC_name[0] == 0 && free_index == -1)
 			free_index = i;
@@ -356,12 +535,17 @@ int PMAN_procadd(char * p_name, int p_id,int p_period, int p_phase, int p_deadli
 		}
 	}
 
-	if(free_index == -1) // Shouldn't happen !
+	if(free_index == -1) // Use a new slot
 	{
-		sem_psignal(pman_sem_id);
-		return -2;
+		if(p_table->nslots == PROC_TABLE_SIZE) // Shouldn't happen !
+		{
+			sem_psignal(pman_sem_id);
+			return -2;
+		}
+		free_index = (p_table->nslots)++;
 	}
 
+	pman_slot_init(free_index);
 
 	/* Valid proc id and free slot found; add process data*/
 	strcpy(p_table->proc[free_index].PROC_name,p_name);
@@ -377,8 +561,10 @@ int PMAN_procadd(char * p_name, int p_id,int p_period, int p_phase, int p_deadli
 	p_table->proc[free_index].PROC_qosupdflag=1;
 
 	p_table->proc[free_index].PROC_status = PROC_S_IDLE;
-	p_table->proc[free_index].PROC_nact = 0;
-	p_table->proc[free_index].PROC_ndm = 0;
+	pman_wheel_schedule(free_index);
+
+	if(p_id != PMAN_NOPID)
+		pman_mask_set(p_table->attach_mask, free_index);
 
 	(p_table->nprocs)++;
 
@@ -408,13 +594,18 @@ int PMAN_procdel(char *p_name)
 
 	sem_pwait(pman_sem_id);
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 
 		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
 		{
 			if(p_table->proc[i].PROC_id != PMAN_NOPID) /* If procees running, kill it */
 				kill(p_table->proc[i].PROC_id, SIGINT);
 
+			pman_mask_clear(p_table->attach_mask, i);
+			pman_mask_clear(p_table->pend_mask, i);
+			pman_mask_clear(p_table->ready_mask, i);
+			pman_wheel_del(i);
+
 			p_table->proc[i].PROC_name[0] = 0;
 			p_table->proc[i].PROC_id = PMAN_NOPID;
 
@@ -453,13 +644,17 @@ int PMAN_attach(char *p_name, pid_t p_id)
 
 	sem_pwait(pman_sem_id);
 
-	for (i=0; i<PROC_TABLE_SIZE; i++)
+	for (i=0; i<p_table->nslots; i++)
 	{
 		if (strcmp(p_table->proc[i].PROC_name, p_name) == 0)
 		{
 			p_table->proc[i].PROC_id = p_id;
 			p_table->proc[i].PROC_qosupdflag=1; // Update process QoS on next activation
 
+			/* Activations of a previous instance of the process are not for this one */
+			p_table->proc[i].PROC_futex_seen = p_table->proc[i].PROC_futex;
+			pman_mask_set(p_table->attach_mask, i);
+
 			sem_psignal(pman_sem_id);
 			return 0;
 		}
@@ -492,10 +687,14 @@ int PMAN_deattach(char *p_name)
 
 	sem_pwait(pman_sem_id);
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 
 		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
 		{
+			pman_mask_clear(p_table->attach_mask, i);
+			pman_mask_clear(p_table->pend_mask, i);
+			pman_mask_clear(p_table->ready_mask, i);
+
 			p_table->proc[i].PROC_id = PMAN_NOPID;
 
 			sem_psignal(pman_sem_id);
@@ -522,7 +721,7 @@ int PMAN_deattach(char *p_name)
  */
 int PMAN_prec_add(char *p_name_pred, char *p_name_succ)
 {
-	int i, pred_index, succ_index;
+	int i, pred_index, pred_slot, succ_index;
 
 	PMAN_DBG("\n PMAN_prec_define called (p_table:%p  p_name_pred:%s p_name_succ:%s)",p_table, p_name_pred, p_name_succ);
 
@@ -533,7 +732,7 @@ int PMAN_prec_add(char *p_name_pred, char *p_name_succ)
 
 	/* Look for sucessor position on PMAN table */
 	succ_index=PMAN_NOINDEX;
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 		if( strcmp(p_table->proc[i].PROC_name,p_name_succ) == 0) {
 			succ_index=i;
 			break;
@@ -545,7 +744,7 @@ int PMAN_prec_add(char *p_name_pred, char *p_name_succ)
 	}
 	/* Look for predecessor in PMAN table */
 	pred_index=PMAN_NOINDEX;
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 		if( strcmp(p_table->proc[i].PROC_name,p_name_pred) == 0) {
 			pred_index=i;
 			break;
@@ -557,36 +756,36 @@ int PMAN_prec_add(char *p_name_pred, char *p_name_succ)
 	}
 
 	/* Update pred_name and succ_index arrays */
-	for(i=0;i<PMAN_MAX_PRED;i++)
-		if(p_table->proc[succ_index].PROC_pred_name[i][0] == 0) {
-			strcpy(p_table->proc[succ_index].PROC_pred_name[i],p_name_pred);
+	for(pred_slot=0;pred_slot<PMAN_MAX_PRED;pred_slot++)
+		if(p_table->proc[succ_index].PROC_pred_name[pred_slot][0] == 0)
 			break;
-		}
 
-	if(i >= PMAN_MAX_PRED) { // Did not found an empty entry to add the predecessor name
+	if(pred_slot >= PMAN_MAX_PRED) { // Did not found an empty entry to add the predecessor name
 		sem_psignal(pman_sem_id);
 		return -4;
 	}
 
 	for(i=0;i<PMAN_MAX_SUCC;i++)
-		if(p_table->proc[pred_index].PROC_succ_index[i] == PMAN_NOINDEX) {
-			p_table->proc[pred_index].PROC_succ_index[i]=succ_index;
+		if(p_table->proc[pred_index].PROC_succ_index[i] == PMAN_NOINDEX)
 			break;
-		}
 
 	if(i >= PMAN_MAX_SUCC) { // Did not found an empty entry to add the successor index
 		sem_psignal(pman_sem_id);
 		return -4;
 	}
 
-	/* Update precedence mask of successor process ...  */
+	strcpy(p_table->proc[succ_index].PROC_pred_name[pred_slot],p_name_pred);
+	p_table->proc[pred_index].PROC_succ_index[i]=succ_index;
+	p_table->proc[pred_index].PROC_succ_slot[i]=pred_slot;
+
+	/* Update precedence mask of successor process (one bit per predecessor slot, independent of the table size) */
 	p_table->proc[succ_index].PROC_pred_met = 0;
-	p_table->proc[succ_index].PROC_pred_mask |= (1 << (pred_index));
+	p_table->proc[succ_index].PROC_pred_mask |= 1UL << pred_slot;
 
 
 	/* Done */
 	sem_psignal(pman_sem_id);
-	return -2;
+	return 0;
 }
 
 
@@ -616,7 +815,7 @@ int PMAN_QoSupd(char * p_name, void * QoSdata, int QoSdata_sz, char when_flag)
 
 	sem_pwait(pman_sem_id);
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 
 		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
 		{
@@ -675,7 +874,7 @@ int PMAN_msgupd(char * p_name, int p_period, int p_phase, int p_deadline, char w
 
 	sem_pwait(pman_sem_id);
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
 		{
 			if((which_flag & PMAN_UPD_PERIOD) && (p_period > 0))
@@ -687,6 +886,9 @@ int PMAN_msgupd(char * p_name, int p_period, int p_phase, int p_deadline, char w
 			if((which_flag & PMAN_UPD_DEADLINE) && (p_deadline > 0))
 				p_table->proc[i].PROC_deadline = p_deadline;
 
+			if(which_flag & (PMAN_UPD_PERIOD | PMAN_UPD_PHASE))
+				pman_wheel_schedule(i);
+
 			sem_psignal(pman_sem_id);
 			return 0;
 		}
@@ -710,55 +912,124 @@ int PMAN_msgupd(char * p_name, int p_period, int p_phase, int p_deadline, char w
  */
 int PMAN_epilogue(char *p_name)
 {
-	int i,j, succ_index, check_preced_flag=0;
+	int i,j, bin, succ_index, check_preced_flag=0;
+	long long now, rt;
+	PROC_TYPE *proc;
 
 	PMAN_DBG("\n PMAN_epilogue called (p_table:%p  p_name:%s)", p_table, p_name);
 
 	if(p_table == NULL)
 		return -1;
 
-	sem_pwait(pman_sem_id);
+	if((i = pman_find(p_name)) == PMAN_NOINDEX)
+		return -2; // Process not found
 
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	proc = &p_table->proc[i];
 
-		if( strcmp(p_table->proc[i].PROC_name,p_name) == 0)
-		{
-			/* Update process status and finish time */
-			p_table->proc[i].PROC_status = PROC_S_IDLE; //
-			gettimeofday(&p_table->proc[i].PROC_last_finish, NULL);
+	/* Update process status and finish time */
+	now = pman_now_us();
+	gettimeofday(&proc->PROC_last_finish, NULL);
+	proc->PROC_status = PROC_S_IDLE;
 
 #ifdef PMAN_TRACE
-			p_table->evt_trace[p_table->evt_lastindex].pindex=i;
-			p_table->evt_trace[p_table->evt_lastindex].etype='E';
-			p_table->evt_trace[p_table->evt_lastindex].etime=p_table->proc[i].PROC_last_finish;
-			p_table->evt_lastindex=(p_table->evt_lastindex+1) % PMAN_TRACE_SIZE;
-			if(p_table->evt_lastindex == p_table->evt_firstindex)
-				p_table->evt_firstindex+=1;
+	pman_trace_evt(i, PMAN_EVT_END, now);
 #endif
 
-			/* Check for successors */
-			for(j=0;j<PMAN_MAX_SUCC;j++)
-				if( (succ_index = p_table->proc[i].PROC_succ_index[j]) != PMAN_NOINDEX) // Dependent process found!
-				{
-					p_table->proc[succ_index].PROC_pred_met |=  (1 << i); // Mark precedence as met
-					check_preced_flag = 1; // Must check if successor process can be released
-				}
+	/* Response time of the instance (if it was released) */
+	if( pman_mask_clear(p_table->ready_mask, i) )
+	{
+		rt = now - proc->PROC_release_us;
+		if(rt < 0)
+			rt = 0;
 
-			break; // Done
-		}
+		proc->PROC_rt_last = rt;
+		if(proc->PROC_rt_last > proc->PROC_rt_max)
+			proc->PROC_rt_max = proc->PROC_rt_last;
+		proc->PROC_rt_sum += rt;
+		proc->PROC_nrt++;
 
+		for(bin=0; bin < PMAN_RTHIST_BINS-1 && (rt >> (bin+1)) != 0; bin++);
+		proc->PROC_rt_hist[bin]++;
 
-	/* Done */
-	sem_psignal(pman_sem_id);
+		/* Deadline (relative to the release, 0 if none) */
+		if( proc->PROC_deadline > 0 && rt > proc->PROC_deadline )
+		{
+			proc->PROC_ndm++;
+#ifdef PMAN_TRACE
+			pman_trace_evt(i, PMAN_EVT_DMISS, now);
+#endif
+		}
+	}
+
+	/* Check for successors */
+	for(j=0;j<PMAN_MAX_SUCC;j++)
+		if( (succ_index = p_table->proc[i].PROC_succ_index[j]) != PMAN_NOINDEX) // Dependent process found!
+		{
+			__sync_fetch_and_or(&p_table->proc[succ_index].PROC_pred_met, 1UL << proc->PROC_succ_slot[j]); // Mark precedence as met
+			check_preced_flag = 1; // Must check if successor process can be released
+		}
 
 	/* Check if successor processes can be released */
 	if(check_preced_flag)
 		PMAN_release();
 
-	if(i == PROC_TABLE_SIZE)
+	return 0;
+}
+
+
+/*
+ * Waits for the next activation of the process
+ *
+ * Input args: (global var) *p_table : pointer to the process table data structure
+ *             p_name                : process name (string)
+ *
+ * Returns:     0 : process activated
+ *              1 : interrupted by a signal (no activation)
+ *             -1 : invalid process table pointer (null)
+ *             -2 : process not found
+ */
+int PMAN_wait(char *p_name)
+{
+	int i, act;
+	long long now, lat;
+	PROC_TYPE *proc;
+
+	PMAN_DBG("\n PMAN_wait called (p_table:%p  p_name:%s)", p_table, p_name);
+
+	if(p_table == NULL)
+		return -1;
+
+	if((i = pman_find(p_name)) == PMAN_NOINDEX)
 		return -2; // Process not found
-	else
-		return 0;
+
+	proc = &p_table->proc[i];
+
+	/* Sleep while there are no new activations */
+	while( (act = *(volatile int *)&proc->PROC_futex) == proc->PROC_futex_seen )
+		if(pman_futex_wait(&proc->PROC_futex, act) == -1 && errno == EINTR)
+			return 1;
+
+	/* Activations missed while running count as one */
+	proc->PROC_futex_seen = act;
+
+	/* Wake-up latency: release instant to now */
+	__sync_synchronize();
+	now = pman_now_us();
+	lat = now - proc->PROC_release_us;
+	if(lat < 0)
+		lat = 0;
+
+#ifdef PMAN_TRACE
+	pman_trace_evt(i, PMAN_EVT_START, now);
+#endif
+
+	proc->PROC_wlat_last = lat;
+	if(proc->PROC_wlat_last > proc->PROC_wlat_max)
+		proc->PROC_wlat_max = proc->PROC_wlat_last;
+	proc->PROC_wlat_sum += lat;
+	proc->PROC_nwake++;
+
+	return 0;
 }
 
 
@@ -790,10 +1061,10 @@ int PMAN_query(PROC_TYPE *pdata, int reset_flag)
 	if(p_table == NULL)
 		return -1;
 
-	if(pti >= PROC_TABLE_SIZE)
+	if(pti >= p_table->nslots)
 		return 1;
 
-	for(i=pti;i<PROC_TABLE_SIZE;i++)
+	for(i=pti;i<p_table->nslots;i++)
 		if( p_table->proc[i].PROC_name[0] != 0)
 		{
 			//printf("(found at %d)",i);
@@ -825,12 +1096,12 @@ int PMAN_print(void)
 	if(p_table == NULL)
 		return -1;
 
-	printf("\n         name    ID    Per   Ph     Ddln  *QoSdta    QoSflg Stat  #Act #Dmiss  Start       Finish");
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	printf("\n         name    ID    Per   Ph     Ddln  *QoSdta    QoSflg Stat  #Act #Dmiss  Start       Finish       Wake(us) last  avg   max");
+	for(i=0;i<p_table->nslots;i++)
 
 		if( p_table->proc[i].PROC_name[0] != 0)
 		{
-			printf("\n [%d] : %5s %5d  %5d %5d %9d %9p %5d %4x %5u %5u %5ld:%5ld %5ld:%5ld",i,\
+			printf("\n [%d] : %5s %5d  %5d %5d %9d %9p %5d %4x %5u %5u %5ld:%5ld %5ld:%5ld %14u %5u %5u",i,\
 					p_table->proc[i].PROC_name,\
 					p_table->proc[i].PROC_id,\
 					p_table->proc[i].PROC_period,\
@@ -844,7 +1115,10 @@ int PMAN_print(void)
 					p_table->proc[i].PROC_last_start.tv_sec,\
 					p_table->proc[i].PROC_last_start.tv_usec,\
 					p_table->proc[i].PROC_last_finish.tv_sec,\
-					p_table->proc[i].PROC_last_finish.tv_usec);
+					p_table->proc[i].PROC_last_finish.tv_usec,\
+					p_table->proc[i].PROC_wlat_last,\
+					p_table->proc[i].PROC_nwake ? (unsigned int)(p_table->proc[i].PROC_wlat_sum / p_table->proc[i].PROC_nwake) : 0,\
+					p_table->proc[i].PROC_wlat_max);
 		}
 		else
 			printf("\n [%d] : Free slot",i);
@@ -855,6 +1129,60 @@ int PMAN_print(void)
 }
 
 
+/*
+ * Prints the response times, deadline misses and overruns of the processes
+ * 
+ * Input args: (global var) *p_table : pointer to the process table data structure
+ *              
+ * Returns:     0 : success
+ *             -1 : invalid process table pointer (null) 
+ */
+int PMAN_print_stats(void)
+{
+	int i,j;
+	PROC_TYPE *proc;
+
+	PMAN_DBG("\n PMAN_print_stats called (ptable: %p)",p_table);
+
+	if(p_table == NULL)
+		return -1;
+
+	printf("\n         name     Ddln  #Act #Dmiss #Ovr   RT(us) last   avg   max  Wake(us) avg   max");
+	for(i=0;i<p_table->nslots;i++)
+	{
+		proc = &p_table->proc[i];
+		if(proc->PROC_name[0] == 0)
+			continue;
+
+		printf("\n [%d] : %5s %9d %5u %6u %4u %13u %5u %5u %11u %5u",i,\
+				proc->PROC_name,\
+				proc->PROC_deadline,\
+				proc->PROC_nact,\
+				proc->PROC_ndm,\
+				proc->PROC_novr,\
+				proc->PROC_rt_last,\
+				proc->PROC_nrt ? (unsigned int)(proc->PROC_rt_sum / proc->PROC_nrt) : 0,\
+				proc->PROC_rt_max,\
+				proc->PROC_nwake ? (unsigned int)(proc->PROC_wlat_sum / proc->PROC_nwake) : 0,\
+				proc->PROC_wlat_max);
+
+		/* Response time histogram (only the used bins) */
+		printf("\n        RT histogram (us):");
+		for(j=0;j<PMAN_RTHIST_BINS;j++)
+			if(proc->PROC_rt_hist[j])
+			{
+				if(j < PMAN_RTHIST_BINS-1)
+					printf(" [%u,%u[:%u", j ? 1U << j : 0, 1U << (j+1), proc->PROC_rt_hist[j]);
+				else
+					printf(" [%u,...[:%u", 1U << j, proc->PROC_rt_hist[j]);
+			}
+	}
+
+	printf("\n");
+
+	return 0;
+}
+
 #ifdef PMAN_TRACE
 /*
  * Saves the current trace data 
@@ -889,14 +1217,13 @@ int PMAN_trace_save(void)
 
 		}
 		else {
-			fprintf(flog,"\n    PName , PInd,EVT,      Instant\n");
+			fprintf(flog,"\n    PName , PInd,EVT,   Instant (us)\n");
 			for(i=p_table->evt_firstindex;i != p_table->evt_lastindex;i=(i+1) % PMAN_TRACE_SIZE) {
-				fprintf(flog,"%10s,%5d, %c ,%5ld,%5ld\n",			\
+				fprintf(flog,"%10s,%5d, %c ,%lld\n",			\
 						p_table->proc[p_table->evt_trace[i].pindex].PROC_name,	\
 						p_table->evt_trace[i].pindex,				\
 						p_table->evt_trace[i].etype,				\
-						p_table->evt_trace[i].etime.tv_sec,
-						p_table->evt_trace[i].etime.tv_usec);
+						p_table->evt_trace[i].etime);
 			}
 
 			fclose(flog);
@@ -915,6 +1242,106 @@ int PMAN_trace_save(void)
 	return retval;
 
 }
+
+
+/*
+ * Exports the trace in the Chrome trace event format (JSON)
+ * 
+ * Input args: (global var) *p_table : pointer to the process table data structure
+ *             fname                 : name of the file to write
+ *              
+ * Returns:     0 : success
+ *             -1 : invalid process table pointer (null) 
+ *             -2 : no trace data to save
+ *             -3 : can't create the file
+ */
+int PMAN_trace_export(char *fname)
+{
+	int i, p, first=1;
+	long long t0, ts, start[PROC_TABLE_SIZE];
+	FILE *fjson;
+	PROC_TRACE_DATA *evt;
+
+	PMAN_DBG("\n PMAN_trace_export called (ptable: %p)",p_table);
+
+	if(p_table == NULL)
+		return -1;
+
+	if(p_table->evt_firstindex == p_table->evt_lastindex)
+		return -2;
+
+	if( !(fjson=fopen(fname,"w")) ) {
+		printf("[PMAN_trace_export] Can't create trace file (%s)",fname);
+		return -3;
+	}
+
+	sem_pwait(pman_sem_id);
+
+	/* One thread per process */
+	fprintf(fjson,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	for(p=0;p<p_table->nslots;p++)
+	{
+		start[p] = -1;
+		if(p_table->proc[p].PROC_name[0] == 0)
+			continue;
+
+		fprintf(fjson,"%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":",
+				first ? "" : ",", p);
+		pman_json_name(fjson, p_table->proc[p].PROC_name);
+		fprintf(fjson,"}}");
+		first = 0;
+	}
+
+	/* Times relative to the first event */
+	t0 = p_table->evt_trace[p_table->evt_firstindex].etime;
+
+	for(i=p_table->evt_firstindex;i != p_table->evt_lastindex;i=(i+1) % PMAN_TRACE_SIZE)
+	{
+		evt = &p_table->evt_trace[i];
+		p = evt->pindex;
+		ts = evt->etime - t0;
+
+		if(p < 0 || p >= p_table->nslots)
+			continue;
+
+		switch(evt->etype)
+		{
+		case PMAN_EVT_START:
+			start[p] = ts;
+			break;
+
+		case PMAN_EVT_END:
+			/* Slice from start to end of the instance; an end without start is skipped */
+			if(start[p] >= 0)
+			{
+				fprintf(fjson,"%s\n{\"name\":", first ? "" : ",");
+				pman_json_name(fjson, p_table->proc[p].PROC_name);
+				fprintf(fjson,",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}", p, start[p], ts - start[p]);
+				first = 0;
+			}
+			start[p] = -1;
+			break;
+
+		case PMAN_EVT_RELEASE:
+		case PMAN_EVT_DMISS:
+		case PMAN_EVT_OVERRUN:
+			fprintf(fjson,"%s\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":%d,\"ts\":%lld}",
+					first ? "" : ",",
+					evt->etype == PMAN_EVT_RELEASE ? "release" : (evt->etype == PMAN_EVT_DMISS ? "deadline miss" : "overrun"),
+					p, ts);
+			first = 0;
+			break;
+		}
+	}
+
+	fprintf(fjson,"\n]}\n");
+
+	/* Done */
+	sem_psignal(pman_sem_id);
+	fclose(fjson);
+
+	return 0;
+}
 #endif
 
 
@@ -936,7 +1363,7 @@ int PMAN_print_prec(void)
 		return -1;
 
 	printf("\n [index] : name  {   process name 1,2,...,n    } { suc ind 1,2,...,n }    pred_mask   pred_met Status");
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	for(i=0;i<p_table->nslots;i++)
 		if( p_table->proc[i].PROC_name[0] != 0) {
 			printf("\n [%5d] : %5s {",i, p_table->proc[i].PROC_name);
 
@@ -986,7 +1413,8 @@ int PMAN_print_prec(void)
  */
 int PMAN_tick(void)
 {
-	int i, check_release_flag=0;
+	int i, next, activated=0;
+	PROC_TYPE *proc;
 
 	PMAN_DBG("\n PMAN_tick called (ptable: %p ). Activated processes:",p_table);
 
@@ -995,27 +1423,33 @@ int PMAN_tick(void)
 
 	sem_pwait(pman_sem_id);
 
-	/* Scans the process table and activates processes*/
-	for(i=0;i<PROC_TABLE_SIZE;i++)
+	/* Activates the processes due on this tick */
+	for(i=p_table->wheel[p_table->ticks % PMAN_WHEEL_SIZE]; i != PMAN_NOINDEX; i=next)
 	{
-		if(p_table->proc[i].PROC_id != PMAN_NOPID)
-		{ /* Filled PT slot: check if process ready */
-			if( ( (p_table->ticks - p_table->proc[i].PROC_phase) % p_table->proc[i].PROC_period) == 0)
-			{
-				if(p_table->proc[i].PROC_qosupdflag) // Check for pending QoS update requests with PMAN_ONNEXTACT flag
-				{
-					(*p_table->QoSupd)(i); // Update process's QoS
-					p_table->proc[i].PROC_qosupdflag=0; // Reset QoS update flag
-					PMAN_DBG("(QoS update on process %s)", p_table->proc[i].PROC_name);
-
-					//printf("**(QoS update on process %s)**", p_table->proc[i].PROC_name);
-				}
-
-				//printf("[PMAN_tick] process %s ACTIV");
-				p_table->proc[i].PROC_status = PROC_S_ACTIV;
-				check_release_flag = 1; // Signals that processes have become ready
-			}
+		proc = &p_table->proc[i];
+		next = proc->PROC_wheel_next;
+
+		if(proc->PROC_next_tick != p_table->ticks) // Due on a later turn of the wheel
+			continue;
+
+		/* Schedule the next activation */
+		pman_wheel_del(i);
+		proc->PROC_next_tick += proc->PROC_period;
+		pman_wheel_add(i);
+
+		if(proc->PROC_id == PMAN_NOPID) // Not attached
+			continue;
+
+		if(proc->PROC_qosupdflag) // Check for pending QoS update requests with PMAN_ONNEXTACT flag
+		{
+			(*p_table->QoSupd)(i); // Update process's QoS
+			proc->PROC_qosupdflag=0; // Reset QoS update flag
+			PMAN_DBG("(QoS update on process %s)", proc->PROC_name);
 		}
+
+		proc->PROC_status = PROC_S_ACTIV;
+		pman_mask_set(p_table->pend_mask, i);
+		activated = 1; // Signals that processes have become ready
 	}
 
 	/* Increment tick counter */
@@ -1025,7 +1459,7 @@ int PMAN_tick(void)
 	sem_psignal(pman_sem_id);
 
 	/* Release processes that became ready */
-	if(check_release_flag)
+	if(activated)
 		PMAN_release();
 
 	return 0;
@@ -1034,69 +1468,110 @@ int PMAN_tick(void)
 
 
 /*
- * Process release: Checks for process activations and precedences and sends activation signals when appropriate
- *               
+ * Releases process i if it is pending and its precedences are met
  *
- * Input args: (global var) *p_table : pointer to the process table data structure
+ * The activation is claimed from pend_mask with an atomic op, so the master
+ * (PMAN_tick) and the clients (PMAN_epilogue) may release at the same time
+ * without the table semaphore and each activation is delivered once.
  *
- * Returns:     0 : success
- *             -1 : invalid process table pointer (null) 
+ * Returns:     0 : not released
+ *              1 : released
+ *              2 : released, but the process no longer exists
  */
-int PMAN_release(void)
+static int pman_release_proc(int i)
 {
-	int i;
+	unsigned long mask;
+	PROC_TYPE *proc = &p_table->proc[i];
 
-	int p_killed_index[PROC_TABLE_SIZE];
-	int npid_killed=0;
+	for(;;)
+	{
+		/* Claim the activation; someone else may have released it already */
+		if( !pman_mask_clear(p_table->pend_mask, i) )
+			return 0;
 
-	PMAN_DBG("\n PMAN_release called (ptable: %p ). Activated processes:",p_table);
+		mask = proc->PROC_pred_mask;
+		if( (proc->PROC_pred_met & mask) == mask )
+			break;
 
-	if(p_table == NULL)
-		return -1;
+		/* Precedences not met: leave it pending. The last predecessor may have
+		 * finished while the bit was taken (and its release skipped it), so check again */
+		proc->PROC_status = PROC_S_PEND;
+		pman_mask_set(p_table->pend_mask, i);
+		PMAN_DBG(" pending [%s (%d)] ",proc->PROC_name, proc->PROC_id);
 
-	sem_pwait(pman_sem_id);
+		if( (proc->PROC_pred_met & mask) != mask )
+			return 0;
+	}
 
-	/* Scans the process table and activates processes*/
-	for(i=0;i<PROC_TABLE_SIZE;i++)
-		if( p_table->proc[i].PROC_id != PMAN_NOPID)
-			if( (p_table->proc[i].PROC_status == PROC_S_ACTIV) || (p_table->proc[i].PROC_status == PROC_S_PEND) ) {
-				/* Activate process if activated and precedences met */
-				if( p_table->proc[i].PROC_pred_mask == p_table->proc[i].PROC_pred_met) {
-					p_table->proc[i].PROC_pred_met = 0; // Reset precedence bitmap
+	__sync_fetch_and_and(&proc->PROC_pred_met, ~mask); // Reset precedence bitmap
 
-					if(kill(p_table->proc[i].PROC_id, PMAN_ACTIVATE_SIG))
-						if(errno == ESRCH) /* Process no longer exists */
-							p_killed_index[npid_killed++] = i;
+	proc->PROC_release_us = pman_now_us();
+	gettimeofday(&proc->PROC_last_start, NULL);
 
-					gettimeofday(&p_table->proc[i].PROC_last_start, NULL);
+#ifdef PMAN_TRACE
+	pman_trace_evt(i, PMAN_EVT_RELEASE, proc->PROC_release_us);
+#endif
+
+	proc->PROC_status = PROC_S_READY;
+	proc->PROC_nact++;
 
+	/* Previous instance not finished yet */
+	if( pman_mask_set(p_table->ready_mask, i) )
+	{
+		proc->PROC_novr++;
 #ifdef PMAN_TRACE
-					p_table->evt_trace[p_table->evt_lastindex].pindex=i;
-					p_table->evt_trace[p_table->evt_lastindex].etype='R';
-					p_table->evt_trace[p_table->evt_lastindex].etime=p_table->proc[i].PROC_last_start;
-					p_table->evt_lastindex=(p_table->evt_lastindex+1) % PMAN_TRACE_SIZE;
-					if(p_table->evt_lastindex == p_table->evt_firstindex)
-						p_table->evt_firstindex+=1;
+		pman_trace_evt(i, PMAN_EVT_OVERRUN, proc->PROC_release_us);
 #endif
+	}
 
-					p_table->proc[i].PROC_status = PROC_S_READY;
-					p_table->proc[i].PROC_nact++;
+	/* Wake up the process */
+	__sync_fetch_and_add(&proc->PROC_futex, 1);
+	pman_futex_wake(&proc->PROC_futex);
 
-					PMAN_DBG(" activated [%s (%d)] ",p_table->proc[i].PROC_name, p_table->proc[i].PROC_id);
-				}
-				else {
-					p_table->proc[i].PROC_status = PROC_S_PEND;
-					PMAN_DBG(" pending [%s (%d)] ",p_table->proc[i].PROC_name, p_table->proc[i].PROC_id);
-				}
+	PMAN_DBG(" activated [%s (%d)] ",proc->PROC_name, proc->PROC_id);
 
-			}
+	/* The previous activation was not consumed either: check if the process is still there */
+	if( proc->PROC_futex - proc->PROC_futex_seen > 1 )
+		if( proc->PROC_id != PMAN_NOPID && kill(proc->PROC_id, 0) && errno == ESRCH )
+			return 2;
+
+	return 1;
+}
 
-	/* Exit mutex */
-	sem_psignal(pman_sem_id);
 
-	/* Detach killed processes */
-	for(i=0;i<npid_killed;i++)
-		PMAN_deattach(p_table->proc[p_killed_index[i]].PROC_name);
+/*
+ * Process release: Checks for process activations and precedences and wakes up processes when appropriate
+ *               
+ *
+ * Input args: (global var) *p_table : pointer to the process table data structure
+ *
+ * Returns:     0 : success
+ *             -1 : invalid process table pointer (null) 
+ */
+int PMAN_release(void)
+{
+	int i, w, nwords;
+	unsigned long pending;
+
+	PMAN_DBG("\n PMAN_release called (ptable: %p ). Activated processes:",p_table);
+
+	if(p_table == NULL)
+		return -1;
+
+	/* Activates the pending processes, a bitmap word at a time */
+	nwords = (p_table->nslots + PMAN_MASK_BITS - 1) / PMAN_MASK_BITS;
+	for(w=0;w<nwords;w++)
+	{
+		pending = p_table->pend_mask[w] & p_table->attach_mask[w];
+		while(pending)
+		{
+			i = w*PMAN_MASK_BITS + __builtin_ctzl(pending);
+			pending &= pending - 1;
+
+			if(pman_release_proc(i) == 2) /* Process no longer exists: detach it */
+				PMAN_deattach(p_table->proc[i].PROC_name);
+		}
+	}
 
 	return 0;
 }
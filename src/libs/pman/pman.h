@@ -30,8 +30,6 @@
  * Defines
  *
  */
-#define PMAN_ACTIVATE_SIG	SIGCONT		// Signal used to activate processes
-
 #define PMAN_ATTACH			1			// PMAN_init option: attach to an existing process table
 #define PMAN_NEW			0			// PMAN_init option: initialize a new process table
 
@@ -47,7 +45,8 @@
 #define PMAN_UPD_DEADLINE	0x10		// Update deadline
 
 
-#define PROC_TABLE_SIZE		  20		// Maximum number of processes managed
+#define PROC_TABLE_SIZE		4096		// Maximum number of processes managed (the shared memory
+										//    is only touched up to the highest slot used)
 #define PNAME_LEN		  32		// Maximum length of the process name string
 
 #define PMAN_NOPID		   0		// Process id undefined 
@@ -56,6 +55,14 @@
 #define PMAN_MAX_PRED              5    // Maximum number of predecessors that a process may have             
 #define PMAN_MAX_SUCC              5    // Maximum number of successors that a process may have             
 
+#define PMAN_WHEEL_SIZE          256    // Slots (ticks) of the timing wheel; longer periods take some turns
+
+/* Process bitmaps (bit i is proc[i]) */
+#define PMAN_MASK_BITS       (8*sizeof(unsigned long))
+#define PMAN_MASK_WORDS      ((PROC_TABLE_SIZE+PMAN_MASK_BITS-1)/PMAN_MASK_BITS)
+#define PMAN_MASK_WORD(i)    ((i)/PMAN_MASK_BITS)
+#define PMAN_MASK_BIT(i)     (1UL << ((i)%PMAN_MASK_BITS))
+
 #define PMAN_NOPENDACT             0    // No pending activation on process
 #define PMAN_PENDACT               1    // Pending activation on process
 
@@ -69,7 +76,17 @@
 
 /* TRACE parameters */
 #define PMAN_TRACE
-#define PMAN_TRACE_SIZE     10000     // Number of events to record during trace ( events/sec = FPS*SUM(1/Period_i)*2 )
+#define PMAN_TRACE_SIZE     10000     // Number of events to record during trace ( events/sec = FPS*SUM(1/Period_i)*3 )
+
+/* Trace event types */
+#define PMAN_EVT_RELEASE   'R'    // Process released (PMAN_release)
+#define PMAN_EVT_START     'S'    // Process woke up (PMAN_wait)
+#define PMAN_EVT_END       'E'    // Process finished (PMAN_epilogue)
+#define PMAN_EVT_DMISS     'D'    // Process finished after its deadline
+#define PMAN_EVT_OVERRUN   'O'    // Process released before finishing the previous instance
+
+/* Response time histogram: bin k counts response times in [2^k,2^(k+1)[ us, the last bin everything above */
+#define PMAN_RTHIST_BINS    16
 
 
 /*
@@ -79,8 +96,8 @@
 #ifdef PMAN_TRACE
 typedef struct {
   int pindex;            // Process index within PMAN table
-  int etype;             // Event type {[R]elease;[E]pilog}
-  struct timeval etime;  // Event time 
+  int etype;             // Event type (PMAN_EVT_*)
+  long long etime;       // Event time (CLOCK_MONOTONIC, in us)
 } PROC_TRACE_DATA;
 #endif
 
@@ -96,8 +113,14 @@ typedef struct {
   /* precedence constraints */
   char   PROC_pred_name[PMAN_MAX_PRED][PNAME_LEN+1]; // Array with the names of the predecessor processes
   int    PROC_succ_index[PMAN_MAX_SUCC];             // Array with the PMAN table indexes of the successors of the process
-  unsigned long   PROC_pred_mask;                    // bitmap with the index of all the predecessor processes set  
-  unsigned long   PROC_pred_met;                     // bitmap with the index of predecessor processes that had an instance
+  int    PROC_succ_slot[PMAN_MAX_SUCC];              // Position of the process in the PROC_pred_name array of each successor
+  unsigned long   PROC_pred_mask;                    // bitmap with the PROC_pred_name positions in use
+  unsigned long   PROC_pred_met;                     // bitmap with the PROC_pred_name positions of predecessors that had an instance
+
+  /* Activation scheduling (timing wheel) */
+  int    PROC_next_tick;          // Tick of the next activation
+  int    PROC_wheel_prev;         // Previous process in the same wheel slot
+  int    PROC_wheel_next;         // Next process in the same wheel slot
 
   /* QoS data */
   int    PROC_qosdata;            // Offset to data structure containing QoS specific data
@@ -111,20 +134,46 @@ typedef struct {
   
   unsigned int PROC_nact;      // Number of activations
   unsigned int PROC_ndm;       // Number of deadline misses
+  unsigned int PROC_novr;      // Number of overruns (released again before the epilogue)
+
+  /* Response time (release to epilogue, in us) */
+  long long PROC_release_us;       // Release instant (CLOCK_MONOTONIC, in us)
+  unsigned int PROC_nrt;           // Number of response times measured
+  unsigned int PROC_rt_last;       // Last response time
+  unsigned int PROC_rt_max;        // Worst response time
+  unsigned long long PROC_rt_sum;  // Sum of response times (for the average)
+  unsigned int PROC_rt_hist[PMAN_RTHIST_BINS]; // Response time histogram
+
+  /* Activation (futex word, shared between processes) */
+  int PROC_futex;              // Activation counter, incremented on every release
+  int PROC_futex_seen;         // Last activation consumed by the process (PMAN_wait)
+
+  /* Wake-up latency (release to return of PMAN_wait, in us) */
+  unsigned int PROC_nwake;         // Number of wake-ups measured
+  unsigned int PROC_wlat_last;     // Latency of the last wake-up
+  unsigned int PROC_wlat_max;      // Worst latency
+  unsigned long long PROC_wlat_sum; // Sum of latencies (for the average)
  
 } PROC_TYPE;
 
 typedef struct {
   int nprocs;        // Number of active processes registered
+  int nslots;        // Number of slots of proc[] in use (highest used + 1); the others are not initialized
   int ticks;         // System "tick" counter
+  int qos_sz;        // Size of the QoS data of each process
   int (*QoSupd)();   // QoS update function hook
   int (*DdlnExcpt)();// Deadline exception handling hook
-  PROC_TYPE proc[PROC_TABLE_SIZE];
+  /* Process state bitmaps, updated with atomic ops only */
+  unsigned long attach_mask[PMAN_MASK_WORDS]; // Processes with a PID attached
+  unsigned long pend_mask[PMAN_MASK_WORDS];   // Processes activated and not yet released (waiting for precedences)
+  unsigned long ready_mask[PMAN_MASK_WORDS];  // Processes released and not yet finished (epilogue)
+  int wheel[PMAN_WHEEL_SIZE]; // First process of each slot of the timing wheel (next tick % PMAN_WHEEL_SIZE)
 #ifdef PMAN_TRACE
   int evt_lastindex;  // Index of last event recorded
   int evt_firstindex; // Index of first event recorded
   PROC_TRACE_DATA evt_trace[PMAN_TRACE_SIZE]; // Trace data
 #endif
+  PROC_TYPE proc[PROC_TABLE_SIZE]; // Must be the last field: pages past nslots are never touched
 } PROC_TABLE_TYPE;
 
 
@@ -222,7 +271,9 @@ int PMAN_close(int close_flags);
 /**
  * \brief Process release
  *
- * Checks for process activations and precedences and sends activation signals when appropriate
+ * Checks for process activations and precedences and wakes up the processes
+ * whose precedences are met. Does not take the table semaphore: the pending
+ * processes are taken from the pend_mask bitmap with atomic operations.
  *               
  * \return  0 : success
  *         -1 : invalid process table pointer (null) 
@@ -346,6 +397,23 @@ int PMAN_msgupd(char * p_name, int p_period, int p_phase, int p_deadline, char w
 int PMAN_epilogue(char *p_name);
 
 
+/**
+ * \brief Waits for the next activation of the process
+ *
+ * Blocks on the process activation word (futex) until the process is
+ * released by PMAN_release, and records the wake-up latency.
+ * To be called by the "client" processes in place of waiting for a signal.
+ *
+ * \param p_name                : process name (string)
+ *
+ * \return  0 : process activated
+ *          1 : interrupted by a signal (no activation)
+ *         -1 : invalid process table pointer (null)
+ *         -2 : process not found
+ */
+int PMAN_wait(char *p_name);
+
+
 /**
  * \brief Queries the contents of the process table 
  * 
@@ -378,8 +446,33 @@ int PMAN_print(void);
 int PMAN_print_prec(void);
 
 
+/**
+ * \brief Prints the response times, deadline misses and overruns of the processes
+ *
+ * \return  0 : success
+ *         -1 : invalid process table pointer (null) 
+ */
+int PMAN_print_stats(void);
+
+
 #ifdef PMAN_TRACE
   int PMAN_trace_save(void);
+
+/**
+ * \brief Exports the trace in the Chrome trace event format (JSON)
+ *
+ * Each process is a thread of the trace, with a slice from start to end of
+ * every instance and instant events on release, deadline miss and overrun.
+ * The file can be opened in chrome://tracing or Perfetto. The trace is kept.
+ *
+ * \param fname : name of the file to write
+ *
+ * \return  0 : success
+ *         -1 : invalid process table pointer (null) 
+ *         -2 : no trace data to save
+ *         -3 : can't create the file
+ */
+  int PMAN_trace_export(char *fname);
 #endif
 
 
@@ -387,7 +480,7 @@ int PMAN_print_prec(void);
  * \brief "System tick". 
  *
  * Should be called every basic time unit (whatever it is).
- *  Checks for process activations; sends activation signals
+ *  Activates the processes due on this tick (timing wheel); wakes up the activated processes
  *  Checks for missed deadlines (TODO)
  *
  * \return  0 : success
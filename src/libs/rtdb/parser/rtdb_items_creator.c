@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA RTDB
+ *
+ * CAMBADA RTDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA RTDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "rtdb_items_creator.h"
+
+/*
+Function to get the index of an item in the Global items list
+  from its number, -1 if it is not in the list
+*/
+static int itemIndex(rtdb_ItemList it, unsigned num)
+{
+	unsigned i;
+
+	for (i= 0; i < it.numIt; i++)
+	{
+		if (it.items[i].num == num)
+			return i;
+	}
+	return -1;
+}
+
+/*
+Function to write the configuration lines of an agent for one
+  list of items of its schema (type 's' or 'l')
+*/
+static void printConfItems(FILE *f, rtdb_Agent ag, rtdb_ItemList items, char type)
+{
+	unsigned l;
+
+	for (l= 0; l < items.numIt; l++)
+	{
+		fprintf(f, "\t{ %s, %s, Item<%s>::size, Item<%s>::period, '%c' },\n",
+			ag.id, items.items[l].id, items.items[l].id, items.items[l].id, type);
+	}
+}
+
+/*
+Function to write the rtdb_items.h file using the Global items list,
+  the Global agents list and the Global assignments list.
+The sizes of the datatypes are left to the compiler (sizeof), so the
+  file replaces the rtdb.ini file and the compilation of a program
+  for each datatype that was needed to write it
+*/
+int printItemsFile(rtdb_ItemList it, rtdb_AgentList ag, rtdb_AssignmentList as)
+{
+	unsigned i, j, k, l;
+	int n;
+	FILE *f;
+	char* command;
+	unsigned *sharedMask, *localMask;
+
+	//Open the file rtdb_items.h for reading to check if it exists
+	f= fopen(RTDB_ITEMS_H, "r");
+	if (f != NULL)
+	{
+		//If it exists close it and ask the user permission to overwrite it
+		fclose(f);
+		char op = '\0';
+		while ((op != 'y') && (op != 'n'))
+		{
+			printf("\nO ficheiro \e[33m%s\e[0m ja existe!\nDeseja substitui-lo? (y/n): ", RTDB_ITEMS_H);
+			assert(scanf("%c", &op) == 1);
+			//Clean stdin
+			purge();
+		}
+		if (op == 'n')
+		{
+			return 1;
+		}
+	}
+
+	//Remove the rtdb_items.h file in case it exists, if we have permission from the user
+	command= malloc((2 + strlen(RM_COMMAND)+strlen(RTDB_ITEMS_H)) * sizeof(char));
+	sprintf(command, "%s %s", RM_COMMAND, RTDB_ITEMS_H);
+	assert(system(command) != -1);
+	free(command);
+
+	//Agents where each item is shared or local, one bit per agent number
+	sharedMask= calloc(it.numIt, sizeof(unsigned));
+	localMask= calloc(it.numIt, sizeof(unsigned));
+	for (j= 0; j < as.numAs; j++)
+	{
+		for (k= 0; k < as.asList[j].agentList.numAg; k++)
+		{
+			for (l= 0; l < as.asList[j].schema->sharedItems.numIt; l++)
+			{
+				if ((n= itemIndex(it, as.asList[j].schema->sharedItems.items[l].num)) >= 0)
+					sharedMask[n] |= 1u << as.asList[j].agentList.agents[k].num;
+			}
+			for (l= 0; l < as.asList[j].schema->localItems.numIt; l++)
+			{
+				if ((n= itemIndex(it, as.asList[j].schema->localItems.items[l].num)) >= 0)
+					localMask[n] |= 1u << as.asList[j].agentList.agents[k].num;
+			}
+		}
+	}
+
+	//If for some reason we can't create the file, abort
+	if ((f= fopen(RTDB_ITEMS_H, "w")) == NULL)
+	{
+		free(sharedMask); free(localMask);
+		return 2;
+	}
+
+	//Write generic information to the file
+	fprintf(f, "/* AUTOGEN FILE : rtdb_items.h */\n\n");
+	fprintf(f, "#ifndef _CAMBADA_RTDB_ITEMS_\n#define _CAMBADA_RTDB_ITEMS_\n\n");
+	fprintf(f, "#include \"rtdb_typed.h\"\n\n");
+	fprintf(f, "/* datatypes section */\n\n");
+
+	//Include once the headerfile of each item used by an agent
+	for (i= 0; i < it.numIt; i++)
+	{
+		if ((sharedMask[i] | localMask[i]) == 0)
+			continue;
+		for (j= 0; j < i; j++)
+		{
+			if (((sharedMask[j] | localMask[j]) != 0) && (strcmp(it.items[j].headerfile, it.items[i].headerfile) == 0))
+				break;
+		}
+		if (j == i)
+			fprintf(f, "#include \"%s\"\n", it.items[i].headerfile);
+	}
+	fprintf(f, "\n#include \"common.h\"\n\n");
+	fprintf(f, "#ifdef RTDB_ITEMS_WIRE\n#include \"wire.h\"\n#endif\n\n");
+
+	fprintf(f, "namespace rtdb {\n\n");
+	fprintf(f, "using namespace cambada;\n\n");
+
+	//Write generic comment
+	fprintf(f, "/* items section */\n\n");
+
+	//Run through the item list and write the items used by an agent, the others can not be accessed
+	for (i= 0; i < it.numIt; i++)
+	{
+		if ((sharedMask[i] | localMask[i]) == 0)
+			continue;
+		fprintf(f, "template<> struct Item<%s>\n{\n", it.items[i].id);
+		fprintf(f, "\ttypedef %s type;\n", it.items[i].datatype);
+		fprintf(f, "\tRTDB_CONST int id = %s;\n", it.items[i].id);
+		fprintf(f, "\tRTDB_CONST int size = sizeof(%s);\n", it.items[i].datatype);
+		fprintf(f, "\tRTDB_CONST int period = %u;\n", it.items[i].period);
+		fprintf(f, "\tRTDB_CONST unsigned shared = 0x%x;\n", sharedMask[i]);
+		fprintf(f, "\tRTDB_CONST unsigned local = 0x%x;\n", localMask[i]);
+		fprintf(f, "};\n\n");
+	}
+
+	//Write the configuration of each agent, in the order of the rtdb.ini file
+	fprintf(f, "/* configuration section */\n\n");
+	fprintf(f, "#ifdef RTDB_ITEMS_CONF\n\n");
+	fprintf(f, "static const RTDBconf_item conf[] = {\n");
+	for (i= 0; i < ag.numAg; i++)
+	{
+		for (j= 0; j < as.numAs; j++)
+		{
+			for (k= 0; k < as.asList[j].agentList.numAg; k++)
+			{
+				//If the current agent is in the current assignment list
+				if (strcmp(as.asList[j].agentList.agents[k].id, ag.agents[i].id) == 0)
+				{
+					printConfItems(f, ag.agents[i], as.asList[j].schema->sharedItems, 's');
+					printConfItems(f, ag.agents[i], as.asList[j].schema->localItems, 'l');
+				}
+			}
+		}
+	}
+	fprintf(f, "};\n\n");
+	fprintf(f, "#endif\n\n");
+
+	//Write the packer and the unpacker of each shared item, used by comm
+	fprintf(f, "/* wire section */\n\n");
+	fprintf(f, "#ifdef RTDB_ITEMS_WIRE\n\n");
+	fprintf(f, "static const RTDBwire_item wire[] = {\n");
+	for (i= 0; i < it.numIt; i++)
+	{
+		if (sharedMask[i] == 0)
+			continue;
+		fprintf(f, "\t{ %s, Item<%s>::size, &Wire<Item<%s>::type>::pack, &Wire<Item<%s>::type>::unpack },\n",
+			it.items[i].id, it.items[i].id, it.items[i].id, it.items[i].id);
+	}
+	fprintf(f, "};\n\n");
+	fprintf(f, "#endif\n\n");
+
+	fprintf(f, "}\n\n");
+
+	//Write generic information to the file
+	fprintf(f, "#endif\n\n");
+	fprintf(f, "/* EOF : rtdb_items.h */\n");
+
+	//Close the rtdb_items.h file
+	fclose(f);
+	free(sharedMask); free(localMask);
+
+	//Return 0, meaning all went smoothly
+	return 0;
+}
+
+/* EOF: rtdb_items_creator.c */
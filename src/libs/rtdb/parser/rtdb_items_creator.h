@@ -20,27 +20,18 @@
  * along with this package.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef _RTDB_INI_CREATOR_H_
-#define _RTDB_USER_CREATOR_H_
+#ifndef _RTDB_ITEMS_CREATOR_H_
+#define _RTDB_ITEMS_CREATOR_H_
 
 #include "rtdb_structs.h"
 #include "rtdb_configuration.h"
 
-/* 
-Function to write, compile and execute a rtdb_sizeof_tmp.c file
-   that has included the headerfile where the datatype is defined
-   and write a rtdb_size.tmp with the size of the datatype.
-After that, the rtdb_size.tmp file is opened, the size of the
-   datatype is read and returned 
-*/
-int getSizeof(char*, char*);
-
 /*
-Function to read the Global list of agents and the Global list
-   of assignments and automatically generate a rtdb.ini file
+Function to write the rtdb_items.h file using the Global items list,
+  the Global agents list and the Global assignments list
 */
-int printIniFile (rtdb_AgentList, rtdb_AssignmentList);
+int printItemsFile(rtdb_ItemList, rtdb_AgentList, rtdb_AssignmentList);
 
 #endif
 
-/* EOF: rtdb_ini_creator.h */
+/* EOF: rtdb_items_creator.h */
@@ -35,7 +35,7 @@
 #include "rtdb_structs.h"
 #include "rtdb_functions.h"
 #include "rtdb_user_creator.h"
-#include "rtdb_ini_creator.h"
+#include "rtdb_items_creator.h"
 #define YYSTYPE char*
 #define YYERROR_VERBOSE 1
 
@@ -255,8 +255,8 @@ int main(int argc, char *argv[])
 
         }
 
-        //Vars to store return values of printUserFile() and printIniFile()
-        int userFileStatus, iniFileStatus; 
+        //Vars to store return values of printUserFile() and printItemsFile()
+        int userFileStatus, itemsFileStatus; 
 
         printf("\nA criar o ficheiro \e[32mrtdb_user.h\e[0m\n");
 
@@ -284,30 +284,30 @@ int main(int argc, char *argv[])
         //Check if there are assignments defined
         if (assignList.numAs == 0)
         {
-                abortOnError("Não é possível escrever o ficheiro \e[32mrtdb.ini\e[0m!\nNão foi definido nenhum \e[33mAssignment\e[0m no ficheiro de configuração!");
+                abortOnError("Não é possível escrever o ficheiro \e[32mrtdb_items.h\e[0m!\nNão foi definido nenhum \e[33mAssignment\e[0m no ficheiro de configuração!");
         }
 
-        printf("\nA criar o ficheiro \e[32mrtdb.ini\e[0m\n");
+        printf("\nA criar o ficheiro \e[32mrtdb_items.h\e[0m\n");
 
-        //Call printIniFile() to generate the rtdb.ini file
-        iniFileStatus= printIniFile(agList, assignList);
+        //Call printItemsFile() to generate the rtdb_items.h file
+        itemsFileStatus= printItemsFile(itList, agList, assignList);
 
-        //Check return value of printIniFile() and output according message
-        switch (iniFileStatus)
+        //Check return value of printItemsFile() and output according message
+        switch (itemsFileStatus)
         {
                 case 0: {
-                        printf("\nFicheiro \e[32mrtdb.ini\e[0m criado com sucesso!\n");
+                        printf("\nFicheiro \e[32mrtdb_items.h\e[0m criado com sucesso!\n");
                         break;
                         }
                 case 1: {
-                        printf("\nCriação do ficheiro \e[32mrtdb.ini\e[0m cancelada pelo utilizador.\n");
+                        printf("\nCriação do ficheiro \e[32mrtdb_items.h\e[0m cancelada pelo utilizador.\n");
                         break;
                         }
                 case 2: {
-                        printf("\n\e[33mERRO\e[0m a criar o ficheiro \e[32mrtdb.ini\e[0m. Não foi possível abrir o ficheiro para escrita.\n");
+                        printf("\n\e[33mERRO\e[0m a criar o ficheiro \e[32mrtdb_items.h\e[0m. Não foi possível abrir o ficheiro para escrita.\n");
                         break;
                         }
-                default: printf("\n\e[33mERRO\e[0m inesperado a criar o ficheiro \e[32mrtdb.ini\e[0m!\n");
+                default: printf("\n\e[33mERRO\e[0m inesperado a criar o ficheiro \e[32mrtdb_items.h\e[0m!\n");
         }
 
         //Free the dynamically allocated vars
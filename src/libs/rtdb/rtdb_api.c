@@ -29,9 +29,14 @@
 #include <sys/shm.h>
 #include <time.h>
 #include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 
 #include "rtdbdefs.h"
+#include "rtdb_api.h"
 
 
 //#define DEBUG
@@ -57,6 +62,7 @@ typedef struct
 	int period;						// refresh period for broadcast
 	int offset;						// offset para o campo de dados da 'variavel'
 	int read_bank;					// variavel mais actual
+	unsigned int version;			// writes * 2, odd while a write is in progress
 	struct timeval timestamp[2];	// relogio da maquina local
 } TRec;
 
@@ -69,7 +75,11 @@ typedef struct
 	int n_local_recs;					// numero de 'variaveis' local
 	int shared_mem_size[MAX_AGENTS];	// tamanho das areas shared
 	int local_mem_size;					// tamanho da area local
+	int shared_view;					// teammates areas mapped from the team region
 	int rec_lut[MAX_AGENTS][MAX_RECS];	// lookuptable
+	unsigned int change_seq;			// writes in this memory, futex word of DB_wait_change
+	unsigned int change_agent[MAX_AGENTS];	// writes per agent area
+	int change_waiters;					// processes blocked in DB_wait_change
 } RTDBdef;
 
 
@@ -91,10 +101,20 @@ void *p_shared_mem[MAX_AGENTS*2][MAX_AGENTS*2];	// array de ponteiros para as ar
 int local_shmid[MAX_AGENTS*2];				// identificador da area local
 void *p_local_mem[MAX_AGENTS*2];				// ponteiro para a area local
 
+int team_shmid[MAX_AGENTS*2];					// identificador da regiao de equipa (shared view)
+void *p_team_mem[MAX_AGENTS*2];				// ponteiro para a regiao de equipa (shared view)
+
 int __agent = -1;
 
-// CONFIG_FILE is still the default configuration file
+// shared view is only used by the simulator, see DB_set_shared_view
+static int rtdbSharedView = 0;
+
+// namespace of the shared memory keys, -1 until known (see DB_get_namespace)
+static int rtdbNamespace = -1;
+
+// CONFIG_FILE is only read if it is set, see read_configuration
 static char* rtdbConfigFile = (char*)CONFIG_FILE;
+static int rtdbConfigFileSet = 0;
 
 /**
  *  Change rtdb configuration file.
@@ -118,11 +138,147 @@ void DB_set_config_file(const char* cf){
   
   //
   canFree = 1;
+  rtdbConfigFileSet = 1;
   return;
 }
 
+/**
+ *  Select the memory layout of the RTDBs created from now on.
+ *
+ *  With the shared view, the area of each agent seen by its teammates is
+ *  one slot of a single team region, instead of a private copy per
+ *  teammate. Publishing a record (DB_put_team) is then one write, read by
+ *  the whole team. The layout is stored in the definitions area, so the
+ *  processes attaching later follow the one chosen by its creator.
+ *
+ *  @param enable 1 to use the shared view, 0 for a copy per agent
+*/
+void DB_set_shared_view(int enable){
+  rtdbSharedView = ( enable != 0 );
+}
+
+/**
+ *  Select the namespace of the RTDBs created or attached from now on.
+ *
+ *  Every shared memory key is moved by ns * RTDB_NAMESPACE_STRIDE, so
+ *  that several simulations, each with its own agents, can run on the
+ *  same machine without sharing their RTDBs.
+ *
+ *  @param ns namespace number, 0 is the default namespace
+*/
+void DB_set_namespace(int ns){
+  rtdbNamespace = ( ns < 0 ) ? 0 : ns;
+}
+
+/**
+ *  Get the namespace of the RTDBs.
+ *
+ *  Unless DB_set_namespace was called, the namespace is taken from the
+ *  RTDB_NAMESPACE environment variable, or 0 if it is not set.
+ *
+ *  @return namespace number
+*/
+int DB_get_namespace(void){
+  char *environment;
+
+  if ( rtdbNamespace < 0 )
+  {
+    if ( (environment = getenv("RTDB_NAMESPACE")) != NULL )
+      DB_set_namespace( atoi(environment) );
+    else
+      rtdbNamespace = 0;
+  }
+
+  return rtdbNamespace;
+}
+
+//	*************************
+//	init_shared_recs: init the records headers of an agent shared area
+//
+//	input:
+//		void *p_mem = shared area
+//		RTDBconf_agents *conf = configuration of the agent
+//
+static void init_shared_recs(void *p_mem, RTDBconf_agents *conf)
+{
+	int j;
+	int offset;
+	TRec *p_rec;
+
+	offset = conf->n_shared_recs * sizeof(TRec);
+	for (j = 0; j < conf->n_shared_recs; j++)
+	{
+		p_rec = (TRec*)((char*)(p_mem) + j * sizeof(TRec));
+		p_rec->id = conf->shared[j].id;
+		p_rec->size = conf->shared[j].size;
+		p_rec->offset = offset;
+		p_rec->period = conf->shared[j].period;
+		p_rec->read_bank = 0;
+		p_rec->version = 0;
+		offset = offset + (p_rec->size * 2) - sizeof(TRec);
+
+		PDEBUG("shared: %d, size: %d, offset:%d, period: %d, lut: %d", p_rec->id, p_rec->size, p_rec->offset, p_rec->period, j);
+	}
+}
+
+
+
+//	*************************
+//	load_items: configuration compiled from rtdb.conf
+//
+//	input:
+//		const RTDBconf_item *items = linhas do rtdb.ini
+//		int n_items = numero de linhas
+//		int n_agents = numero de agentes
+//	output:
+//		number of agents
+//		-1 = error
+//
+static int load_items(RTDBconf_agents *conf, const RTDBconf_item *items, int n_items, int n_agents)
+{
+	int i;
+	RTDBconf_agents *p_conf;
+	RTDBconf_var *p_var;
+
+	if (n_agents > MAX_AGENTS)
+	{
+		PERR("Increase MAX_AGENTS");
+		return -1;
+	}
+
+	for (i = 0; i < n_agents; i++)
+	{
+		conf[i].n_shared_recs = 0;
+		conf[i].n_local_recs = 0;
+	}
+
+	for (i = 0; i < n_items; i++)
+	{
+		p_conf = &conf[items[i].agent];
+		if ((p_conf->n_shared_recs + p_conf->n_local_recs) >= MAX_RECS)
+		{
+			PERR("Increase MAX_RECS");
+			return -1;
+		}
+
+		if (items[i].type == 's')
+			p_var = &p_conf->shared[p_conf->n_shared_recs++];
+		else
+			p_var = &p_conf->local[p_conf->n_local_recs++];
+		p_var->id = items[i].id;
+		p_var->size = items[i].size;
+		p_var->period = items[i].period;
+	}
+
+	return n_agents;
+}
+
+
+
 //	*************************
 //	read_configuration: CONFIG_FILE parser
+//		note: the compiled configuration is used instead, unless
+//		a file was set with DB_set_config_file
 //
 //	output:
 //		number of agents
@@ -137,6 +293,11 @@ int read_configuration(RTDBconf_agents *conf)
 	int agent;
 	int id, size, period;
 	char type;
+	const RTDBconf_item *items;
+	int n_items, n_items_agents;
+
+	if (!rtdbConfigFileSet && ((n_items = DB_get_items(&items, &n_items_agents)) > 0))
+		return load_items(conf, items, n_items, n_items_agents);
 
 	if ((f_def = fopen(rtdbConfigFile, "r")) == NULL)
 	{
@@ -232,6 +393,10 @@ void _DB_free (int _agent)
 	// shared memory
 	for (i = 0; i < p_def[_agent]->n_agents; i++)
 	{
+		// teammates areas are part of the team region
+		if (p_def[_agent]->shared_view && (i != _agent % MAX_AGENTS))
+			continue;
+
 		shmdt(p_shared_mem[_agent][i]);
 		
 		// if it is the last
@@ -242,6 +407,19 @@ void _DB_free (int _agent)
 			shmctl(shared_shmid[_agent][i], IPC_RMID, NULL);
 	}
 
+	// team region
+	if (p_def[_agent]->shared_view && (p_team_mem[_agent] != NULL))
+	{
+		shmdt(p_team_mem[_agent]);
+		p_team_mem[_agent] = NULL;
+
+		// if it is the last
+		if (shmctl(team_shmid[_agent], IPC_STAT, &shmem_status) == -1)
+			PERRNO("shmctl");
+		if (shmem_status.shm_nattch == 0)
+			shmctl(team_shmid[_agent], IPC_RMID, NULL);
+	}
+
 	// local memory
 	shmdt(p_local_mem[_agent]);
 	// if it is the last
@@ -305,12 +483,18 @@ int DB_initialization (int _agent, int _second_rtdb)
 	int i, j;
 	int key;
 	int offset;
+	int self;
+	int conf_loaded = 0;
+	int team_size;
 	TRec *p_rec;
 	struct shmid_ds shmem_status;
 	RTDBconf_agents rtdb_conf[MAX_AGENTS];
 
+	// index of the agent inside its team
+	self = _agent % MAX_AGENTS;
+
 	// malloc
-  key = SHMEM_KEY + (_agent * MAX_AGENTS * 4);
+  key = SHMEM_KEY + DB_get_namespace() * RTDB_NAMESPACE_STRIDE + (_agent * MAX_AGENTS * 4);
   
 	def_shmid[_agent] = shmget(key, sizeof(RTDBdef), 0644 | IPC_CREAT);
 	if (def_shmid[_agent] == -1)
@@ -343,8 +527,10 @@ int DB_initialization (int _agent, int _second_rtdb)
 			_DB_free(_agent);
 			return -1;
 		}
+		conf_loaded = 1;
 
 		p_def[_agent]->self_agent = _agent;
+		p_def[_agent]->shared_view = rtdbSharedView;
 	
 		for (i = 0; i < p_def[_agent]->n_agents; i++)
 		{
@@ -365,9 +551,71 @@ int DB_initialization (int _agent, int _second_rtdb)
 		}
 	}
 
+	// alloc of the team region, one slot per agent
+	p_team_mem[_agent] = NULL;
+	if (p_def[_agent]->shared_view)
+	{
+		team_size = 0;
+		for (i = 0; i < p_def[_agent]->n_agents; i++)
+			team_size += p_def[_agent]->shared_mem_size[i];
+
+		team_shmid[_agent] = shmget(SHMEM_TEAM_KEY + DB_get_namespace() * RTDB_NAMESPACE_STRIDE + _agent / MAX_AGENTS, team_size, 0644 | IPC_CREAT);
+		if (team_shmid[_agent] == -1)
+		{
+			PERRNO("shmget4");
+			_DB_free(_agent);
+			return -1;
+		}
+		p_team_mem[_agent] = shmat(team_shmid[_agent], (void *)0, 0);
+		if (p_team_mem[_agent] == (char *)(-1))
+		{
+			PERRNO("shmat");
+			p_team_mem[_agent] = NULL;
+			_DB_free(_agent);
+			return -1;
+		}
+
+		// if it is the first, slots initialization
+		if (shmctl(team_shmid[_agent], IPC_STAT, &shmem_status) == -1)
+		{
+			PERRNO("shmctl");
+			_DB_free(_agent);
+			return -1;
+		}
+		if (shmem_status.shm_nattch == 1)
+		{
+			if (!conf_loaded && (read_configuration(rtdb_conf) < 1))
+			{
+				PERR("read_configuration");
+				_DB_free(_agent);
+				return -1;
+			}
+			conf_loaded = 1;
+
+			offset = 0;
+			for (i = 0; i < p_def[_agent]->n_agents; i++)
+			{
+				init_shared_recs((char*)(p_team_mem[_agent]) + offset, &rtdb_conf[i]);
+				offset += p_def[_agent]->shared_mem_size[i];
+			}
+		}
+	}
+
 	// alloc of shared memory
+	offset = 0;
 	for (i = 0; i < p_def[_agent]->n_agents; i++)
 	{
+		if (p_def[_agent]->shared_view && (i != self))
+		{
+			// teammates are read from the team region
+			shared_shmid[_agent][i] = team_shmid[_agent];
+			p_shared_mem[_agent][i] = (char*)(p_team_mem[_agent]) + offset;
+			offset += p_def[_agent]->shared_mem_size[i];
+			key ++;
+			continue;
+		}
+		offset += p_def[_agent]->shared_mem_size[i];
+
 		shared_shmid[_agent][i] = shmget(key, p_def[_agent]->shared_mem_size[i], 0644 | IPC_CREAT);
 		if (shared_shmid[_agent][i] == -1)
 		{
@@ -423,20 +671,12 @@ int DB_initialization (int _agent, int _second_rtdb)
 
 	for (i = 0; i < p_def[_agent]->n_agents; i++)
 	{
-		offset = p_def[_agent]->n_shared_recs[i] * sizeof(TRec);
+		// the team region slots are initialized by its creator
+		if (!p_def[_agent]->shared_view || (i == self))
+			init_shared_recs(p_shared_mem[_agent][i], &rtdb_conf[i]);
+
 		for (j = 0; j < p_def[_agent]->n_shared_recs[i]; j++)
-		{
-			p_rec = (TRec*)((char*)(p_shared_mem[_agent][i]) + j * sizeof(TRec));
-			p_rec->id = rtdb_conf[i].shared[j].id;
-			p_rec->size = rtdb_conf[i].shared[j].size;
-			p_rec->offset = offset;
-			p_rec->period = rtdb_conf[i].shared[j].period;
-			p_rec->read_bank = 0;
-			p_def[_agent]->rec_lut[i][p_rec->id] = j;
-			offset = offset + (p_rec->size * 2) - sizeof(TRec);
-
-			PDEBUG("agent: %d, shared: %d, size: %d, offset:%d, period: %d, lut: %d", i, p_rec->id, p_rec->size, p_rec->offset, p_rec->period, j);
-		}
+			p_def[_agent]->rec_lut[i][rtdb_conf[i].shared[j].id] = j;
 	}
 	
 	offset = p_def[_agent]->n_local_recs * sizeof(TRec);
@@ -448,6 +688,7 @@ int DB_initialization (int _agent, int _second_rtdb)
 		p_rec->offset = offset;
 		p_rec->period = rtdb_conf[p_def[_agent]->self_agent].local[j].period;
 		p_rec->read_bank = 0;
+		p_rec->version = 0;
 		p_def[_agent]->rec_lut[p_def[_agent]->self_agent][p_rec->id] = MAX_RECS + j;
 		offset = offset + (p_rec->size * 2) - sizeof(TRec);
 		
@@ -561,6 +802,10 @@ int DB_put_in (int _agent, int _to_agent, int _id, void *_value, int life)
 
 	write_bank = (p_rec->read_bank + 1) % 2;
 
+	// odd version: write in progress
+	p_rec->version ++;
+	__sync_synchronize();
+
 	p_data = (void*)((char*)(p_rec) + p_rec->offset + write_bank * p_rec->size);
 	memcpy(p_data, _value, p_rec->size);
 
@@ -570,6 +815,15 @@ int DB_put_in (int _agent, int _to_agent, int _id, void *_value, int life)
 
 	p_rec->read_bank = write_bank;
 
+	__sync_synchronize();
+	p_rec->version ++;
+
+	// wake the readers blocked in DB_wait_change, the syscall only when there is one
+	__sync_fetch_and_add(&p_def[_agent]->change_agent[_to_agent], 1);
+	__sync_fetch_and_add(&p_def[_agent]->change_seq, 1);
+	if (p_def[_agent]->change_waiters > 0)
+		syscall(SYS_futex, &p_def[_agent]->change_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+
 	PDEBUG("agent: %d, id: %d, lut: %d, size: %d, write_bank: %d, previous life: %umsec", _to_agent, p_rec->id, lut, p_rec->size, p_rec->read_bank, life);
 	
 	return p_rec->size;
@@ -651,6 +905,9 @@ int DB_get_from (int _agent, int _from_agent, int _id, void *_value)
 	TRec *p_rec;
 	void *p_data;
 	struct timeval time;
+	struct timeval timestamp;
+	unsigned int version;
+	int read_bank;
 	int life;
 
 	if (_from_agent == SELF)
@@ -669,18 +926,296 @@ int DB_get_from (int _agent, int _from_agent, int _id, void *_value)
 	
 	p_data = (void *)((char *)(p_rec) + p_rec->offset);
 
-	memcpy(_value, (char *)p_data + (p_rec->read_bank * p_rec->size), p_rec->size);
+	// the writer uses the other bank, so the copy is only torn if a
+	// second write started meanwhile; retry in that case
+	do
+	{
+		version = p_rec->version;
+		__sync_synchronize();
+
+		read_bank = p_rec->read_bank;
+		memcpy(_value, (char *)p_data + (read_bank * p_rec->size), p_rec->size);
+		timestamp = p_rec->timestamp[read_bank];
+
+		__sync_synchronize();
+	} while ((p_rec->version - (version & ~1u)) > 2);
 
 	gettimeofday(&time, NULL);
-	life = (int)(((time.tv_sec - (p_rec->timestamp[p_rec->read_bank]).tv_sec) * 1E3) + ((time.tv_usec - (p_rec->timestamp[p_rec->read_bank]).tv_usec) / 1E3));
+	life = (int)(((time.tv_sec - timestamp.tv_sec) * 1E3) + ((time.tv_usec - timestamp.tv_usec) / 1E3));
 
-	PDEBUG("agent: %d, from_agent: %d, id: %d, read_bank: %d, life: %umsec", _agent, _from_agent, p_rec->id, p_rec->read_bank, life);
+	PDEBUG("agent: %d, from_agent: %d, id: %d, read_bank: %d, life: %umsec", _agent, _from_agent, p_rec->id, read_bank, life);
 
 	return (life);
 }
 
 
 
+//	*************************
+//	DB_get_range_from: read part of a record
+//		note: same consistency as DB_get_from, for large records
+//
+//	input:
+//		int _agent
+//		int _from_agent = agent number
+//		int _id = identificador da 'variavel'
+//		int _offset = first byte to read
+//		int _size = number of bytes to read
+//		void *_value = ponteiro para onde sao copiados os dados
+//	output:
+//		int life = tempo de vida da 'variavel' em ms
+//		-1 = error
+//
+int DB_get_range_from (int _agent, int _from_agent, int _id, int _offset, int _size, void *_value)
+{
+	int lut;
+	TRec *p_rec;
+	void *p_data;
+	struct timeval time;
+	struct timeval timestamp;
+	unsigned int version;
+	int read_bank;
+
+	if (_from_agent == SELF)
+		_from_agent = p_def[_agent]->self_agent;
+
+	if((lut = p_def[_agent]->rec_lut[_from_agent][_id]) == -1)
+	{
+		PERR("Unknown record %d for agent %d", _id, _from_agent);
+		return -1;
+	}
+
+	if (lut < MAX_RECS)
+		p_rec = (TRec*)((char*)(p_shared_mem[_agent][_from_agent]) + lut * sizeof(TRec));
+	else
+		p_rec = (TRec*)((char*)(p_local_mem[_agent]) + (lut - MAX_RECS) * sizeof(TRec));
+
+	if (_offset < 0 || _size < 0 || _offset + _size > p_rec->size)
+	{
+		PERR("Range %d+%d out of record %d (%d bytes)", _offset, _size, _id, p_rec->size);
+		return -1;
+	}
+
+	p_data = (void *)((char *)(p_rec) + p_rec->offset + _offset);
+
+	do
+	{
+		version = p_rec->version;
+		__sync_synchronize();
+
+		read_bank = p_rec->read_bank;
+		memcpy(_value, (char *)p_data + (read_bank * p_rec->size), _size);
+		timestamp = p_rec->timestamp[read_bank];
+
+		__sync_synchronize();
+	} while ((p_rec->version - (version & ~1u)) > 2);
+
+	gettimeofday(&time, NULL);
+
+	return (int)(((time.tv_sec - timestamp.tv_sec) * 1E3) + ((time.tv_usec - timestamp.tv_usec) / 1E3));
+}
+
+
+
+//	*************************
+//	DB_get_range: read part of a record
+//
+//	input:
+//		int _from_agent = agent number
+//		int _id = identificador da 'variavel'
+//		int _offset = first byte to read
+//		int _size = number of bytes to read
+//		void *_value = ponteiro para onde sao copiados os dados
+//	output:
+//		int life = tempo de vida da 'variavel' em ms
+//		-1 = error
+//
+int DB_get_range (int _from_agent, int _id, int _offset, int _size, void *_value)
+{
+	if (__agent == -1)
+		return (-1);
+	return (DB_get_range_from (__agent, _from_agent, _id, _offset, _size, _value));
+}
+
+
+
+//	*************************
+//	DB_get_version_from: number of writes of a record
+//		note: a reader detects stale data when it does not change
+//
+//	input:
+//		int _agent
+//		int _from_agent = agent number
+//		int _id = identificador da 'variavel'
+//	output:
+//		int version = number of completed writes
+//		-1 = error
+//
+int DB_get_version_from (int _agent, int _from_agent, int _id)
+{
+	int lut;
+	TRec *p_rec;
+
+	if (_from_agent == SELF)
+		_from_agent = p_def[_agent]->self_agent;
+
+	if((lut = p_def[_agent]->rec_lut[_from_agent][_id]) == -1)
+	{
+		PERR("Unknown record %d for agent %d", _id, _from_agent);
+		return -1;
+	}
+
+	if (lut < MAX_RECS)
+		p_rec = (TRec*)((char*)(p_shared_mem[_agent][_from_agent]) + lut * sizeof(TRec));
+	else
+		p_rec = (TRec*)((char*)(p_local_mem[_agent]) + (lut - MAX_RECS) * sizeof(TRec));
+
+	return (int)((p_rec->version >> 1) & 0x7FFFFFFF);
+}
+
+
+
+//	*************************
+//	DB_get_version: number of writes of a record
+//
+//	input:
+//		int _from_agent = agent number
+//		int _id = identificador da 'variavel'
+//	output:
+//		int version = number of completed writes
+//		-1 = error
+//
+int DB_get_version (int _from_agent, int _id)
+{
+	if (__agent == -1)
+		return (-1);
+	return (DB_get_version_from (__agent, _from_agent, _id));
+}
+
+
+
+//	*************************
+//	DB_wait_change: wait for a write in the memory of the running agent
+//		note: writes of the comm process wake it, no polling needed
+//
+//	input:
+//		int _last = value returned by the previous call (-1 the first time)
+//		int _timeout = maximum wait in ms, -1 waits forever
+//	output:
+//		int seq = change counter, equal to _last on timeout
+//		-1 = error
+//
+int DB_wait_change (int _last, int _timeout)
+{
+	RTDBdef *def;
+	unsigned int seq;
+	struct timespec ts;
+	struct timespec *pts = NULL;
+
+	if (__agent == -1)
+		return (-1);
+
+	def = p_def[__agent];
+
+	if (_timeout >= 0)
+	{
+		ts.tv_sec = _timeout / 1000;
+		ts.tv_nsec = (_timeout % 1000) * 1000000L;
+		pts = &ts;
+	}
+
+	// the writer bumps change_seq before reading change_waiters, the
+	// futex returns at once if change_seq moved after it was read here
+	__sync_fetch_and_add(&def->change_waiters, 1);
+
+	seq = def->change_seq;
+	if ((int)(seq & 0x7FFFFFFF) == _last)
+	{
+		if (syscall(SYS_futex, &def->change_seq, FUTEX_WAIT, seq, pts, NULL, 0) == -1 &&
+			errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+		{
+			PERRNO("futex");
+			__sync_fetch_and_sub(&def->change_waiters, 1);
+			return -1;
+		}
+		seq = def->change_seq;
+	}
+
+	__sync_fetch_and_sub(&def->change_waiters, 1);
+
+	return (int)(seq & 0x7FFFFFFF);
+}
+
+
+
+//	*************************
+//	DB_get_change_count: number of writes in the area of an agent
+//
+//	input:
+//		int _from_agent = agent number
+//	output:
+//		int count = number of writes
+//		-1 = error
+//
+int DB_get_change_count (int _from_agent)
+{
+	if (__agent == -1)
+		return (-1);
+
+	if (_from_agent == SELF)
+		_from_agent = p_def[__agent]->self_agent;
+
+	if (_from_agent < 0 || _from_agent >= MAX_AGENTS)
+	{
+		PERR("Unknown agent %d", _from_agent);
+		return -1;
+	}
+
+	return (int)(p_def[__agent]->change_agent[_from_agent] & 0x7FFFFFFF);
+}
+
+
+
+//	*************************
+//	DB_put_team: publish a shared record of an agent to its teammates
+//		note: one write with the shared view, one per teammate otherwise
+//
+//	input:
+//		int _agent = agent memory (with the second team offset)
+//		int _id = identificador da 'variavel'
+//		void *_value = ponteiro com os dados
+//		int life = tempo de vida da 'variavel' em ms
+//	output:
+//		int size = size of record data
+//		-1 = error
+//
+int DB_put_team (int _agent, int _id, void *_value, int life)
+{
+	int i;
+	int self;
+	int base;
+	int size = -1;
+
+	self = _agent % MAX_AGENTS;
+	base = _agent - self;
+
+	for (i = 0; i < p_def[_agent]->n_agents; i++)
+	{
+		if (i == self)
+			continue;
+
+		if ((size = DB_put_in(base + i, self, _id, _value, life)) == -1)
+			return -1;
+
+		// every teammate reads the same slot
+		if (p_def[base + i]->shared_view)
+			break;
+	}
+
+	return size;
+}
+
+
+
 //	*************************
 //	DB_get_from: Le da base de dados
 //
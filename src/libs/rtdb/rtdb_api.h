@@ -72,6 +72,85 @@ int DB_put (int _id, void *_value);
 int DB_get (int _from_agent, int _id, void *_value);
 
 
+//	*************************
+//	DB_get_range: Le parte de uma 'variavel'
+//		note: for large records, e.g. only the changed tiles of GRIDVIEW
+//
+//	Entrada:
+//		int _agent = numero do agente
+//		int _id = identificador da 'variavel'
+//		int _offset = primeiro byte a ler
+//		int _size = numero de bytes a ler
+//		void *_value = ponteiro para onde sao copiados os dados
+//	Saida:
+//		int life = tempo de vida da 'variavel' em ms
+//			-1 se erro
+//
+int DB_get_range (int _from_agent, int _id, int _offset, int _size, void *_value);
+
+
+//	*************************
+//	DB_get_version: number of writes of a record
+//		note: an unchanged version means there is no new data
+//
+//	Entrada:
+//		int _agent = numero do agente
+//		int _id = identificador da 'variavel'
+//	Saida:
+//		int version = number of completed writes
+//			-1 se erro
+//
+int DB_get_version (int _from_agent, int _id);
+
+
+//	*************************
+//	DB_wait_change: espera por escritas na base de dados do proprio agente
+//		note: wakes on every write, including the ones of the comm process
+//
+//	Entrada:
+//		int _last = valor devolvido na chamada anterior (-1 na primeira)
+//		int _timeout = tempo maximo de espera em ms, -1 sem limite
+//	Saida:
+//		int seq = contador de escritas, igual a _last se expirou
+//			-1 se erro
+//
+int DB_wait_change (int _last, int _timeout);
+
+
+//	*************************
+//	DB_get_change_count: numero de escritas na area de um agente
+//
+//	Entrada:
+//		int _agent = numero do agente
+//	Saida:
+//		int count = numero de escritas
+//			-1 se erro
+//
+int DB_get_change_count (int _from_agent);
+
+
+//	*************************
+//	DB_get_namespace: namespace of the shared memory keys
+//		note: taken from RTDB_NAMESPACE, 0 if not set
+//
+//	Saida:
+//		int ns = numero do namespace
+//
+int DB_get_namespace (void);
+
+
+//	*************************
+//	DB_get_items: configuration compiled from rtdb.conf (rtdb_items.h)
+//		note: used instead of CONFIG_FILE, unless DB_set_config_file is called
+//
+//	Saida:
+//		const RTDBconf_item **items = linhas do rtdb.ini
+//		int *n_agents = numero de agentes
+//		int n_items = numero de linhas
+//
+int DB_get_items (const RTDBconf_item **items, int *n_agents);
+
+
 //	*************************
 //	Whoami: identifica o agente onde esta a correr
 //
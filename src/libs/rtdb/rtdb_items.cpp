@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA RTDB
+ *
+ * CAMBADA RTDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA RTDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// the configuration section of rtdb_items.h, compiled once in the library
+#define RTDB_ITEMS_CONF
+#include "rtdb_items.h"
+
+RTDB_STATIC_ASSERT(N_AGENTS <= MAX_AGENTS, Increase_MAX_AGENTS);
+RTDB_STATIC_ASSERT(N_ITEMS <= MAX_RECS, Increase_MAX_RECS);
+
+int DB_get_items (const RTDBconf_item **items, int *n_agents)
+{
+	*items = rtdb::conf;
+	*n_agents = N_AGENTS;
+
+	return sizeof(rtdb::conf) / sizeof(rtdb::conf[0]);
+}
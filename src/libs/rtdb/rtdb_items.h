@@ -0,0 +1,388 @@
+/* AUTOGEN FILE : rtdb_items.h */
+
+#ifndef _CAMBADA_RTDB_ITEMS_
+#define _CAMBADA_RTDB_ITEMS_
+
+#include "rtdb_typed.h"
+
+/* datatypes section */
+
+#include "Robot.h"
+#include "SystemInfo.h"
+#include "CoachInfo.h"
+#include "VisionInfo.h"
+#include "HWcomm_rtdb.h"
+#include "stdio.h"
+#include "KickCalibData.h"
+#include "GridView.h"
+#include "CoachLogModeInfo.h"
+
+#include "common.h"
+
+#ifdef RTDB_ITEMS_WIRE
+#include "wire.h"
+#endif
+
+namespace rtdb {
+
+using namespace cambada;
+
+/* items section */
+
+template<> struct Item<ROBOT_WS>
+{
+	typedef Robot type;
+	RTDB_CONST int id = ROBOT_WS;
+	RTDB_CONST int size = sizeof(Robot);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x7e;
+	RTDB_CONST unsigned local = 0x0;
+};
+
+template<> struct Item<LAPTOP_INFO>
+{
+	typedef LaptopInfo type;
+	RTDB_CONST int id = LAPTOP_INFO;
+	RTDB_CONST int size = sizeof(LaptopInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x7e;
+	RTDB_CONST unsigned local = 0x0;
+};
+
+template<> struct Item<COACH_INFO>
+{
+	typedef CoachInfo type;
+	RTDB_CONST int id = COACH_INFO;
+	RTDB_CONST int size = sizeof(CoachInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x1;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<VISION_INFO>
+{
+	typedef VisionInfo type;
+	RTDB_CONST int id = VISION_INFO;
+	RTDB_CONST int size = sizeof(VisionInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<FRONT_VISION_INFO>
+{
+	typedef FrontVisionInfo type;
+	RTDB_CONST int id = FRONT_VISION_INFO;
+	RTDB_CONST int size = sizeof(FrontVisionInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<FORMATION_INFO>
+{
+	typedef FormationInfo type;
+	RTDB_CONST int id = FORMATION_INFO;
+	RTDB_CONST int size = sizeof(FormationInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x1;
+	RTDB_CONST unsigned local = 0x0;
+};
+
+template<> struct Item<CMD_VEL>
+{
+	typedef CMD_Vel type;
+	RTDB_CONST int id = CMD_VEL;
+	RTDB_CONST int size = sizeof(CMD_Vel);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_POS>
+{
+	typedef CMD_Pos type;
+	RTDB_CONST int id = CMD_POS;
+	RTDB_CONST int size = sizeof(CMD_Pos);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_KICKER>
+{
+	typedef CMD_Kicker type;
+	RTDB_CONST int id = CMD_KICKER;
+	RTDB_CONST int size = sizeof(CMD_Kicker);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_INFO>
+{
+	typedef CMD_Info type;
+	RTDB_CONST int id = CMD_INFO;
+	RTDB_CONST int size = sizeof(CMD_Info);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_HWERRORS>
+{
+	typedef CMD_HWerrors type;
+	RTDB_CONST int id = CMD_HWERRORS;
+	RTDB_CONST int size = sizeof(CMD_HWerrors);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_GRABBER>
+{
+	typedef CMD_Grabber type;
+	RTDB_CONST int id = CMD_GRABBER;
+	RTDB_CONST int size = sizeof(CMD_Grabber);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<LAST_CMD_VEL>
+{
+	typedef CMD_Vel type;
+	RTDB_CONST int id = LAST_CMD_VEL;
+	RTDB_CONST int size = sizeof(CMD_Vel);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_IMU>
+{
+	typedef CMD_Imu type;
+	RTDB_CONST int id = CMD_IMU;
+	RTDB_CONST int size = sizeof(CMD_Imu);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_SYNCIMU>
+{
+	typedef int type;
+	RTDB_CONST int id = CMD_SYNCIMU;
+	RTDB_CONST int size = sizeof(int);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_GRABBER_INFO>
+{
+	typedef CMD_Grabber_Info type;
+	RTDB_CONST int id = CMD_GRABBER_INFO;
+	RTDB_CONST int size = sizeof(CMD_Grabber_Info);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<CMD_GRABBER_CONFIG>
+{
+	typedef CMD_Grabber_Config type;
+	RTDB_CONST int id = CMD_GRABBER_CONFIG;
+	RTDB_CONST int size = sizeof(CMD_Grabber_Config);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x7e;
+};
+
+template<> struct Item<KICKCALIB_APP>
+{
+	typedef KickCalibAppData type;
+	RTDB_CONST int id = KICKCALIB_APP;
+	RTDB_CONST int size = sizeof(KickCalibAppData);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x1;
+	RTDB_CONST unsigned local = 0x0;
+};
+
+template<> struct Item<KICKCALIB_ROB>
+{
+	typedef KickCalibRobData type;
+	RTDB_CONST int id = KICKCALIB_ROB;
+	RTDB_CONST int size = sizeof(KickCalibRobData);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x7e;
+	RTDB_CONST unsigned local = 0x0;
+};
+
+template<> struct Item<GRIDVIEW>
+{
+	typedef GridView type;
+	RTDB_CONST int id = GRIDVIEW;
+	RTDB_CONST int size = sizeof(GridView);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x1;
+};
+
+template<> struct Item<COACHLOGROBOTSINFO>
+{
+	typedef CoachLogRobotsInfo type;
+	RTDB_CONST int id = COACHLOGROBOTSINFO;
+	RTDB_CONST int size = sizeof(CoachLogRobotsInfo);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x1;
+};
+
+template<> struct Item<COACHLOGMODEFLAG>
+{
+	typedef CoachLogModeFlag type;
+	RTDB_CONST int id = COACHLOGMODEFLAG;
+	RTDB_CONST int size = sizeof(CoachLogModeFlag);
+	RTDB_CONST int period = 1;
+	RTDB_CONST unsigned shared = 0x0;
+	RTDB_CONST unsigned local = 0x1;
+};
+
+/* configuration section */
+
+#ifdef RTDB_ITEMS_CONF
+
+static const RTDBconf_item conf[] = {
+	{ BASE_STATION, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 's' },
+	{ BASE_STATION, FORMATION_INFO, Item<FORMATION_INFO>::size, Item<FORMATION_INFO>::period, 's' },
+	{ BASE_STATION, KICKCALIB_APP, Item<KICKCALIB_APP>::size, Item<KICKCALIB_APP>::period, 's' },
+	{ BASE_STATION, GRIDVIEW, Item<GRIDVIEW>::size, Item<GRIDVIEW>::period, 'l' },
+	{ BASE_STATION, COACHLOGROBOTSINFO, Item<COACHLOGROBOTSINFO>::size, Item<COACHLOGROBOTSINFO>::period, 'l' },
+	{ BASE_STATION, COACHLOGMODEFLAG, Item<COACHLOGMODEFLAG>::size, Item<COACHLOGMODEFLAG>::period, 'l' },
+	{ CAMBADA_1, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_1, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_1, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_1, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_1, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_1, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_1, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_1, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_1, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_1, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_1, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_1, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_1, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_1, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_1, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_1, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_1, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+	{ CAMBADA_2, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_2, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_2, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_2, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_2, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_2, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_2, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_2, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_2, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_2, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_2, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_2, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_2, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_2, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_2, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_2, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_2, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+	{ CAMBADA_3, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_3, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_3, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_3, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_3, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_3, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_3, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_3, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_3, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_3, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_3, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_3, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_3, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_3, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_3, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_3, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_3, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+	{ CAMBADA_4, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_4, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_4, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_4, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_4, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_4, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_4, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_4, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_4, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_4, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_4, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_4, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_4, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_4, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_4, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_4, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_4, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+	{ CAMBADA_5, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_5, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_5, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_5, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_5, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_5, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_5, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_5, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_5, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_5, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_5, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_5, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_5, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_5, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_5, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_5, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_5, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+	{ CAMBADA_6, ROBOT_WS, Item<ROBOT_WS>::size, Item<ROBOT_WS>::period, 's' },
+	{ CAMBADA_6, LAPTOP_INFO, Item<LAPTOP_INFO>::size, Item<LAPTOP_INFO>::period, 's' },
+	{ CAMBADA_6, KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, Item<KICKCALIB_ROB>::period, 's' },
+	{ CAMBADA_6, COACH_INFO, Item<COACH_INFO>::size, Item<COACH_INFO>::period, 'l' },
+	{ CAMBADA_6, VISION_INFO, Item<VISION_INFO>::size, Item<VISION_INFO>::period, 'l' },
+	{ CAMBADA_6, FRONT_VISION_INFO, Item<FRONT_VISION_INFO>::size, Item<FRONT_VISION_INFO>::period, 'l' },
+	{ CAMBADA_6, CMD_VEL, Item<CMD_VEL>::size, Item<CMD_VEL>::period, 'l' },
+	{ CAMBADA_6, CMD_POS, Item<CMD_POS>::size, Item<CMD_POS>::period, 'l' },
+	{ CAMBADA_6, CMD_KICKER, Item<CMD_KICKER>::size, Item<CMD_KICKER>::period, 'l' },
+	{ CAMBADA_6, CMD_INFO, Item<CMD_INFO>::size, Item<CMD_INFO>::period, 'l' },
+	{ CAMBADA_6, CMD_HWERRORS, Item<CMD_HWERRORS>::size, Item<CMD_HWERRORS>::period, 'l' },
+	{ CAMBADA_6, CMD_GRABBER, Item<CMD_GRABBER>::size, Item<CMD_GRABBER>::period, 'l' },
+	{ CAMBADA_6, LAST_CMD_VEL, Item<LAST_CMD_VEL>::size, Item<LAST_CMD_VEL>::period, 'l' },
+	{ CAMBADA_6, CMD_IMU, Item<CMD_IMU>::size, Item<CMD_IMU>::period, 'l' },
+	{ CAMBADA_6, CMD_SYNCIMU, Item<CMD_SYNCIMU>::size, Item<CMD_SYNCIMU>::period, 'l' },
+	{ CAMBADA_6, CMD_GRABBER_INFO, Item<CMD_GRABBER_INFO>::size, Item<CMD_GRABBER_INFO>::period, 'l' },
+	{ CAMBADA_6, CMD_GRABBER_CONFIG, Item<CMD_GRABBER_CONFIG>::size, Item<CMD_GRABBER_CONFIG>::period, 'l' },
+};
+
+#endif
+
+/* wire section */
+
+#ifdef RTDB_ITEMS_WIRE
+
+static const RTDBwire_item wire[] = {
+	{ ROBOT_WS, Item<ROBOT_WS>::size, &Wire<Item<ROBOT_WS>::type>::pack, &Wire<Item<ROBOT_WS>::type>::unpack },
+	{ LAPTOP_INFO, Item<LAPTOP_INFO>::size, &Wire<Item<LAPTOP_INFO>::type>::pack, &Wire<Item<LAPTOP_INFO>::type>::unpack },
+	{ COACH_INFO, Item<COACH_INFO>::size, &Wire<Item<COACH_INFO>::type>::pack, &Wire<Item<COACH_INFO>::type>::unpack },
+	{ FORMATION_INFO, Item<FORMATION_INFO>::size, &Wire<Item<FORMATION_INFO>::type>::pack, &Wire<Item<FORMATION_INFO>::type>::unpack },
+	{ KICKCALIB_APP, Item<KICKCALIB_APP>::size, &Wire<Item<KICKCALIB_APP>::type>::pack, &Wire<Item<KICKCALIB_APP>::type>::unpack },
+	{ KICKCALIB_ROB, Item<KICKCALIB_ROB>::size, &Wire<Item<KICKCALIB_ROB>::type>::pack, &Wire<Item<KICKCALIB_ROB>::type>::unpack },
+};
+
+#endif
+
+}
+
+#endif
+
+/* EOF : rtdb_items.h */
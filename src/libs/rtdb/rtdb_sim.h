@@ -44,8 +44,36 @@ int DB_put_in (int _agent, int _to_agent, int _id, void *_value, int life);
 
 int DB_get_from (int _agent, int _from_agent, int _id, void *_value);
 
+//	*************************
+//	DB_get_version_from: number of writes of a record
+//
+//	Saida:
+//		>= 0 = number of completed writes
+//		-1 = erro
+//
+int DB_get_version_from (int _agent, int _from_agent, int _id);
+
+//	*************************
+//	DB_put_team: publish a shared record of _agent to all its teammates
+//
+//	Saida:
+//		int size = size of record data
+//		-1 = erro
+//
+int DB_put_team (int _agent, int _id, void *_value, int life);
+
 void DB_set_config_file(const char* cf);
 
+//	*************************
+//	DB_set_shared_view: teammates map one team region (call before DB_init_all)
+//
+void DB_set_shared_view(int enable);
+
+//	*************************
+//	DB_set_namespace: move all shared memory keys (call before DB_init_all)
+//
+void DB_set_namespace(int ns);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA RTDB
+ *
+ * CAMBADA RTDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA RTDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RTDB_TYPED_H
+#define __RTDB_TYPED_H
+
+#include "rtdb_user.h"
+#include "rtdb_api.h"
+
+#if __cplusplus >= 201103L
+#define RTDB_CONST static constexpr
+#define RTDB_STATIC_ASSERT(cond, msg) static_assert(cond, #msg)
+#else
+#define RTDB_CONST static const
+#define RTDB_STATIC_ASSERT(cond, msg) typedef char msg[(cond) ? 1 : -1] __attribute__((unused))
+#endif
+
+namespace rtdb {
+
+//	*************************
+//	Item<ID>: datatype and configuration of an item
+//		note: specialized by rtdb_items.h (xrtdb), only for the items
+//		used by some agent
+//
+template<int ID> struct Item;
+
+template<typename A, typename B> struct SameType { RTDB_CONST bool value = false; };
+template<typename A> struct SameType<A, A> { RTDB_CONST bool value = true; };
+
+}
+
+
+//	*************************
+//	DB_put<ID>: DB_put checked at compile time
+//		note: fails to compile if _value is not the datatype of the item
+//
+//	Entrada:
+//		const T *_value = ponteiro com os dados
+//	Saida:
+//		0 = OK
+//		-1 = erro
+//
+template<int ID, typename T>
+inline int DB_put (const T *_value)
+{
+	RTDB_STATIC_ASSERT((rtdb::SameType<T, typename rtdb::Item<ID>::type>::value), DB_put_datatype_of_item_mismatch);
+	return DB_put(ID, const_cast<T*>(_value));
+}
+
+
+//	*************************
+//	DB_get<ID>: DB_get checked at compile time
+//		note: fails to compile if _value is not the datatype of the item
+//
+//	Entrada:
+//		int _from_agent = numero do agente
+//		T *_value = ponteiro para onde sao copiados os dados
+//	Saida:
+//		int life = tempo de vida da 'variavel' em ms
+//			-1 se erro
+//
+template<int ID, typename T>
+inline int DB_get (int _from_agent, T *_value)
+{
+	RTDB_STATIC_ASSERT((rtdb::SameType<T, typename rtdb::Item<ID>::type>::value), DB_get_datatype_of_item_mismatch);
+	return DB_get(_from_agent, ID, _value);
+}
+
+#endif
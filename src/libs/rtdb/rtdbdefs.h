@@ -35,6 +35,8 @@ extern "C" {
 
 #define SHMEM_KEY 0x2000
 #define SHMEM_SECOND_TEAM_KEY 0x3000
+#define SHMEM_TEAM_KEY 0x2800	// team region (shared view), + team number
+#define RTDB_NAMESPACE_STRIDE 0x10000	// distance between the keys of two namespaces
 
 // definicoes hard-coded
 // alterar de acordo com a utilizacao pretendida
@@ -51,6 +53,15 @@ typedef struct
 	int period;			// periodicidade de refrescamento via wireless
 } RTDBconf_var;
 
+typedef struct
+{
+	int agent;			// numero do agente
+	int id;				// identificador da 'variavel'
+	int size;			// tamanho de dados
+	int period;			// periodicidade de refrescamento via wireless
+	char type;			// 's' = shared, 'l' = local
+} RTDBconf_item;		// linha do rtdb.ini, compilada em rtdb_items.h
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,8 @@
 #include <QtOpenGL>
 
 #include <math.h>
+#include <string.h>
+#include <stddef.h>
 
 #include <GL/glut.h>
 #include "FieldWidget.h"
@@ -44,13 +46,21 @@ FieldWidget::FieldWidget(QWidget *parent)
 
 
 	/* Inicializa as listas de objectos a 0 */
-	field=0;
-	robot=0;
-	ball=0;
 	select=0;
+	ball_engaged=0;
 	robotAngle=0;
-	debug_point=0;
 	ballVel=0;			//added by Joao
+	robotContour=0;
+
+	/* Buffers de vértices */
+	recordTarget = NULL;
+	shapeTarget = NULL;
+	shapeMode = GL_POINTS;
+	obstaclePointSize = 1.0;
+	frameBuffer.setUsagePattern(QGLBuffer::StreamDraw);
+	memset(lastRobotInfo, 0, sizeof(lastRobotInfo));
+	memset(lastRobotStatus, 0, sizeof(lastRobotStatus));
+	sceneDirty = true;
 	
 	ConfigXML config;
 	if( config.parse("../config/cambada.conf.xml") == false )
@@ -168,15 +178,13 @@ FieldWidget::~FieldWidget()
 {
 	/* Destroi todas as listas de objectos */
     makeCurrent();
-    glDeleteLists(field, 1);
-    glDeleteLists(robot, 1);
-    glDeleteLists(ball, 1);
+    fieldBuffer.destroy();
+    frameBuffer.destroy();
     glDeleteLists(select, 1);
     glDeleteLists(ball_engaged, 1);
     glDeleteLists(robotAngle, 1);
-    glDeleteLists(debug_point, 1);
-    glDeleteLists(obstacle_point, 1);
     glDeleteLists(ballVel, 1);			//added by Joao
+    glDeleteLists(robotContour, 1);
 
     delete Update_timer;
 }
@@ -190,14 +198,14 @@ void FieldWidget::initializeGL()
 	qglClearColor(FieldGreen);
 
 	/*Construção das listas de objectos */
-	field = makeField();
-	robot = makeRobot();
-	ball= makeBall();
+	makeField();
+	makeRobot();
+	makeBall();
 	select= makeSelect();
 	ball_engaged = makeBallEngaged();
 	robotAngle = makeRobotAngle();
-	debug_point = makeDebugPoint();
-	obstacle_point = makeObstaclePoint();
+	makeDebugPoint();
+	makeObstaclePoint();
 	ballVel = makeBallVel();		//added by Joao
 	robotContour = makeRobotContour();
 
@@ -230,6 +238,11 @@ void FieldWidget::paintGL()
 	int	closerToBall=-1;
 	int closerDist=1000;
 
+	/* Robots, bolas, pontos de debug e obstáculos vão para um só buffer,
+	   desenhado no fim do ciclo; a ordem dos robots é mantida */
+	frameVertices.clear();
+	framePoints.clear();
+
 	for (unsigned i=0; i<NROBOTS; i++)
 	{
 		/*Check if the robot is in standby and make its color semi-transparent if it is*/
@@ -309,23 +322,14 @@ void FieldWidget::paintGL()
 				glCallList(ball_engaged);
 				glPopMatrix();				
 
-				glLoadIdentity();
-				glPushMatrix();
-				qglColor(robot_info[i].color);
-				glTranslated(robot_info[i].Pos.x, robot_info[i].Pos.y, 0.02);	//ZZ changed by Joao
-				glRotated(robot_info[i].angle, 0.0, 0.0, 1.0);
-				glTranslated(0, _ROBOT_RADIUS, 0);
-				glCallList(ball);
-				glPopMatrix();
+				addInstance(frameVertices, ballShape, robot_info[i].Pos.x, robot_info[i].Pos.y, 0.02,	//ZZ changed by Joao
+						robot_info[i].angle, 1.0, robot_info[i].color, _ROBOT_RADIUS);
 			}
 			else
 			{
 				//Se não, desenha a bola na posição recebida da rtdb
-				glPushMatrix();
-				qglColor(robot_info[i].color);
-				glTranslated(robot_info[i].PosBall.x, robot_info[i].PosBall.y, 0.02);	//ZZ changed by Joao
-				glCallList(ball);
-				glPopMatrix();
+				addInstance(frameVertices, ballShape, robot_info[i].PosBall.x, robot_info[i].PosBall.y, 0.02,	//ZZ changed by Joao
+						0.0, 1.0, robot_info[i].color);
 			}
 
 			if ( robot_info[i].velBall.length() < closerDist )
@@ -376,18 +380,11 @@ void FieldWidget::paintGL()
 		// Se o robot estiver visivel desenha-o no campo
 		if (robot_info[i].visible)
 		{
-			//glLoadIdentity();
-			glPushMatrix();
-			qglColor(robot_info[i].color);
-			glTranslated(robot_info[i].Pos.x, robot_info[i].Pos.y, 0.0);
-
 			double angle=robot_info[i].angle;
 			//if (flipV == -1) angle += 180;
-				glRotated(angle, 0.0, 0.0, 1.0);
 
-			glCallList(robot);
-
-			glPopMatrix();
+			addInstance(frameVertices, robotShape, robot_info[i].Pos.x, robot_info[i].Pos.y, 0.0,
+					angle, 1.0, robot_info[i].color);
 		}
 
 
@@ -413,12 +410,8 @@ void FieldWidget::paintGL()
 		{
 			if ( robot_info[i].Debug_point_visible[dp] && robot_info[i].visible )
 			{
-				glPushMatrix();
-				qglColor(robot_info[i].color);
-				glTranslated(robot_info[i].Debug_point[dp].x, robot_info[i].Debug_point[dp].y, 0.03);		//ZZ changed by Joao
-	    		glRotated(45.0, 0.0, 0.0, 1.0);
-				glCallList(debug_point);
-				glPopMatrix();
+				addInstance(frameVertices, debugPointShape, robot_info[i].Debug_point[dp].x, robot_info[i].Debug_point[dp].y, 0.03,		//ZZ changed by Joao
+						45.0, 1.0, robot_info[i].color);
 			}
 		}
 
@@ -447,12 +440,8 @@ void FieldWidget::paintGL()
 					}
 
 					//Draw Points
-					glPushMatrix();
-					qglColor(robot_info[i].color);
-					glTranslated(robot_info[i].obstacleAbsCenter[obs].x, robot_info[i].obstacleAbsCenter[obs].y, 0.01);		//ZZ changed by Joao
-					glScaled(robot_info[i].obstacleWidth[obs]*100, robot_info[i].obstacleWidth[obs]*100, 1);
-					glCallList(obstacle_point);
-					glPopMatrix();
+					addInstance(framePoints, obstacleShape, robot_info[i].obstacleAbsCenter[obs].x, robot_info[i].obstacleAbsCenter[obs].y, 0.01,		//ZZ changed by Joao
+							0.0, robot_info[i].obstacleWidth[obs]*100, robot_info[i].color);
 
 					
 
@@ -474,6 +463,29 @@ void FieldWidget::paintGL()
 	}
 
 
+	/* Desenho de todos os robots de uma vez: triângulos e depois os pontos dos obstáculos */
+	{
+		int nTriangles = frameVertices.size();
+		int nPoints = framePoints.size();
+
+		frameVertices.insert(frameVertices.end(), framePoints.begin(), framePoints.end());
+
+		if (frameBuffer.isCreated() || frameBuffer.create())
+		{
+			frameBuffer.bind();
+			frameBuffer.allocate(frameVertices.empty() ? NULL : &frameVertices[0], frameVertices.size()*sizeof(FieldVertex));
+			frameBuffer.release();
+		}
+
+		glLoadIdentity();
+		drawVertices(frameBuffer, frameVertices, GL_TRIANGLES, 0, nTriangles);
+
+		glPointSize(obstaclePointSize);
+		glEnable(GL_POINT_SMOOTH);
+		drawVertices(frameBuffer, frameVertices, GL_POINTS, nTriangles, nPoints);
+		glDisable(GL_POINT_SMOOTH);
+	}
+
 	//DRAW VELOCITY OF THE CLOSEST ROBOT
 	glPushMatrix();
 	if ( robot_info[closerToBall].velBall.length() > 0.70 )
@@ -603,7 +615,7 @@ void FieldWidget::paintGL()
 	//glLoadIdentity();
 	glPushMatrix();
 	glTranslated(0.0, 0.0, 0.0);
-	glCallList(field);
+	drawVertices(fieldBuffer, fieldVertices, GL_TRIANGLES, 0, fieldVertices.size());
 	glPopMatrix();
 }
 
@@ -655,12 +667,13 @@ glViewport(0, 0, width, height);
 
 //==================================================== makeField ==========================================
 
-GLuint FieldWidget::makeField()
+void FieldWidget::makeField()
 {
 	makeCurrent();
 
-    GLuint list = glGenLists(1);
-    glNewList(list, GL_COMPILE);
+	/* quad() e circ() passam a guardar os vértices em vez de desenhar */
+	fieldVertices.clear();
+	recordTarget = &fieldVertices;
 
 	/* Pontos no campo */
 	//baixo direita
@@ -1055,18 +1068,25 @@ GLuint FieldWidget::makeField()
 
 
 
-    glEndList();
-    return list;
+	recordTarget = NULL;
+
+	/* O campo não muda, vai uma só vez para a placa gráfica */
+	if (fieldBuffer.create())
+	{
+		fieldBuffer.setUsagePattern(QGLBuffer::StaticDraw);
+		fieldBuffer.bind();
+		fieldBuffer.allocate(&fieldVertices[0], fieldVertices.size()*sizeof(FieldVertex));
+		fieldBuffer.release();
+	}
 }
 
 //==================================================== makeRobot ==========================================
 
-GLuint FieldWidget::makeRobot()
+void FieldWidget::makeRobot()
 {
 	makeCurrent();
 
-	GLuint list1 = glGenLists(1);
-	glNewList(list1, GL_COMPILE);
+	robotShape.clear();
 
 using namespace std;
 
@@ -1089,9 +1109,9 @@ using namespace std;
 	vector<Vec> vec_pontos_bola;
 	vector<Vec> vec_pontos_robot;
 
-glBegin(GL_TRIANGLE_FAN);
+beginShape(&robotShape, GL_TRIANGLE_FAN);
 	//Ponto do centro
-	glVertex2d(centro_r.x, centro_r.y);
+	vertex(centro_r.x, centro_r.y);
 
 	for (int i = 0; i < NumSectors+1; ++i)
 	{
@@ -1150,11 +1170,11 @@ glBegin(GL_TRIANGLE_FAN);
 
 				}
 		//outro ponto
-		glVertex2d(p.x, p.y);
+		vertex(p.x, p.y);
 	}
 
 
-glEnd();
+endShape();
 
 
 
@@ -1164,8 +1184,6 @@ glEnd();
 
 
 
-	glEndList();
-	return list1;
 }
 
 
@@ -1287,16 +1305,15 @@ GLuint FieldWidget::makeRobotContour()
 
 //==================================================== makeBall ==========================================
 
-GLuint FieldWidget::makeBall()
+void FieldWidget::makeBall()
 {
 	makeCurrent();
 	//a bola é um circulo normal mas sem cor
-    GLuint list1 = glGenLists(1);
-    glNewList(list1, GL_COMPILE);
+	ballShape.clear();
 
-	glBegin(GL_TRIANGLE_FAN);
+	beginShape(&ballShape, GL_TRIANGLE_FAN);
 
-	glVertex2d(0, 0);
+	vertex(0, 0);
 
 	for (int i = 0; i < NumSectors+1; ++i) 
 	{
@@ -1304,51 +1321,48 @@ GLuint FieldWidget::makeBall()
 		GLdouble x = _BALL_DIAMETER/2 * sin(angle1);
 		GLdouble y = _BALL_DIAMETER/2 * cos(angle1);
 
-		glVertex2d(x, y);
+		vertex(x, y);
 	}
 
 
-glEnd();
+endShape();
 
 
-    glEndList();
-    return list1;
 }
 
 //==================================================== makeDebugPoint ==========================================
 
-GLuint FieldWidget::makeDebugPoint()
+void FieldWidget::makeDebugPoint()
 {
 
 	makeCurrent();
 	//o Debug_point é um circulo normal mas sem cor
-    GLuint list1 = glGenLists(1);
-    glNewList(list1, GL_COMPILE);
+	debugPointShape.clear();
 
 
 
-glBegin(GL_QUADS);
+beginShape(&debugPointShape, GL_QUADS);
 
-    glVertex2d((0.15), (-(0.05)));
-    glVertex2d((-(0.15)), (-(0.05)));
-    glVertex2d((-(0.15)), (0.05));
-    glVertex2d((0.15), (0.05));
+    vertex((0.15), (-(0.05)));
+    vertex((-(0.15)), (-(0.05)));
+    vertex((-(0.15)), (0.05));
+    vertex((0.15), (0.05));
 
-glEnd();
+endShape();
 
-glBegin(GL_QUADS);
+beginShape(&debugPointShape, GL_QUADS);
 
-    glVertex2d((0.05), (-(0.15)));
-    glVertex2d((-(0.05)), (-(0.15)));
-    glVertex2d((-(0.05)), (0.15));
-    glVertex2d((0.05), (0.15));
+    vertex((0.05), (-(0.15)));
+    vertex((-(0.05)), (-(0.15)));
+    vertex((-(0.05)), (0.15));
+    vertex((0.05), (0.15));
 
-glEnd();
+endShape();
 
 /*
-	glBegin(GL_TRIANGLE_FAN);
+	beginShape(&debugPointShape, GL_TRIANGLE_FAN);
 
-	glVertex2d(0, 0);
+	vertex(0, 0);
 
 	for (int i = 0; i < NumSectors+1; ++i) 
 	{
@@ -1356,15 +1370,13 @@ glEnd();
 		GLdouble x = _BALL_DIAMETER/3 * sin(angle1);
 		GLdouble y = _BALL_DIAMETER/3 * cos(angle1);
 
-		glVertex2d(x, y);
+		vertex(x, y);
 	}
 
 
-glEnd();
+endShape();
 */
 
-    glEndList();
-    return list1;
 
 
 }
@@ -1466,26 +1478,23 @@ glEnd();
 
 //==================================================== makeObstaclePoint ==========================================
 
-GLuint FieldWidget::makeObstaclePoint()
+void FieldWidget::makeObstaclePoint()
 {
 	makeCurrent();
 
 	/* desenha um quadrado da cor do robot*/
-    GLuint list1 = glGenLists(1);
-    glNewList(list1, GL_COMPILE);
+	obstacleShape.clear();
 
 
-GLfloat size;
+GLfloat size[2];
 GLfloat increment;
-glGetFloatv(GL_POINT_SIZE_RANGE,&size);
+glGetFloatv(GL_POINT_SIZE_RANGE,size);
 glGetFloatv(GL_POINT_SIZE_GRANULARITY,&increment);
-glPointSize(size+3*increment);
-
+obstaclePointSize = size[0]+3*increment;
 
-	glEnable(GL_POINT_SMOOTH);
-	glBegin(GL_POINTS);
+	beginShape(&obstacleShape, GL_POINTS);
 
-	glVertex2d(0, 0);
+	vertex(0, 0);
 
 	for (int i = 0; i < NumSectors+1; ++i) 
 	{
@@ -1493,11 +1502,11 @@ glPointSize(size+3*increment);
 		GLdouble x = 0.005 * sin(angle1);
 		GLdouble y = 0.005 * cos(angle1);
 
-		glVertex2d(x, y);
+		vertex(x, y);
 	}
 
 
-glEnd();
+endShape();
 
 
 
@@ -1505,18 +1514,15 @@ glEnd();
 
 
 /*
-glBegin(GL_QUADS);
+beginShape(&obstacleShape, GL_QUADS);
 
-    glVertex2d((0.005), (-(0.005)));
-    glVertex2d((-(0.005)), (-(0.005)));
-    glVertex2d((-(0.005)), (0.005));
-    glVertex2d((0.005), (0.005));
+    vertex((0.005), (-(0.005)));
+    vertex((-(0.005)), (-(0.005)));
+    vertex((-(0.005)), (0.005));
+    vertex((0.005), (0.005));
 
-glEnd();
+endShape();
 */
-    glEndList();
-
-    return list1;
 }
 
 //==================================================== makeBallVel ==========================================	added by Joao
@@ -1546,6 +1552,18 @@ void FieldWidget::quad(	GLdouble x1, GLdouble y1, GLdouble x2, GLdouble y2,
 {
 /* Função para desenhar quadrados através dos pontos dos vértices */
 
+if (recordTarget != NULL)
+{
+	shapeColor = color;
+	beginShape(recordTarget, GL_QUADS);
+	vertex(x4, y4);
+	vertex(x3, y3);
+	vertex(x2, y2);
+	vertex(x1, y1);
+	endShape();
+	return;
+}
+
 glBegin(GL_QUADS);
 
     qglColor(color);
@@ -1565,6 +1583,20 @@ void FieldWidget::circ(	GLdouble xcent, GLdouble ycent,
 {
 	/* Função para desenhar um circulo através do ponto central e do raio*/
 
+if (recordTarget != NULL)
+{
+	shapeColor = color;
+	beginShape(recordTarget, GL_TRIANGLE_FAN);
+	vertex(xcent, ycent);
+	for (int i = 0; i < NumSectors+1; ++i)
+	{
+		double angle1 = (i * 2 * Pi) / NumSectors;
+		vertex((radius * sin(angle1) + xcent), (radius * cos(angle1) + ycent));
+	}
+	endShape();
+	return;
+}
+
 glBegin(GL_TRIANGLE_FAN);
 
 	qglColor(color);
@@ -1585,6 +1617,113 @@ glBegin(GL_TRIANGLE_FAN);
 glEnd();
 }
 
+//==================================================== beginShape ==========================================
+
+void FieldWidget::beginShape(std::vector<FieldVertex>* target, GLenum mode)
+{
+	/* Guarda uma primitiva em vez de a desenhar; leques e quadrados passam a triângulos */
+	shapeTarget = target;
+	shapeMode = mode;
+	shapeVertices.clear();
+}
+
+void FieldWidget::vertex(GLdouble x, GLdouble y)
+{
+	FieldVertex v;
+	v.x = x;
+	v.y = y;
+	v.z = 0;
+	v.r = shapeColor.red();
+	v.g = shapeColor.green();
+	v.b = shapeColor.blue();
+	v.a = shapeColor.alpha();
+	shapeVertices.push_back(v);
+}
+
+void FieldWidget::endShape()
+{
+	unsigned int n = shapeVertices.size();
+
+	if (shapeMode == GL_TRIANGLE_FAN)
+	{
+		for (unsigned int i = 1; i+1 < n; i++)
+		{
+			shapeTarget->push_back(shapeVertices[0]);
+			shapeTarget->push_back(shapeVertices[i]);
+			shapeTarget->push_back(shapeVertices[i+1]);
+		}
+	}
+	else if (shapeMode == GL_QUADS)
+	{
+		for (unsigned int i = 0; i+3 < n; i+=4)
+		{
+			shapeTarget->push_back(shapeVertices[i]);
+			shapeTarget->push_back(shapeVertices[i+1]);
+			shapeTarget->push_back(shapeVertices[i+2]);
+			shapeTarget->push_back(shapeVertices[i]);
+			shapeTarget->push_back(shapeVertices[i+2]);
+			shapeTarget->push_back(shapeVertices[i+3]);
+		}
+	}
+	else	// GL_POINTS, GL_TRIANGLES
+		shapeTarget->insert(shapeTarget->end(), shapeVertices.begin(), shapeVertices.end());
+
+	shapeVertices.clear();
+}
+
+//==================================================== addInstance ==========================================
+
+void FieldWidget::addInstance(std::vector<FieldVertex>& out, const std::vector<FieldVertex>& shape,
+			double x, double y, double z, double angle, double scale, QColor color, double offsetY)
+{
+	/* Equivalente a glTranslated(x,y,z); glRotated(angle); glScaled(scale); glTranslated(0,offsetY) */
+	double c = cos(angle*Pi/180.0)*scale;
+	double sn = sin(angle*Pi/180.0)*scale;
+	FieldVertex v;
+
+	v.z = z;
+	v.r = color.red();
+	v.g = color.green();
+	v.b = color.blue();
+	v.a = color.alpha();
+
+	for (unsigned int i = 0; i < shape.size(); i++)
+	{
+		double lx = shape[i].x;
+		double ly = shape[i].y + offsetY;
+		v.x = x + c*lx - sn*ly;
+		v.y = y + sn*lx + c*ly;
+		out.push_back(v);
+	}
+}
+
+//==================================================== drawVertices ==========================================
+
+void FieldWidget::drawVertices(QGLBuffer& buffer, const std::vector<FieldVertex>& vertices, GLenum mode, int first, int count)
+{
+	/* Sem VBO (p.ex. Mesa muito antigo) desenha a partir da memória */
+	if (count <= 0)
+		return;
+
+	const char* base = buffer.isCreated() ? NULL : (const char*)&vertices[0];
+
+	if (buffer.isCreated())
+		buffer.bind();
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(FieldVertex), base + offsetof(FieldVertex, x));
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(FieldVertex), base + offsetof(FieldVertex, r));
+
+	glDrawArrays(mode, first, count);
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	if (buffer.isCreated())
+		buffer.release();
+}
+
 //==================================================== line ==========================================
 void FieldWidget::line(	GLdouble x1, GLdouble y1, GLdouble x2, GLdouble y2,
 			QColor color)
@@ -1832,8 +1971,8 @@ void FieldWidget::updateField(void)
 //	int width = QWidget::width();
 //	resizeGL(width, height);
 
+		sceneDirty = false;
 		updateGL();
-		paintGL();
 }
 
 
@@ -1847,6 +1986,7 @@ void FieldWidget::flip(void)
 
 	flipV *= -1;
 	flipH *= -1;
+	sceneDirty = true;
 
 	resizeGL(width, height);
 	updateField();
@@ -1863,6 +2003,15 @@ void FieldWidget::update_robot_info(void)
 
 	if ( DB_Info != NULL )
 	{
+		/* Sem informação nova e sem alterações na vista, não há nada para redesenhar */
+		if ( !sceneDirty &&
+			memcmp(lastRobotInfo, DB_Info->Robot_info, sizeof(lastRobotInfo)) == 0 &&
+			memcmp(lastRobotStatus, DB_Info->Robot_status, sizeof(lastRobotStatus)) == 0 )
+			return;
+
+		memcpy(lastRobotInfo, DB_Info->Robot_info, sizeof(lastRobotInfo));
+		memcpy(lastRobotStatus, DB_Info->Robot_status, sizeof(lastRobotStatus));
+
 		for (unsigned i=0; i<NROBOTS;i++) //mudar para o número de robots no .h
 		{
 			Robot nowRobot = DB_Info->Robot_info[i];
@@ -1989,6 +2138,7 @@ void FieldWidget::debug_point_flip (void)
 {
 	if (Debug_point_visible) Debug_point_visible =0;
 		else Debug_point_visible=1;
+	sceneDirty = true;
 
 }
 
@@ -1996,6 +2146,7 @@ void FieldWidget::obstacles_point_flip (unsigned int Robot_no, bool on_off)
 {
 	if (Robot_no < NROBOTS)
 		robot_info[Robot_no].obstacleVisible=on_off;
+	sceneDirty = true;
 
 }
 
@@ -2010,6 +2161,7 @@ void FieldWidget::debug_point_flip (unsigned int Robot_no, bool on_off)
 	if (Robot_no < NROBOTS)
 	for(int i=0;i<NDEBUG_POINTS;i++)
 		robot_info[Robot_no].Debug_point_visible[i]=on_off;
+	sceneDirty = true;
 
 }
 
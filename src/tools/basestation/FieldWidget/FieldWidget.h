@@ -24,6 +24,9 @@
 #define GLWIDGET_H
 
 #include <QGLWidget>
+#include <QGLBuffer>
+
+#include <vector>
 
 #include <geometry.h>
 #include "Robot.h"
@@ -31,6 +34,13 @@
 
 #define NDEBUG_POINTS 4
 
+/* Vértice dos buffers de desenho (posição e cor) */
+struct FieldVertex
+{
+	GLfloat x, y, z;
+	GLubyte r, g, b, a;
+};
+
 class FieldWidget : public QGLWidget
 {
     Q_OBJECT
@@ -72,14 +82,14 @@ protected:
     void keyPressEvent(QKeyEvent *event);
 
 private:
-	GLuint makeField();
-	GLuint makeRobot();
-	GLuint makeBall();
+	void makeField();
+	void makeRobot();
+	void makeBall();
 	GLuint makeSelect();
 	GLuint makeBallEngaged();
 	GLuint makeRobotAngle();
-	GLuint makeDebugPoint();
-	GLuint makeObstaclePoint();
+	void makeDebugPoint();
+	void makeObstaclePoint();
 	GLuint makeBallVel();		//added by Joao
 	GLuint makeRobotContour();		//added by Joao
 
@@ -91,15 +101,47 @@ private:
 	void move_robot(unsigned robotnum, Vec pos);
 	void robot_text (unsigned robotnum);
 
+	/* Construção das formas em memória (substitui glBegin/glVertex/glEnd) */
+	void beginShape(std::vector<FieldVertex>* target, GLenum mode);
+	void vertex(GLdouble x, GLdouble y);
+	void endShape();
+
+	/* Acrescenta uma cópia da forma transformada (como glTranslated/glRotated/glScaled) */
+	void addInstance(std::vector<FieldVertex>& out, const std::vector<FieldVertex>& shape,
+			double x, double y, double z, double angle, double scale, QColor color, double offsetY = 0.0);
+	void drawVertices(QGLBuffer& buffer, const std::vector<FieldVertex>& vertices, GLenum mode, int first, int count);
+
+
+	/* Campo: estático, enviado uma vez para a placa gráfica */
+	std::vector<FieldVertex> fieldVertices;
+	QGLBuffer fieldBuffer;
+
+	/* Formas dos objectos, em coordenadas locais */
+	std::vector<FieldVertex> robotShape;
+	std::vector<FieldVertex> ballShape;
+	std::vector<FieldVertex> debugPointShape;
+	std::vector<FieldVertex> obstacleShape;
+	GLfloat obstaclePointSize;
+
+	/* Robots, bolas, pontos de debug e obstáculos de uma frame, num só buffer */
+	std::vector<FieldVertex> frameVertices;
+	std::vector<FieldVertex> framePoints;
+	QGLBuffer frameBuffer;
+
+	std::vector<FieldVertex>* recordTarget;
+	std::vector<FieldVertex>* shapeTarget;
+	std::vector<FieldVertex> shapeVertices;
+	GLenum shapeMode;
+	QColor shapeColor;
+
+	/* Última informação desenhada, para não redesenhar sem mudanças */
+	char lastRobotInfo[sizeof(Robot)*NROBOTS];
+	char lastRobotStatus[NROBOTS];
+	bool sceneDirty;
 
-   	GLuint field;
-	GLuint robot;
-	GLuint ball;
 	GLuint select;
 	GLuint ball_engaged;
 	GLuint robotAngle;
-	GLuint debug_point;
-	GLuint obstacle_point;
 	GLuint ballVel;		//added by Joao
 	GLuint robotContour;	//added by Joao
 
@@ -23,6 +23,9 @@
 #include "FieldWidget3D.h"
 #include <vtkLineWidget.h>
 
+#include <sys/time.h>
+#include <string.h>
+
 #include "ConfigXML.h"
 
 using namespace cambada;
@@ -376,10 +379,28 @@ FieldWidget3D::FieldWidget3D(QWidget *parent) :
     heightColor = true;
     height3D = false;
     heightActor = NULL;
+    heightGrid = NULL;
 
     lockCam = false;
     top = false;
 
+    // Pooled actors, created on demand by the updates
+    labels.init(renderer, false);
+    dashedLines.init(renderer, true);
+    solidLines.init(renderer, true);
+
+    obstacleGlyphs = createGlyphs(createObstacleShape(), &obstaclePoints, &obstacleColors);
+
+    debugPtGlyphs = createGlyphs(createDebugPtShape(), &debugPtPoints, &debugPtColors);
+    debugPtGlyphs->GetProperty()->SetAmbient(1.0);
+    debugPtGlyphs->GetProperty()->SetDiffuse(0.0);
+    debugPtGlyphs->GetProperty()->SetSpecular(0.0);
+
+    statsUpdates = 0;
+    statsUpdateTime = 0.0;
+    statsRenderTime = 0.0;
+    statsHeightTiles = 0;
+
     Update_timer->start(50);
 }
 
@@ -391,13 +412,14 @@ void FieldWidget3D::update_robot_info(void)
     if(DB_Info == NULL)
         return;
 
-    // Remove all actors that need to be deleted
-    for(unsigned int i = 0; i < toDeleteActors.size(); i++)
-    {
-        renderer->RemoveActor(toDeleteActors.at(i));
-        toDeleteActors.at(i)->Delete();
-    }
-    toDeleteActors.clear();
+    struct timeval startTime, renderTime, endTime;
+    gettimeofday(&startTime, NULL);
+
+    // Obstacles and debug points are refilled on every update
+    obstaclePoints->Reset();
+    obstacleColors->Reset();
+    debugPtPoints->Reset();
+    debugPtColors->Reset();
 
     int countFreePlay=0;
     int countOther=0;
@@ -506,20 +528,11 @@ void FieldWidget3D::update_robot_info(void)
                 }
 
 
-                vtkActor* dbgPt = createDebugPt();
-                dbgPt->SetPosition(flipVal*xPos, flipVal*yPos, 0.02);
-                dbgPt->GetProperty()->SetAmbient(1.0);
-                dbgPt->GetProperty()->SetDiffuse(0.0);
-                dbgPt->GetProperty()->SetSpecular(0.0);
-                dbgPt->GetProperty()->SetColor(robotsColorR[i],robotsColorG[i],robotsColorB[i]);
-                renderer->AddActor(dbgPt);
-                toDeleteActors.push_back(dbgPt);
+                addGlyph(debugPtPoints, debugPtColors, flipVal*xPos, flipVal*yPos, 0.02,
+                         robotsColorR[i], robotsColorG[i], robotsColorB[i]);
 
-                vtkActor* dbgText = createText(QString().sprintf("%d",dp));
-                dbgText->GetProperty()->SetColor(1,1,1);
+                vtkActor* dbgText = createLabel(dp);
                 dbgText->SetScale(0.25);
-                dbgText->GetProperty()->SetAmbient(1.0);
-                dbgText->GetProperty()->SetColor(1.0,1.0,1.0);
 
                 if(camera->GetPosition()[0] > 0)
                 {
@@ -529,9 +542,6 @@ void FieldWidget3D::update_robot_info(void)
                     dbgText->SetOrientation(0,0,-90);
                     dbgText->SetPosition(flipVal*(xPos - 0.4), flipVal*(yPos + 0.14), 0.04);
                 }
-
-                renderer->AddActor(dbgText);
-                toDeleteActors.push_back(dbgText);
             }
         }
 
@@ -544,26 +554,19 @@ void FieldWidget3D::update_robot_info(void)
 
 				if ( option_draw_obstacles[i] || (nowObs.id == nowRobot.opponentDribbling) )
 				{
-					vtkActor* obstacle = createObstacle();
-                    obstacle->SetPosition(flipVal*nowObs.absCenter.x, flipVal*nowObs.absCenter.y, OBSTACLE_HEIGHT/2);
-
 					bool draw = option_draw_obstacles[i];
 					bool dribbling = nowObs.id == nowRobot.opponentDribbling;
 					// Set color according to the situation
 					if ( (!draw && dribbling) || (draw && !dribbling) )
-						obstacle->GetProperty()->SetColor(robotsColorR[i],robotsColorG[i],robotsColorB[i]);
+						addGlyph(obstaclePoints, obstacleColors, flipVal*nowObs.absCenter.x, flipVal*nowObs.absCenter.y, OBSTACLE_HEIGHT/2,
+								robotsColorR[i], robotsColorG[i], robotsColorB[i]);
 					else
-						obstacle->GetProperty()->SetColor(0,0,0);
-
-					renderer->AddActor(obstacle);
-					toDeleteActors.push_back(obstacle);
+						addGlyph(obstaclePoints, obstacleColors, flipVal*nowObs.absCenter.x, flipVal*nowObs.absCenter.y, OBSTACLE_HEIGHT/2,
+								0, 0, 0);
 
 					//JLS: DRAW OBSTACLE TEXT
-					vtkActor* dbgText = createText(QString().sprintf("%d",nowObs.id));
-					dbgText->GetProperty()->SetColor(1,1,1);
+					vtkActor* dbgText = createLabel(nowObs.id);
 					dbgText->SetScale(0.15);
-					dbgText->GetProperty()->SetAmbient(1.0);
-					dbgText->GetProperty()->SetColor(1.0,1.0,1.0);
 
 					if(camera->GetPosition()[0] > 0)
 					{
@@ -573,9 +576,6 @@ void FieldWidget3D::update_robot_info(void)
 						dbgText->SetOrientation(0,0,-90);
                         dbgText->SetPosition(flipVal*(nowObs.absCenter.x - 0.1), flipVal*(nowObs.absCenter.y + 0.15), 0.3);
 					}
-
-					renderer->AddActor(dbgText);
-					toDeleteActors.push_back(dbgText);
 				}
 			}
 		}
@@ -656,9 +656,6 @@ void FieldWidget3D::update_robot_info(void)
                         {
                             line->GetProperty()->SetColor(1,0,0); // red
                         }
-
-                        renderer->AddActor(line);
-                        toDeleteActors.push_back(line);
                     }
                 }
             }
@@ -671,20 +668,11 @@ void FieldWidget3D::update_robot_info(void)
                     // Ignore default line
                     if(DB_Info->Robot_info[i].passLine.p1 != Line::def.p1 && DB_Info->Robot_info[i].passLine.p2 != Line::def.p2 )
                     {
-                        vtkSmartPointer<vtkLineSource> line = vtkSmartPointer<vtkLineSource>::New();
-                        vtkSmartPointer<vtkPolyDataMapper> lineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-                        vtkActor* lineActor = vtkActor::New();
-
-                        line->SetPoint1(flipVal*DB_Info->Robot_info[i].passLine.p1.x, flipVal*DB_Info->Robot_info[i].passLine.p1.y, 0.05);
-                        line->SetPoint2(flipVal*DB_Info->Robot_info[i].passLine.p2.x, flipVal*DB_Info->Robot_info[i].passLine.p2.y, 0.05);
-                        lineMapper->SetInputConnection(line->GetOutputPort());
-                        lineActor->SetMapper(lineMapper);
-                        lineActor->GetProperty()->SetLineWidth(3);
-                        lineActor->GetProperty()->SetColor(0,0,0); // black line
+                        vtkActor* lineActor = createSolidLine(
+                                    flipVal*DB_Info->Robot_info[i].passLine.p1.x, flipVal*DB_Info->Robot_info[i].passLine.p1.y, 0.05,
+                                    flipVal*DB_Info->Robot_info[i].passLine.p2.x, flipVal*DB_Info->Robot_info[i].passLine.p2.y, 0.05);
 
                         lineActor->GetProperty()->SetColor(0.3,0.3,1); // red
-                        renderer->AddActor(lineActor);
-                        toDeleteActors.push_back(lineActor);
                     }
                 }
             }
@@ -739,9 +727,6 @@ void FieldWidget3D::update_robot_info(void)
                         {
                             line->GetProperty()->SetColor(1,0,0); // red
                         }
-
-                        renderer->AddActor(line);
-                        toDeleteActors.push_back(line);
                     }
                 }
             }
@@ -757,19 +742,9 @@ void FieldWidget3D::update_robot_info(void)
                     int receiverIdx = (DB_Info->Robot_info[i].coordinationFlag[0]-TryingToPass0);
                     if (receiverIdx >=0 && receiverIdx <=5)
                     {
-                        vtkSmartPointer<vtkLineSource> line = vtkSmartPointer<vtkLineSource>::New();
-                        vtkSmartPointer<vtkPolyDataMapper> lineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-                        vtkActor* lineActor = vtkActor::New();
-
-                        line->SetPoint1(flipVal*DB_Info->Robot_info[i].ball.pos.x, flipVal*DB_Info->Robot_info[i].ball.pos.y, 0.05);
-                        line->SetPoint2(flipVal*DB_Info->Robot_info[receiverIdx].coordinationVec.x, flipVal*DB_Info->Robot_info[receiverIdx].coordinationVec.y, 0.05);
-                        lineMapper->SetInputConnection(line->GetOutputPort());
-                        lineActor->SetMapper(lineMapper);
-                        lineActor->GetProperty()->SetLineWidth(3);
-                        lineActor->GetProperty()->SetColor(0,0,0); // black line
-
-                        renderer->AddActor(lineActor);
-                        toDeleteActors.push_back(lineActor);
+                        createSolidLine(
+                                    flipVal*DB_Info->Robot_info[i].ball.pos.x, flipVal*DB_Info->Robot_info[i].ball.pos.y, 0.05,
+                                    flipVal*DB_Info->Robot_info[receiverIdx].coordinationVec.x, flipVal*DB_Info->Robot_info[receiverIdx].coordinationVec.y, 0.05);
                     }
                 }
             }
@@ -777,6 +752,13 @@ void FieldWidget3D::update_robot_info(void)
         }
     }
 
+    // Hide what this update did not use
+    finishGlyphs(obstacleGlyphs, obstaclePoints, obstacleColors);
+    finishGlyphs(debugPtGlyphs, debugPtPoints, debugPtColors);
+    labels.finish();
+    dashedLines.finish();
+    solidLines.finish();
+
     updateGridView();
 
     // Score board update
@@ -790,8 +772,27 @@ void FieldWidget3D::update_robot_info(void)
     score_cambada->SetPosition(width/2 - 20, height - 35);
     score_other->SetPosition(width/2 + 20, height - 35);
     // Force render frame
+    gettimeofday(&renderTime, NULL);
     if(!renderWindow->CheckInRenderStatus())
         renderWindow->Render();
+    gettimeofday(&endTime, NULL);
+
+#if FIELD3D_STATS_PERIOD > 0
+    statsUpdateTime += (renderTime.tv_sec - startTime.tv_sec)*1000.0 + (renderTime.tv_usec - startTime.tv_usec)/1000.0;
+    statsRenderTime += (endTime.tv_sec - renderTime.tv_sec)*1000.0 + (endTime.tv_usec - renderTime.tv_usec)/1000.0;
+    statsUpdates++;
+    if(statsUpdates >= FIELD3D_STATS_PERIOD)
+    {
+        fprintf(stderr,"FieldWidget3D :: update %.2f ms, render %.2f ms, pooled actors %u, height tiles read %.1f/%d\n",
+                statsUpdateTime/statsUpdates, statsRenderTime/statsUpdates,
+                labels.size() + dashedLines.size() + solidLines.size(),
+                (double)statsHeightTiles/statsUpdates, GRIDVIEW_TILES);
+        statsUpdates = 0;
+        statsUpdateTime = 0.0;
+        statsRenderTime = 0.0;
+        statsHeightTiles = 0;
+    }
+#endif
 
     // Actualize DB_Coach_Info if a robot as been selected or if a number of ticks have passed
     /*if(taxiRole == true)
@@ -858,19 +859,22 @@ void FieldWidget3D::debug_point_flip_all (bool on_off)
 
 vtkActor* FieldWidget3D::createDashedLine(float x1, float y1, float z1, float x2, float y2, float z2)
 {
-    vtkSmartPointer<vtkLineSource> line = vtkSmartPointer<vtkLineSource>::New();
-    vtkSmartPointer<vtkPolyDataMapper> lineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    vtkActor* lineActor = vtkActor::New();
-    line->SetPoint1(x1, y1, z1);
-    line->SetPoint2(x2, y2, z2);
-    lineMapper->SetInputConnection(line->GetOutputPort());
-    lineActor->SetMapper(lineMapper);
-    lineActor->GetProperty()->SetLineWidth(3);
-    lineActor->GetProperty()->SetLineStipplePattern(0xf0f0);
-    lineActor->GetProperty()->SetLineStippleRepeatFactor(1);
-    lineActor->GetProperty()->SetPointSize(1);
-    lineActor->GetProperty()->SetLineWidth(3);
-    return lineActor;
+    ActorPool::Entry& entry = dashedLines.acquire();
+    entry.line->SetPoint1(x1, y1, z1);
+    entry.line->SetPoint2(x2, y2, z2);
+    entry.actor->GetProperty()->SetLineStipplePattern(0xf0f0);
+    entry.actor->GetProperty()->SetLineStippleRepeatFactor(1);
+    entry.actor->GetProperty()->SetPointSize(1);
+    return entry.actor;
+}
+
+vtkActor* FieldWidget3D::createSolidLine(float x1, float y1, float z1, float x2, float y2, float z2)
+{
+    ActorPool::Entry& entry = solidLines.acquire();
+    entry.line->SetPoint1(x1, y1, z1);
+    entry.line->SetPoint2(x2, y2, z2);
+    entry.actor->GetProperty()->SetColor(0,0,0); // black line
+    return entry.actor;
 }
 
 vtkSmartPointer<vtkActor> FieldWidget3D::createLine(float x1, float y1, float z1, float x2, float y2, float z2)
@@ -1056,38 +1060,87 @@ void FieldWidget3D::initBalls(vtkRenderer* renderer)
     }
 }
 
-vtkActor* FieldWidget3D::createText(QString text){
-    vtkActor* actor = vtkActor::New();
+vtkPolyDataMapper* FieldWidget3D::textMapper(int number){
+    std::map<int, vtkPolyDataMapper*>::iterator it = textMappers.find(number);
+    if(it != textMappers.end())
+        return it->second;
+
+    // One mapper per number ever shown, shared by all its labels
     vtkSmartPointer<vtkVectorText> txt = vtkSmartPointer<vtkVectorText>::New();
-    txt->SetText(text.toStdString().c_str());
-    vtkSmartPointer<vtkPolyDataMapper> txtRobotMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    txtRobotMapper->SetInput(txt->GetOutput());
-    actor->SetMapper(txtRobotMapper);
-    actor->GetProperty()->SetColor(0.0,0.0,0.0);
+    txt->SetText(QString().sprintf("%d",number).toStdString().c_str());
+    vtkPolyDataMapper* mapper = vtkPolyDataMapper::New();
+    mapper->SetInput(txt->GetOutput());
+    textMappers[number] = mapper;
+    return mapper;
+}
+
+vtkActor* FieldWidget3D::createLabel(int number){
+    vtkActor* actor = labels.acquire().actor;
+    actor->SetMapper(textMapper(number));
+    actor->GetProperty()->SetColor(1.0,1.0,1.0);
     actor->GetProperty()->SetAmbient(1.0);
-    actor->SetOrientation(0,0,90);
     return actor;
 }
 
-vtkActor* FieldWidget3D::createObstacle(){
-    // Obstacle actors
+vtkActor* FieldWidget3D::createGlyphs(vtkPolyDataAlgorithm* shape, vtkPoints** points, vtkUnsignedCharArray** colors){
+    *points = vtkPoints::New();
+    *colors = vtkUnsignedCharArray::New();
+    (*colors)->SetNumberOfComponents(3);
+
+    vtkSmartPointer<vtkPolyData> data = vtkSmartPointer<vtkPolyData>::New();
+    data->SetPoints(*points);
+    data->GetPointData()->SetScalars(*colors);
+
+    // One copy of the shape on each point, colored by the point
+    vtkSmartPointer<vtkGlyph3D> glyph = vtkSmartPointer<vtkGlyph3D>::New();
+    glyph->SetSourceConnection(shape->GetOutputPort());
+    glyph->SetInput(data);
+    glyph->ScalingOff();
+    glyph->OrientOff();
+    glyph->SetColorModeToColorByScalar();
+    shape->Delete();
+
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputConnection(glyph->GetOutputPort());
+    mapper->ScalarVisibilityOn();
+    mapper->SetScalarModeToUsePointData();
+    mapper->SetColorModeToDefault();
+
+    vtkActor* actor = vtkActor::New();
+    actor->SetMapper(mapper);
+    actor->SetVisibility(0);
+    renderer->AddActor(actor);
+    return actor;
+}
+
+void FieldWidget3D::addGlyph(vtkPoints* points, vtkUnsignedCharArray* colors, double x, double y, double z, float r, float g, float b){
+    points->InsertNextPoint(x, y, z);
+    colors->InsertNextTuple3(r*255.0, g*255.0, b*255.0);
+}
+
+void FieldWidget3D::finishGlyphs(vtkActor* actor, vtkPoints* points, vtkUnsignedCharArray* colors){
+    points->Modified();
+    colors->Modified();
+    actor->SetVisibility(points->GetNumberOfPoints() > 0);
+}
+
+vtkPolyDataAlgorithm* FieldWidget3D::createObstacleShape(){
+    // Obstacle shape
     vtkSmartPointer<vtkCylinderSource> cylinder = vtkSmartPointer<vtkCylinderSource>::New();
     cylinder->SetRadius(0.25);
     cylinder->SetHeight(OBSTACLE_HEIGHT);
     cylinder->SetResolution(12);
-    vtkSmartPointer<vtkPolyDataMapper> cylinderMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    cylinderMapper->SetInput(cylinder->GetOutput());
 
-    vtkActor* obstacleActor = vtkActor::New();
-    obstacleActor->SetMapper(cylinderMapper);
-    obstacleActor->GetProperty()->SetColor(0,0,0);
-    //obstacleActor->GetProperty()->SetRepresentationToWireframe();
-    obstacleActor->RotateX(90); // Rotate 90 degrees in XX axis
+    vtkSmartPointer<vtkTransform> rotation = vtkSmartPointer<vtkTransform>::New();
+    rotation->RotateX(90); // Rotate 90 degrees in XX axis
 
-    return obstacleActor;
+    vtkTransformPolyDataFilter* shape = vtkTransformPolyDataFilter::New();
+    shape->SetInputConnection(cylinder->GetOutputPort());
+    shape->SetTransform(rotation);
+    return shape;
 }
 
-vtkActor* FieldWidget3D::createDebugPt(){
+vtkPolyDataAlgorithm* FieldWidget3D::createDebugPtShape(){
     // Setup four points
       vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
       float zz = 0.00;
@@ -1122,15 +1175,13 @@ vtkActor* FieldWidget3D::createDebugPt(){
       polygonPolyData->SetPoints(points);
       polygonPolyData->SetPolys(polygons);
 
-      // Create a mapper and actor
-      vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-      mapper->SetInput(polygonPolyData);
-
-      vtkActor* actor = vtkActor::New();
-      actor->SetMapper(mapper);
-      actor->RotateZ(45);
+      vtkSmartPointer<vtkTransform> rotation = vtkSmartPointer<vtkTransform>::New();
+      rotation->RotateZ(45);
 
-      return actor;
+      vtkTransformPolyDataFilter* shape = vtkTransformPolyDataFilter::New();
+      shape->SetInput(polygonPolyData);
+      shape->SetTransform(rotation);
+      return shape;
 }
 
 void FieldWidget3D::updateGridView()
@@ -1149,133 +1200,141 @@ void FieldWidget3D::updateGridView()
     heightActor->SetVisibility(1);
     heightActor->GetProperty()->SetOpacity(0.8);
 
-    // GRID SIZE: 81x57
-
-    //int sizeL = 81;
-    //int sizeW = 57;
-    //double resolution = 0.25;
-    double xx, yy, zz;
-    double minz = 2010.0;
-    double maxz = -2010.0;
-    int i = 0;
+    // Header first: it has the version of every tile
+    GridView& grid = *heightGrid;
+    int oldVersion[GRIDVIEW_TILES];
+    int oldCount = grid.count;
+    memcpy(oldVersion, grid.tileVersion, sizeof(oldVersion));
 
-    //addtions
-    GridView grid;
-    DB_get(0,GRIDVIEW, &grid);
-    if(grid.count > 0)
+    if(DB_get_range(0, GRIDVIEW, 0, GridView::headerSize(), &grid) == -1 || grid.count <= 0)
     {
+        heightActor->SetVisibility(0);
+        return;
+    }
 
-    	for(int i=0;i<grid.count;i++)
-    	{
-    		xx=grid.grid[i].pos.x;
-    		yy=grid.grid[i].pos.y;
-    		float realVal = grid.grid[i].val;
-
-    		if(!height3D)
-    			zz = -0.01;
-    		else
-    			zz = realVal;
-    		heightPoints->SetPoint(i, xx,yy,zz);
-
-    		if(i==0)
-    		{
-    			minz = realVal;
-    			maxz = realVal;
-    		}else{
-    			if(realVal < minz)
-    				minz = realVal;
-    			if(realVal > maxz)
-    				maxz = realVal;
-    		}
-    		//cout<<"XX="<<xx<<" YY="<<yy<<" ZZ="<<zz<<" I="<<i<<endl;
-
-    	}
-
-    }else{
-    	minz = 0.0;
-    	maxz = 0.0;
+    // A new layout (first map) rebuilds the whole grid
+    bool full = false;
+    if(grid.count != oldCount)
+    {
+        heightData->SetDimensions(grid.width, grid.length, 1);
+        heightPoints->SetNumberOfPoints(grid.count);
+        heightColors->SetNumberOfTuples(grid.count);
+        full = true;
     }
 
-    if(height3D)
+    bool changed[GRIDVIEW_TILES];
+    int nChanged = 0;
+    for(int t = 0; t < GRIDVIEW_TILES; t++)
     {
-        for(int j = 0; j < i; j++)
+        changed[t] = full || grid.tileVersion[t] != oldVersion[t];
+        if(changed[t])
         {
-            heightPoints->SetPoint(j, heightPoints->GetPoint(j)[0],heightPoints->GetPoint(j)[1],heightPoints->GetPoint(j)[2] - minz);
+            DB_get_range(0, GRIDVIEW, GridView::tileOffset(t), sizeof(grid.tile[t]), grid.tile[t]);
+            nChanged++;
         }
     }
+    statsHeightTiles += nChanged;
 
-    heightPolyData->SetPoints(heightPoints);
-    heightDelaunay->SetInput(heightPolyData);
-    heightDelaunay->Update();
-    heightPolyDataAfterInterp  = heightDelaunay->GetOutput();
-
-    // Create the color map
-    vtkSmartPointer<vtkLookupTable> colorLookupTable = vtkSmartPointer<vtkLookupTable>::New();
-    colorLookupTable->SetTableRange(minz, maxz);
+    if(nChanged == 0 && height3D == heightShown3D && heightColor == heightShownColor)
+        return;
 
-    if(heightColor)
+    // Colours and heights are relative to the range, all cells change with it
+    float minz = grid.val(0, 0);
+    float maxz = minz;
+    for(int x = 0; x < grid.width; x++)
     {
-        colorLookupTable->SetValueRange(1, 1);
-        colorLookupTable->SetSaturationRange(1, 1);
-        //colorLookupTable->SetHueRange(0, 1);
-    }
-    else
-    {
-        colorLookupTable->SetValueRange(0, 1);
-        colorLookupTable->SetSaturationRange(0, 0);
-        //colorLookupTable->SetHueRange(0, 0);
+        for(int y = 0; y < grid.length; y++)
+        {
+            float v = grid.val(x, y);
+            if(v < minz)
+                minz = v;
+            if(v > maxz)
+                maxz = v;
+        }
     }
-    colorLookupTable->Build();
-
-    // Generate the colors for each point based on the color map
-    vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
-    colors->SetNumberOfComponents(3);
 
-    for(int i = 0; i < heightPolyDataAfterInterp->GetNumberOfPoints(); i++)
+    if(full || minz != heightMin || maxz != heightMax ||
+       height3D != heightShown3D || heightColor != heightShownColor)
     {
-        double p[3];
-        heightPolyDataAfterInterp->GetPoint(i,p);
+        heightMin = minz;
+        heightMax = maxz;
+        heightShown3D = height3D;
+        heightShownColor = heightColor;
 
-        double dcolor[3];
-        colorLookupTable->GetColor(grid.grid[i].val, dcolor);
-        unsigned char color[3];
-        for(unsigned int j = 0; j < 3; j++)
+        heightLut->SetTableRange(minz, maxz);
+        if(heightColor)
         {
-            color[j] = static_cast<unsigned char>(255.0 * dcolor[j]);
+            heightLut->SetValueRange(1, 1);
+            heightLut->SetSaturationRange(1, 1);
         }
-        colors->InsertNextTupleValue(color);
+        else
+        {
+            heightLut->SetValueRange(0, 1);
+            heightLut->SetSaturationRange(0, 0);
+        }
+        heightLut->ForceBuild();
+
+        for(int t = 0; t < GRIDVIEW_TILES; t++)
+            changed[t] = true;
     }
 
-    heightPolyDataAfterInterp->GetPointData()->SetScalars(colors);
-}
+    for(int t = 0; t < GRIDVIEW_TILES; t++)
+    {
+        if(changed[t])
+            updateGridTile(t);
+    }
 
-void FieldWidget3D::initGridView(){
+    heightPoints->Modified();
+    heightColors->Modified();
+}
 
-    heightPoints = vtkPoints::New(); // Create a grid of points (height/terrian map)
-    heightPolyData = vtkPolyData::New();
-    heightDelaunay = vtkDelaunay2D::New();
+void FieldWidget3D::updateGridTile(int tile)
+{
+    const GridView& grid = *heightGrid;
+    int x0 = (tile % GRIDVIEW_TILES_X) * GRIDVIEW_TILE;
+    int y0 = (tile / GRIDVIEW_TILES_X) * GRIDVIEW_TILE;
 
-    int sizeL = 81;
-    int sizeW = 57;
-    float resolution = 0.25;
-    for(int x = -sizeW/2; x <= sizeW/2; x++)
+    for(int y = y0; y < y0 + GRIDVIEW_TILE && y < grid.length; y++)
     {
-        for(int y = -sizeL/2; y <= sizeL/2; y++)
+        for(int x = x0; x < x0 + GRIDVIEW_TILE && x < grid.width; x++)
         {
-            heightPoints->InsertNextPoint(x*resolution, y*resolution, x*resolution*y*resolution);
+            float val = grid.val(x, y);
+            Vec pos = grid.pos(x, y);
+            int id = y * grid.width + x;
+
+            heightPoints->SetPoint(id, pos.x, pos.y, height3D ? val - heightMin : -0.01);
+
+            double dcolor[3];
+            unsigned char color[3];
+            heightLut->GetColor(val, dcolor);
+            for(unsigned int j = 0; j < 3; j++)
+                color[j] = static_cast<unsigned char>(255.0 * dcolor[j]);
+            heightColors->SetTupleValue(id, color);
         }
     }
+}
+
+void FieldWidget3D::initGridView(){
+
+    heightGrid = new GridView;
+    memset(heightGrid, 0, sizeof(GridView));
+    heightMin = heightMax = 0;
+    heightShown3D = height3D;
+    heightShownColor = heightColor;
 
-    heightPolyData->SetPoints(heightPoints); // Add the grid points to a polydata object
-    heightDelaunay->SetInput(heightPolyData);
+    // Structured grid, with the points and colours updated in place
+    heightPoints = vtkPoints::New();
+    heightColors = vtkUnsignedCharArray::New();
+    heightColors->SetNumberOfComponents(3);
+    heightLut = vtkLookupTable::New();
 
-    // Triangulate the grid points
-    heightDelaunay->Update();
-    heightPolyDataAfterInterp = heightDelaunay->GetOutput();
+    heightData = vtkStructuredGrid::New();
+    heightData->SetPoints(heightPoints);
+    heightData->GetPointData()->SetScalars(heightColors);
 
     // Create a mapper and actor
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputConnection(heightPolyDataAfterInterp->GetProducerPort());
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInput(heightData);
     heightActor = vtkActor::New();
     heightActor->SetMapper(mapper);
     heightActor->SetVisibility(0);
@@ -1293,17 +1352,19 @@ void FieldWidget3D::deleteGridView(){
 
     renderer->RemoveActor(heightActor);
 
-    heightDelaunay->Delete();
-    heightPolyDataAfterInterp->Delete();
-    heightPolyData->Delete();
+    heightActor->Delete();
+    heightData->Delete();
+    heightLut->Delete();
+    heightColors->Delete();
     heightPoints->Delete();
+    delete heightGrid;
 
     heightActor = NULL;
-    heightDelaunay = NULL;
-    heightPolyDataAfterInterp = NULL;
-    heightPolyData = NULL;
+    heightData = NULL;
+    heightLut = NULL;
+    heightColors = NULL;
     heightPoints = NULL;
-
+    heightGrid = NULL;
 }
 
 void FieldWidget3D::setTop(bool top)
@@ -1332,3 +1393,53 @@ void FieldWidget3D::lock(bool lock)
 {
     this->lockCam = lock;
 }
+
+ActorPool::~ActorPool()
+{
+    for(unsigned int i = 0; i < entries.size(); i++)
+    {
+        if(renderer != NULL)
+            renderer->RemoveActor(entries[i].actor);
+        entries[i].actor->Delete();
+        if(entries[i].line != NULL)
+            entries[i].line->Delete();
+    }
+}
+
+void ActorPool::init(vtkRenderer* renderer, bool lines)
+{
+    this->renderer = renderer;
+    this->lines = lines;
+}
+
+ActorPool::Entry& ActorPool::acquire()
+{
+    if(used == entries.size())
+    {
+        Entry entry;
+        entry.actor = vtkActor::New();
+        entry.line = NULL;
+
+        if(lines)
+        {
+            entry.line = vtkLineSource::New();
+            vtkSmartPointer<vtkPolyDataMapper> lineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+            lineMapper->SetInputConnection(entry.line->GetOutputPort());
+            entry.actor->SetMapper(lineMapper);
+            entry.actor->GetProperty()->SetLineWidth(3);
+        }
+
+        renderer->AddActor(entry.actor);
+        entries.push_back(entry);
+    }
+
+    entries[used].actor->SetVisibility(1);
+    return entries[used++];
+}
+
+void ActorPool::finish()
+{
+    for(unsigned int i = used; i < entries.size(); i++)
+        entries[i].actor->SetVisibility(0);
+    used = 0;
+}
@@ -65,10 +65,14 @@
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
 #include <vtkPropCollection.h>
-#include <vtkDelaunay2D.h>
+#include <vtkStructuredGrid.h>
 #include <vtkLookupTable.h>
 #include <vtkMath.h>
 #include <vtkPointData.h>
+#include <vtkGlyph3D.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <map>
 
 #include <QVTKInteractor.h>
 
@@ -78,6 +82,41 @@
 #include "Vec.h"
 
 #define OBSTACLE_HEIGHT 0.2
+#ifndef FIELD3D_STATS_PERIOD
+#define FIELD3D_STATS_PERIOD 0		// updates between two frame time reports on stderr, 0 to disable (-DFIELD3D_STATS_PERIOD=200)
+#endif
+
+/* Actors kept from one update to the next
+ *
+ * Each update acquires the actors it needs, changing only their position
+ * and properties; finish() hides the ones that were not acquired. Actors
+ * are only created when an update needs more than any update before.
+ */
+class ActorPool
+{
+public:
+    struct Entry
+    {
+        vtkActor* actor;
+        vtkLineSource* line;    // only for pools of lines
+    };
+
+    ActorPool() : renderer(NULL), lines(false), used(0) {}
+    ~ActorPool();
+
+    void init(vtkRenderer* renderer, bool lines);
+
+    Entry& acquire();
+    void finish();
+
+    unsigned int size() const { return entries.size(); }
+
+private:
+    vtkRenderer* renderer;
+    bool lines;
+    unsigned int used;
+    std::vector<Entry> entries;
+};
 
 class FieldWidget3D : public QVTKWidget
 {
@@ -134,12 +173,18 @@ private:
     void initBalls(vtkRenderer* renderer);
     void initGridView();
     void updateGridView();
+    void updateGridTile(int tile);
     void deleteGridView();
 
-    vtkActor* createText(QString text);
-    vtkActor* createObstacle();
-    vtkActor* createDebugPt();
+    vtkPolyDataMapper* textMapper(int number);
+    vtkActor* createLabel(int number);
     vtkActor* createDashedLine(float x1, float y1, float z1, float x2, float y2, float z2);
+    vtkActor* createSolidLine(float x1, float y1, float z1, float x2, float y2, float z2);
+    vtkActor* createGlyphs(vtkPolyDataAlgorithm* shape, vtkPoints** points, vtkUnsignedCharArray** colors);
+    vtkPolyDataAlgorithm* createObstacleShape();
+    vtkPolyDataAlgorithm* createDebugPtShape();
+    void addGlyph(vtkPoints* points, vtkUnsignedCharArray* colors, double x, double y, double z, float r, float g, float b);
+    void finishGlyphs(vtkActor* actor, vtkPoints* points, vtkUnsignedCharArray* colors);
     void createDot(vtkRenderer* renderer, float x, float y, bool black, float radius=0.05);
 
 
@@ -154,12 +199,34 @@ private:
     vtkLineSource* velocityLineSrc;
     vtkActor* velocityLine;
 
-    vector<vtkActor*> toDeleteActors;
-
+    // Actors reused on every update
+    ActorPool labels;
+    ActorPool dashedLines;
+    ActorPool solidLines;
+    std::map<int, vtkPolyDataMapper*> textMappers;
+
+    // Obstacles and debug points of all the robots, drawn as one actor each
+    vtkActor* obstacleGlyphs;
+    vtkPoints* obstaclePoints;
+    vtkUnsignedCharArray* obstacleColors;
+    vtkActor* debugPtGlyphs;
+    vtkPoints* debugPtPoints;
+    vtkUnsignedCharArray* debugPtColors;
+
+    // Frame time counters
+    unsigned int statsUpdates;
+    double statsUpdateTime;
+    double statsRenderTime;
+    unsigned int statsHeightTiles;
+
+    // Height map: local copy of GRIDVIEW, only the tiles with a new version are read
+    GridView* heightGrid;
+    float heightMin, heightMax;
+    bool heightShown3D, heightShownColor;
     vtkPoints* heightPoints;
-    vtkPolyData* heightPolyData;
-    vtkDelaunay2D* heightDelaunay;
-    vtkPolyData* heightPolyDataAfterInterp;
+    vtkUnsignedCharArray* heightColors;
+    vtkStructuredGrid* heightData;
+    vtkLookupTable* heightLut;
     vtkActor* heightActor;
 
     float robotsColorR[6];
@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogFile.h"
+
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <iostream>
+
+using namespace std;
+
+// The header must keep its size on every build
+typedef char LogFileHeaderSizeCheck[(sizeof(LogFileHeader) == LOGFILE_HEADER_SIZE) ? 1 : -1];
+
+LogFile::LogFile()
+{
+	data = NULL;
+	dataSize = 0;
+	frameCount = 0;
+	frames = NULL;
+}
+
+LogFile::~LogFile()
+{
+	close();
+}
+
+bool LogFile::open(const char* path)
+{
+	int fd;
+	struct stat st;
+	const LogFileHeader* header;
+
+	close();
+
+	if ((fd = ::open(path, O_RDONLY)) < 0)
+	{
+		perror("LogFile :: open");
+		return false;
+	}
+
+	if (fstat(fd, &st) < 0 || st.st_size < LOGFILE_HEADER_SIZE)
+	{
+		fprintf(stderr, "LogFile :: %s is not a binary log\n", path);
+		::close(fd);
+		return false;
+	}
+
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		perror("LogFile :: mmap");
+		data = NULL;
+		return false;
+	}
+	dataSize = st.st_size;
+
+	header = (const LogFileHeader*)data;
+	if (memcmp(header->magic, LOGFILE_MAGIC, sizeof(header->magic)) != 0
+		|| header->version != LOGFILE_VERSION)
+	{
+		fprintf(stderr, "LogFile :: %s is not a binary log\n", path);
+		close();
+		return false;
+	}
+
+	if (header->recordSize != sizeof(Log_Information) || header->nRobots != NROBOTS)
+	{
+		fprintf(stderr, "LogFile :: %s was written by an incompatible build (record %u, expected %u)\n",
+				path, header->recordSize, (unsigned int)sizeof(Log_Information));
+		close();
+		return false;
+	}
+
+	// Records are read in place, so they must be aligned
+	if (header->headerSize < LOGFILE_HEADER_SIZE
+		|| header->headerSize % __alignof__(Log_Information) != 0
+		|| header->frameCount > UINT_MAX)
+	{
+		fprintf(stderr, "LogFile :: %s has an invalid header\n", path);
+		close();
+		return false;
+	}
+
+	if (header->headerSize > dataSize
+		|| header->frameCount > (dataSize - header->headerSize) / header->recordSize)
+	{
+		fprintf(stderr, "LogFile :: %s is truncated\n", path);
+		close();
+		return false;
+	}
+
+	frameCount = header->frameCount;
+	frames = (const Log_Information*)((const char*)data + header->headerSize);
+
+	// The slider seeks anywhere and playback steps both ways: no readahead
+	// past the frame read, and no early dropping of the pages behind it.
+	// LogPrefetch brings in the frames around the playhead.
+	madvise(data, dataSize, MADV_RANDOM);
+
+	return true;
+}
+
+void LogFile::close()
+{
+	if (data != NULL)
+		munmap(data, dataSize);
+
+	data = NULL;
+	dataSize = 0;
+	frameCount = 0;
+	frames = NULL;
+}
+
+bool LogFile::isBinaryLog(const char* path)
+{
+	char magic[8];
+	bool result = false;
+	FILE* file = fopen(path, "r");
+
+	if (file == NULL)
+		return false;
+
+	if (fread(magic, 1, sizeof(magic), file) == sizeof(magic))
+		result = (memcmp(magic, LOGFILE_MAGIC, sizeof(magic)) == 0);
+
+	fclose(file);
+	return result;
+}
+
+int LogFile::loadXML(FILE* LoadLogFile, std::deque<Log_Information>& LogInfo)
+{
+	int nItems=0;
+	bool exitLoad = false;
+	Log_Information LI;
+
+	//FIXME protection that should not exist if the file never got corrupted
+	int nTries = 0;
+
+	fscanf(LoadLogFile, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n<Root>\n");
+
+	while( exitLoad == false )
+	{
+		nItems = fscanf(LoadLogFile, "<Instance gametime=\"%d\" gamestate=\"%d\" cambada=\"%d\" mf=\"%d\" formation=\"%d\">\n",
+				&(LI.coach.time) , &(LI.coach.gameState), &(LI.coach.ourGoals), &(LI.coach.theirGoals), &(LI.finfo.formationIdFreePlay));//FIXME need to add new formationIdSP
+
+		if(nItems!=5)
+		{
+			if (nItems!=EOF) {
+				//FIXME protection that should not exist if the file never got corrupted
+				char dummy[5000];
+				fgets(dummy, 5000, LoadLogFile);
+				nTries++;
+				cerr << "LOGPLAYER ERROR loading header - Try " << nTries << endl;
+				continue;
+			} else {
+				cerr << "LOGPLAYER ERROR loading header - items " << nItems << endl;
+				break;
+			}
+		}
+
+		for( int i = 0 ; i < NROBOTS ; i++ )
+		{
+			int id, running, rAuto, coaching, oppDribbling, visible, engaged, airborne, own;
+			int nObst, nRole, nBehavior, nTeamColor, nGoalColor, nGameState;
+			unsigned int nIt;
+
+			char currentLine[2048];
+
+			fgets(currentLine, 2048, LoadLogFile);
+
+			nIt = sscanf(currentLine, "<Agent id=\"%d\" running=\"%d\" robotx=\"%f\" roboty=\"%f\" orientation=\"%f\""
+								  " velx=\"%f\" vely=\"%f\" vela=\"%f\" role=\"%d\" behavior=\"%d\" stuck=\"%c\""
+								  " sposid=\"%d\" nobst=\"%d\" visible=\"%d\" own=\"%d\" engaged=\"%d\" airborne=\"%d\""
+								  " absx=\"%f\" absy=\"%f\" relx=\"%f\" rely=\"%f\" z=\"%f\" ballvelx=\"%f\" ballvely=\"%f\""
+								  " bat1=\"%f\" bat2=\"%f\""
+								  " bat3=\"%f\" oppDribbling=\"%d\" coaching=\"%d\" roleAuto=\"%d\" teamColor=\"%d\""
+								  " goalColor=\"%d\" gameState=\"%d\" coordFlag1=\"%d\" coordFlag2=\"%d\" cVecx=\"%f\""
+								  " cVecy=\"%f\" dPoint0x=\"%f\" dPoint0y=\"%f\" dPoint1x=\"%f\" dPoint1y=\"%f\""
+								  " dPoint2x=\"%f\" dPoint2y=\"%f\" dPoint3x=\"%f\" dPoint3y=\"%f\">\n",
+						&id, &running, &(LI.robot[i].pos.x), &(LI.robot[i].pos.y),
+						&(LI.robot[i].orientation), &(LI.robot[i].vel.x), &(LI.robot[i].vel.y),
+						&(LI.robot[i].angVelocity), &nRole, &nBehavior,
+						&(LI.robot[i].stuck), &(LI.finfo.posId[i]), &nObst,
+						&visible, &own, &engaged, &airborne, &(LI.robot[i].ball.pos.x), &(LI.robot[i].ball.pos.y),
+						&(LI.robot[i].ball.posRel.x), &(LI.robot[i].ball.posRel.y),
+						&(LI.robot[i].ball.height), &(LI.robot[i].ball.vel.x), &(LI.robot[i].ball.vel.y),
+						&(LI.robot[i].battery[0]), &(LI.robot[i].battery[1]), &(LI.robot[i].battery[2]), &oppDribbling,
+						&coaching, &rAuto, &nTeamColor, &nGoalColor,
+						&nGameState, &(LI.robot[i].coordinationFlag[0]),
+						&(LI.robot[i].coordinationFlag[1]), &(LI.robot[i].coordinationVec.x),
+						&(LI.robot[i].coordinationVec.y), &(LI.robot[i].debugPoints[0].x), &(LI.robot[i].debugPoints[0].y),
+						&(LI.robot[i].debugPoints[1].x), &(LI.robot[i].debugPoints[1].y), &(LI.robot[i].debugPoints[2].x),
+						&(LI.robot[i].debugPoints[2].y), &(LI.robot[i].debugPoints[3].x), &(LI.robot[i].debugPoints[3].y) );
+
+			if(nIt!=45)
+			{
+				cerr << "LOGPLAYER ERROR loading record with " << nIt << " items." << endl;
+				exitLoad = true;
+				break;
+			}
+
+			if (nObst < 0 || nObst > MAX_SHARED_OBSTACLES)
+			{
+				cerr << "LOGPLAYER ERROR loading record with " << nObst << " obstacles." << endl;
+				exitLoad = true;
+				break;
+			}
+			LI.robot[i].nObst = nObst;
+
+			nIt = 0;
+
+			for( unsigned int oo = 0 ; oo < LI.robot[i].nObst ; oo++ )
+			{
+				float trash;
+				int obstId = 0;
+				fgets(currentLine, 2048, LoadLogFile);
+
+				nIt += sscanf(currentLine, "<Obst obstx=\"%f\" obsty=\"%f\" size=\"%f\" teammate=\"%d\"/>\n",
+						&(LI.robot[i].obstacles[oo].absCenter.x),&(LI.robot[i].obstacles[oo].absCenter.y), &trash,
+						&obstId);
+				LI.robot[i].obstacles[oo].id = obstId;
+			}
+
+			if( nIt !=  (4 * LI.robot[i].nObst) )
+			{
+				cerr << "LOGPLAYER ERROR loading obst: AGENT "<< i <<" has "<< LI.robot[i].nObst << "obs, total items "<< nIt << endl;
+				exitLoad = true;
+				break;
+			}
+
+			LI.robot[i].role = (RoleID)nRole;
+			LI.robot[i].behaviour = (BehaviourID)nBehavior;
+			LI.robot[i].teamColor = (WSColor)nTeamColor;
+			LI.robot[i].goalColor = (WSColor)nGoalColor;
+			LI.robot[i].currentGameState = (WSGameState)nGameState;
+
+			LI.robot[i].opponentDribbling = oppDribbling;
+			LI.robot[i].running = (running != 0);
+			LI.robot[i].roleAuto = (rAuto != 0);
+			LI.robot[i].coaching = (coaching != 0);
+			LI.robot[i].ball.visible = (visible != 0);
+			LI.robot[i].ball.engaged = (engaged != 0);
+			LI.robot[i].ball.airborne = (airborne != 0);
+			LI.robot[i].ball.own = (own != 0);
+
+			fgets(currentLine, 2048, LoadLogFile);
+		}
+
+		if (exitLoad)
+			break;
+
+		fscanf(LoadLogFile, "</Instance>\n");
+		LogInfo.push_back(LI);
+	}
+
+	cerr << "nFrames " << LogInfo.size() << endl;
+
+	return LogInfo.size();
+}
+
+LogFileWriter::LogFileWriter()
+{
+	file = NULL;
+	frameCount = 0;
+}
+
+LogFileWriter::~LogFileWriter()
+{
+	if (file != NULL)
+		close();
+}
+
+bool LogFileWriter::open(const char* path)
+{
+	LogFileHeader header;
+
+	if ((file = fopen(path, "w")) == NULL)
+	{
+		perror("LogFileWriter :: open");
+		return false;
+	}
+
+	frameCount = 0;
+
+	// Placeholder, the real header is written by close()
+	memset(&header, 0, sizeof(header));
+	if (fwrite(&header, sizeof(header), 1, file) != 1)
+	{
+		perror("LogFileWriter :: write");
+		fclose(file);
+		file = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+bool LogFileWriter::append(const Log_Information& frame)
+{
+	if (file == NULL)
+		return false;
+
+	if (fwrite(&frame, sizeof(frame), 1, file) != 1)
+	{
+		perror("LogFileWriter :: write");
+		return false;
+	}
+
+	frameCount++;
+	return true;
+}
+
+bool LogFileWriter::close()
+{
+	LogFileHeader header;
+	bool result = true;
+
+	if (file == NULL)
+		return false;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LOGFILE_MAGIC, sizeof(header.magic));
+	header.version = LOGFILE_VERSION;
+	header.headerSize = sizeof(header);
+	header.recordSize = sizeof(Log_Information);
+	header.nRobots = NROBOTS;
+	header.frameCount = frameCount;
+
+	// The header goes last, a log cut short is never taken for a valid one
+	if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1)
+		result = false;
+
+	if (fclose(file) != 0)
+		result = false;
+
+	if (!result)
+		perror("LogFileWriter :: close");
+
+	file = NULL;
+	frameCount = 0;
+
+	return result;
+}
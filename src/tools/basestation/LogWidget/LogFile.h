@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOGFILE_H
+#define __LOGFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <deque>
+
+#include "DB_Robot_info.h"
+
+using namespace cambada;
+
+class Log_Information
+{
+	public:
+	FormationInfo finfo;
+	CoachInfo coach;
+	Robot robot[NROBOTS];
+};
+
+/* Binary game log (.cblog)
+ *
+ *   LogFileHeader                  fixed, LOGFILE_HEADER_SIZE bytes
+ *   Log_Information[frameCount]    one fixed size record per frame
+ *
+ * Records are the in-memory Log_Information, so a log is only valid for
+ * the build that wrote it; the header keeps the record size to reject
+ * logs of other builds. Since records have a fixed size, frame i is at
+ * headerSize + i * recordSize and the file is read in place through mmap.
+ */
+#define LOGFILE_MAGIC		"CBLOG01"
+#define LOGFILE_VERSION		2
+#define LOGFILE_HEADER_SIZE	64
+
+struct LogFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t recordSize;
+	uint32_t nRobots;
+	uint64_t frameCount;
+	char reserved[LOGFILE_HEADER_SIZE - 32];
+};
+
+/* Read-only binary log, mapped in memory */
+class LogFile
+{
+public:
+	LogFile();
+	~LogFile();
+
+	bool open(const char* path);
+	void close();
+	bool isOpen() const { return data != NULL; }
+
+	unsigned int size() const { return frameCount; }
+
+	/* Frame i (0 based), no copy */
+	const Log_Information& frame(unsigned int i) const { return frames[i]; }
+
+	/* Whether the file starts with a binary log header */
+	static bool isBinaryLog(const char* path);
+
+	/* Parse a text (XML) log, returns the number of frames read */
+	static int loadXML(FILE* file, std::deque<Log_Information>& frames);
+
+private:
+	void* data;
+	size_t dataSize;
+	unsigned int frameCount;
+	const Log_Information* frames;
+};
+
+/* Sequential writer of binary logs */
+class LogFileWriter
+{
+public:
+	LogFileWriter();
+	~LogFileWriter();
+
+	bool open(const char* path);
+	bool append(const Log_Information& frame);
+
+	/* Write the final header */
+	bool close();
+
+	unsigned int size() const { return frameCount; }
+
+private:
+	FILE* file;
+	unsigned int frameCount;
+};
+
+#endif
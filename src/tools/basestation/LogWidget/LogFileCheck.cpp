@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Round trip and validation check of the binary log format
+ *
+ * Logs of random frames are written and read back, every frame must come
+ * back unchanged. Then the header of a valid log is damaged in the ways
+ * open() has to catch (magic, version, record size, header size and
+ * alignment, frame count, truncation) and every one must be rejected.
+ *
+ * Usage: logfile-check [directory]
+ */
+
+#include "LogFile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static string path;
+static int failures = 0;
+
+static void fail(const char* what)
+{
+	cerr << "logfile-check: " << what << endl;
+	failures++;
+}
+
+static void randomFrame(Log_Information& frame)
+{
+	unsigned char* p = (unsigned char*)&frame;
+
+	for (unsigned int i = 0; i < sizeof(frame); i++)
+		p[i] = rand() & 0xff;
+}
+
+static bool writeLog(const vector<Log_Information>& frames)
+{
+	LogFileWriter writer;
+
+	if (!writer.open(path.c_str()))
+		return false;
+
+	for (unsigned int i = 0; i < frames.size(); i++)
+		if (!writer.append(frames[i]))
+			return false;
+
+	return writer.close();
+}
+
+static void roundTrip(unsigned int n)
+{
+	vector<Log_Information> frames(n);
+	LogFile reader;
+
+	for (unsigned int i = 0; i < n; i++)
+		randomFrame(frames[i]);
+
+	if (!writeLog(frames))
+	{
+		fail("writing a log failed");
+		return;
+	}
+
+	if (!LogFile::isBinaryLog(path.c_str()) || !reader.open(path.c_str()))
+	{
+		fail("a written log does not open");
+		return;
+	}
+
+	if (reader.size() != n)
+	{
+		fail("the frame count changed");
+		return;
+	}
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (memcmp(&reader.frame(i), &frames[i], sizeof(Log_Information)) != 0)
+		{
+			fail("a frame changed after the round trip");
+			return;
+		}
+	}
+}
+
+/* Patch a header field of the log at path */
+static void patch(size_t offset, const void* value, size_t size)
+{
+	FILE* file = fopen(path.c_str(), "r+");
+
+	if (file == NULL || fseek(file, offset, SEEK_SET) != 0
+		|| fwrite(value, size, 1, file) != 1)
+		fail("patching the header failed");
+
+	if (file != NULL)
+		fclose(file);
+}
+
+static void patch32(size_t offset, uint32_t value) { patch(offset, &value, sizeof(value)); }
+static void patch64(size_t offset, uint64_t value) { patch(offset, &value, sizeof(value)); }
+
+/* Write a valid log, damage it and check that open() rejects it */
+static void damaged(const char* what, void (*damage)())
+{
+	vector<Log_Information> frames(4);
+	LogFile reader;
+
+	for (unsigned int i = 0; i < frames.size(); i++)
+		randomFrame(frames[i]);
+
+	if (!writeLog(frames))
+	{
+		fail("writing a log failed");
+		return;
+	}
+
+	damage();
+
+	if (reader.open(path.c_str()))
+	{
+		string message = string("a log with ") + what + " was accepted";
+		fail(message.c_str());
+	}
+}
+
+static void badMagic() { patch(offsetof(LogFileHeader, magic), "CBLOG99", 8); }
+static void badVersion() { patch32(offsetof(LogFileHeader, version), LOGFILE_VERSION + 1); }
+static void badRecord() { patch32(offsetof(LogFileHeader, recordSize), sizeof(Log_Information) + 4); }
+static void badRobots() { patch32(offsetof(LogFileHeader, nRobots), NROBOTS + 1); }
+static void shortHeader() { patch32(offsetof(LogFileHeader, headerSize), LOGFILE_HEADER_SIZE - 8); }
+static void misaligned() { patch32(offsetof(LogFileHeader, headerSize), LOGFILE_HEADER_SIZE + 1); }
+static void hugeHeader() { patch32(offsetof(LogFileHeader, headerSize), 0xfffffff0u); }
+static void moreFrames() { patch64(offsetof(LogFileHeader, frameCount), 5); }
+static void hugeCount() { patch64(offsetof(LogFileHeader, frameCount), (uint64_t)UINT_MAX + 1); }
+static void cut(off_t size)
+{
+	if (truncate(path.c_str(), size) != 0)
+		fail("truncating the log failed");
+}
+
+static void truncated() { cut(LOGFILE_HEADER_SIZE + sizeof(Log_Information) * 3 + 1); }
+static void headerOnly() { cut(LOGFILE_HEADER_SIZE - 1); }
+
+int main(int argc, char* argv[])
+{
+	path = string(argc > 1 ? argv[1] : "/tmp") + "/logfile-check.cblog";
+
+	srand(2015);
+
+	roundTrip(0);
+	roundTrip(1);
+	roundTrip(257);
+
+	damaged("a bad magic", badMagic);
+	damaged("another version", badVersion);
+	damaged("another record size", badRecord);
+	damaged("another robot count", badRobots);
+	damaged("a short header", shortHeader);
+	damaged("a misaligned header", misaligned);
+	damaged("a header past the end", hugeHeader);
+	damaged("more frames than data", moreFrames);
+	damaged("a frame count over UINT_MAX", hugeCount);
+	damaged("a truncated record", truncated);
+	damaged("a truncated header", headerOnly);
+
+	unlink(path.c_str());
+
+	if (failures > 0)
+		return 1;
+
+	cerr << "logfile-check: all checks passed" << endl;
+	return 0;
+}
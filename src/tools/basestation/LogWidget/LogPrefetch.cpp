@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogPrefetch.h"
+
+LogPrefetch::LogPrefetch()
+{
+	file = NULL;
+	playhead = 0;
+	direction = 1;
+	generation = 0;
+	touching = false;
+	stopping = false;
+}
+
+LogPrefetch::~LogPrefetch()
+{
+	finish();
+}
+
+void LogPrefetch::setFile(const LogFile* file)
+{
+	QMutexLocker lock(&mutex);
+
+	/* The old log may be closed when this returns */
+	while (touching)
+		touched.wait(&mutex);
+
+	this->file = file;
+	playhead = 0;
+	direction = 1;
+
+	generation++;
+	moved.wakeOne();
+}
+
+void LogPrefetch::moveTo(unsigned int i)
+{
+	QMutexLocker lock(&mutex);
+
+	if (file == NULL || i == playhead)
+		return;
+
+	direction = (i > playhead) ? 1 : -1;
+	playhead = i;
+
+	generation++;
+	moved.wakeOne();
+}
+
+void LogPrefetch::finish()
+{
+	if (!isRunning())
+		return;
+
+	{
+		QMutexLocker lock(&mutex);
+		stopping = true;
+		moved.wakeOne();
+	}
+	wait();
+}
+
+void LogPrefetch::run()
+{
+	QMutexLocker lock(&mutex);
+
+	while (!stopping)
+	{
+		unsigned int gen = generation;
+		unsigned int size = file != NULL ? file->size() : 0;
+		int reach = LOGPREFETCH_AHEAD > LOGPREFETCH_BEHIND ? LOGPREFETCH_AHEAD : LOGPREFETCH_BEHIND;
+
+		/* Nearest frames first, alternating between both sides */
+		for (int d = 0; d <= reach && size > 0 && gen == generation && !stopping; d++)
+		{
+			for (int side = 0; side < 2 && gen == generation && !stopping; side++)
+			{
+				if ((d == 0 && side == 1) || d > (side == 0 ? LOGPREFETCH_AHEAD : LOGPREFETCH_BEHIND))
+					continue;
+
+				long n = (long)playhead + (side == 0 ? direction : -direction) * d;
+				if (n < 0 || n >= (long)size)
+					continue;
+
+				/* Read it unlocked, seeks go on meanwhile */
+				const Log_Information* frame = &file->frame(n);
+				touching = true;
+				lock.unlock();
+				touch(*frame);
+				lock.relock();
+				touching = false;
+				touched.wakeAll();
+			}
+		}
+
+		if (gen == generation && !stopping)
+			moved.wait(&mutex);
+	}
+}
+
+/* Read a byte of every page of the frame, faulting it in */
+void LogPrefetch::touch(const Log_Information& frame)
+{
+	const volatile char* p = (const volatile char*)&frame;
+	char sum = 0;
+
+	for (unsigned int k = 0; k < sizeof(Log_Information); k += LOGPREFETCH_PAGE)
+		sum += p[k];
+	sum += p[sizeof(Log_Information) - 1];
+	(void)sum;
+}
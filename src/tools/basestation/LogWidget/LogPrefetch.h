@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOGPREFETCH_H
+#define __LOGPREFETCH_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "LogFile.h"
+
+#define LOGPREFETCH_AHEAD	200		//frames read in after the playhead (in the playing direction)
+#define LOGPREFETCH_BEHIND	100		//frames read in before the playhead
+#define LOGPREFETCH_PAGE	4096	//stride of the reads inside a frame
+
+/* Reads the frames of a binary log around the playhead in the background
+ *
+ * A binary log is mapped, not read, so the first access to a frame may
+ * wait for the disk. This thread touches the pages of the frames around
+ * the playhead, nearest first and further ahead in the direction the
+ * playhead last moved, so seeking and scrubbing the slider mostly find
+ * them in memory. Text logs are parsed in memory and need nothing.
+ * The pages are touched without the lock, so moveTo() never waits for the
+ * disk; setFile() waits for the frame being touched, once it returns the
+ * old log is not read anymore and may be closed.
+ */
+class LogPrefetch : public QThread
+{
+public:
+	LogPrefetch();
+	~LogPrefetch();
+
+	/* Binary log being viewed, or NULL to stop reading ahead */
+	void setFile(const LogFile* file);
+
+	/* Frame shown (0 based) */
+	void moveTo(unsigned int i);
+
+	/* Stop the thread */
+	void finish();
+
+protected:
+	void run();
+
+private:
+	QMutex mutex;
+	QWaitCondition moved;
+	QWaitCondition touched;
+
+	const LogFile* file;
+	unsigned int playhead;
+	int direction;					//+1 forward, -1 backward
+	unsigned int generation;		//bumped when the playhead moves or the file changes
+	bool touching;					//a frame of file is being read, with the mutex released
+	bool stopping;
+
+	static void touch(const Log_Information& frame);
+};
+
+#endif
@@ -29,27 +29,20 @@
 #include <vector>
 #include <deque>
 
-#include <fstream>
-
 #include "DB_Robot_info.h"
 #include "CoachLogModeInfo.h"
+#include "LogFile.h"
+#include "LogPrefetch.h"
+#include "LogWriter.h"
 
 #define LOG_STOPED 0
 #define LOG_PLAYING 1
 #define MAX_AUTOLOG_REGISTERS 36000	//maximum number of registers (frames) on auto log (36000 is 1 hour)	100 for 10 seconds
-#define FILE_DUMP_FREQUENCY 600		//number of frames accumulated before dumping to the file (600 is 1 minute)		10 for each second
+#define FILE_DUMP_FREQUENCY 600		//number of frames in each temporary log file (600 is 1 minute)		10 for each second
 #define N_FILES MAX_AUTOLOG_REGISTERS / FILE_DUMP_FREQUENCY
 
 using namespace cambada;
 
-class Log_Information
-{
-	public:
-	FormationInfo finfo;
-	CoachInfo coach;
-	Robot robot[NROBOTS];
-};
-
 class LogWidget: public QWidget, public Ui::LogWG
 {
 	Q_OBJECT
@@ -67,6 +60,12 @@ private:
 	CoachLogModeFlag *coachLogFlag;
 
 	std::deque<Log_Information> LogInfo;
+	LogFile logFile;		//Binary log, played in place instead of LogInfo when open
+
+	unsigned int frameCount() const { return logFile.isOpen() ? logFile.size() : LogInfo.size(); }
+	const Log_Information& frameAt(unsigned int i) const { return logFile.isOpen() ? logFile.frame(i) : LogInfo[i]; }
+
+	LogPrefetch *prefetch;		//Reads the binary log around the playhead while viewing it
 
 	FILE *LoadLogFile;
 	bool ReadyToRead;
@@ -76,19 +75,8 @@ private:
 
 	//Auto logger variables
 	QTimer *saveTimer;		//Timer for the frequency of log data saving
-	QString initialMessage;
-	QString finalMessage;
-	QString logLine;
-	std::ofstream autoLogFile;
-
-	unsigned int frameCounter;
-	long oneLogEntrySize;
-
-	unsigned int firstFile;
-	unsigned int lastFile;
-	unsigned int nextFileToWrite;
+	LogWriter *logWriter;	//Encodes and writes the saved frames in the background
 
-	void concatAutoLog();
 	bool removeDir(const QString dirName);
 
 
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogWriter.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+#if LOGWRITER_COMPRESS
+#define LOGWRITER_EXT	".xml.gz"
+#define LOGWRITER_MODE	"wb"
+#define LOGWRITER_APPEND	"ab"
+#else
+#define LOGWRITER_EXT	".xml"
+#define LOGWRITER_MODE	"wbT"	//transparent, no compression
+#define LOGWRITER_APPEND	"abT"
+#endif
+
+static const char* initialMessage = "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n<Root>\n";
+static const char* finalMessage = "</Root>\n";
+
+LogWriter::LogWriter(const char* tempDir, const char* logPath, unsigned int framesPerChunk, unsigned int nChunks)
+{
+	snprintf(this->tempDir, sizeof(this->tempDir), "%s", tempDir);
+	snprintf(this->logPath, sizeof(this->logPath), "%s" LOGWRITER_EXT, logPath);
+	this->framesPerChunk = framesPerChunk;
+	this->nChunks = nChunks;
+
+	head = 0;
+	tail = 0;
+	stopping = false;
+	dropped = 0;
+
+	chunk = NULL;
+	chunkSeq = 0;
+	chunkFrames = 0;
+}
+
+LogWriter::~LogWriter()
+{
+	finish();
+}
+
+bool LogWriter::push(const Log_Information& frame)
+{
+	unsigned int next = (head + 1) % LOGWRITER_RING_SIZE;
+
+	if (next == tail)
+	{
+		dropped++;
+		return false;
+	}
+
+	ring[head] = frame;
+	__sync_synchronize();		//the frame must be visible before the slot is published
+	head = next;
+
+	return true;
+}
+
+void LogWriter::finish()
+{
+	if (!isRunning())
+		return;
+
+	stopping = true;
+	wait();
+
+	if (dropped > 0)
+		fprintf(stderr, "LogWriter :: %u frames dropped, the writer could not keep up\n", dropped);
+}
+
+void LogWriter::run()
+{
+	while (true)
+	{
+		bool last = stopping;
+
+		while (tail != head)
+		{
+			__sync_synchronize();
+			writeFrame(ring[tail]);
+			__sync_synchronize();		//done with the slot before handing it back
+			tail = (tail + 1) % LOGWRITER_RING_SIZE;
+		}
+
+		if (last)
+			break;
+
+		msleep(50);
+	}
+
+	if (chunk != NULL)
+	{
+		gzclose(chunk);
+		chunk = NULL;
+	}
+
+	fprintf(stderr, "Writing log file, please be patient!\n");
+	joinChunks();
+}
+
+void LogWriter::chunkName(unsigned int seq, char* name, size_t size)
+{
+	snprintf(name, size, "%s/autoLog%02u" LOGWRITER_EXT, tempDir, seq % nChunks);
+}
+
+void LogWriter::writeText(gzFile file, const char* text)
+{
+	if (gzputs(file, text) < 0)
+		fprintf(stderr, "LogWriter :: error writing the log\n");
+}
+
+void LogWriter::writeFrame(const Log_Information& frame)
+{
+	if (chunk != NULL && chunkFrames >= framesPerChunk)
+	{
+		gzclose(chunk);
+		chunk = NULL;
+		chunkSeq++;
+	}
+
+	if (chunk == NULL)
+	{
+		char name[300];
+
+		chunkName(chunkSeq, name, sizeof(name));
+		if ((chunk = gzopen(name, LOGWRITER_MODE)) == NULL)
+		{
+			fprintf(stderr, "LogWriter :: could not open %s\n", name);
+			return;
+		}
+		chunkFrames = 0;
+	}
+
+	snprintf(line, sizeof(line), "<Instance gametime=\"%d\" gamestate=\"%d\" cambada=\"%d\" mf=\"%d\" formation=\"%d\">\n",
+			frame.coach.time, frame.coach.gameState, frame.coach.ourGoals, frame.coach.theirGoals, 0);	//FIXME finfo.formationID
+	writeText(chunk, line);
+
+	for (int i = 0; i < N_CAMBADAS; i++)
+	{
+		const Robot& r = frame.robot[i];
+
+		snprintf(line, sizeof(line), "<Agent id=\"%d\" running=\"%d\" robotx=\"%.2f\" roboty=\"%.2f\" orientation=\"%.2f\""
+				" velx=\"%.2f\" vely=\"%.2f\" vela=\"%.2f\" role=\"%d\" behavior=\"%d\" stuck=\"%d\""
+				" sposid=\"%d\" nobst=\"%d\" visible=\"%d\" own=\"%d\" engaged=\"%d\" airborne=\"%d\""
+				" absx=\"%.2f\" absy=\"%.2f\" relx=\"%.2f\" rely=\"%.2f\" z=\"%.2f\" ballvelx=\"%.2f\" ballvely=\"%.2f\""
+				" bat1=\"%.2f\" bat2=\"%.2f\" bat3=\"%.2f\" oppDribbling=\"%d\" coaching=\"%d\" roleAuto=\"%d\" teamColor=\"%d\""
+				" goalColor=\"%d\" gameState=\"%d\" coordFlag1=\"%d\" coordFlag2=\"%d\" cVecx=\"%.2f\""
+				" cVecy=\"%.2f\" dPoint0x=\"%.2f\" dPoint0y=\"%.2f\" dPoint1x=\"%.2f\" dPoint1y=\"%.2f\""
+				" dPoint2x=\"%.2f\" dPoint2y=\"%.2f\" dPoint3x=\"%.2f\" dPoint3y=\"%.2f\">\n",
+				r.number, r.running, (double)r.pos.x, (double)r.pos.y, (double)r.orientation,
+				(double)r.vel.x, (double)r.vel.y, (double)r.angVelocity, (int)r.role, (int)r.behaviour, (int)r.stuck,
+				0, r.nObst, r.ball.visible, r.ball.own, r.ball.engaged, r.ball.airborne,	//FIXME finfo.formationSPos[i]
+				(double)r.ball.pos.x, (double)r.ball.pos.y, (double)r.ball.posRel.x, (double)r.ball.posRel.y,
+				(double)r.ball.height, (double)r.ball.vel.x, (double)r.ball.vel.y,
+				(double)r.battery[0], (double)r.battery[1], (double)r.battery[2], r.opponentDribbling,
+				r.coaching, r.roleAuto, (int)r.teamColor, (int)r.goalColor, (int)r.currentGameState,
+				r.coordinationFlag[0], r.coordinationFlag[1], (double)r.coordinationVec.x, (double)r.coordinationVec.y,
+				(double)r.debugPoints[0].x, (double)r.debugPoints[0].y, (double)r.debugPoints[1].x, (double)r.debugPoints[1].y,
+				(double)r.debugPoints[2].x, (double)r.debugPoints[2].y, (double)r.debugPoints[3].x, (double)r.debugPoints[3].y);
+		writeText(chunk, line);
+
+		for (unsigned int o = 0; o < r.nObst; o++)
+		{
+			snprintf(line, sizeof(line), "<Obst obstx=\"%.2f\" obsty=\"%.2f\" size=\"%.2f\" teammate=\"%d\"/>\n",
+					(double)r.obstacles[o].absCenter.x, (double)r.obstacles[o].absCenter.y, 0.5, r.obstacles[o].id);
+			writeText(chunk, line);
+		}
+
+		writeText(chunk, "</Agent>\n");
+	}
+	writeText(chunk, "</Instance>\n");
+
+	chunkFrames++;
+}
+
+/* Concatenate the kept chunks between the header and the footer. gzip
+ * members can be concatenated, so this is a plain copy in both modes. */
+void LogWriter::joinChunks()
+{
+	gzFile gz;
+	int out;
+	char buffer[65536];
+	unsigned int first = 0;
+
+	if ((gz = gzopen(logPath, LOGWRITER_MODE)) == NULL)
+	{
+		fprintf(stderr, "LogWriter :: could not open %s\n", logPath);
+		return;
+	}
+	writeText(gz, initialMessage);
+	gzclose(gz);
+
+	if ((out = open(logPath, O_WRONLY | O_APPEND)) < 0)
+	{
+		perror("LogWriter :: open");
+		return;
+	}
+
+	if (chunkSeq + 1 > nChunks)
+		first = chunkSeq + 1 - nChunks;
+
+	//chunkFrames is only 0 if no frame was ever written
+	for (unsigned int seq = first; seq <= chunkSeq && chunkFrames > 0; seq++)
+	{
+		char name[300];
+		int in;
+		ssize_t n;
+
+		chunkName(seq, name, sizeof(name));
+		if ((in = open(name, O_RDONLY)) < 0)
+			continue;
+
+		while ((n = read(in, buffer, sizeof(buffer))) > 0)
+		{
+			if (write(out, buffer, n) != n)
+			{
+				perror("LogWriter :: write");
+				break;
+			}
+		}
+		close(in);
+	}
+	close(out);
+
+	if ((gz = gzopen(logPath, LOGWRITER_APPEND)) == NULL)
+		return;
+	writeText(gz, finalMessage);
+	gzclose(gz);
+}
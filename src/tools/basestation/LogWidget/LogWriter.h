@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOGWRITER_H
+#define __LOGWRITER_H
+
+#include <QThread>
+#include <zlib.h>
+
+#include "LogFile.h"
+
+#define LOGWRITER_RING_SIZE		256		//frames waiting to be written (25 seconds at 10 frames per second)
+#define LOGWRITER_LINE_SIZE		2048	//longest line of a frame
+#define LOGWRITER_COMPRESS		0		//1 writes gzip compressed chunks and log (autoLog.xml.gz)
+
+/* Writes the automatic log in the background
+ *
+ * The GUI thread only copies each frame into a single producer, single
+ * consumer ring; the writer thread encodes the frames to the XML log
+ * format and appends them to rotating chunk files in tempDir. Only the
+ * last nChunks chunks are kept. finish() stops the thread after writing
+ * the pending frames and joins the kept chunks into the final log.
+ */
+class LogWriter : public QThread
+{
+public:
+	LogWriter(const char* tempDir, const char* logPath, unsigned int framesPerChunk, unsigned int nChunks);
+	~LogWriter();
+
+	/* Queue a frame, never blocks; returns false if the ring is full */
+	bool push(const Log_Information& frame);
+
+	/* Write the pending frames, build the final log and stop the thread */
+	void finish();
+
+	unsigned int getDropped() const { return dropped; }
+
+protected:
+	void run();
+
+private:
+	Log_Information ring[LOGWRITER_RING_SIZE];
+	volatile unsigned int head;		//next slot to fill, only written by push()
+	volatile unsigned int tail;		//next slot to write, only written by the writer thread
+	volatile bool stopping;
+	unsigned int dropped;
+
+	char tempDir[256];
+	char logPath[256];
+	unsigned int framesPerChunk;
+	unsigned int nChunks;
+
+	gzFile chunk;
+	unsigned int chunkSeq;			//sequence number of the current chunk
+	unsigned int chunkFrames;		//frames in the current chunk
+
+	char line[LOGWRITER_LINE_SIZE];
+
+	void chunkName(unsigned int seq, char* name, size_t size);
+	void writeFrame(const Log_Information& frame);
+	void writeText(gzFile file, const char* text);
+	void joinChunks();
+};
+
+#endif
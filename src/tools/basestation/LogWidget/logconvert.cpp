@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Converts a text (XML) game log to the binary log format and checks
+ * that every frame reads back unchanged.
+ *
+ * Usage: logconvert <log.xml> <log.cblog>
+ */
+
+#include "LogFile.h"
+
+#include <string.h>
+
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	std::deque<Log_Information> frames;
+	LogFileWriter writer;
+	LogFile reader;
+	FILE* in;
+
+	if (argc != 3)
+	{
+		cerr << "Usage: " << argv[0] << " <log.xml> <log.cblog>" << endl;
+		return 1;
+	}
+
+	if ((in = fopen(argv[1], "r")) == NULL)
+	{
+		perror("logconvert");
+		return 1;
+	}
+
+	LogFile::loadXML(in, frames);
+	fclose(in);
+
+	if (!writer.open(argv[2]))
+		return 1;
+
+	for (unsigned int i = 0; i < frames.size(); i++)
+	{
+		if (!writer.append(frames[i]))
+			return 1;
+	}
+
+	if (!writer.close())
+		return 1;
+
+	//Read the binary log back and compare every frame
+	if (!reader.open(argv[2]))
+		return 1;
+
+	if (reader.size() != frames.size())
+	{
+		cerr << "logconvert: wrote " << frames.size() << " frames, read " << reader.size() << endl;
+		return 2;
+	}
+
+	for (unsigned int i = 0; i < frames.size(); i++)
+	{
+		if (memcmp(&reader.frame(i), &frames[i], sizeof(Log_Information)) != 0)
+		{
+			cerr << "logconvert: frame " << i << " differs after conversion" << endl;
+			return 2;
+		}
+	}
+
+	cerr << "logconvert: " << frames.size() << " frames written to " << argv[2] << endl;
+
+	return 0;
+}
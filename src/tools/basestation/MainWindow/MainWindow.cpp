@@ -167,18 +167,18 @@ MWind::MWind(QMainWindow *parent)
 	GoalColorChanged( 1 );
 	
     UpdateWG->setFormationCombo(FormationCombo);
-    UpdateTimer->start(10);
+	/* O tempo de jogo é ao segundo, 100 ms chegam para o relógio e para o coach */
+    UpdateTimer->start(100);
 
 
 	/* Descomentar estas linhas para testes no campo */
-	commWatcher = new MyThreadWatcher( labelComm, "comm" );
-	commWatcher->start();
-
-	coachWatcher = new MyThreadWatcher( labelCoach, "coach" );
-	coachWatcher->start();
-
-	loggerWatcher = new MyThreadWatcher( labelLogger, "logger" );
-	loggerWatcher->start();
+	processWatcher = new ProcessWatcher( this, "ProcessStateChanged" );
+	processLabels[processWatcher->add( "comm" )] = labelComm;
+	processLabels[processWatcher->add( "coach" )] = labelCoach;
+	processLabels[processWatcher->add( "logger" )] = labelLogger;
+	for (unsigned i=0; i<processWatcher->size(); i++)
+		ProcessStateChanged(i);
+	processWatcher->start();
 
 	/* Inicializar o GameClock */
 	db_coach_info->gTimeSecOffset=0;
@@ -273,21 +273,14 @@ MWind::~MWind()
     disconnect(actionDebugAgent_6, SIGNAL(toggled ( bool)), FieldW, SLOT(debug_point_flip_r5(bool)));
 	
 	// Destroy "Gustavo" Threads
-	commWatcher->terminate();
-	while (commWatcher->wait()!=1){};
-	coachWatcher->terminate();
-	while (coachWatcher->wait()!=1){};
-	loggerWatcher->terminate();
-	while (coachWatcher->wait()!=1){};
+	processWatcher->finish();
 	
 	
 
 	//Delete
 	if(UpdateWG!=NULL)		delete UpdateWG; UpdateWG=NULL;
 	if(UpdateTimer!=NULL)	delete UpdateTimer; UpdateTimer=NULL;
-	if(commWatcher!=NULL)	delete commWatcher; commWatcher=NULL;
-	if(coachWatcher!=NULL)	delete coachWatcher; coachWatcher=NULL;
-	if(loggerWatcher!=NULL)	delete loggerWatcher; loggerWatcher=NULL;
+	if(processWatcher!=NULL)	delete processWatcher; processWatcher=NULL;
 	if(cambada_logo_pixmap!=NULL)	delete cambada_logo_pixmap;	 cambada_logo_pixmap=NULL;
     if(fullinfowindow!=NULL) delete fullinfowindow; fullinfowindow=NULL;
     if(FIW!=NULL)			delete FIW; FIW=NULL;
@@ -587,6 +580,25 @@ void MWind::UpdateGameParameters(void)
 
 }
 
+void MWind::ProcessStateChanged(int index)
+{
+	QColor red(QColor::fromRgb(191, 63, 63, 255));
+	QColor green(QColor::fromRgb(100, 172, 100, 255));
+
+	ProcessWatcher::Info info = processWatcher->info(index);
+	QWidget* labelWidget = processLabels[index];
+	QPalette plt(labelWidget->palette());
+
+	plt.setColor(QPalette::Foreground, info.running ? green : red);
+	plt.setColor(QPalette::Text, info.running ? green : red);
+	labelWidget->setPalette( plt );
+
+	if (info.running)
+		labelWidget->setToolTip(QString("%1: pid %2, %3% CPU, %4 restarts").arg(info.name).arg(info.pid).arg(info.cpu, 0, 'f', 1).arg(info.restarts));
+	else
+		labelWidget->setToolTip(QString("%1: not running, %2 restarts").arg(info.name).arg(info.restarts));
+}
+
 void MWind::allRoleChanged(int role_id)
 {
 	for (unsigned i=0; i<NROBOTS; i++)
@@ -28,6 +28,7 @@
 #include "ui_MainWindow.h"
 #include "FullInfoWindow.h"
 #include "UpdateWidget.h"
+#include "ProcessWatcher.h"
 #include "Robot.h"
 
 #include <iostream>
@@ -36,90 +37,6 @@ using namespace std;
 using namespace cambada;
 
 
-class MyThreadWatcher : public QThread
-{
-
-public:
-	MyThreadWatcher(QWidget* w, string cmd) 
-		{
-			this->cmd = cmd; 
-			this->labelWidget   = w;
-		};
-	//virtual ~MyThreadWatcher(){cerr <<"MyThreadWatcher::destructor"<<endl;};
-
-
-	bool findProcess(string pname)
-	{
-		FILE* fp;
-	//	string cmd = " acpi -b | cut -d':' -f2";
-		string cmd = "ps --no-headers -C " + pname;
-
-		if( (fp=popen(cmd.c_str(), "r")) == NULL )
-		{
-			cerr << "MyThreadWatcher :: findProcess() error"<<endl;
-			return false;
-		}
-
-		int pid = -1;
-	
-		const int LINE_BUFFER_SIZE =  128;
-
-		char line[LINE_BUFFER_SIZE];
-
-		bzero(line,sizeof(char)*LINE_BUFFER_SIZE);
-		fgets( line, sizeof(char)*LINE_BUFFER_SIZE, fp);
-		pclose(fp);
-	//	printf("line s: %s  %d\n",line, strlen(line));
-
-		sscanf(line,"%d",&pid);
-	//	printf("pid  %d\n", pid);
-
-		if( pid < 0 )
-			return false;
-		
-		return true;
-	}
-
-	virtual void run()
-	{
-		//cerr << cmd.toAscii() << "  :  ";
-		//cerr << system( cmd.toAscii() ) << endl;
-
-			QColor red(QColor::fromRgb(191, 63, 63, 255));
-			QColor green(QColor::fromRgb(100, 172, 100, 255));
-			QColor white(QColor::fromRgb(72,72,72,255));
-		while(1)
-		{	
-			QPalette plt(labelWidget->palette());
-//			plt.setColor(QPalette::Foreground, white);
-			
-			if( findProcess( cmd.c_str() ) )
-			{	
-				plt.setColor(QPalette::Foreground, green);
-				plt.setColor(QPalette::Text, green);
-				//cerr <<cmd.c_str() << " : TRUE"<<endl;
-			}
-			else
-			{
-				plt.setColor(QPalette::Foreground, red);
-				plt.setColor(QPalette::Text, red);
-				//plt.setColor( labelWidget->foregroundRole() , red);
-				//cerr <<cmd.c_str() <<" : FALSE"<<endl;
-			}
-			labelWidget->setPalette( plt );
-			sleep(1);
-		}
-	}
-
-private:
-	string cmd;
-	QWidget* labelWidget;
-};
-
-
-
-
-
 class MWind : public QMainWindow , public Ui::MainWindow
 {
 	Q_OBJECT
@@ -164,9 +81,9 @@ private:
 
 	QTimer *UpdateTimer;
 
-	MyThreadWatcher*  commWatcher;
-	MyThreadWatcher*  coachWatcher;
-	MyThreadWatcher*  loggerWatcher;
+	/* comm, coach e logger: um só thread, as etiquetas mudam no thread da GUI */
+	ProcessWatcher* processWatcher;
+	QWidget* processLabels[3];
 
 protected:
 	bool eventFilter(QObject *obj, QEvent *event);
@@ -191,6 +108,7 @@ public slots:
 
 	void UpdateGameTime(void);
     void UpdateGameParameters(void);
+	void ProcessStateChanged(int index);
 private slots:
     void on_checkBoxManualFormation_stateChanged(int arg1);
 
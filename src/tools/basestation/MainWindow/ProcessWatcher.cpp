@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+
+#include <QMetaObject>
+
+#include "ProcessWatcher.h"
+
+#define STOP_EVENT	0xFFFFFFFFu		//epoll data of the stop event
+
+static double monotonicTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+static int pidfdOpen(int pid)
+{
+#ifdef SYS_pidfd_open
+	return syscall(SYS_pidfd_open, pid, 0);
+#else
+	(void)pid;
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+ProcessWatcher::ProcessWatcher(QObject* receiver, const char* slot)
+{
+	this->receiver = receiver;
+	this->slot = slot;
+	stopping = false;
+
+	if ((epollFd = epoll_create(8)) == -1)
+		perror("ProcessWatcher: epoll_create");
+
+	if ((stopFd = eventfd(0, 0)) != -1 && epollFd != -1)
+	{
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.u32 = STOP_EVENT;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &ev);
+	}
+}
+
+ProcessWatcher::~ProcessWatcher()
+{
+	finish();
+
+	for (unsigned int i = 0; i < watched.size(); i++)
+		if (watched[i].pidfd != -1)
+			close(watched[i].pidfd);
+
+	if (stopFd != -1)
+		close(stopFd);
+	if (epollFd != -1)
+		close(epollFd);
+}
+
+int ProcessWatcher::add(const char* name)
+{
+	Watched w;
+
+	memset(&w, 0, sizeof(w));
+	strncpy(w.info.name, name, sizeof(w.info.name) - 1);
+	w.info.pid = -1;
+	w.pidfd = -1;
+
+	watched.push_back(w);
+	return watched.size() - 1;
+}
+
+ProcessWatcher::Info ProcessWatcher::info(unsigned int index)
+{
+	QMutexLocker lock(&mutex);
+	return watched[index].info;
+}
+
+void ProcessWatcher::finish()
+{
+	uint64_t one = 1;
+
+	stopping = true;
+	if (stopFd != -1 && write(stopFd, &one, sizeof(one)) == -1)
+		perror("ProcessWatcher: write");
+	wait();
+}
+
+void ProcessWatcher::run()
+{
+	struct epoll_event events[8];
+	double lastScan = monotonicTime();
+
+	scan(0);
+
+	while (!stopping)
+	{
+		int n = -1;
+
+		if (epollFd != -1)
+			n = epoll_wait(epollFd, events, 8, PROCESSWATCHER_PERIOD);
+		else
+			msleep(PROCESSWATCHER_PERIOD);
+
+		for (int e = 0; e < n; e++)
+		{
+			unsigned int index = events[e].data.u32;
+
+			if (index == STOP_EVENT)
+				return;
+
+			/* pidfd readable: the process exited */
+			detach(index);
+			post(index);
+		}
+
+		double now = monotonicTime();
+		if (now - lastScan >= PROCESSWATCHER_PERIOD / 1000.0)
+		{
+			scan(now - lastScan);
+			lastScan = now;
+		}
+	}
+}
+
+void ProcessWatcher::scan(double elapsed)
+{
+	bool missing = false;
+	long ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+	/* Cached pids: still alive (without pidfd) and CPU usage */
+	for (unsigned int i = 0; i < watched.size(); i++)
+	{
+		Watched& w = watched[i];
+		unsigned long long ticks;
+
+		if (!w.info.running)
+		{
+			missing = true;
+			continue;
+		}
+
+		char name[16];
+		if (!readCpuTicks(w.info.pid, &ticks) ||
+			(w.pidfd == -1 && (!readComm(w.info.pid, name, sizeof(name)) || strcmp(name, w.info.name) != 0)))
+		{
+			detach(i);
+			post(i);
+			missing = true;
+			continue;
+		}
+
+		if (elapsed > 0)
+		{
+			mutex.lock();
+			w.info.cpu = (ticks - w.cpuTicks) * 100.0 / ticksPerSecond / elapsed;
+			mutex.unlock();
+		}
+		w.cpuTicks = ticks;
+
+		if (w.info.cpu > w.reportedCpu + PROCESSWATCHER_CPU_STEP || w.info.cpu < w.reportedCpu - PROCESSWATCHER_CPU_STEP)
+		{
+			w.reportedCpu = w.info.cpu;
+			post(i);
+		}
+	}
+
+	if (!missing)
+		return;
+
+	/* One pass over /proc for all the missing processes */
+	DIR* dir = opendir("/proc");
+	struct dirent* entry;
+
+	if (dir == NULL)
+	{
+		perror("ProcessWatcher: /proc");
+		return;
+	}
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		char name[16];
+
+		if (!isdigit(entry->d_name[0]))
+			continue;
+
+		int pid = atoi(entry->d_name);
+		if (!readComm(pid, name, sizeof(name)))
+			continue;
+
+		for (unsigned int i = 0; i < watched.size(); i++)
+		{
+			if (!watched[i].info.running && strcmp(watched[i].info.name, name) == 0)
+			{
+				attach(i, pid);
+				post(i);
+				break;
+			}
+		}
+	}
+
+	closedir(dir);
+}
+
+void ProcessWatcher::attach(unsigned int index, int pid)
+{
+	Watched& w = watched[index];
+	char name[16];
+
+	w.pidfd = pidfdOpen(pid);
+
+	/* The pid may have been reused before the pidfd was open */
+	if (!readComm(pid, name, sizeof(name)) || strcmp(name, w.info.name) != 0)
+	{
+		if (w.pidfd != -1)
+			close(w.pidfd);
+		w.pidfd = -1;
+		return;
+	}
+
+	if (w.pidfd != -1 && epollFd != -1)
+	{
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.u32 = index;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, w.pidfd, &ev);
+	}
+
+	readCpuTicks(pid, &w.cpuTicks);
+
+	mutex.lock();
+	w.info.pid = pid;
+	w.info.running = true;
+	w.info.cpu = 0;
+	if (w.seen)
+		w.info.restarts++;
+	mutex.unlock();
+
+	w.seen = true;
+	w.reportedCpu = 0;
+}
+
+void ProcessWatcher::detach(unsigned int index)
+{
+	Watched& w = watched[index];
+
+	if (w.pidfd != -1)
+	{
+		if (epollFd != -1)
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, w.pidfd, NULL);
+		close(w.pidfd);
+		w.pidfd = -1;
+	}
+
+	mutex.lock();
+	w.info.pid = -1;
+	w.info.running = false;
+	w.info.cpu = 0;
+	mutex.unlock();
+}
+
+bool ProcessWatcher::readComm(int pid, char* name, size_t size)
+{
+	char path[32];
+	FILE* fp;
+
+	snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+	if ((fp = fopen(path, "r")) == NULL)
+		return false;
+
+	bool ok = fgets(name, size, fp) != NULL;
+	fclose(fp);
+
+	if (ok)
+		name[strcspn(name, "\n")] = '\0';
+	return ok;
+}
+
+bool ProcessWatcher::readCpuTicks(int pid, unsigned long long* ticks)
+{
+	char path[32];
+	char line[512];
+	FILE* fp;
+	char state;
+	unsigned long long utime, stime;
+
+	snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+	if ((fp = fopen(path, "r")) == NULL)
+		return false;
+
+	bool ok = fgets(line, sizeof(line), fp) != NULL;
+	fclose(fp);
+
+	/* The command name may have spaces, the fields start after the last ')' */
+	char* p = ok ? strrchr(line, ')') : NULL;
+	if (p == NULL || sscanf(p + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &state, &utime, &stime) != 3)
+		return false;
+
+	/* A zombie is a dead process */
+	if (state == 'Z' || state == 'X')
+		return false;
+
+	*ticks = utime + stime;
+	return true;
+}
+
+void ProcessWatcher::post(unsigned int index)
+{
+	if (receiver != NULL)
+		QMetaObject::invokeMethod(receiver, slot, Qt::QueuedConnection, Q_ARG(int, index));
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PROCESSWATCHER_H
+#define __PROCESSWATCHER_H
+
+#include <QThread>
+#include <QMutex>
+
+#include <vector>
+
+#define PROCESSWATCHER_PERIOD	1000	//ms between scans of /proc for missing processes
+#define PROCESSWATCHER_CPU_STEP	2.0		//CPU change (%) that is reported to the GUI
+
+/* Liveness of the team daemons (comm, coach, logger...)
+ *
+ * One thread watches all the processes. A missing process is looked up
+ * by name in /proc once per period; once found, its pid is cached and a
+ * pidfd is added to an epoll set, so its exit is seen at once without
+ * polling (kernels without pidfd just check the cached pid every period).
+ * State changes are posted to the GUI thread by calling slot(int index)
+ * on receiver through a queued connection; the slot reads the state with
+ * info().
+ */
+class ProcessWatcher : public QThread
+{
+public:
+	struct Info
+	{
+		char name[16];			//command name, as in /proc/<pid>/comm
+		int pid;				//-1 while not running
+		bool running;
+		unsigned int restarts;	//times it came back after being seen
+		float cpu;				//CPU usage in %, over the last period
+	};
+
+	ProcessWatcher(QObject* receiver, const char* slot);
+	~ProcessWatcher();
+
+	/* Watch a process, before start(); returns its index */
+	int add(const char* name);
+
+	unsigned int size() const { return watched.size(); }
+	Info info(unsigned int index);
+
+	/* Stop the thread and wait for it */
+	void finish();
+
+protected:
+	void run();
+
+private:
+	struct Watched
+	{
+		Info info;
+		bool seen;
+		int pidfd;
+		unsigned long long cpuTicks;
+		float reportedCpu;
+	};
+
+	std::vector<Watched> watched;
+	QMutex mutex;
+
+	QObject* receiver;
+	const char* slot;
+
+	int epollFd;
+	int stopFd;
+	volatile bool stopping;
+
+	void scan(double elapsed);
+	void attach(unsigned int index, int pid);
+	void detach(unsigned int index);
+	bool readComm(int pid, char* name, size_t size);
+	bool readCpuTicks(int pid, unsigned long long* ticks);
+	void post(unsigned int index);
+};
+
+#endif
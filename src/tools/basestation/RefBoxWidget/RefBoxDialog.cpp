@@ -42,7 +42,7 @@ RefBoxDialog::RefBoxDialog(QDialog *parent)
 	socket = NULL;
 	udpSocket = NULL;
 
-//	udpParser = NULL;
+	udpParser = NULL;
 
 #if 0
 	destHost = "172.16.39.10";
@@ -101,8 +101,9 @@ RefBoxDialog::~RefBoxDialog()
 	{
 		udpSocket->close();
 		delete udpSocket;
-//		delete udpParser;
 	}
+
+	delete udpParser;
 }
 
 void RefBoxDialog::connectToHost(void)
@@ -165,7 +166,7 @@ void RefBoxDialog::connectToHost(void)
 
 		connect(udpSocket, SIGNAL(readyRead()) , this, SLOT(receiveRefMsg()));
 
-//		udpParser = new RefBoxXML();
+		udpParser = new RefBoxXML();
 
 		Status_val->setText("Connected using new protocol");
 		Connect_bot->setChecked(1);
@@ -207,7 +208,8 @@ void RefBoxDialog::connectToHost(void)
 		udpSocket->close();
 		delete udpSocket;
 		udpSocket = NULL;
-//		delete udpParser;
+		delete udpParser;
+		udpParser = NULL;
 
 		Status_val->setText("Disconnected");
 		Connect_bot->setChecked(0);
@@ -249,18 +251,21 @@ void RefBoxDialog::receiveRefMsg(void)
 
 void RefBoxDialog::processNewRefBoxMsg()
 {
-/*	printf("\nA refbox message received\n");
-	printf("<<<<<<<<<<<<<<<<<<<<<<<<<<<\n");
-
-	char msg[1500];
-	qint64 nread = udpSocket->read(msg, 1500-1);
-	msg[nread] = '\0';
-	printf("%s", msg);
-	printf("---------------------------\n");
-	bool retv = udpParser->parse(msg, db_coach_info);
-	printf("---------------------------\n");
-	printf(">>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
-	if (retv == true) emit transmitCoach();*/
+	if (udpParser == NULL || db_coach_info == NULL)
+		return;
+
+	/* Leitura direta para o buffer, o parser guarda as mensagens incompletas */
+	int applied = 0;
+	qint64 nread;
+	while ((nread = udpSocket->read(data_received, sizeof(data_received))) > 0)
+		applied += udpParser->feed(data_received, nread, db_coach_info);
+
+	if (applied > 0)
+	{
+		printf("Ref box message(s): %d, latency %u us (max %u us), errors %u\n", applied,
+			udpParser->lastLatency(), udpParser->maxLatency(), udpParser->errors());
+		emit transmitCoach();
+	}
 }
 
 void RefBoxDialog::processRefBoxMsg()
@@ -32,7 +32,7 @@
 
 #include "DB_Robot_info.h"
 
-//#include "RefBoxXML.h"
+#include "RefBoxXML.h"
 
 class RefBoxDialog : public QDialog, public Ui::RefBoxDialog
 {
@@ -50,7 +50,7 @@ public:
 private:
 	DB_Coach_Info *db_coach_info;
 
-//	RefBoxXML* udpParser;
+	RefBoxXML* udpParser;
 
 protected:
 	QString destHost;
@@ -21,579 +21,608 @@
  */
 
 #include "RefBoxXML.h"
-#include <syslog.h>
-#include <assert.h>
-#include <libxml++/exceptions/parse_error.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 enum TagType { XML_ROOT=0, TAG_REFBOX_EVENT, TAG_REFEREE, TAG_GAME_INFO, TAG_TEAM_SETUP, TAG_TEAM_DATA, TAG_SETUP, XML_ERROR };
 
+enum ParserState { ST_TEXT=0, ST_TAG_OPEN, ST_NAME, ST_ATTR_WAIT, ST_ATTR_NAME, ST_ATTR_EQ, ST_ATTR_QUOTE, ST_ATTR_VALUE,
+	ST_EMPTY_END, ST_CLOSE_WAIT, ST_SKIP_DECL, ST_SKIP_PI, ST_COMMENT };
 
-RefBoxXML::RefBoxXML( ) : SaxParser()
+enum CommandAction { CMD_NONE=0, CMD_SIGNAL, CMD_TEAM_SIGNAL, CMD_STAGE, CMD_GOAL_AWARDED, CMD_GOAL_REMOVED };
+
+enum ChangeTeam { TEAM_NONE=0, TEAM_CYAN, TEAM_MAGENTA };
+
+enum ChangeStage { STAGE_NONE=0, STAGE_FIRST_HALF, STAGE_SECOND_HALF };
+
+struct RefBoxCommand
 {
-	depth = 0;
-	branch = XML_ROOT;
-	retValue = true;
+	const char* name;
+	int action;
+	int ourSignal;
+	int theirSignal;
+};
+
+/* Commands inside <Referee>, sorted by name for the binary search */
+static const RefBoxCommand refboxCommands[] =
+{
+	{ "Cancel",			CMD_NONE,			SIGnop,				SIGnop },
+	{ "CardAwarded",	CMD_NONE,			SIGnop,				SIGnop },
+	{ "CardRemoved",	CMD_NONE,			SIGnop,				SIGnop },
+	{ "Corner",			CMD_TEAM_SIGNAL,	SIGourCornerKick,	SIGtheirCornerKick },
+	{ "DroppedBall",	CMD_SIGNAL,			SIGdropBall,		SIGdropBall },
+	{ "FreeKick",		CMD_TEAM_SIGNAL,	SIGourFreeKick,		SIGtheirFreeKick },
+	{ "GameStart",		CMD_SIGNAL,			SIGstart,			SIGstart },
+	{ "GameStop",		CMD_SIGNAL,			SIGstop,			SIGstop },
+	{ "GoalAwarded",	CMD_GOAL_AWARDED,	SIGnop,				SIGnop },
+	{ "GoalKick",		CMD_TEAM_SIGNAL,	SIGourGoalKick,		SIGtheirGoalKick },
+	{ "GoalRemoved",	CMD_GOAL_REMOVED,	SIGnop,				SIGnop },
+	{ "KickOff",		CMD_TEAM_SIGNAL,	SIGourKickOff,		SIGtheirKickOff },
+	{ "Parking",		CMD_SIGNAL,			SIGparking,			SIGparking },
+	{ "Penalty",		CMD_TEAM_SIGNAL,	SIGourPenalty,		SIGtheirPenalty },
+	{ "PlayerIn",		CMD_NONE,			SIGnop,				SIGnop },
+	{ "PlayerOut",		CMD_NONE,			SIGnop,				SIGnop },
+	{ "StageChange",	CMD_STAGE,			SIGnop,				SIGnop },
+	{ "Substitution",	CMD_NONE,			SIGnop,				SIGnop },
+	{ "ThrowIn",		CMD_TEAM_SIGNAL,	SIGourThrowIn,		SIGtheirThrowIn },
+};
+
+static const int nRefboxCommands = sizeof(refboxCommands) / sizeof(refboxCommands[0]);
+
+static int compareCommand(const void* key, const void* elem)
+{
+	return strcmp((const char*)key, ((const RefBoxCommand*)elem)->name);
 }
 
-RefBoxXML::~RefBoxXML()
+static inline bool isSpace(char c)
 {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
 }
 
-bool RefBoxXML::parse(string msg, DB_Coach_Info* cip) throw(xmlpp::exception)
+static inline bool isNameChar(char c)
 {
-	depth = 0;
-	branch = XML_ROOT;
-	retValue = true;
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+		|| c == '_' || c == '-' || c == '.' || c == ':';
+}
 
-	db_coach_info = *cip;
+/* Append c to a fixed size buffer; on overflow the length is set past the
+ * end, so that the truncated text never matches anything */
+static inline void append(char* buf, int& len, int size, char c)
+{
+	if (len < size - 1)
+		buf[len++] = c;
+	else
+		len = size;
+}
 
-	try
-	{
-	//	set_substitute_entities(true);
-		parse_memory(msg);
-	}
-//	catch(const std::exception& ex)
-	catch(xmlpp::exception)
-	{
-		retValue = false;
-	}
-	
-	if (retValue == true)
-	{
-		cip->print();
-		db_coach_info.print();
-		*cip = db_coach_info;
-		cout << "Message OK\n";
-	}
+static inline void terminate(char* buf, int len, int size)
+{
+	if (len < size)
+		buf[len] = '\0';
 	else
-	{
-		cerr << "Message wrong\n";
-	}
+		buf[0] = '\0';
+}
 
-	return retValue;
+static long long monotonicTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 }
 
-void RefBoxXML::on_fatal_error(const std::string& text)
+
+RefBoxXML::RefBoxXML( )
 {
-	cerr << "RefBoxXML::on_fatal_error" << endl;
+	target = NULL;
+	applied = 0;
+	nMessages = 0;
+	nErrors = 0;
+	now = 0;
+	startTime = 0;
+	latency = 0;
+	latencyMax = 0;
+
+	reset();
 }
 
-void RefBoxXML::on_error(const std::string& text)
+RefBoxXML::~RefBoxXML()
 {
-	cerr << "RefBoxXML::on_error" << endl;
-	retValue = false;
-	branch = XML_ERROR;
 }
 
-void RefBoxXML::on_start_document() throw (xmlpp::exception)
+void RefBoxXML::reset()
 {
-//	cout << "on_start_document()" << endl;
+	state = ST_TEXT;
 	depth = 0;
 	branch = XML_ROOT;
-	retValue = true;
-}
+	retValue = false;
+	closing = false;
+	started = false;
+	dashes = 0;
+	quote = '"';
 
-void RefBoxXML::on_end_document() throw (xmlpp::exception)
-{
-//	cout << "on_end_document()" << endl;
+	nameLen = 0;
+	attrNameLen = 0;
+	attrValueLen = 0;
+	command = -1;
+	team[0] = '\0';
+	stage[0] = '\0';
+	nChanges = 0;
 }
 
-void RefBoxXML::on_start_element(const string& name, const AttributeList& attributes) throw (xmlpp::exception)
+int RefBoxXML::feed(const char* data, int size, DB_Coach_Info* cip)
 {
-	//cout << "tag: \"" << name << "\"" << endl;
+	target = cip;
+	applied = 0;
+	now = monotonicTime();
 
-	switch (branch)
+	for (int i = 0; i < size; i++)
 	{
-		case XML_ROOT:
-		{
-			if (name == "RefboxEvent")
-			{
-				branch = TAG_REFBOX_EVENT;
-				depth++;
-			}
-			else
-			{
-				cerr << "Wrong tag: " << name << endl;
-				retValue = false;
-				branch = XML_ERROR;
-				//throw new xmlpp::exception("Wrong tag");
-			}
-			break;
-		}
+		char c = data[i];
 
-		case XML_ERROR:
+		/* '<' is only valid in text, comments and PIs, start over on it */
+		if (c == '<' && state >= ST_TAG_OPEN && state <= ST_SKIP_DECL)
 		{
-			break;
+			syntaxError("Unexpected '<'");
+			state = ST_TAG_OPEN;
+			continue;
 		}
 
-		case TAG_REFBOX_EVENT:
+		switch (state)
 		{
-			if (name == "Referee")
-			{
-				/** \todo process Referee attributes */
-				branch = TAG_REFEREE;
-				depth++;
-			}
-			else if (name == "GameInfo")
-			{
-				/** \todo process Referee attributes */
-				branch = TAG_GAME_INFO;
-				depth++;
-			}
-			else if (name == "TeamSetup")
-			{
-				/** \todo process Referee attributes */
-				branch = TAG_TEAM_SETUP;
-				depth++;
-			}
-			else
+			case ST_TEXT:
 			{
-				retValue = false;
-				branch = XML_ERROR;
-				cerr << "Wrong tag: " << name << " inside <RefboxEvent>" << endl;
-				//throw new xmlpp::exception("Wrong tag 2");
+				if (c == '<')
+					state = ST_TAG_OPEN;
+				break;
 			}
-			break;
-		}
 
-		case TAG_REFEREE:
-		{
-			if (name == "StageChange")
+			case ST_TAG_OPEN:
 			{
-				/* action depends on attribute 'newStage' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				closing = false;
+				nameLen = 0;
+				if (c == '/')
 				{
-					if (attr->name != "newStage")
-					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
-					}
-					else
-					{
-						if (attr->value == "firstHalf")
-						{
-							db_coach_info.GameTime.start();
-							db_coach_info.GamePart = 1;
-							db_coach_info.Coach_Info.ourGoals=0;
-							db_coach_info.Coach_Info.theirGoals=0;
-						}
-						else if (attr->value == "secondHalf")
-						{
-							db_coach_info.GameTime.start();
-							db_coach_info.GamePart = 2;
-						}
-					}
+					closing = true;
+					state = ST_NAME;
 				}
-			}
-			else if (name == "GameStart")
-			{
-				db_coach_info.Coach_Info.gameState = SIGstart;
-			}
-			else if (name == "GameStop")
-			{
-				db_coach_info.Coach_Info.gameState = SIGstop;
-			}
-			else if (name == "KickOff")
-			{
-				/* action depends on attribute 'team' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				else if (c == '?')
 				{
-					if (attr->name != "team")
-					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
-					}
-					else
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourKickOff;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirKickOff;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourKickOff;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirKickOff;
-						}
-					}
+					/* a declaration inside a message means the rest of it was lost */
+					if (depth > 0)
+						syntaxError("Truncated message");
+					state = ST_SKIP_PI;
 				}
-			}
-			else if (name == "FreeKick")
-			{
-				/* action depends on attribute 'team' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				else if (c == '!')
 				{
-					if (attr->name != "team")
-					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
-					}
-					else
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourFreeKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirFreeKick;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourFreeKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirFreeKick;
-						}
-					}
+					dashes = 0;
+					state = ST_SKIP_DECL;
 				}
-			}
-			else if (name == "GoalKick")
-			{
-				/* action depends on attribute 'team' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				else if (isNameChar(c))
 				{
-					if (attr->name != "team")
-					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
-					}
-					else
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourGoalKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirGoalKick;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourGoalKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirGoalKick;
-						}
-					}
+					append(name, nameLen, REFBOXXML_NAME_SIZE, c);
+					state = ST_NAME;
 				}
+				else
+					syntaxError("Invalid character after '<'");
+				break;
 			}
-			else if (name == "ThrowIn")
+
+			case ST_NAME:
 			{
-				/* action depends on attribute 'team' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (isNameChar(c))
 				{
-					if (attr->name != "team")
+					append(name, nameLen, REFBOXXML_NAME_SIZE, c);
+					break;
+				}
+
+				if (nameLen == 0)
+				{
+					syntaxError("Missing tag name");
+					break;
+				}
+
+				terminate(name, nameLen, REFBOXXML_NAME_SIZE);
+				if (closing)
+				{
+					if (c == '>')
 					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
+						endElement();
+						state = ST_TEXT;
 					}
+					else if (isSpace(c))
+						state = ST_CLOSE_WAIT;
 					else
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourThrowIn;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirThrowIn;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourThrowIn;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirThrowIn;
-						}
-					}
+						syntaxError("Invalid character in end tag");
+					break;
+				}
+
+				beginElement();
+				if (c == '>')
+				{
+					startElement();
+					state = ST_TEXT;
 				}
+				else if (c == '/')
+					state = ST_EMPTY_END;
+				else if (isSpace(c))
+					state = ST_ATTR_WAIT;
+				else
+					syntaxError("Invalid character in tag");
+				break;
 			}
-			else if (name == "Corner")
+
+			case ST_ATTR_WAIT:
 			{
-				/* action depends on attribute 'team' */
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (isSpace(c))
+					break;
+
+				if (c == '>')
 				{
-					if (attr->name != "team")
-					{
-						cerr << "Invalid attribute \"" << attr->name << "\" in tag \"" << name << "\"\n";
-						continue;
-					}
-					else
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourCornerKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirCornerKick;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourCornerKick;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirCornerKick;
-						}
-					}
+					startElement();
+					state = ST_TEXT;
 				}
+				else if (c == '/')
+					state = ST_EMPTY_END;
+				else if (isNameChar(c))
+				{
+					attrNameLen = 0;
+					append(attrName, attrNameLen, REFBOXXML_NAME_SIZE, c);
+					state = ST_ATTR_NAME;
+				}
+				else
+					syntaxError("Invalid character in tag");
+				break;
 			}
-			else if (name == "DroppedBall")
+
+			case ST_ATTR_NAME:
 			{
-				db_coach_info.Coach_Info.gameState = SIGdropBall;
+				if (isNameChar(c))
+					append(attrName, attrNameLen, REFBOXXML_NAME_SIZE, c);
+				else if (c == '=')
+					state = ST_ATTR_QUOTE;
+				else if (isSpace(c))
+					state = ST_ATTR_EQ;
+				else
+					syntaxError("Invalid character in attribute name");
+				break;
 			}
-			else if (name == "GoalAwarded")
+
+			case ST_ATTR_EQ:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
-				{
-					if (attr->name == "team")
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.ourGoals++;
-							else
-								db_coach_info.Coach_Info.theirGoals++;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.ourGoals++;
-							else
-								db_coach_info.Coach_Info.theirGoals++;
-						}
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "own")
-					{
-					}
-					else if (attr->name == "stage")
-					{
-					}
-					else if (attr->name == "time")
-					{
-					}
-					else
-					{
-					}
-				}
+				if (c == '=')
+					state = ST_ATTR_QUOTE;
+				else if (!isSpace(c))
+					syntaxError("Missing '=' after attribute name");
+				break;
 			}
-			else if (name == "GoalRemoved")
+
+			case ST_ATTR_QUOTE:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (c == '"' || c == '\'')
 				{
-					if (attr->name == "team")
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.ourGoals--;
-							else
-								db_coach_info.Coach_Info.theirGoals--;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.ourGoals--;
-							else
-								db_coach_info.Coach_Info.theirGoals--;
-						}
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "own")
-					{
-					}
-					else if (attr->name == "stage")
-					{
-					}
-					else if (attr->name == "time")
-					{
-					}
-					else
-					{
-					}
+					quote = c;
+					attrValueLen = 0;
+					state = ST_ATTR_VALUE;
 				}
+				else if (!isSpace(c))
+					syntaxError("Missing quote in attribute value");
+				break;
 			}
-			else if (name == "Penalty")
+
+			case ST_ATTR_VALUE:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (c == quote)
 				{
-					if (attr->name == "team")
-					{
-						if (attr->value == "Cyan")
-						{
-							if (db_coach_info.TeamColor == Cyan)
-								db_coach_info.Coach_Info.gameState = SIGourPenalty;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirPenalty;
-						}
-						else if (attr->value == "Magenta")
-						{
-							if (db_coach_info.TeamColor == Magenta)
-								db_coach_info.Coach_Info.gameState = SIGourPenalty;
-							else
-								db_coach_info.Coach_Info.gameState = SIGtheirPenalty;
-						}
-					}
-					else if (attr->name == "goalColor")
-					{
-					}
-					else
-					{
-					}
+					terminate(attrName, attrNameLen, REFBOXXML_NAME_SIZE);
+					terminate(attrValue, attrValueLen, REFBOXXML_VALUE_SIZE);
+					attribute();
+					state = ST_ATTR_WAIT;
 				}
+				else
+					append(attrValue, attrValueLen, REFBOXXML_VALUE_SIZE, c);
+				break;
 			}
-			else if (name == "Substitution")
+
+			case ST_EMPTY_END:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (c == '>')
 				{
-					if (attr->name == "team")
-					{
-					}
-					else if (attr->name == "playerIn")
-					{
-					}
-					else if (attr->name == "playerOut")
-					{
-					}
-					else
-					{
-					}
+					startElement();
+					endElement();
+					state = ST_TEXT;
 				}
+				else
+					syntaxError("Invalid character after '/'");
+				break;
 			}
-			else if (name == "Cancel")
-			{
-			}
-			else if (name == "PlayerOut")
+
+			case ST_CLOSE_WAIT:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				if (c == '>')
 				{
-					if (attr->name == "team")
-					{
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "reason")
-					{
-					}
-					else if (attr->name == "minimumNrOfSecondsOfField")
-					{
-					}
-					else
-					{
-					}
+					endElement();
+					state = ST_TEXT;
 				}
+				else if (!isSpace(c))
+					syntaxError("Invalid character in end tag");
+				break;
 			}
-			else if (name == "PlayerIn")
+
+			case ST_SKIP_PI:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
-				{
-					if (attr->name == "team")
-					{
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "reason")
-					{
-					}
-					else
-					{
-					}
-				}
+				if (c == '>')
+					state = ST_TEXT;
+				break;
 			}
-			else if (name == "CardAwarded")
+
+			case ST_SKIP_DECL:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
+				/* <!-- starts a comment, anything else is skipped up to '>' */
+				if (c == '-' && dashes >= 0)
 				{
-					if (attr->name == "team")
-					{
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "color")
-					{
-					}
-					else if (attr->name == "number")
-					{
-					}
-					else if (attr->name == "time")
-					{
-					}
-					else if (attr->name == "stage")
-					{
-					}
-					else
+					if (++dashes == 2)
 					{
+						dashes = 0;
+						state = ST_COMMENT;
 					}
 				}
+				else if (c == '>')
+					state = ST_TEXT;
+				else
+					dashes = -1;
+				break;
 			}
-			else if (name == "CardRemoved")
+
+			case ST_COMMENT:
 			{
-				for (AttributeList::const_iterator attr = attributes.begin(); attr != attributes.end(); attr++)
-				{
-					if (attr->name == "team")
-					{
-					}
-					else if (attr->name == "player")
-					{
-					}
-					else if (attr->name == "color")
-					{
-					}
-					else if (attr->name == "number")
-					{
-					}
-					else if (attr->name == "time")
-					{
-					}
-					else if (attr->name == "stage")
-					{
-					}
-					else
-					{
-					}
-				}
+				if (c == '-')
+					dashes++;
+				else if (c == '>' && dashes >= 2)
+					state = ST_TEXT;
+				else
+					dashes = 0;
+				break;
 			}
-			else if (name == "Parking")
+		}
+	}
+
+	target = NULL;
+	return applied;
+}
+
+/* Tag name known, attributes not yet */
+void RefBoxXML::beginElement()
+{
+	command = -1;
+	team[0] = '\0';
+	stage[0] = '\0';
+
+	/* messages do not nest, the previous one was cut */
+	if (depth > 0 && strcmp(name, "RefboxEvent") == 0)
+	{
+		error("Truncated message");
+		depth = 0;
+		branch = XML_ROOT;
+	}
+
+	switch (branch)
+	{
+		case XML_ROOT:
+		{
+			if (depth != 0)
+				break;
+
+			if (strcmp(name, "RefboxEvent") == 0)
 			{
-				db_coach_info.Coach_Info.gameState = SIGparking;
+				/* a new message, its commands are kept until it ends */
+				branch = TAG_REFBOX_EVENT;
+				retValue = true;
+				started = true;
+				startTime = now;
+				nChanges = 0;
 			}
 			else
 			{
-				cerr << "Wrong tag: " << name << " inside <RefboxEvent>" << endl;
-				branch = XML_ERROR;
-				retValue = false;
-				//throw new xmlpp::exception("Wrong tag 3");
+				error("Wrong tag");
 			}
 			break;
 		}
 
-		case TAG_GAME_INFO:
+		case XML_ERROR:
+		{
+			break;
+		}
+
+		case TAG_REFBOX_EVENT:
+		{
+			if (depth != 1)
+				break;
+
+			if (strcmp(name, "Referee") == 0)
+				branch = TAG_REFEREE;
+			else if (strcmp(name, "GameInfo") == 0)
+				/** \todo process tag <GameInfo ...> */
+				branch = TAG_GAME_INFO;
+			else if (strcmp(name, "TeamSetup") == 0)
+				/** \todo process tag <TeamSetup ...> */
+				branch = TAG_TEAM_SETUP;
+			else
+				error("Wrong tag inside <RefboxEvent>");
+			break;
+		}
+
+		case TAG_REFEREE:
 		{
-			/** \todo process tag <GameInfo ...> */
+			if (depth != 2)
+				break;
+
+			const RefBoxCommand* cmd = (const RefBoxCommand*)bsearch(name, refboxCommands,
+				nRefboxCommands, sizeof(RefBoxCommand), compareCommand);
+			if (cmd != NULL)
+				command = cmd - refboxCommands;
+			else
+				error("Wrong tag inside <Referee>");
 			break;
 		}
+	}
+}
+
+/* Only the attributes used by the commands are kept */
+void RefBoxXML::attribute()
+{
+	if (command < 0)
+		return;
+
+	if (strcmp(attrName, "team") == 0)
+		memcpy(team, attrValue, REFBOXXML_VALUE_SIZE);
+	else if (strcmp(attrName, "newStage") == 0)
+		memcpy(stage, attrValue, REFBOXXML_VALUE_SIZE);
+}
+
+/* End of the start tag, all the attributes are known */
+void RefBoxXML::startElement()
+{
+	depth++;
+
+	if (command < 0 || branch != TAG_REFEREE)
+		return;
+
+	if (nChanges == REFBOXXML_MAX_CHANGES)
+	{
+		error("Too many commands");
+		return;
+	}
+
+	Change& change = changes[nChanges++];
+	change.command = command;
+	command = -1;
+
+	change.team = TEAM_NONE;
+	if (strcmp(team, "Cyan") == 0)
+		change.team = TEAM_CYAN;
+	else if (strcmp(team, "Magenta") == 0)
+		change.team = TEAM_MAGENTA;
+
+	change.stage = STAGE_NONE;
+	if (strcmp(stage, "firstHalf") == 0)
+		change.stage = STAGE_FIRST_HALF;
+	else if (strcmp(stage, "secondHalf") == 0)
+		change.stage = STAGE_SECOND_HALF;
+}
+
+/* Apply a command to the coach info as it is when the message ends */
+void RefBoxXML::applyChange(const Change& change, DB_Coach_Info& info)
+{
+	const RefBoxCommand& cmd = refboxCommands[change.command];
+
+	/* -1 when the command is for the other team, 0 when not for a team */
+	int ours = 0;
+	if (change.team == TEAM_CYAN)
+		ours = (info.TeamColor == Cyan) ? 1 : -1;
+	else if (change.team == TEAM_MAGENTA)
+		ours = (info.TeamColor == Magenta) ? 1 : -1;
 
-		case TAG_TEAM_SETUP:
+	switch (cmd.action)
+	{
+		case CMD_SIGNAL:
+			info.Coach_Info.gameState = cmd.ourSignal;
+			break;
+
+		case CMD_TEAM_SIGNAL:
+			if (ours != 0)
+				info.Coach_Info.gameState = (ours > 0) ? cmd.ourSignal : cmd.theirSignal;
+			break;
+
+		case CMD_STAGE:
+			if (change.stage == STAGE_FIRST_HALF)
+			{
+				info.GameTime.start();
+				info.GamePart = 1;
+				info.Coach_Info.ourGoals=0;
+				info.Coach_Info.theirGoals=0;
+			}
+			else if (change.stage == STAGE_SECOND_HALF)
+			{
+				info.GameTime.start();
+				info.GamePart = 2;
+			}
+			break;
+
+		case CMD_GOAL_AWARDED:
+		case CMD_GOAL_REMOVED:
 		{
-			/** \todo process tag <TeamSetup ...> */
+			int delta = (cmd.action == CMD_GOAL_AWARDED) ? 1 : -1;
+			if (ours > 0)
+				info.Coach_Info.ourGoals += delta;
+			else if (ours < 0)
+				info.Coach_Info.theirGoals += delta;
 			break;
 		}
 	}
+}
+
+void RefBoxXML::endElement()
+{
+	if (depth == 0)
+		return;		// leftovers of a message dropped on an error
+
+	depth--;
 
-	return;
-}	
+	if (depth == 1 && branch != XML_ERROR)
+		branch = TAG_REFBOX_EVENT;
 
-void RefBoxXML::on_end_element(const string& name) throw (xmlpp::exception)
+	if (depth == 0)
+	{
+		if (strcmp(name, "RefboxEvent") != 0 && branch != XML_ERROR)
+			error("Wrong end tag");
+		endMessage();
+	}
+}
+
+void RefBoxXML::endMessage()
 {
-//	cout << "on_end_element()" << endl;
-	//cout << "/tag: \"" << name << "\"" << endl;
+	if (started && retValue && target != NULL)
+	{
+		for (int i = 0; i < nChanges; i++)
+			applyChange(changes[i], *target);
+		applied++;
+		nMessages++;
+
+		long long end = monotonicTime();
+		latency = (unsigned int)(end - startTime);
+		if (latency > latencyMax)
+			latencyMax = latency;
+	}
+
+	depth = 0;
+	branch = XML_ROOT;
+	started = false;
+	retValue = false;
+	nChanges = 0;
 }
 
+/* Drop the current message, up to its end tag */
+void RefBoxXML::error(const char* what)
+{
+	if (branch != XML_ERROR)
+	{
+		cerr << "RefBoxXML: " << what << endl;
+		nErrors++;
+	}
+
+	retValue = false;
+	branch = XML_ERROR;
+}
+
+/* The nesting of the elements is not known anymore, drop the current
+ * message and look for the start of the next one */
+void RefBoxXML::syntaxError(const char* what)
+{
+	error(what);
+
+	state = ST_TEXT;
+	depth = 0;
+	branch = XML_ROOT;
+	started = false;
+}
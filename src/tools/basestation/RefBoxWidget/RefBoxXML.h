@@ -20,56 +20,102 @@
  * along with this package.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef _CONFIGXML_H_
-#define _CONFIGXML_H_
-
-#include <libxml++/libxml++.h>
-#include <iostream>
-#include <map>
+#ifndef _REFBOXXML_H_
+#define _REFBOXXML_H_
 
 #include "DB_Robot_info.h"
 
-using namespace xmlpp;
-using namespace std;
+/* Incremental parser of the refbox XML protocol
+ *
+ * Bytes are fed as they come from the socket, without building a string
+ * or a tree, and a message may be split over any number of reads. The
+ * tokenizer keeps its state between calls in fixed size buffers, so no
+ * memory is allocated while parsing. Commands are looked up in a sorted
+ * table built at compile time.
+ *
+ * The commands of a message are recorded and only applied to the coach
+ * info when the whole <RefboxEvent> was parsed without errors, so that
+ * the fields changed by others while a message is split over several
+ * reads are kept.
+ */
+#define REFBOXXML_NAME_SIZE		32
+#define REFBOXXML_VALUE_SIZE	32
+#define REFBOXXML_MAX_CHANGES	8
 
-class RefBoxXML : public SaxParser
+class RefBoxXML
 {
-	private:
-		DB_Coach_Info db_coach_info; // a local copy 
-#if 0
-		map<string,PID> ctrlParam;
-		map<string,float> parameter;
-		map<string,int> field;
-#endif
 	public:
 		RefBoxXML();
 		~RefBoxXML();
-	
-		bool parse(string msg, DB_Coach_Info* cip) throw(xmlpp::exception);
-	
-		//map<string,PID> ctrlParam;
-		//map<string,float> parameter;
-		//map<string,int> field;
-		
-#if 0
-		bool write(string fileName);
-	
-		void display();
-#endif			
+
+		/* Parse size bytes of data, applying every message completed to *cip.
+		 * Returns the number of messages applied */
+		int feed(const char* data, int size, DB_Coach_Info* cip);
+
+		/* Drop any partial message */
+		void reset();
+
+		unsigned int messages() const { return nMessages; }
+		unsigned int errors() const { return nErrors; }
+
+		/* Time between the first byte of a message being fed and the
+		 * message being applied, in microseconds */
+		unsigned int lastLatency() const { return latency; }
+		unsigned int maxLatency() const { return latencyMax; }
+
 	protected:
-		virtual void on_start_document() throw(xmlpp::exception);
-		virtual void on_end_document() throw(xmlpp::exception);
-		virtual void on_start_element(const string& name, const AttributeList& properties) throw(xmlpp::exception);
-		virtual void on_end_element(const string& name) throw(xmlpp::exception);
+		void beginElement();
+		void startElement();
+		void endElement();
+		void attribute();
+		void endMessage();
+		void error(const char* what);
+		void syntaxError(const char* what);
+
+		/* A command of the current message */
+		struct Change
+		{
+			int command;
+			int team;
+			int stage;
+		};
 
- 		virtual void on_fatal_error(const std::string& text);
- 		virtual void on_error(const std::string& text);
+		void applyChange(const Change& change, DB_Coach_Info& info);
 
 	protected:
+		DB_Coach_Info* target;
+		int applied;
+
+		int state;
 		int depth;
 		int branch;
 		bool retValue;
-};
+		bool closing;
+		bool started;
+		int dashes;
+		char quote;
 
-#endif //_CONFIGXML_H_
+		char name[REFBOXXML_NAME_SIZE];
+		int nameLen;
+		char attrName[REFBOXXML_NAME_SIZE];
+		int attrNameLen;
+		char attrValue[REFBOXXML_VALUE_SIZE];
+		int attrValueLen;
+
+		/* attributes of the current element that commands use */
+		int command;
+		char team[REFBOXXML_VALUE_SIZE];
+		char stage[REFBOXXML_VALUE_SIZE];
+
+		Change changes[REFBOXXML_MAX_CHANGES];
+		int nChanges;
+
+		unsigned int nMessages;
+		unsigned int nErrors;
+		long long now;
+		long long startTime;
+		unsigned int latency;
+		unsigned int latencyMax;
+};
 
+#endif //_REFBOXXML_H_
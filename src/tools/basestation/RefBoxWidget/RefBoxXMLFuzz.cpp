@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Fuzz check of the incremental refbox parser:
+//   a stream of random messages gives the same coach info and message
+//   count whether it is fed at once, at random split points or byte by byte
+//   fields changed by others while a message is split over reads are kept
+//   random bytes and mutated messages never crash the parser, and after a
+//   reset the next valid message is applied
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "RefBoxXML.h"
+#include "MersenneTwister.h"
+#include "CheckReport.h"
+
+MTRand randomGenerator;
+
+static const char* commands[] = {
+	"GameStart", "GameStop", "DroppedBall", "Parking", "Cancel",
+	"KickOff", "FreeKick", "GoalKick", "ThrowIn", "Corner", "Penalty",
+	"GoalAwarded", "GoalRemoved", "StageChange", "CardAwarded", "Substitution",
+};
+
+static const int nCommands = sizeof(commands) / sizeof(commands[0]);
+
+static std::string randomMessage()
+{
+	std::string msg = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<RefboxEvent eventTime=\"12:00:00\">\n";
+
+	if (randomGenerator.randInt(4) == 0)
+		msg += "  <!-- comment with <tags> -->\n";
+
+	if (randomGenerator.randInt(5) == 0)
+		msg += "  <GameInfo><Stage name=\"firstHalf\"/></GameInfo>\n";
+
+	msg += "  <Referee>\n";
+	int n = 1 + randomGenerator.randInt(2);
+	for (int i = 0; i < n; i++)
+	{
+		const char* command = commands[randomGenerator.randInt(nCommands - 1)];
+		msg += "    <";
+		msg += command;
+		if (randomGenerator.randInt(3) != 0)
+			msg += randomGenerator.randInt(1) ? " team=\"Cyan\"" : " team='Magenta'";
+		if (strcmp(command, "StageChange") == 0)
+			msg += randomGenerator.randInt(1) ? " newStage=\"firstHalf\"" : " newStage=\"secondHalf\"";
+		msg += randomGenerator.randInt(1) ? " />\n" : "></" + std::string(command) + ">\n";
+	}
+	msg += "  </Referee>\n</RefboxEvent>\n";
+
+	return msg;
+}
+
+static void initInfo(DB_Coach_Info& info)
+{
+	info.Coach_Info.gameState = SIGstop;
+	info.Coach_Info.ourGoals = 0;
+	info.Coach_Info.theirGoals = 0;
+	info.GamePart = 0;
+	info.gTimeSecOffset = 0;
+	info.TeamColor = Cyan;
+	info.GoalColor = Yellow;
+}
+
+static bool sameInfo(const DB_Coach_Info& a, const DB_Coach_Info& b)
+{
+	return a.Coach_Info.gameState == b.Coach_Info.gameState
+		&& a.Coach_Info.ourGoals == b.Coach_Info.ourGoals
+		&& a.Coach_Info.theirGoals == b.Coach_Info.theirGoals
+		&& a.GamePart == b.GamePart
+		&& a.gTimeSecOffset == b.gTimeSecOffset
+		&& a.TeamColor == b.TeamColor;
+}
+
+// feed the stream in chunks of random size (maxChunk 1 is byte by byte)
+static int feedSplit(RefBoxXML& parser, const std::string& stream, DB_Coach_Info& info, int maxChunk)
+{
+	int applied = 0;
+	unsigned int pos = 0;
+
+	while (pos < stream.size())
+	{
+		unsigned int chunk = 1 + randomGenerator.randInt(maxChunk - 1);
+		if (chunk > stream.size() - pos)
+			chunk = stream.size() - pos;
+		applied += parser.feed(stream.data() + pos, chunk, &info);
+		pos += chunk;
+	}
+
+	return applied;
+}
+
+static void checkSplits()
+{
+	for (int run = 0; run < 2000; run++)
+	{
+		std::string stream;
+		int n = 1 + randomGenerator.randInt(9);
+		for (int i = 0; i < n; i++)
+			stream += randomMessage();
+
+		RefBoxXML whole, split, bytes;
+		DB_Coach_Info wholeInfo, splitInfo, bytesInfo;
+		initInfo(wholeInfo);
+		initInfo(splitInfo);
+		initInfo(bytesInfo);
+		if (run & 1)
+		{
+			wholeInfo.TeamColor = splitInfo.TeamColor = bytesInfo.TeamColor = Magenta;
+		}
+
+		int a = whole.feed(stream.data(), stream.size(), &wholeInfo);
+		int b = feedSplit(split, stream, splitInfo, 64);
+		int c = feedSplit(bytes, stream, bytesInfo, 1);
+
+		CHECK(a == n, "run %d: %d of %d messages applied", run, a, n);
+		CHECK(b == n && c == n, "run %d: split feeds applied %d and %d of %d", run, b, c, n);
+		CHECK(sameInfo(wholeInfo, splitInfo), "run %d: split feed differs", run);
+		CHECK(sameInfo(wholeInfo, bytesInfo), "run %d: byte by byte feed differs", run);
+		CHECK(whole.errors() == 0 && split.errors() == 0 && bytes.errors() == 0,
+			"run %d: errors on valid messages", run);
+	}
+}
+
+// others change the coach info while a message is half way
+static void checkConcurrentChanges()
+{
+	const char* msg = "<RefboxEvent><Referee><GoalAwarded team=\"Cyan\"/></Referee></RefboxEvent>";
+	int len = strlen(msg);
+
+	for (int cut = 1; cut < len; cut++)
+	{
+		RefBoxXML parser;
+		DB_Coach_Info info;
+		initInfo(info);
+
+		CHECK(parser.feed(msg, cut, &info) == 0, "cut %d: message applied early", cut);
+
+		info.Coach_Info.gameState = SIGstart;
+		info.gTimeSecOffset = 42;
+		info.TeamColor = Magenta;
+
+		CHECK(parser.feed(msg + cut, len - cut, &info) == 1, "cut %d: message not applied", cut);
+		CHECK(info.Coach_Info.gameState == SIGstart && info.gTimeSecOffset == 42,
+			"cut %d: fields changed during the message were overwritten", cut);
+		CHECK(info.Coach_Info.theirGoals == 1 && info.Coach_Info.ourGoals == 0,
+			"cut %d: goal not counted with the current team color", cut);
+	}
+}
+
+static void checkGarbage()
+{
+	std::string valid = randomMessage();
+	char buffer[512];
+
+	for (int run = 0; run < 20000; run++)
+	{
+		RefBoxXML parser;
+		DB_Coach_Info info;
+		initInfo(info);
+
+		if (run & 1)
+		{
+			// random bytes, biased to the markup characters
+			static const char markup[] = "<>/?!-=\"' \nRefboxEventReferee";
+			int n = 1 + randomGenerator.randInt(sizeof(buffer) - 1);
+			for (int i = 0; i < n; i++)
+				buffer[i] = randomGenerator.randInt(1) ? markup[randomGenerator.randInt(sizeof(markup) - 2)]
+					: (char)randomGenerator.randInt(255);
+			feedSplit(parser, std::string(buffer, n), info, 32);
+		}
+		else
+		{
+			// a message with flipped, dropped or inserted bytes
+			std::string msg = randomMessage();
+			int n = 1 + randomGenerator.randInt(4);
+			for (int i = 0; i < n && !msg.empty(); i++)
+			{
+				unsigned int pos = randomGenerator.randInt(msg.size() - 1);
+				switch (randomGenerator.randInt(2))
+				{
+					case 0: msg[pos] = (char)randomGenerator.randInt(255); break;
+					case 1: msg.erase(pos, 1); break;
+					case 2: msg.insert(pos, 1, (char)randomGenerator.randInt(255)); break;
+				}
+			}
+			feedSplit(parser, msg, info, 32);
+		}
+
+		CHECK(info.gTimeSecOffset == 0 && info.TeamColor == Cyan,
+			"run %d: garbage changed fields no command sets", run);
+
+		parser.reset();
+		CHECK(parser.feed(valid.data(), valid.size(), &info) == 1,
+			"run %d: valid message not applied after a reset", run);
+	}
+}
+
+int main()
+{
+	checkSplits();
+	checkConcurrentChanges();
+
+	// the parser reports every error found in the garbage
+	freopen("/dev/null", "w", stderr);
+	checkGarbage();
+
+	return checkReport("refbox parser");
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "RtdbNotifier.h"
+
+RtdbNotifier::RtdbNotifier()
+{
+	stopping = false;
+
+	if (pipe(pipeFd) == -1)
+	{
+		perror("RtdbNotifier: pipe");
+		pipeFd[0] = pipeFd[1] = -1;
+		return;
+	}
+
+	/* A full pipe already means new data, the writer must never block */
+	fcntl(pipeFd[0], F_SETFL, fcntl(pipeFd[0], F_GETFL) | O_NONBLOCK);
+	fcntl(pipeFd[1], F_SETFL, fcntl(pipeFd[1], F_GETFL) | O_NONBLOCK);
+
+	for (int i = 0; i < MAX_AGENTS; i++)
+		agentCount[i] = DB_get_change_count(i);
+}
+
+RtdbNotifier::~RtdbNotifier()
+{
+	finish();
+
+	if (pipeFd[0] != -1)
+	{
+		close(pipeFd[0]);
+		close(pipeFd[1]);
+	}
+}
+
+void RtdbNotifier::acknowledge()
+{
+	char buffer[64];
+
+	while (read(pipeFd[0], buffer, sizeof(buffer)) > 0)
+		;
+}
+
+void RtdbNotifier::finish()
+{
+	stopping = true;
+	wait();
+}
+
+void RtdbNotifier::run()
+{
+	int seq = -1;
+	int self = Whoami();
+
+	if (pipeFd[1] == -1)
+		return;
+
+	while (!stopping)
+	{
+		int now = DB_wait_change(seq, RTDBNOTIFIER_TIMEOUT);
+
+		if (now == -1)
+		{
+			msleep(RTDBNOTIFIER_TIMEOUT);
+			continue;
+		}
+		if (now == seq)
+			continue;
+		seq = now;
+
+		/* Only writes of the other agents (comm) are news */
+		bool changed = false;
+		for (int i = 0; i < MAX_AGENTS; i++)
+		{
+			int count = DB_get_change_count(i);
+
+			if (count != agentCount[i] && i != self)
+				changed = true;
+			agentCount[i] = count;
+		}
+
+		if (changed)
+		{
+			char c = 0;
+			// EAGAIN: pipe full, the GUI did not read the previous ones yet
+			if (write(pipeFd[1], &c, 1) == -1 && errno != EAGAIN)
+				perror("RtdbNotifier: write");
+		}
+	}
+}
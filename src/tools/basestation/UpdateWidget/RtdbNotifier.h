@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA BASESTATION
+ *
+ * CAMBADA BASESTATION is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA BASESTATION is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RTDBNOTIFIER_H
+#define __RTDBNOTIFIER_H
+
+#include <QThread>
+
+#include "rtdb_api.h"
+
+#define RTDBNOTIFIER_TIMEOUT	200		//ms between checks of the stop flag
+
+/* Turns RtDB writes into a readable file descriptor
+ *
+ * The thread blocks in DB_wait_change and writes one byte to a pipe when
+ * the area of another agent changed (writes of the basestation itself
+ * are ignored), so the GUI can wait for new data with a QSocketNotifier
+ * on fd() instead of polling the database on a timer.
+ */
+class RtdbNotifier : public QThread
+{
+public:
+	RtdbNotifier();
+	~RtdbNotifier();
+
+	/* Read end of the pipe, readable when there is new data */
+	int fd() const { return pipeFd[0]; }
+
+	/* Empty the pipe, call before reading the database */
+	void acknowledge();
+
+	/* Stop the thread and wait for it */
+	void finish();
+
+protected:
+	void run();
+
+private:
+	int pipeFd[2];
+	volatile bool stopping;
+	int agentCount[MAX_AGENTS];
+};
+
+#endif
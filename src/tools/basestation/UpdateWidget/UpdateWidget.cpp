@@ -30,6 +30,14 @@ UpdateWidget::UpdateWidget()
 
 	Update_timer=new QTimer();
 	LogViewMode=false;
+	notifier=NULL;
+	dataNotifier=NULL;
+	lastChanges=-1;
+	reads=0;
+	wastedReads=0;
+	coachPending=false;
+	coachRequests=0;
+	coachWrites=0;
 	if( DB_init() == 0 || DB_init() == 0 || DB_init() == 0 )
 	{
 		printf("RtDB connection successful.\n");
@@ -46,7 +54,23 @@ UpdateWidget::UpdateWidget()
 	{
 		connect(Update_timer, SIGNAL(timeout ()), this, SLOT(UpdateInfo()));
 		//connect(Update_timer, SIGNAL(timeout ()), this, SLOT(transmitCoach()));
-		Update_timer->start(20);
+
+		/* Lê quando o comm escreve; o timer só fica para os robots que deixam de enviar */
+		notifier = new RtdbNotifier();
+		if (notifier->fd() != -1)
+		{
+			dataNotifier = new QSocketNotifier(notifier->fd(), QSocketNotifier::Read);
+			connect(dataNotifier, SIGNAL(activated(int)), this, SLOT(NewData()));
+			notifier->start();
+			Update_timer->start(UPDATE_FALLBACK_PERIOD);
+		}
+		else
+		{
+			delete notifier;
+			notifier = NULL;
+			Update_timer->start(UPDATE_POLL_PERIOD);
+		}
+		statsTime.start();
 	}
 
 	/* incializações da base de dados */
@@ -69,6 +93,8 @@ UpdateWidget::~UpdateWidget()
 {
 	disconnect(Update_timer, SIGNAL(timeout ()), this, SLOT(UpdateInfo()));
 	delete Update_timer;
+	delete dataNotifier;
+	delete notifier;
 	if( valid_connection )
 	{
 		DB_free();
@@ -76,6 +102,12 @@ UpdateWidget::~UpdateWidget()
 	}
 }
 
+void UpdateWidget::NewData(void)
+{
+	notifier->acknowledge();
+	UpdateInfo();
+}
+
 void UpdateWidget::UpdateInfo(void)
 {
 	if (LogViewMode)
@@ -83,6 +115,27 @@ void UpdateWidget::UpdateInfo(void)
 		return;
 	}
 	//return;
+
+	/* Conta as leituras que não trouxeram nada de novo dos robots */
+	int changes = 0;
+	for (int i=0; i<NROBOTS; i++)
+		changes += DB_get_change_count(i+1);
+
+	reads++;
+	if (changes == lastChanges)
+		wastedReads++;
+	lastChanges = changes;
+
+	if (statsTime.elapsed() > UPDATE_STATS_PERIOD)
+	{
+		fprintf(stderr, "UpdateWidget: %u RtDB reads, %u without new data (%s); coach: %u requests, %u writes\n",
+				reads, wastedReads, notifier != NULL ? "notified" : "polled", coachRequests, coachWrites);
+		reads = 0;
+		wastedReads = 0;
+		coachRequests = 0;
+		coachWrites = 0;
+		statsTime.restart();
+	}
 	
 	Robot temp_info;
 	LaptopInfo lpBatTemp[NROBOTS];
@@ -207,8 +260,21 @@ void UpdateWidget::transmitFormation(int formationId)
 
 }
 
+/* Os pedidos seguidos (timer e sinais dos widgets) juntam-se numa só escrita */
 void UpdateWidget::transmitCoach(void)
 {
+	coachRequests++;
+	if (coachPending)
+		return;
+
+	coachPending = true;
+	QTimer::singleShot(0, this, SLOT(publishCoach()));
+}
+
+void UpdateWidget::publishCoach(void)
+{
+	coachPending = false;
+
 	// update game time
 
 	if (DB_Coach.addLogTimeOffset) {	//When log viewing is disabled, restore the time previous
@@ -219,10 +285,27 @@ void UpdateWidget::transmitCoach(void)
 	DB_Coach.Coach_Info.time += DB_Coach.gTimeSecOffset;
 	DB_Coach.Coach_Info.time += DB_Coach.logTimeOffset;
 
-	if (valid_connection) {
-		if( (DB_put(COACH_INFO, (void*)(&DB_Coach.Coach_Info))) == -1 )
-			fprintf(stderr,"Error cenas");
+	if (!valid_connection)
+		return;
+
+	// only write when something changed, or to keep the record alive
+	bool changed = memcmp(&DB_Coach.Coach_Info, &lastCoach, sizeof(CoachInfo)) != 0;
+	if (!changed && !coachKeepalive.isNull() && coachKeepalive.elapsed() < COACH_KEEPALIVE_PERIOD)
+		return;
+
+	if (changed)
+	{
+		DB_Coach.Coach_Info.seq++;
+		if (DB_Coach.Coach_Info.seq == 0)
+			DB_Coach.Coach_Info.seq = 1;
 	}
+
+	if( (DB_put(COACH_INFO, (void*)(&DB_Coach.Coach_Info))) == -1 )
+		fprintf(stderr,"Error cenas");
+
+	memcpy(&lastCoach, &DB_Coach.Coach_Info, sizeof(CoachInfo));
+	coachKeepalive.start();
+	coachWrites++;
 }
 
 DB_Coach_Info * UpdateWidget::get_coach_pointer(void)
@@ -29,6 +29,12 @@
 #include "rtdb_api.h"
 #include "rtdb_user.h"
 #include "DB_Robot_info.h"
+#include "RtdbNotifier.h"
+
+#define UPDATE_POLL_PERIOD		20		//ms, polling when there is no change notification
+#define UPDATE_FALLBACK_PERIOD	250		//ms, lifetime of silent robots and coach info
+#define UPDATE_STATS_PERIOD		30000	//ms between reports of the read counters
+#define COACH_KEEPALIVE_PERIOD	1000	//ms, coach info is written again even if unchanged
 
 
 class UpdateWidget : public QWidget
@@ -41,6 +47,23 @@ private:
 	QTimer *Update_timer;
 	bool LogViewMode;
 
+	/* Change notification of the RtDB */
+	RtdbNotifier *notifier;
+	QSocketNotifier *dataNotifier;
+
+	/* Reads without new data from the robots */
+	int lastChanges;
+	unsigned int reads;
+	unsigned int wastedReads;
+	QTime statsTime;
+
+	/* Coach info published only when changed, once per burst of requests */
+	bool coachPending;
+	CoachInfo lastCoach;
+	QTime coachKeepalive;
+	unsigned int coachRequests;
+	unsigned int coachWrites;
+
 public: 
 	UpdateWidget();
 	virtual ~UpdateWidget();
@@ -58,7 +81,9 @@ public:
 
 public slots:
 	void UpdateInfo(void);
+	void NewData(void);
 	void transmitCoach(void);
+	void publishCoach(void);
 	void SetLogViewMode (bool on_off);
 
 	
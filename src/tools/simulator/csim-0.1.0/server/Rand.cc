@@ -43,6 +43,13 @@ Rand::~Rand()
 {
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// Restart the random sequence
+void Rand::SetSeed(unsigned int seed)
+{
+  randGenerator->seed(seed);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Get a double from a uniform distribution
 double Rand::GetDblUniform(double min, double max)
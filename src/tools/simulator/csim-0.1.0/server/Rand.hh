@@ -49,6 +49,10 @@ namespace gazebo
 
     /// \brief Destructor
     private: virtual ~Rand();
+
+    /// \brief Restart the random sequence
+    /// \param seed Seed of the generator
+    public: static void SetSeed(unsigned int seed);
  
     /// \brief Get a double from a uniform distribution
     /// \param min Minimum bound for the random number
@@ -0,0 +1,236 @@
+/*
+ *  Gazebo - Outdoor Multi-Robot Simulator
+ *  Copyright (C) 2003
+ *     Nate Koenig & Andrew Howard
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/* Desc: Determinism check of the parallel sensor compute stage
+ *
+ * The world file is run twice, each time in its own process with the same
+ * random seed: once with a single sensor thread and once with the
+ * requested number of threads. After every step the VISION_INFO record of
+ * every agent is read back from the RTDB and written out, together with
+ * one draw of the noise generator as a probe of its state. Both outputs
+ * must be identical, the first difference is reported.
+ *
+ * Usage: csim-sensor-check [-n steps] [-j threads] [-r seed] <worldfile>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <iostream>
+
+#include <config.h>
+#include "Simulator.hh"
+#include "World.hh"
+#include "PhysicsEngine.hh"
+#include "Referee.hh"
+#include "Visual.hh"
+#include "GazeboError.hh"
+#include "SensorManager.hh"
+#include "Rand.hh"
+
+#include "rtdb_api.h"
+#include "rtdb_sim.h"
+#include "rtdb_user.h"
+#include "VisionInfo.h"
+
+unsigned int optSteps = 500;
+unsigned int optThreads = 4;
+unsigned int optSeed = 2015;
+
+////////////////////////////////////////////////////////////////////////////////
+// Write the vision records of all agents and a random probe of one step
+void WriteStep(FILE *out, unsigned int step)
+{
+  VisionInfo info;
+  int i;
+
+  for (int agent = 1; agent < N_AGENTS; agent++)
+  {
+    if (DB_get_from(agent, agent, VISION_INFO, &info) < 0)
+      continue;
+
+    fprintf(out, "%u %d ball %d", step, agent, info.nBalls);
+    for (i = 0; i < info.nBalls && i < MAX_BALLS; i++)
+      fprintf(out, " %a %a", info.ball[i].position.x, info.ball[i].position.y);
+
+    fprintf(out, " obstacles %d", info.obstacles.nPoints);
+    for (i = 0; i < info.obstacles.nPoints && i < MAX_POINTS; i++)
+      fprintf(out, " %a %a", info.obstacles.point[i].x,
+              info.obstacles.point[i].y);
+
+    fprintf(out, " lines %d", info.lines.nPoints);
+    for (i = 0; i < info.lines.nPoints && i < MAX_POINTS; i++)
+      fprintf(out, " %a %a", info.lines.point[i].x, info.lines.point[i].y);
+
+    fprintf(out, "\n");
+  }
+
+  // Both runs draw at the same point, so the sequences stay aligned
+  fprintf(out, "%u rand %a\n", step, gazebo::Rand::GetDblUniform());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Run the world file with the given number of sensor threads
+int RunScenario(const char *worldFile, unsigned int serverId,
+                unsigned int threads, FILE *out)
+{
+  try
+  {
+    gazebo::Rand::SetSeed(optSeed);
+
+    gazebo::Simulator::Instance()->Load(worldFile, serverId);
+    gazebo::Simulator::Instance()->SetPaused(false);
+    visual::VisualApp::Instance()->SetEnabled(false);
+
+    gazebo::Simulator::Instance()->Init();
+    gazebo::Referee::Instance()->Init();
+
+    gazebo::SensorManager::Instance()->SetThreads(threads);
+
+    gazebo::Simulator *simulator = gazebo::Simulator::Instance();
+    gazebo::World *world = gazebo::World::Instance();
+    gazebo::Time stepTime = world->GetPhysicsEngine()->GetStepTime();
+
+    for (unsigned int step = 0; step < optSteps; step++)
+    {
+      simulator->SetSimTime(simulator->GetSimTime() + stepTime);
+      world->Update();
+      WriteStep(out, step);
+    }
+
+    gazebo::Simulator::Instance()->Fini();
+    gazebo::Referee::Instance()->Fini();
+  }
+  catch (gazebo::GazeboError e)
+  {
+    std::cerr << "Scenario failed" << std::endl;
+    std::cerr << e << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Run a scenario in a child process, its output goes to a temporary file
+FILE *RunChild(const char *worldFile, unsigned int serverId,
+               unsigned int threads)
+{
+  FILE *out = tmpfile();
+  int status;
+  pid_t pid;
+
+  if (out == NULL)
+    return NULL;
+
+  pid = fork();
+  if (pid < 0)
+  {
+    fclose(out);
+    return NULL;
+  }
+
+  if (pid == 0)
+  {
+    // Keep clear of the interactive simulator namespace
+    setenv("RTDB_NAMESPACE", "99", 1);
+
+    int ret = RunScenario(worldFile, serverId, threads, out);
+    fflush(out);
+    _exit(ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != EXIT_SUCCESS)
+  {
+    fclose(out);
+    return NULL;
+  }
+
+  rewind(out);
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function
+int main(int argc, char **argv)
+{
+  char serialLine[65536], parallelLine[65536];
+  unsigned long lines = 0;
+  FILE *serial, *parallel;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "n:j:r:h")) != -1)
+  {
+    switch (ch)
+    {
+      case 'n': optSteps = atoi(optarg); break;
+      case 'j': optThreads = atoi(optarg); break;
+      case 'r': optSeed = atoi(optarg); break;
+      default:
+        fprintf(stderr, "Usage: csim-sensor-check [-n steps] [-j threads] "
+                "[-r seed] <worldfile>\n");
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (optind >= argc)
+  {
+    fprintf(stderr, "Usage: csim-sensor-check [-n steps] [-j threads] "
+            "[-r seed] <worldfile>\n");
+    return EXIT_FAILURE;
+  }
+
+#ifndef PARALLEL_SENSORS
+  fprintf(stderr, "Built without PARALLEL_SENSORS, both runs are serial\n");
+#endif
+
+  serial = RunChild(argv[optind], 90, 1);
+  parallel = RunChild(argv[optind], 91, optThreads);
+  if (serial == NULL || parallel == NULL)
+  {
+    fprintf(stderr, "Scenario run failed\n");
+    return EXIT_FAILURE;
+  }
+
+  for (;;)
+  {
+    char *s = fgets(serialLine, sizeof(serialLine), serial);
+    char *p = fgets(parallelLine, sizeof(parallelLine), parallel);
+
+    if (s == NULL && p == NULL)
+      break;
+
+    if (s == NULL || p == NULL || strcmp(s, p) != 0)
+    {
+      printf("Mismatch at line %lu\n  serial:   %s  parallel: %s",
+             lines + 1, s ? s : "<end>\n", p ? p : "<end>\n");
+      return EXIT_FAILURE;
+    }
+    lines++;
+  }
+
+  printf("%u steps, %lu records: serial and %u threads match\n",
+         optSteps, lines, optThreads);
+  return EXIT_SUCCESS;
+}
@@ -129,6 +129,15 @@ void Simulator::Close()
 /// Load the world configuration file
 /// Any error that reach this level must make the simulator exit
 void Simulator::Load(const std::string &worldFileName, unsigned int serverId )
+{
+  this->LoadFile(worldFileName);
+  this->Load(serverId);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Parse the world file and the local configuration, the world is not created
+/// The batch runner calls it before forking, the worker only calls Load(serverId)
+void Simulator::LoadFile(const std::string &worldFileName)
 {
   this->state = LOAD;
 
@@ -139,6 +148,8 @@ void Simulator::Load(const std::string &worldFileName, unsigned int serverId )
   }
 
   // Load the world file
+  if (this->xmlFile)
+    delete this->xmlFile;
   this->xmlFile=new gazebo::XMLConfig();
   try
   {
@@ -149,12 +160,10 @@ void Simulator::Load(const std::string &worldFileName, unsigned int serverId )
     gzthrow("The XML config file can not be loaded, please make sure is a correct file\n" << e); 
   }
 
-  XMLConfigNode *rootNode(xmlFile->GetRootNode());
-
-  // Load the messaging system
-  gazebo::GazeboMessage::Instance()->Load(rootNode);
+  // load the configuration options, the same for every world file
+  if (this->gazeboConfig)
+    return;
 
-  // load the configuration options 
   this->gazeboConfig=new gazebo::GazeboConfig();
   try
   {
@@ -164,6 +173,21 @@ void Simulator::Load(const std::string &worldFileName, unsigned int serverId )
   {
     gzthrow("Error loading the Gazebo configuration file, check the .gazeborc file on your HOME directory \n" << e); 
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the world of the file parsed by LoadFile
+void Simulator::Load(unsigned int serverId)
+{
+  this->state = LOAD;
+
+  // The real time, and the timeout, count from the creation of the world
+  this->startTime = this->GetWallTime();
+
+  XMLConfigNode *rootNode(xmlFile->GetRootNode());
+
+  // Load the messaging system
+  gazebo::GazeboMessage::Instance()->Load(rootNode);
 
   //Create the world
   try
@@ -271,6 +295,10 @@ void Simulator::MainLoop()
   struct timespec timeSpec;
   double freq = 50.0; // used to be 80
 
+  // Let the gui keep up with the render rate
+  if (visual::VisualApp::Instance()->GetUpdateRate() > freq)
+    freq = visual::VisualApp::Instance()->GetUpdateRate();
+
   this->physicsThread = new boost::thread( 
                          boost::bind(&Simulator::PhysicsLoop, this));
 
@@ -521,6 +549,9 @@ void Simulator::PhysicsLoop()
       boost::recursive_mutex::scoped_lock lock(*this->mutex);
       world->Update();
       //referee->ApplyRules();
+
+      // Hand the new poses to the renderer
+      visual::VisualApp::Instance()->Capture();
     }
 
     currTime = this->GetRealTime();
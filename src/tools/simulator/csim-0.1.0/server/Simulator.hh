@@ -89,6 +89,13 @@ namespace gazebo
     /// \brief Load the world configuration file 
     public: void Load(const std::string &worldFileName, unsigned int serverId );
 
+    /// \brief Parse the world file and the local configuration, without
+    ///        creating the world
+    public: void LoadFile(const std::string &worldFileName);
+
+    /// \brief Create the world of the world file parsed by LoadFile
+    public: void Load(unsigned int serverId);
+
     /// \brief Save the world configuration file
     public: void Save(const std::string& filename=std::string());
 
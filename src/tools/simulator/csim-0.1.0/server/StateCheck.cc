@@ -0,0 +1,244 @@
+/*
+ *  Gazebo - Outdoor Multi-Robot Simulator
+ *  Copyright (C) 2003
+ *     Nate Koenig & Andrew Howard
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/* Desc: Round trip check of the world state snapshots
+ *
+ * Every dynamic body of the world file gets a random velocity, then the
+ * world state is captured and the simulation runs for a number of steps,
+ * recording the state after each one. The capture is applied again and the
+ * same steps are run a second time: the states must match the first run
+ * bit for bit. The time taken by ApplyState is reported too.
+ *
+ * The kick keeps every body above the ODE auto-disable threshold at the
+ * capture, as the idle timers are not part of a snapshot (see WorldState).
+ *
+ * Usage: csim-state-check [-n steps] [-r seed] <worldfile>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <config.h>
+#include "Simulator.hh"
+#include "World.hh"
+#include "PhysicsEngine.hh"
+#include "Model.hh"
+#include "Body.hh"
+#include "Referee.hh"
+#include "Visual.hh"
+#include "GazeboError.hh"
+#include "SensorManager.hh"
+#include "Rand.hh"
+
+using namespace gazebo;
+
+unsigned int optSteps = 200;
+unsigned int optSeed = 2015;
+
+#define APPLY_REPEAT 100
+
+////////////////////////////////////////////////////////////////////////////////
+// Compare two arrays of doubles bit for bit
+bool Same(const double *a, const double *b, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; i++)
+    if (memcmp(&a[i], &b[i], sizeof(double)) != 0)
+      return false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Compare two snapshots, print the first difference
+bool Compare(const WorldState &a, const WorldState &b, unsigned int step)
+{
+  unsigned int i;
+
+  if (a.models.size() != b.models.size() || a.bodies.size() != b.bodies.size())
+  {
+    printf("Step %u: the layout changed\n", step);
+    return false;
+  }
+
+  for (i = 0; i < a.models.size(); i++)
+  {
+    if (!Same(a.models[i].pos, b.models[i].pos, 3) ||
+        !Same(a.models[i].rot, b.models[i].rot, 4))
+    {
+      printf("Step %u: model %u pose differs\n", step, i);
+      return false;
+    }
+  }
+
+  for (i = 0; i < a.bodies.size(); i++)
+  {
+    const WorldState::BodyRecord &ra = a.bodies[i];
+    const WorldState::BodyRecord &rb = b.bodies[i];
+
+    if (!Same(ra.pos, rb.pos, 3) || !Same(ra.rot, rb.rot, 4))
+      printf("Step %u: body %u pose differs\n", step, i);
+    else if (!Same(ra.linearVel, rb.linearVel, 3) ||
+             !Same(ra.angularVel, rb.angularVel, 3))
+      printf("Step %u: body %u velocity differs\n", step, i);
+    else if (ra.enabled != rb.enabled)
+      printf("Step %u: body %u enabled flag differs\n", step, i);
+    else
+      continue;
+
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Give every dynamic body a random velocity
+void Kick(World *world)
+{
+  std::vector<Model*>::iterator mIter;
+  std::map<std::string, Body*>::const_iterator bIter;
+
+  for (mIter = world->GetModels().begin(); mIter != world->GetModels().end();
+       mIter++)
+  {
+    if ((*mIter)->IsStatic())
+      continue;
+
+    const std::map<std::string, Body*> *bodies = (*mIter)->GetBodies();
+    for (bIter = bodies->begin(); bIter != bodies->end(); bIter++)
+    {
+      bIter->second->SetEnabled(true);
+      bIter->second->SetLinearVel(Vector3(Rand::GetDblUniform(-3, 3),
+                                          Rand::GetDblUniform(-3, 3), 0));
+      bIter->second->SetAngularVel(Vector3(0, 0, Rand::GetDblUniform(-3, 3)));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function
+int main(int argc, char **argv)
+{
+  std::vector<WorldState> trace;
+  WorldState start, state;
+  unsigned int step;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "n:r:h")) != -1)
+  {
+    switch (ch)
+    {
+      case 'n': optSteps = atoi(optarg); break;
+      case 'r': optSeed = atoi(optarg); break;
+      default:
+        fprintf(stderr, "Usage: csim-state-check [-n steps] [-r seed] "
+                "<worldfile>\n");
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (optind >= argc)
+  {
+    fprintf(stderr, "Usage: csim-state-check [-n steps] [-r seed] "
+            "<worldfile>\n");
+    return EXIT_FAILURE;
+  }
+
+  // Keep clear of the interactive simulator namespace
+  setenv("RTDB_NAMESPACE", "99", 1);
+
+  try
+  {
+    Rand::SetSeed(optSeed);
+
+    Simulator::Instance()->Load(argv[optind], 92);
+    Simulator::Instance()->SetPaused(false);
+    visual::VisualApp::Instance()->SetEnabled(false);
+
+    Simulator::Instance()->Init();
+    Referee::Instance()->Init();
+
+    // Same order of noise draws in both runs
+    SensorManager::Instance()->SetThreads(1);
+
+    Simulator *simulator = Simulator::Instance();
+    World *world = World::Instance();
+    Time stepTime = world->GetPhysicsEngine()->GetStepTime();
+
+    Kick(world);
+    world->CaptureState(start);
+
+    trace.resize(optSteps);
+    for (step = 0; step < optSteps; step++)
+    {
+      simulator->SetSimTime(simulator->GetSimTime() + stepTime);
+      world->Update();
+      world->CaptureState(trace[step]);
+    }
+
+    Time t0 = Time::GetWallTime();
+    for (unsigned int i = 0; i < APPLY_REPEAT; i++)
+    {
+      if (!world->ApplyState(start))
+      {
+        fprintf(stderr, "ApplyState rejected the capture\n");
+        return EXIT_FAILURE;
+      }
+    }
+    Time t1 = Time::GetWallTime();
+
+    world->CaptureState(state);
+    if (!Compare(start, state, 0))
+    {
+      printf("The capture does not round trip\n");
+      return EXIT_FAILURE;
+    }
+
+    for (step = 0; step < optSteps; step++)
+    {
+      simulator->SetSimTime(simulator->GetSimTime() + stepTime);
+      world->Update();
+      world->CaptureState(state);
+
+      if (!Compare(trace[step], state, step + 1))
+        return EXIT_FAILURE;
+    }
+
+    printf("%u bodies, %u steps match after restore, ApplyState %.1f us\n",
+           (unsigned int)start.bodies.size(), optSteps,
+           (t1 - t0).Double() * 1e6 / APPLY_REPEAT);
+
+    Simulator::Instance()->Fini();
+    Referee::Instance()->Fini();
+  }
+  catch (GazeboError e)
+  {
+    std::cerr << "Scenario failed" << std::endl;
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -74,6 +74,10 @@ World::World()
   this->factory = NULL;
 
   this->field = new csim::Field();
+
+  this->stateLayout = 0;
+  this->stateLayoutDirty = true;
+  this->savedState = new WorldState();
   
   Param::Begin(&this->parameters);
   this->threadsP = new ParamT<int>("threads",2,0);
@@ -88,6 +92,10 @@ World::World()
 World::~World()
 {
   this->Close();
+
+  if (this->savedState)
+    delete this->savedState;
+  this->savedState = NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -214,8 +222,7 @@ void World::Load(XMLConfigNode *rootNode, unsigned int serverId)
   this->worldStates.resize(**this->saveStateBufferSizeP);
   this->worldStatesInsertIter = this->worldStates.begin();
   this->worldStatesEndIter = this->worldStates.begin();
-  this->worldStatesCurrentIter = this->worldStatesInsertIter;
-
+  this->worldStatesCurrentIter = this->worldStates.end();
 
 #ifdef USE_THREADPOOL
   // start a thread pool with X threads
@@ -266,13 +273,17 @@ void World::Init()
   // Initialize the physics engine
   this->physicsEngine->Init();
 
+  // Start the sensor compute stage threads
+  SensorManager::Instance()->SetThreads(
+      **this->threadsP > 0 ? **this->threadsP : 1);
+
   this->toDeleteModels.clear();
   this->toLoadEntities.clear();
 
   this->factory->Init();
-  this->saveStateTimer.Start();
-  
+
   this->SaveState();
+  this->PushState();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -328,11 +339,9 @@ void World::Update()
       this->physicsEngine->UpdatePhysics();
     }
 
-    /*if (this->saveStateTimer.GetElapsed() > **this->saveStateTimeoutP)
-    {
-      this->SaveState();
-      this->saveStateTimer.Start();
-    }*/
+    if (Simulator::Instance()->GetSimTime() - this->lastStateTime >=
+        **this->saveStateTimeoutP)
+      this->PushState();
   }
 
   this->factory->Update();
@@ -344,6 +353,9 @@ void World::Fini()
 {
   std::vector< Model* >::iterator miter;
 
+  // Stop the sensor compute stage threads
+  SensorManager::Instance()->SetThreads(1);
+
   // Finalize the models
   for (miter=this->models.begin(); miter!=this->models.end(); miter++)
   {
@@ -482,6 +494,7 @@ void World::DeleteEntity(const char *name)
     {
       (*miter)->Fini();
       this->toDeleteModels.push_back(*miter);
+      this->stateLayoutDirty = true;
     }
   }
 }
@@ -503,6 +516,7 @@ Model *World::LoadModel(XMLConfigNode *node, Model *parent, bool removeDuplicate
 
   // Add the model to our list
   this->models.push_back(model);
+  this->stateLayoutDirty = true;
 
   if (Simulator::Instance()->GetSimTime() > 0)
     model->Init();
@@ -1319,38 +1333,163 @@ void World::GetInterfaceNames(Entity* en, std::vector<std::string>& list)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Save the state of the world
-void World::SaveState()
+// Rebuild the list of dynamic models and bodies
+void World::UpdateStateLayout()
 {
-
   std::vector<Model*>::iterator mIter;
-  
-  for (mIter = this->models.begin(); mIter != this->models.end(); mIter++){
-  
+  std::deque<WorldState>::iterator sIter;
+
+  this->stateModels.clear();
+  this->stateBodies.clear();
+  this->stateModelFirstBody.clear();
+
+  for (mIter = this->models.begin(); mIter != this->models.end(); mIter++)
+  {
     if ( (*mIter)->IsStatic() ) continue;
-  
-    this->modelAbsPose[(*mIter)->GetName()]     = (*mIter)->GetAbsPose();
-    this->modelLinearVel[(*mIter)->GetName()]   = (*mIter)->GetLinearVel();
-    this->modelLinearAccel[(*mIter)->GetName()] = (*mIter)->GetLinearAccel();
-    this->modelAngularVel[(*mIter)->GetName()]  = (*mIter)->GetAngularVel();
-    this->modelAngularAccel[(*mIter)->GetName()]= (*mIter)->GetAngularAccel();
+
+    this->stateModels.push_back(*mIter);
+    this->stateModelFirstBody.push_back(this->stateBodies.size());
+
+    const std::map<std::string, Body*> *bodies = (*mIter)->GetBodies();
+    std::map<std::string, Body*>::const_iterator bIter;
+
+    for (bIter = bodies->begin(); bIter != bodies->end(); bIter++)
+      this->stateBodies.push_back(bIter->second);
   }
+  this->stateModelFirstBody.push_back(this->stateBodies.size());
 
-#if 0
-  std::vector<Model*>::iterator mIter;
-  std::vector<Body*>::iterator bIter;
-  std::vector<Geom*>::iterator gIter;
+  // Preallocate the ring, so that saving never allocates
+  for (sIter = this->worldStates.begin(); sIter != this->worldStates.end();
+       sIter++)
+  {
+    sIter->models.resize(this->stateModels.size());
+    sIter->bodies.resize(this->stateBodies.size());
+    sIter->valid = false;
+  }
 
-  WorldState *ws = &(*this->worldStatesInsertIter);
-  for (mIter = this->models.begin(); mIter != this->models.end(); mIter++)
-    ws->modelPoses[(*mIter)->GetName()] = (*mIter)->GetRelativePose();
+  // Snapshots of the old layout can not be applied anymore
+  this->worldStatesInsertIter = this->worldStates.begin();
+  this->worldStatesEndIter = this->worldStates.begin();
+  this->worldStatesCurrentIter = this->worldStates.end();
+
+  this->stateLayout++;
+  this->stateLayoutDirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy the state of all dynamic bodies into a snapshot
+void World::CaptureState(WorldState &state)
+{
+  boost::recursive_mutex::scoped_lock lock(
+      *Simulator::Instance()->GetMRMutex());
+
+  unsigned int i;
+
+  if (this->stateLayoutDirty)
+    this->UpdateStateLayout();
+
+  state.models.resize(this->stateModels.size());
+  state.bodies.resize(this->stateBodies.size());
+
+  for (i = 0; i < this->stateModels.size(); i++)
+  {
+    WorldState::ModelRecord &rec = state.models[i];
+    Pose3d pose = this->stateModels[i]->GetRelativePose();
+
+    rec.pos[0] = pose.pos.x;
+    rec.pos[1] = pose.pos.y;
+    rec.pos[2] = pose.pos.z;
+    rec.rot[0] = pose.rot.u;
+    rec.rot[1] = pose.rot.x;
+    rec.rot[2] = pose.rot.y;
+    rec.rot[3] = pose.rot.z;
+  }
+
+  for (i = 0; i < this->stateBodies.size(); i++)
+  {
+    WorldState::BodyRecord &rec = state.bodies[i];
+    Body *body = this->stateBodies[i];
+    Pose3d pose = body->GetRelativePose();
+    Vector3 vel;
+
+    rec.pos[0] = pose.pos.x;
+    rec.pos[1] = pose.pos.y;
+    rec.pos[2] = pose.pos.z;
+    rec.rot[0] = pose.rot.u;
+    rec.rot[1] = pose.rot.x;
+    rec.rot[2] = pose.rot.y;
+    rec.rot[3] = pose.rot.z;
+
+    vel = body->GetLinearVel();
+    rec.linearVel[0] = vel.x;
+    rec.linearVel[1] = vel.y;
+    rec.linearVel[2] = vel.z;
+
+    vel = body->GetAngularVel();
+    rec.angularVel[0] = vel.x;
+    rec.angularVel[1] = vel.y;
+    rec.angularVel[2] = vel.z;
+
+    rec.enabled = body->GetEnabled() ? 1 : 0;
+  }
+
+  state.simTime = Simulator::Instance()->GetSimTime();
+  state.layout = this->stateLayout;
+  state.valid = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Save the state of the world in the restore slot
+void World::SaveState()
+{
+  this->CaptureState(*this->savedState);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Save the state of a specific model in the restore slot
+void World::SaveModelState(Model* model)
+{
+  WorldState tmp;
+  unsigned int i, b;
+
+  if ( model->IsStatic() ) return;
+
+  // Without a full save there is nothing to update
+  if (!this->savedState->valid ||
+      this->savedState->layout != this->stateLayout ||
+      this->stateLayoutDirty)
+  {
+    this->SaveState();
+    return;
+  }
+
+  for (i = 0; i < this->stateModels.size(); i++)
+    if (this->stateModels[i] == model)
+      break;
+
+  if (i == this->stateModels.size())
+    return;
+
+  this->CaptureState(tmp);
 
-  for (bIter = this->bodies.begin(); bIter !=this->bodies.end(); bIter++)
-    ws->bodyPoses[(*bIter)->GetName()] = (*bIter)->GetRelativePose();
+  this->savedState->models[i] = tmp.models[i];
+  for (b = this->stateModelFirstBody[i]; b < this->stateModelFirstBody[i+1];
+       b++)
+    this->savedState->bodies[b] = tmp.bodies[b];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Push the current state in the rewind ring
+void World::PushState()
+{
+  if (this->worldStates.empty())
+    return;
+
+  if (this->stateLayoutDirty)
+    this->UpdateStateLayout();
 
-  for (gIter = this->geometries.begin(); gIter !=this->geometries.end(); 
-       gIter++)
-    ws->geomPoses[(*gIter)->GetName()] = (*gIter)->GetRelativePose();
+  this->CaptureState(*this->worldStatesInsertIter);
+  this->lastStateTime = this->worldStatesInsertIter->simTime;
 
   this->worldStatesInsertIter++;
   if (this->worldStatesInsertIter == this->worldStates.end())
@@ -1364,19 +1503,6 @@ void World::SaveState()
       this->worldStatesEndIter = this->worldStates.begin();
     }
   }
-#endif
-}
-
-void World::SaveModelState(Model* model){
-
-  if ( model->IsStatic() ) return;
-  
-  this->modelAbsPose[model->GetName()]     = model->GetAbsPose();
-  this->modelLinearVel[model->GetName()]   = model->GetLinearVel();
-  this->modelLinearAccel[model->GetName()] = model->GetLinearAccel();
-  this->modelAngularVel[model->GetName()]  = model->GetAngularVel();
-  this->modelAngularAccel[model->GetName()]= model->GetAngularAccel();
-
 }
 
 Json::Value World::GetDynamicModelsState(){
@@ -1526,50 +1652,82 @@ void World::SetDynamicModelsState(const Json::Value& root){
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Restore the state of the world
-void World::RestoreState(){
+// Apply a snapshot to all dynamic bodies
+bool World::ApplyState(const WorldState &state)
+{
+  boost::recursive_mutex::scoped_lock lock(
+      *Simulator::Instance()->GetMRMutex());
 
-  std::vector<Model*>::iterator mIter;
-  
-  for (mIter = this->models.begin(); mIter != this->models.end(); mIter++){
-  
-    if ( (*mIter)->IsStatic() ) continue;
-    
-    (*mIter)->SetAbsPose( this->modelAbsPose[(*mIter)->GetName()] );
-    (*mIter)->SetLinearVel(this->modelLinearVel[(*mIter)->GetName()] );
-    (*mIter)->SetLinearAccel(this->modelLinearAccel[(*mIter)->GetName()] );
-    (*mIter)->SetAngularVel(this->modelAngularVel[(*mIter)->GetName()] );
-    (*mIter)->SetAngularAccel(this->modelAngularAccel[(*mIter)->GetName()] );
-    
-    (*mIter)->GetCanonicalBody()->SetEnabled(true);
-    (*mIter)->Restore();
+  unsigned int i;
+  Pose3d pose;
+
+  if (!state.valid || this->stateLayoutDirty ||
+      state.layout != this->stateLayout)
+  {
+    gzerr(0) << "World state does not match the current world\n";
+    return false;
   }
 
+  // Set all the relative poses first, so that the absolute pose of
+  // every body is known before it is written to the physics engine
+  for (i = 0; i < this->stateModels.size(); i++)
+  {
+    const WorldState::ModelRecord &rec = state.models[i];
+
+    pose.pos.Set(rec.pos[0], rec.pos[1], rec.pos[2]);
+    pose.rot.Set(rec.rot[0], rec.rot[1], rec.rot[2], rec.rot[3]);
+    this->stateModels[i]->SetRelativePose(pose, false);
+  }
+
+  for (i = 0; i < this->stateBodies.size(); i++)
+  {
+    const WorldState::BodyRecord &rec = state.bodies[i];
+
+    pose.pos.Set(rec.pos[0], rec.pos[1], rec.pos[2]);
+    pose.rot.Set(rec.rot[0], rec.rot[1], rec.rot[2], rec.rot[3]);
+    this->stateBodies[i]->SetRelativePose(pose, false);
+  }
+
+  for (i = 0; i < this->stateBodies.size(); i++)
+  {
+    const WorldState::BodyRecord &rec = state.bodies[i];
+    Body *body = this->stateBodies[i];
+
+    body->SetRelativePose(body->GetRelativePose(), true);
+    body->SetLinearVel(Vector3(rec.linearVel[0], rec.linearVel[1],
+                               rec.linearVel[2]));
+    body->SetAngularVel(Vector3(rec.angularVel[0], rec.angularVel[1],
+                                rec.angularVel[2]));
+    body->SetEnabled(rec.enabled != 0);
+  }
+
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Set the state of the world to the pos pointed to by the iterator
-void World::SetState(std::deque<WorldState>::iterator iter)
-{
+// Restore the state of the world from the restore slot
+void World::RestoreState(){
 
-#if 0
   std::vector<Model*>::iterator mIter;
-  std::vector<Body*>::iterator bIter;
-  std::vector<Geom*>::iterator gIter;
 
-  WorldState *ws = &(*iter);
-  for (mIter = this->models.begin(); mIter != this->models.end(); mIter++)
-    (*mIter)->SetRelativePose( ws->modelPoses[(*mIter)->GetName()] );
+  if (!this->ApplyState(*this->savedState))
+    return;
 
-  for (bIter = this->bodies.begin(); bIter !=this->bodies.end(); bIter++)
-    (*bIter)->SetRelativePose( ws->bodyPoses[(*bIter)->GetName()] );
+  // Let the agents know their robots were moved
+  for (mIter = this->stateModels.begin(); mIter != this->stateModels.end();
+       mIter++)
+    (*mIter)->Restore();
 
-  for (gIter = this->geometries.begin(); gIter !=this->geometries.end(); 
-       gIter++)
-    (*gIter)->SetRelativePose( ws->geomPoses[(*gIter)->GetName()] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Set the state of the world to the pos pointed to by the iterator
+void World::SetState(std::deque<WorldState>::iterator iter)
+{
+  if (!this->ApplyState(*iter))
+    return;
 
   this->worldStatesCurrentIter = iter;
-#endif
 }
 
 
@@ -1577,33 +1735,49 @@ void World::SetState(std::deque<WorldState>::iterator iter)
 /// Goto a position in time
 void World::GotoTime(double pos)
 {
-  Simulator::Instance()->SetPaused(true);
+  int size = this->worldStates.size();
+  int count, back;
+  std::deque<WorldState>::iterator iter;
 
-  this->worldStatesCurrentIter = this->worldStatesInsertIter;
+  if (this->stateLayoutDirty)
+    this->UpdateStateLayout();
 
-  int diff = this->worldStatesInsertIter - this->worldStatesEndIter;
+  count = (this->worldStatesInsertIter - this->worldStatesEndIter + size);
+  if (size > 0)
+    count %= size;
 
-  int i = (int)(diff * (1.0-pos));
+  if (count == 0)
+    return;
 
-  if (this->worldStatesCurrentIter == this->worldStates.begin())
-    this->worldStatesCurrentIter = this->worldStates.end()--;
+  Simulator::Instance()->SetPaused(true);
 
-  for (;i>=0; i--, this->worldStatesCurrentIter--)
-  {
-    if (this->worldStatesCurrentIter == this->worldStatesEndIter)
-      break;
+  if (pos < 0.0)
+    pos = 0.0;
+  if (pos > 1.0)
+    pos = 1.0;
 
-    if (this->worldStatesCurrentIter == this->worldStates.begin())
-      this->worldStatesCurrentIter = this->worldStates.end()-1;
-  }
+  // pos 1.0 is the latest snapshot, 0.0 the oldest one
+  back = 1 + (int)((count - 1) * (1.0 - pos) + 0.5);
+
+  iter = this->worldStates.begin() +
+    (this->worldStatesInsertIter - this->worldStates.begin() - back + size)
+    % size;
 
-  this->SetState(this->worldStatesCurrentIter);
+  this->SetState(iter);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Pause callback
 void World::PauseSlot(bool p)
 {
-  if (!p)
-    this->worldStatesInsertIter = this->worldStatesCurrentIter;
+  // Resuming after a rewind drops the snapshots that came after it
+  if (!p && this->worldStatesCurrentIter != this->worldStates.end())
+  {
+    this->worldStatesInsertIter = this->worldStatesCurrentIter + 1;
+    if (this->worldStatesInsertIter == this->worldStates.end())
+      this->worldStatesInsertIter = this->worldStates.begin();
+
+    this->lastStateTime = Simulator::Instance()->GetSimTime();
+    this->worldStatesCurrentIter = this->worldStates.end();
+  }
 }
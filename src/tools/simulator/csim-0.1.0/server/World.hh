@@ -182,7 +182,7 @@ class World : public SingletonT<World>
   /// \brief Goto a position in time
   public: void GotoTime(double pos);
 
-  /// \brief Save the state of the world
+  /// \brief Save the state of the world in the restore slot
   public: void SaveState();
 
   /// \brief Return a json object with the state of all dynamic models.
@@ -191,14 +191,28 @@ class World : public SingletonT<World>
   /// \brief Set the state of the dynamic models given a json root.
   public: void SetDynamicModelsState(const Json::Value& root);
 
-  /// \brief Save the state of a specific model
+  /// \brief Save the state of a specific model in the restore slot
   public: void SaveModelState(Model* model);
-  /// \brief Restore the state of the world
+
+  /// \brief Restore the state of the world from the restore slot
   public: void RestoreState();
 
-  /// \breif Set the state of the world to the pos pointed to by the iterator
+  /// \brief Set the state of the world to the pos pointed to by the iterator
   public: void SetState(std::deque<WorldState>::iterator iter);
-  
+
+  /// \brief Copy the state of all dynamic bodies into a snapshot
+  public: void CaptureState(WorldState &state);
+
+  /// \brief Apply a snapshot to all dynamic bodies
+  /// \return false if the snapshot does not match the current world
+  public: bool ApplyState(const WorldState &state);
+
+  /// \brief Push the current state in the rewind ring
+  private: void PushState();
+
+  /// \brief Rebuild the list of dynamic models and bodies
+  private: void UpdateStateLayout();
+
 
   /// \brief Pause callback
   private: void PauseSlot(bool p);
@@ -275,30 +289,85 @@ class World : public SingletonT<World>
 
   private: boost::signal<void (Entity*)> addEntitySignal;
 
-  // SAVE WORLD STATE
-  // TODO: Create structure
-  private: std::map<std::string, Pose3d> modelAbsPose;
-  private: std::map<std::string, Vector3> modelLinearVel;
-  private: std::map<std::string, Vector3> modelLinearAccel;
-  private: std::map<std::string, Vector3> modelAngularVel;
-  private: std::map<std::string, Vector3> modelAngularAccel;
-  
+  /// Dynamic models and bodies, in snapshot order
+  private: std::vector<Model*> stateModels;
+  private: std::vector<Body*> stateBodies;
+
+  /// Index of the first body of each dynamic model in stateBodies
+  private: std::vector<unsigned int> stateModelFirstBody;
+
+  /// Incremented each time the snapshot layout changes
+  private: unsigned int stateLayout;
+  private: bool stateLayoutDirty;
+
+  /// Restore slot used by SaveState/RestoreState
+  private: WorldState *savedState;
 
   private: std::deque<WorldState> worldStates;
   private: std::deque<WorldState>::iterator worldStatesInsertIter;
   private: std::deque<WorldState>::iterator worldStatesEndIter;
   private: std::deque<WorldState>::iterator worldStatesCurrentIter;
 
-  private: Timer saveStateTimer;
+  /// Simulation time of the last snapshot pushed in the ring
+  private: Time lastStateTime;
   private: ParamT<Time> *saveStateTimeoutP;
   private: ParamT<unsigned int> *saveStateBufferSizeP;
 };
 
+/// \brief Binary snapshot of all dynamic bodies of the world
+/*
+ * Records are stored in the order of World::stateModels and
+ * World::stateBodies, so that saving and restoring never looks up names.
+ *
+ * Not part of a snapshot:
+ *  - the simulation clock: simTime is the time of the capture, but applying
+ *    a snapshot does not move the clock back, as sensors and controllers
+ *    time their updates from the last one;
+ *  - the ODE auto-disable idle timers, which ODE does not expose: applying
+ *    a snapshot restarts them, so a body that was already resting at the
+ *    capture may be disabled later than in the original run;
+ *  - controller state, such as the velocity commands of the robots, which
+ *    the agents send again every cycle (RestoreState tells the agents that
+ *    their robots were moved).
+ *
+ * csim-state-check replays a scenario from a capture and compares it with
+ * the original run.
+ */
 class WorldState
 {
-  public: std::map<std::string, Pose3d> modelPoses;
-  public: std::map<std::string, Pose3d> bodyPoses;
-  public: std::map<std::string, Pose3d> geomPoses;
+  /// \brief State of a dynamic model
+  public: struct ModelRecord
+          {
+            double pos[3];
+            double rot[4];
+          };
+
+  /// \brief State of a dynamic body
+  public: struct BodyRecord
+          {
+            double pos[3];
+            double rot[4];
+            double linearVel[3];
+            double angularVel[3];
+            unsigned char enabled;
+          };
+
+  public: WorldState() : layout(0), valid(false) {}
+
+  /// Simulation time of the capture
+  public: Time simTime;
+
+  /// Layout the records were captured with
+  public: unsigned int layout;
+
+  /// Whether the snapshot holds a capture
+  public: bool valid;
+
+  /// Model poses, relative to the parent
+  public: std::vector<ModelRecord> models;
+
+  /// Body poses, relative to the model, and velocities
+  public: std::vector<BodyRecord> bodies;
 };
 
 /// \}
@@ -87,6 +87,7 @@ void Comm::LoadChild(XMLConfigNode *node)
   // Force "Always on"
   this->alwaysOnP->SetValue( true );
   this->rtdbConfigFile = node->GetFilename("rtdbConf", std::string(), 0);
+  this->sharedView = node->GetBool("sharedView", true, 0);
   
 }
 
@@ -96,6 +97,14 @@ void Comm::InitChild()
 {
   if ( this->rtdbConfigFile != "" )
     DB_set_config_file( this->rtdbConfigFile.c_str() );
+
+  // Agents attaching later follow the layout of the rtdb created here
+  DB_set_shared_view( this->sharedView ? 1 : 0 );
+
+  for(int ag=0; ag < N_AGENTS; ag++) {
+    this->wsVersion[ag] = -1;
+    this->kcVersion[ag] = -1;
+  }
   
   int _second_rtdb;
   if ( this->rtdbNum == 1)
@@ -137,23 +146,31 @@ void Comm::UpdateChild()
 
 //  fprintf(stderr,"csim_comm finfo size %d fid %d msg %s\n", sizeof(fInfo), fInfo.formationID, fInfo.setplayMessage);
 
+  // Publish coach data to the team, always fresh
+  DB_put_team(0 + offset, COACH_INFO, (void*)&cInfo, 0);
+  if(FINFO_Lifetime < 1000){    
+    DB_put_team(0 + offset, FORMATION_INFO, (void*)&fInfo, 0);
+  }
+  DB_put_team(0 + offset, KICKCALIB_APP, (void*)&kcAppData, 0);
+
+  // Publish each robot record once, keeping its lifetime. An unchanged
+  // version is the same data with the same timestamp, so it is skipped.
   for(int ag1=1; ag1 < N_AGENTS; ag1++) {
-    DB_put_in(ag1 + offset , 0, COACH_INFO, (void*)&cInfo,0);
-    if(FINFO_Lifetime < 1000){    
-	DB_put_in(ag1 + offset, 0, FORMATION_INFO, (void*)&fInfo,0);
+    int v = DB_get_version_from(ag1 + offset, ag1, ROBOT_WS);
+    if ( v != this->wsVersion[ag1] ) {
+      int lt = DB_get_from(ag1 + offset, ag1, ROBOT_WS, (void*)&rws);
+      DB_put_team(ag1 + offset, ROBOT_WS, (void*)&rws, lt );
+      this->wsVersion[ag1] = v;
     }
-    DB_put_in(ag1 + offset, 0, KICKCALIB_APP, (void*)&kcAppData,0);
 
-    int lt = DB_get_from(ag1 + offset, ag1, ROBOT_WS, (void*)&rws);
-    int lt2 = DB_get_from(ag1 + offset, ag1, KICKCALIB_ROB, (void*)&kcRobData);
+    int v2 = DB_get_version_from(ag1 + offset, ag1, KICKCALIB_ROB);
+    if ( v2 != this->kcVersion[ag1] ) {
+      int lt2 = DB_get_from(ag1 + offset, ag1, KICKCALIB_ROB, (void*)&kcRobData);
+      DB_put_team(ag1 + offset, KICKCALIB_ROB, (void*)&kcRobData, lt2 );
+      this->kcVersion[ag1] = v2;
+    }
     //int lt3 = DB_get_from(ag1 + offset, ag1, GRIDVIEW, (void*)&gv);
-    for(int ag2=0; ag2 < N_AGENTS; ag2++) {
-      if(ag1!=ag2) {
-        DB_put_in(ag2 + offset, ag1, ROBOT_WS, (void*)&rws, lt );
-        DB_put_in(ag2 + offset, ag1, KICKCALIB_ROB, (void*)&kcRobData, lt2 );
-        //DB_put_in(ag2 + offset, ag1, GRIDVIEW, (void*)&gv, lt3 );
-      }
-    } // end for( ag2 )
+    //DB_put_team(ag1 + offset, GRIDVIEW, (void*)&gv, lt3 );
   } // end for( ag1 )
 
 }
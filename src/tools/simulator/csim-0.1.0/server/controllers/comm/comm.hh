@@ -32,6 +32,8 @@
 #include "Controller.hh"
 #include "Entity.hh"
 
+#include "rtdb_user.h"
+
 namespace gazebo
 { 
   
@@ -78,6 +80,13 @@ class Comm : public Controller
     std::string PMANConfigFile;
     
     int rtdbNum;
+
+    /// Teammates map one team region instead of a copy per agent
+    bool sharedView;
+
+    /// Last published version of each robot shared records
+    int wsVersion[N_AGENTS];
+    int kcVersion[N_AGENTS];
     
     /// Allow only one instance
     static int commLoaded;
@@ -58,6 +58,8 @@ where [options] is one or more of the following:
 - -t &lt;sec&gt;      : Timeout and quit after &lt;sec&gt; seconds
 - -l &lt;logfile&gt;  : Log messages to &lt;logfile&gt
 - -n                  : Do not do any time control
+- -b &lt;listfile&gt; : Batch mode, run every world file listed in &lt;listfile&gt;
+- -j &lt;jobs&gt;     : Number of batch scenarios run at the same time
 
 The server prints some diagnostic information to the console before
 starting the main simulation loop.  Check carefully for any warnings
@@ -105,6 +107,11 @@ real time.  Note that this measures the utilization by the server process
 only; it does not measure the processor utilization of the X server,
 which may be significant.
 
+In batch mode each scenario runs without rendering in its own worker
+process, pinned to a core, with its own server id and RTDB namespace
+(the RTDB_NAMESPACE environment variable, inherited by the processes the
+scenario starts). The -t option is required, it bounds each scenario.
+
 The server can be terminated with @c control-C.  Errors, warnings and
 messages are appended by default to a file called @c .gazebo located in your
 home directory, or to the log file specified with the -l command line option.
@@ -116,7 +123,16 @@ home directory, or to the log file specified with the -l command line option.
 #include <stdlib.h>
 #include <signal.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ode/ode.h>
 
 #include <config.h>
 #include "Simulator.hh"
@@ -136,6 +152,11 @@ unsigned int optMsgLevel = 1;
 int optTimeControl = 1;
 bool optPhysicsEnabled  = true;
 bool optPaused = false;
+const char *optBatchFileName = NULL;
+int optBatchJobs = 0;
+
+// Set by the signal handler of the batch runner
+volatile sig_atomic_t batchQuit = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 // TODO: Implement these options
@@ -152,6 +173,8 @@ void PrintUsage()
   fprintf(stderr, "  -n            : Do not do any time control\n");
   fprintf(stderr, "  -p            : Run without physics engine\n");
   fprintf(stderr, "  -u            : Start the simulation paused\n");
+  fprintf(stderr, "  -b <listfile> : Batch mode, run every world file listed in <listfile>\n");
+  fprintf(stderr, "  -j <jobs>     : Batch scenarios run at the same time; default is one per cpu\n");
   fprintf(stderr, "  <worldfile>   : load the the indicated world file\n");
   return;
 }
@@ -178,7 +201,7 @@ int ParseArgs(int argc, char **argv)
 {
   int ch;
 
-  char *flags = (char*)("l:hd:s:fxt:nqperu");
+  char *flags = (char*)("l:hd:s:fxt:nqperub:j:");
 
   // Get letter options
   while ((ch = getopt(argc, argv, flags)) != -1)
@@ -226,6 +249,14 @@ int ParseArgs(int argc, char **argv)
         optPhysicsEnabled = false;
         break;
 
+      case 'b':
+        optBatchFileName = optarg;
+        break;
+
+      case 'j':
+        optBatchJobs = atoi(optarg);
+        break;
+
       case 'h':
       default:
         PrintUsage();
@@ -236,6 +267,10 @@ int ParseArgs(int argc, char **argv)
   argc -= optind;
   argv += optind;
 
+  // The world files of a batch come from the list file
+  if (optBatchFileName != NULL)
+    return 0;
+
   if (argc < 1)
   {
     PrintUsage();
@@ -259,34 +294,19 @@ void SignalHandler( int /*dummy*/ )
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Main function
-int main(int argc, char **argv)
+// Load, run and finalize the simulation of a world file
+// fileLoaded: the world file was parsed before (Simulator::LoadFile)
+int RunSimulation(const char *worldFile, unsigned int serverId, bool fileLoaded)
 {
-
-
-  // force a cpu affinity for CPU 0, this slow down sim by about 4X
-  // cpu_set_t cpuSet;
-  // CPU_ZERO(&cpuSet);
-  // CPU_SET(0, &cpuSet);
-  // sched_setaffinity( 0, sizeof(cpuSet), &cpuSet);
-
-
-  //Application Setup
-  if (ParseArgs(argc, argv) != 0)
-    return -1;
-
-  PrintVersion();
-
-  if (signal(SIGINT, SignalHandler) == SIG_ERR)
-  {
-    std::cerr << "signal(2) failed while setting up for SIGINT" << std::endl;
-    return -1;
-  }
+  gazebo::Time loadStart = gazebo::Time::GetWallTime();
 
   //Load the simulator
   try
   {
-    gazebo::Simulator::Instance()->Load(worldFileName, optServerId);
+    if (fileLoaded)
+      gazebo::Simulator::Instance()->Load(serverId);
+    else
+      gazebo::Simulator::Instance()->Load(worldFile, serverId);
     gazebo::Simulator::Instance()->SetTimeout(optTimeout);
     gazebo::Simulator::Instance()->SetPhysicsEnabled(optPhysicsEnabled);
     gazebo::Simulator::Instance()->SetPaused(optPaused);
@@ -320,6 +340,13 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  if (optBatchFileName != NULL)
+  {
+    printf("Scenario %s: started in %.3f s\n", worldFile,
+           (gazebo::Time::GetWallTime() - loadStart).Double());
+    fflush(stdout);
+  }
+
   // Main loop of the simulator
   try
   { 
@@ -350,6 +377,222 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// sighandler of the batch runner, stop launching new scenarios
+void BatchSignalHandler( int /*dummy*/ )
+{
+  batchQuit = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Read the world files of a batch, one per line ('#' starts a comment)
+int LoadBatch(const char *fileName, std::vector<std::string> &worlds)
+{
+  std::ifstream input(fileName);
+  std::string line;
+
+  if (!input.is_open())
+  {
+    std::cerr << "Unable to open batch file[" << fileName << "]" << std::endl;
+    return -1;
+  }
+
+  while (std::getline(input, line))
+  {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#')
+      continue;
+
+    size_t last = line.find_last_not_of(" \t\r");
+    worlds.push_back(line.substr(first, last - first + 1));
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parse a world file of the batch in the runner, before its worker is forked
+int LoadWorldFile(const char *worldFile)
+{
+  try
+  {
+    gazebo::Simulator::Instance()->LoadFile(worldFile);
+  }
+  catch (gazebo::GazeboError e)
+  {
+    std::cerr << "Error Loading Gazebo" << std::endl;
+    std::cerr << e << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Run every scenario of the batch, optBatchJobs worker processes at a time
+int RunBatch()
+{
+  std::vector<std::string> worlds;
+  std::vector<pid_t> slotPid;
+  std::vector<unsigned int> slotScenario;
+  std::vector<gazebo::Time> slotStart;
+  unsigned int next = 0;
+  int running = 0;
+  int failed = 0;
+  int cpus, jobs, slot, status;
+  struct rusage usage;
+  pid_t pid;
+
+  if (LoadBatch(optBatchFileName, worlds) != 0)
+    return -1;
+
+  if (optTimeout <= 0)
+  {
+    std::cerr << "Batch mode requires a timeout (-t)" << std::endl;
+    return -1;
+  }
+
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus < 1)
+    cpus = 1;
+
+  jobs = (optBatchJobs > 0) ? optBatchJobs : cpus;
+  slotPid.resize(jobs, 0);
+  slotScenario.resize(jobs, 0);
+  slotStart.resize(jobs);
+
+  signal(SIGINT, BatchSignalHandler);
+
+  // The state every scenario shares is set up here once, the workers
+  // inherit it: the ODE collision tables, and the local configuration
+  // (the first Simulator::LoadFile). The world, its libgazebo server and
+  // the RTDB/PMAN tables of its namespace are the worker's own.
+  dInitODE2(0);
+
+  while ((next < worlds.size() && !batchQuit) || running > 0)
+  {
+    // Start a scenario in every free slot
+    for (slot = 0; slot < jobs && next < worlds.size() && !batchQuit; slot++)
+    {
+      if (slotPid[slot] != 0)
+        continue;
+
+      // Parse the world file before forking, a broken one costs no worker
+      while (next < worlds.size() && LoadWorldFile(worlds[next].c_str()) != 0)
+      {
+        printf("Scenario %s: failed to load\n", worlds[next].c_str());
+        failed++;
+        next++;
+      }
+      if (next == worlds.size())
+        break;
+
+      // or the worker prints the output pending here again
+      fflush(stdout);
+
+      pid = fork();
+      if (pid < 0)
+      {
+        std::cerr << "fork(2) failed for scenario[" << worlds[next] << "]\n";
+        batchQuit = 1;
+        break;
+      }
+
+      if (pid == 0)
+      {
+        cpu_set_t cpuSet;
+        char ns[16];
+
+        CPU_ZERO(&cpuSet);
+        CPU_SET(slot % cpus, &cpuSet);
+        sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+
+        // Namespace 0 is left to the interactive simulator
+        snprintf(ns, sizeof(ns), "%d", slot + 1);
+        setenv("RTDB_NAMESPACE", ns, 1);
+
+        signal(SIGINT, SignalHandler);
+        optRenderEngineEnabled = false;
+
+        _exit(RunSimulation(worlds[next].c_str(), optServerId + slot + 1, true)
+              == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+      }
+
+      slotPid[slot] = pid;
+      slotScenario[slot] = next;
+      slotStart[slot] = gazebo::Time::GetWallTime();
+      running++;
+      next++;
+    }
+
+    // Wait for a scenario to finish
+    pid = wait4(-1, &status, 0, &usage);
+    if (pid < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    for (slot = 0; slot < jobs; slot++)
+    {
+      if (slotPid[slot] != pid)
+        continue;
+
+      bool ok = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+      if (!ok)
+        failed++;
+
+      printf("Scenario %s: %s (%.2f s, %ld kB max rss)\n",
+             worlds[slotScenario[slot]].c_str(), ok ? "done" : "failed",
+             (gazebo::Time::GetWallTime() - slotStart[slot]).Double(),
+             usage.ru_maxrss);
+
+      slotPid[slot] = 0;
+      running--;
+    }
+  }
+
+  printf("Batch: %u of %u scenarios run, %d failed\n",
+         next, (unsigned int)worlds.size(), failed);
+
+  return (failed == 0 && next == worlds.size()) ? 0 : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function
+int main(int argc, char **argv)
+{
+
+
+  // force a cpu affinity for CPU 0, this slow down sim by about 4X
+  // cpu_set_t cpuSet;
+  // CPU_ZERO(&cpuSet);
+  // CPU_SET(0, &cpuSet);
+  // sched_setaffinity( 0, sizeof(cpuSet), &cpuSet);
+
+
+  //Application Setup
+  if (ParseArgs(argc, argv) != 0)
+    return -1;
+
+  PrintVersion();
+
+  if (optBatchFileName != NULL)
+    return RunBatch();
+
+  if (signal(SIGINT, SignalHandler) == SIG_ERR)
+  {
+    std::cerr << "signal(2) failed while setting up for SIGINT" << std::endl;
+    return -1;
+  }
+
+  if (RunSimulation(worldFileName, optServerId, false) != 0)
+    return -1;
+
   printf("Done.\n");
   return 0;
 }
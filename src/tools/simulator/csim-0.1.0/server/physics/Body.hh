@@ -102,6 +102,9 @@ namespace gazebo
     
     /// \brief Set whether this body is enabled
     public: virtual void SetEnabled(bool enable) const = 0;
+
+    /// \brief Get whether this body is enabled
+    public: virtual bool GetEnabled() const = 0;
     
     /// \brief Update the center of mass
     public: virtual void UpdateCoM();
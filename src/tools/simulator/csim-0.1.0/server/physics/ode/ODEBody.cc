@@ -317,6 +317,22 @@ void ODEBody::SetEnabled(bool enable) const
   this->physicsEngine->UnlockMutex();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Get whether this body is enabled
+bool ODEBody::GetEnabled() const
+{
+  bool result;
+
+  if (!this->bodyId)
+    return false;
+
+  this->physicsEngine->LockMutex();
+  result = dBodyIsEnabled(this->bodyId);
+  this->physicsEngine->UnlockMutex();
+
+  return result;
+}
+
 /////////////////////////////////////////////////////////////////////
 // Update the CoM and mass matrix
 /*
@@ -99,6 +99,9 @@ namespace gazebo
     /// \brief Set whether this body is enabled
     public: virtual void SetEnabled(bool enable) const;
 
+    /// \brief Get whether this body is enabled
+    public: virtual bool GetEnabled() const;
+
     /// \brief Update the center of mass
     public: virtual void UpdateCoM();
 
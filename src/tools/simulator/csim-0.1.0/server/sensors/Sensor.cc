@@ -34,6 +34,7 @@
 #include "ControllerFactory.hh"
 #include "Simulator.hh"
 #include "Sensor.hh"
+#include "SensorSnapshot.hh"
 #include "Simulator.hh"
 #include "PhysicsEngine.hh"
 #include "Global.hh"
@@ -48,6 +49,7 @@ Sensor::Sensor(Body *body)
   this->body = body;
   this->controller = NULL;
   this->active = true;
+  this->updatePending = false;
 
   this->world = World::Instance();
   this->simulator = Simulator::Instance();
@@ -127,12 +129,57 @@ void Sensor::Update()
 {
   //DiagnosticTimer timer("Sensor[" + this->GetName() + "] Update");
 
+  SensorSnapshot snapshot;
+
+  this->Prepare();
+
+  snapshot.Clear(this->simulator->GetSimTime());
+  this->Snapshot(snapshot);
+
+  this->Compute(snapshot);
+  this->Commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Decide if the sensor is due for an update in this stage
+void Sensor::Prepare()
+{
   Time physics_dt = this->world->GetPhysicsEngine()->GetStepTime();
 
-  if (((this->simulator->GetSimTime() - this->lastUpdate - this->updatePeriod)/physics_dt) >= 0)
+  this->updatePending =
+    ((this->simulator->GetSimTime() - this->lastUpdate - this->updatePeriod)/physics_dt) >= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bodies read by the compute stage to the snapshot
+void Sensor::Snapshot(SensorSnapshot &snapshot)
+{
+  if (!this->updatePending || !this->IsParallel())
+    return;
+
+  snapshot.AddBody(this->body);
+  this->SnapshotChild(snapshot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the sensor output from the world snapshot
+void Sensor::Compute(const SensorSnapshot &snapshot)
+{
+  if (!this->updatePending || !this->IsParallel())
+    return;
+
+  this->ComputeChild(snapshot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Publish the sensor output and update the controller
+void Sensor::Commit()
+{
+  if (this->updatePending)
   {
-    this->UpdateChild();
+    this->CommitChild();
     this->lastUpdate = this->simulator->GetSimTime();
+    this->updatePending = false;
   }
 
   // update any controllers that are children of sensors, e.g. ros_bumper
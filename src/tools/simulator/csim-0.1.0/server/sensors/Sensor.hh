@@ -38,6 +38,7 @@ namespace gazebo
   class World;
   class Simulator;
   class Controller;
+  class SensorSnapshot;
 
   /// \addtogroup gazebo_sensor
   /// \brief Base class for sensors
@@ -67,6 +68,26 @@ namespace gazebo
   
     /// \brief  Update the sensor
     public: void Update();
+
+    /// \brief Decide if the sensor is due for an update in this stage
+    public: void Prepare();
+
+    /// \brief Add the bodies read by the compute stage to the snapshot
+    public: void Snapshot(SensorSnapshot &snapshot);
+
+    /// \brief Compute the sensor output from the world snapshot.
+    ///
+    /// Only reads the snapshot and writes the sensor's own output buffer,
+    /// so it may run concurrently with the compute stage of other sensors.
+    public: void Compute(const SensorSnapshot &snapshot);
+
+    /// \brief Publish the sensor output and update the controller.
+    ///
+    /// Always called serially, in the order the sensors were added.
+    public: void Commit();
+
+    /// \brief True if the sensor splits its update in compute and commit
+    public: virtual bool IsParallel() const { return false; }
   
     /// \brief  Finalize the sensor
     public: void Fini();
@@ -92,6 +113,15 @@ namespace gazebo
   
     /// \brief  Update the child
     protected: virtual void UpdateChild() {};
+
+    /// \brief Add the bodies read by the child to the snapshot
+    protected: virtual void SnapshotChild(SensorSnapshot & /*snapshot*/) {};
+
+    /// \brief Compute the child output (parallel sensors only)
+    protected: virtual void ComputeChild(const SensorSnapshot & /*snapshot*/) {};
+
+    /// \brief Publish the child output. Defaults to a serial update
+    protected: virtual void CommitChild() { this->UpdateChild(); };
   
     /// \brief Finalize the child
     protected: virtual void FiniChild() {};
@@ -116,6 +146,9 @@ namespace gazebo
     protected: Time updatePeriod;
     protected: Time lastUpdate;
     protected: std::string typeName;
+
+    /// \brief True if Prepare found the sensor due for an update
+    private: bool updatePending;
   };
   /// \}
 }
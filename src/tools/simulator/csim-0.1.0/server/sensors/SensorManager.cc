@@ -25,6 +25,13 @@
  * SVN info: $Id$
  */
 
+#include <boost/bind.hpp>
+
+#include "config.h"
+#include "Global.hh"
+#include "Simulator.hh"
+#include "World.hh"
+#include "PhysicsEngine.hh"
 #include "Sensor.hh"
 #include "SensorManager.hh"
 
@@ -33,6 +40,7 @@ using namespace gazebo;
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor
 SensorManager::SensorManager()
+  : nextDue(0), busyWorkers(0), generation(0), quitWorkers(false)
 {
 }
 
@@ -40,6 +48,7 @@ SensorManager::SensorManager()
 /// Destructor
 SensorManager::~SensorManager()
 {
+  this->SetThreads(1);
   this->sensors.erase(this->sensors.begin(), this->sensors.end());
 }
 
@@ -48,9 +57,116 @@ SensorManager::~SensorManager()
 void SensorManager::Update()
 {
   std::list<Sensor*>::iterator iter;
+
+  // Capture the world state read by the sensors that are due
+  this->snapshot.Clear(Simulator::Instance()->GetSimTime());
+  for (iter = this->sensors.begin(); iter != this->sensors.end(); iter++)
+  {
+    (*iter)->Prepare();
+    (*iter)->Snapshot(this->snapshot);
+  }
+
+  // Compute the sensor outputs, each one into its own buffer
+  this->due.clear();
   for (iter = this->sensors.begin(); iter != this->sensors.end(); iter++)
-    (*iter)->Update();
-    
+    if ((*iter)->IsParallel())
+      this->due.push_back(*iter);
+
+  this->nextDue = 0;
+  if (this->workers.empty() || this->due.size() < 2)
+    this->ComputeDue();
+  else
+  {
+    {
+      boost::mutex::scoped_lock lock(this->workMutex);
+      this->busyWorkers = this->workers.size();
+      this->generation++;
+    }
+    this->workCond.notify_all();
+
+    // This thread takes its share too
+    this->ComputeDue();
+
+    boost::mutex::scoped_lock lock(this->workMutex);
+    while (this->busyWorkers > 0)
+      this->doneCond.wait(lock);
+  }
+
+  // Publish in a fixed order so results do not depend on the scheduling
+  for (iter = this->sensors.begin(); iter != this->sensors.end(); iter++)
+    (*iter)->Commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of threads of the compute stage
+void SensorManager::SetThreads(unsigned int count)
+{
+  std::vector<boost::thread*>::iterator iter;
+
+  {
+    boost::mutex::scoped_lock lock(this->workMutex);
+    this->quitWorkers = true;
+  }
+  this->workCond.notify_all();
+
+  for (iter = this->workers.begin(); iter != this->workers.end(); iter++)
+  {
+    (*iter)->join();
+    delete *iter;
+  }
+  this->workers.clear();
+  this->quitWorkers = false;
+
+#ifdef PARALLEL_SENSORS
+  for (unsigned int i = 1; i < count; i++)
+    this->workers.push_back(new boost::thread(
+        boost::bind(&SensorManager::WorkerLoop, this, this->generation)));
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the due sensors until there is none left
+void SensorManager::ComputeDue()
+{
+  Sensor *sensor;
+
+  for (;;)
+  {
+    {
+      boost::mutex::scoped_lock lock(this->workMutex);
+      if (this->nextDue >= this->due.size())
+        return;
+      sensor = this->due[this->nextDue++];
+    }
+
+    sensor->Compute(this->snapshot);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Body of the worker threads
+void SensorManager::WorkerLoop(unsigned int generation)
+{
+  World::Instance()->GetPhysicsEngine()->InitForThread();
+
+  for (;;)
+  {
+    {
+      boost::mutex::scoped_lock lock(this->workMutex);
+      while (this->generation == generation && !this->quitWorkers)
+        this->workCond.wait(lock);
+
+      if (this->quitWorkers)
+        return;
+      generation = this->generation;
+    }
+
+    this->ComputeDue();
+
+    boost::mutex::scoped_lock lock(this->workMutex);
+    if (--this->busyWorkers == 0)
+      this->doneCond.notify_one();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,8 +29,11 @@
 #define SENSORMANAGER_HH
 
 #include <list>
+#include <vector>
+#include <boost/thread.hpp>
 
 #include "SingletonT.hh"
+#include "SensorSnapshot.hh"
 
 namespace gazebo
 {
@@ -46,8 +49,21 @@ namespace gazebo
     public: virtual ~SensorManager();
 
     /// \brief Update all the sensors
+    ///
+    /// The update runs in three stages: the world state read by the due
+    /// sensors is copied to a snapshot, the parallel sensors compute their
+    /// output from it (on the worker threads when built with
+    /// PARALLEL_SENSORS), and finally every sensor commits its output
+    /// serially in the order it was added.
     public: void Update();
 
+    /// \brief Set the number of threads of the compute stage
+    ///
+    /// The calling thread is one of them, so 1 (or 0) computes serially.
+    /// Must not be called during an Update.
+    /// \param count Number of threads, the world file "threads" parameter
+    public: void SetThreads(unsigned int count);
+
     /// \brief Init all the sensors
     public: void Init();
 
@@ -60,8 +76,39 @@ namespace gazebo
     /// \brief Remove a sensor
     public: void RemoveSensor(Sensor *sensor);
 
+    /// \brief Compute the due sensors until there is none left
+    private: void ComputeDue();
+
+    /// \brief Body of the worker threads
+    /// \param generation Round already done when the worker started
+    private: void WorkerLoop(unsigned int generation);
+
     private: std::list<Sensor *> sensors;
 
+    /// \brief Parallel sensors of the current update
+    private: std::vector<Sensor *> due;
+
+    /// \brief Next sensor of the due list to compute
+    private: unsigned int nextDue;
+
+    /// \brief Compute stage worker threads
+    private: std::vector<boost::thread *> workers;
+
+    /// \brief Workers still computing in this round
+    private: unsigned int busyWorkers;
+
+    /// \brief Round counter, a new value releases the workers
+    private: unsigned int generation;
+
+    private: bool quitWorkers;
+
+    private: boost::mutex workMutex;
+    private: boost::condition_variable workCond;
+    private: boost::condition_variable doneCond;
+
+    /// \brief World state seen by the compute stage
+    private: SensorSnapshot snapshot;
+
     private: friend class DestroyerT<SensorManager>;
     private: friend class SingletonT<SensorManager>;
   };
@@ -0,0 +1,100 @@
+/*
+ *  CSim - CAMBADA Simulator
+ *  Copyright (C) 2010  Universidade de Aveiro
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ *  @Desc   Read-only copy of the world state used by the sensor stage
+ *
+ */
+
+#include "Body.hh"
+#include "GazeboError.hh"
+#include "SensorSnapshot.hh"
+
+using namespace gazebo;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor
+SensorSnapshot::SensorSnapshot()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+SensorSnapshot::~SensorSnapshot()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Drop all captured bodies and start a new capture
+void SensorSnapshot::Clear(const Time &simTime)
+{
+  this->bodies.clear();
+  this->simTime = simTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Capture the state of a body (once per capture)
+void SensorSnapshot::AddBody(const Body *body)
+{
+  if (!body || this->bodies.find(body) != this->bodies.end())
+    return;
+
+  BodyState &state = this->bodies[body];
+  state.pose = body->GetAbsPose();
+  body->GetBoundingBox(state.bbMin, state.bbMax);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Get the captured state of a body
+const SensorSnapshot::BodyState &SensorSnapshot::GetBodyState(
+    const Body *body) const
+{
+  std::map<const Body*, BodyState>::const_iterator iter;
+
+  iter = this->bodies.find(body);
+  if (iter == this->bodies.end())
+    gzthrow("Body is not part of the sensor snapshot");
+
+  return iter->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Get the captured absolute pose of a body
+const Pose3d &SensorSnapshot::GetPose(const Body *body) const
+{
+  return this->GetBodyState(body).pose;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Get the captured bounding box of a body
+void SensorSnapshot::GetBoundingBox(const Body *body,
+                                    Vector3 &min, Vector3 &max) const
+{
+  const BodyState &state = this->GetBodyState(body);
+  min = state.bbMin;
+  max = state.bbMax;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Get the simulation time of the capture
+Time SensorSnapshot::GetSimTime() const
+{
+  return this->simTime;
+}
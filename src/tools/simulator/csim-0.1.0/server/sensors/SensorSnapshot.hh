@@ -0,0 +1,91 @@
+/*
+ *  CSim - CAMBADA Simulator
+ *  Copyright (C) 2010  Universidade de Aveiro
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ *  @Desc   Read-only copy of the world state used by the sensor stage
+ *
+ */
+
+#ifndef SENSORSNAPSHOT_HH
+#define SENSORSNAPSHOT_HH
+
+#include <map>
+
+#include "Pose3d.hh"
+#include "Vector3.hh"
+#include "Time.hh"
+
+namespace gazebo
+{
+  class Body;
+
+  /// \addtogroup gazebo_sensor
+  /// \{
+
+  /// \brief Read-only copy of the world state used by the sensor stage
+  /*
+   * The snapshot is filled serially before the sensors compute their
+   * output, so that the compute stage never touches the physics engine
+   * and can safely run on several threads.
+   */
+  class SensorSnapshot
+  {
+    /// \brief State of a body at the time of the capture
+    public: struct BodyState
+            {
+              Pose3d pose;
+              Vector3 bbMin;
+              Vector3 bbMax;
+            };
+
+    /// \brief Constructor
+    public: SensorSnapshot();
+
+    /// \brief Destructor
+    public: virtual ~SensorSnapshot();
+
+    /// \brief Drop all captured bodies and start a new capture
+    /// \param simTime Simulation time of the capture
+    public: void Clear(const Time &simTime);
+
+    /// \brief Capture the state of a body (once per capture)
+    public: void AddBody(const Body *body);
+
+    /// \brief Get the captured state of a body
+    public: const BodyState &GetBodyState(const Body *body) const;
+
+    /// \brief Get the captured absolute pose of a body
+    public: const Pose3d &GetPose(const Body *body) const;
+
+    /// \brief Get the captured bounding box of a body
+    public: void GetBoundingBox(const Body *body,
+                                Vector3 &min, Vector3 &max) const;
+
+    /// \brief Get the simulation time of the capture
+    public: Time GetSimTime() const;
+
+    private: std::map<const Body*, BodyState> bodies;
+    private: Time simTime;
+  };
+
+  /// \}
+}
+
+#endif
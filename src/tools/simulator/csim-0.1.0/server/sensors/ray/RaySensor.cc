@@ -199,3 +199,10 @@ void RaySensor::UpdateChild()
   if (this->active)
     this->laserShape->Update();
 }
+
+//////////////////////////////////////////////////////////////////////////////
+// Cast the rays in the parallel sensor stage
+void RaySensor::ComputeChild(const SensorSnapshot & /*snapshot*/)
+{
+  this->UpdateChild();
+}
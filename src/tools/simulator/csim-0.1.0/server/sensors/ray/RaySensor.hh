@@ -74,6 +74,16 @@ namespace gazebo
   
     ///  Update sensed values
     protected: virtual void UpdateChild();
+
+    /// The rays only touch their own geoms and collide under the
+    /// physics mutex, so they can be cast in the parallel sensor stage
+    public: virtual bool IsParallel() const { return true; }
+
+    ///  Cast the rays (parallel stage)
+    protected: virtual void ComputeChild(const SensorSnapshot &snapshot);
+
+    ///  Nothing to publish, the controller reads the ranges
+    protected: virtual void CommitChild() {};
     
     /// Finalize the ray
     protected: virtual void FiniChild();
@@ -47,6 +47,7 @@
 
 
 // CAMBADA include
+#include "rtdb_api.h"
 #include "rtdb_sim.h"
 #include "pman.h"
 #include "pmandefs.h"
@@ -83,6 +84,9 @@ SensorVision::SensorVision(Body *body)
 {
   this->omniQueue = NULL;
   this->typeName  = "vision";
+  this->ball      = NULL;
+  this->rawBallChecked = false;
+  this->rawBallVisible = false;
 }
 
 
@@ -169,10 +173,11 @@ void SensorVision::InitChild()
   // Init PMAN
   FILE *fpPman = NULL;
 	int pmanstat, pprio;
+  int pmanOffset = DB_get_namespace()*RTDB_NAMESPACE_STRIDE + 2*this->selfID;
 
   this->fPMAN = false;
 	// PMAN initializations
-  pmanstat = PMAN_init2(SHMEM_OCAM_PMAN_KEY + 2*this->selfID, SEM_OCAM_PMAN_KEY + 2*this->selfID,
+  pmanstat = PMAN_init2(SHMEM_OCAM_PMAN_KEY + pmanOffset, SEM_OCAM_PMAN_KEY + pmanOffset,
                        (void *)dummyShed, sizeof(pprio), PMAN_NEW);
 
 	if( pmanstat < 0 ) {
@@ -228,9 +233,38 @@ void SensorVision::FiniChild(){
 
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Add the bodies read by the detection to the snapshot
+void SensorVision::SnapshotChild( SensorSnapshot &snapshot )
+{
+  // Withour ID define it will not update
+  if ( this->selfID < 1 ) return;
+
+  snapshot.AddBody( this->ball );
+
+  std::vector<Body*>::iterator it = this->obstacleList.begin();
+  for( ; it != this->obstacleList.end(); it++)
+    snapshot.AddBody( *it );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Detect everything from the snapshot, may run on the threadpool
+void SensorVision::ComputeChild( const SensorSnapshot &snapshot )
+{
+  // Withour ID define it will not update
+  if ( this->selfID < 1 ) return;
+
+  // Detect obstacles before anything else
+  // as it is needed to do Ball and White-points occlusion.
+  this->DetectOcclusions(snapshot);
+  this->DetectObstacle(snapshot);
+  this->DetectBall(snapshot);
+  this->DetectWhite(snapshot);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Update the drawing
-void SensorVision::UpdateChild()
+void SensorVision::CommitChild()
 {
   DiagnosticTimer dt("Vision update");
   dt.Start();
@@ -238,13 +272,62 @@ void SensorVision::UpdateChild()
   // Withour ID define it will not update
   if ( this->selfID < 1 ) return;
 
-  // Detect obstacles before anything else
-  // as it is needed to do Ball and White-points occlusion.
-  this->DetectOcclusions();
-  this->DetectObstacle();
-  this->DetectBall();
-  this->DetectWhite();
+  // Obstacles -- noise is added before sorting, as the detection did
+  std::list<Vec> black;
+  std::vector<Vec>::iterator bit = this->rawObstacles.begin();
+  for ( ; bit != this->rawObstacles.end(); bit++ ){
+    Vec maybeBlack = *bit;
+    if(this->noisyObstacles){
+      Vector3 pos = Vector3( maybeBlack.x, maybeBlack.y, 0.0 );
+      this->NoisyPosition(pos);
+      maybeBlack.x = pos.x;
+      maybeBlack.y = pos.y;
+    }
+    black.push_back( maybeBlack );
+  }
+
+  black.sort( comparePosByAngle );
+
+  unsigned int i = 0;
+  std::list<Vec>::iterator it;
+
+  for ( it = black.begin() ; it != black.end(); it++ ){
+    this->visionInfo.obstacles.point[i] = (*it);
+    i++;
+  }
+
+  this->visionInfo.obstacles.nPoints = i;
+
+  // Ball
+  if ( this->rawBallChecked ){
+    if ( this->rawBallVisible ){
+      Vector3 pos = this->rawBall;
+      // noisy or not...
+      if (this->noisyBall)
+          this->NoisyPosition(pos);
+
+      // Update vision info -- Ball section
+      this->visionInfo.ball[0].position.x = pos.x;
+      this->visionInfo.ball[0].position.y = pos.y;
+      this->visionInfo.nBalls = 1;
+    }else{
+      this->visionInfo.nBalls = 0;
+    }
+  }
+
+  // White points
+  for ( i = 0; i < this->rawWhite.size(); i++ ){
+    Vector3 pos = this->rawWhite[i];
+
+    // noisy or not...
+    if (this->noisyWhite)
+        this->NoisyPosition(pos, true);
+
+    this->visionInfo.lines.point[i] = Vec( pos.x * 1000, pos.y * 1000 );
+  }
   
+  this->visionInfo.lines.nPoints = this->rawWhite.size();
+
   if ( this->omniQueue != NULL ){
     
     omniQueue->push_back( this->visionInfo );
@@ -262,7 +345,7 @@ void SensorVision::UpdateChild()
 
 //////////////////////////////////////////////////////////////////////////////
 // Detect occlusions
-void SensorVision::DetectOcclusions(){
+void SensorVision::DetectOcclusions(const SensorSnapshot &snapshot){
 
   std::vector<Body*>::iterator it = this->obstacleList.begin();
   
@@ -273,13 +356,13 @@ void SensorVision::DetectOcclusions(){
   Pose3d opose; // Obstacle pose
   Pose3d rpose; // Relative pose
   // Parent pose
-  Pose3d ppose = this->body->GetAbsPose();
+  Pose3d ppose = snapshot.GetPose( this->body );
   ppose.pos.z = 0;
   
   this->occlusion.clear();
   for( ; it != this->obstacleList.end(); it++){
     
-    opose = (*it)->GetAbsPose();
+    opose = snapshot.GetPose( *it );
     opose.pos.z = 0; // ground level ...
     // Get the relative position
     rpose = opose - ppose;
@@ -288,7 +371,7 @@ void SensorVision::DetectOcclusions(){
     // assume that every obstacle has the shape of a cylinder,
     // therefore i can use the axis-align bounding box to obtain
     // the obstacle radius.
-    (*it)->GetBoundingBox( aabb_min, aabb_max );
+    snapshot.GetBoundingBox( *it, aabb_min, aabb_max );
     radius = (aabb_max.x - aabb_min.x) * 0.5;
     radius = (aabb_max.y - aabb_min.y) * 0.5 > radius ? 
              (aabb_max.y - aabb_min.y) * 0.5 : radius ;
@@ -300,7 +383,7 @@ void SensorVision::DetectOcclusions(){
     location = rpose.pos * 0.5; // half way beetwen origin and obstacle center
     Circle usefullCircle( Vec(location.x, location.y), location.GetLength() );
     
-    std::vector<Vec> limitPoints = intersect( obstCircle, usefullCircle );
+    Intersections limitPoints = intersect( obstCircle, usefullCircle );
     // limitPoints will always be size 2, unless something wrong happens
     // I think the size should be asserted..
     
@@ -317,24 +400,28 @@ void SensorVision::DetectOcclusions(){
 
 //////////////////////////////////////////////////////////////////////////////
 // Detect ball
-void SensorVision::DetectBall(){
+void SensorVision::DetectBall(const SensorSnapshot &snapshot){
   
+  this->rawBallChecked = false;
+  this->rawBallVisible = false;
+
   if ( this->ball == NULL )
     return;
+
+  this->rawBallChecked = true;
   
   // Front Vision does not exist
   //this->frontVisionInfo.ball.cyclesNotVisible = 10000;
   
   // Parent pose
-  Pose3d ppose = this->body->GetAbsPose();
+  Pose3d ppose = snapshot.GetPose( this->body );
   // Ball pose
-  Pose3d bpose = this->ball->GetAbsPose();
+  Pose3d bpose = snapshot.GetPose( this->ball );
   // Save ball distance from the ground 
   float ballAltitude = std::max(bpose.pos.z - this->ballRadius, 0.0);
   
   if ( ballAltitude >= this->height ){
     // Ball above visual detection
-    this->visionInfo.nBalls = 0;
     return;
   }
   
@@ -348,7 +435,6 @@ void SensorVision::DetectBall(){
   
   if ( (this->height-ballAltitude) < (this->height*distance) / this->seeDistance ){
     // Ball out of visual reach
-    this->visionInfo.nBalls = 0;
     return;
   }
   
@@ -359,7 +445,6 @@ void SensorVision::DetectBall(){
   
   if ( ballNotVisible ){
     // Ball out of visual reach
-    this->visionInfo.nBalls = 0;
     return;
   }
 
@@ -367,14 +452,9 @@ void SensorVision::DetectBall(){
   float groundDistance = (this->height * distance) / ( this->height - ballAltitude );
   ballRelPosition.pos *= (groundDistance / distance) ;
   
-  // noisy or not...
-  if (this->noisyBall)
-      this->NoisyPosition(ballRelPosition.pos);
-
-  // Update vision info -- Ball section
-  this->visionInfo.ball[0].position.x = ballRelPosition.pos.x;
-  this->visionInfo.ball[0].position.y = ballRelPosition.pos.y;
-  this->visionInfo.nBalls = 1;
+  // Noise is added on commit
+  this->rawBall = ballRelPosition.pos;
+  this->rawBallVisible = true;
 
 /*  std::cout << "BALL " << Simulator::Instance()->GetSimTime().Double()
             << " "     << (ballRelPosition + ppose).pos
@@ -384,25 +464,24 @@ void SensorVision::DetectBall(){
 
 //////////////////////////////////////////////////////////////////////////////
 // Detect white points
-void SensorVision::DetectWhite(){
+void SensorVision::DetectWhite(const SensorSnapshot &snapshot){
 
-  unsigned int i;
   int k;
         
   // Resolve White Points...
   float angle;
   float angleStep;
   unsigned int   totalWhite;
-  std::vector<csim::Point> allWhite;
   
   // Parent pose
-  Pose3d ppose = this->body->GetAbsPose();
+  Pose3d ppose = snapshot.GetPose( this->body );
   ppose.pos.z = 0;
 
   csim::Point robotPosition( ppose.pos.x , ppose.pos.y);
   
   // Radial sensors 
   totalWhite = 0;
+  this->rawWhite.clear();
   angleStep = M_PI / (float) this->radialSensors;
   
   for ( k = 0; k < this->radialPasses ; k++ )
@@ -428,7 +507,8 @@ void SensorVision::DetectWhite(){
       if ( this->OnOcclusionArea( relPosition.pos )  )
         continue; // White point is not visible
       
-      allWhite.push_back( *it );
+      // Noise is added on commit
+      this->rawWhite.push_back( relPosition.pos );
       totalWhite++;
       
       if ( totalWhite == this->maxWhitePoints )
@@ -440,31 +520,18 @@ void SensorVision::DetectWhite(){
 
   } // for "angle"
   
-  for ( i = 0; i < totalWhite; i++ ){
-    
-    // Calculate points relative to robot position..
-    Pose3d white( Vector3( allWhite[i].x  , allWhite[i].y , 0.0), Quatern() );
-    Pose3d relPosition = white - ppose;
-
-    // noisy or not...
-    if (this->noisyWhite)
-        this->NoisyPosition(relPosition.pos, true);
-
-    this->visionInfo.lines.point[i] = Vec( relPosition.pos.x * 1000, relPosition.pos.y * 1000 );
-  }
-  
-  this->visionInfo.lines.nPoints = totalWhite;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 // Detect obstacles - new algorithm
-void SensorVision::DetectObstacle(void){
+void SensorVision::DetectObstacle(const SensorSnapshot &snapshot){
 
-  std::list<Vec> black;
   float angleStep = DTOR( 1.5 );
 
+  this->rawObstacles.clear();
+
   // Parent pose
-  Pose3d ppose = this->body->GetAbsPose();
+  Pose3d ppose = snapshot.GetPose( this->body );
   ppose.pos.z = 0;
 
   std::vector<Body*>::iterator oit = this->obstacleList.begin();
@@ -474,7 +541,7 @@ void SensorVision::DetectObstacle(void){
     Pose3d opose; // Obstacle pose
     Pose3d rpose; // Relative pose
 
-    opose = (*oit)->GetAbsPose();
+    opose = snapshot.GetPose( *oit );
     opose.pos.z = 0; // ground level ...
     // Get the relative position
     rpose = opose - ppose;
@@ -484,7 +551,7 @@ void SensorVision::DetectObstacle(void){
     // assume that every obstacle has the shape of a cylinder,
     // therefore i can use the axis-align bounding box to obtain
     // the obstacle radius.
-    (*oit)->GetBoundingBox( aabb_min, aabb_max );
+    snapshot.GetBoundingBox( *oit, aabb_min, aabb_max );
     radius = (aabb_max.x - aabb_min.x) * 0.5;
     radius = (aabb_max.y - aabb_min.y) * 0.5 > radius ?
              (aabb_max.y - aabb_min.y) * 0.5 : radius;
@@ -511,7 +578,7 @@ void SensorVision::DetectObstacle(void){
       // Obstacle representation
       Circle orep( Vec(rpose.pos.x, rpose.pos.y), radius);
       // intersection points
-      std::vector<Vec> ip = intersect( ray, orep );
+      Intersections ip = intersect( ray, orep );
       if ( !ip.empty() ){
         // As the obstacle is represented as a circle, most of the times
         // 2 points are returned, but I only want the closest one.
@@ -526,13 +593,8 @@ void SensorVision::DetectObstacle(void){
 
         Vector3 pos = Vector3( maybeBlack.x, maybeBlack.y, 0.0 );
         if (! this->OnOcclusionArea( pos )  ){
-            if(this->noisyObstacles){
-                this->NoisyPosition(pos);
-                maybeBlack.x = pos.x;
-                maybeBlack.y = pos.y;
-            }
-
-            black.push_back( maybeBlack );
+            // Noise is added on commit
+            this->rawObstacles.push_back( maybeBlack );
         }
 
       } // end if ( ip.size() == 1 )
@@ -540,18 +602,6 @@ void SensorVision::DetectObstacle(void){
 
   }// end for all obstacles
 
-  black.sort( comparePosByAngle );
-
-  unsigned int i = 0;
-  std::list<Vec>::iterator it;
-
-  for ( it = black.begin() ; it != black.end(); it++ ){
-    this->visionInfo.obstacles.point[i] = (*it);
-    i++;
-  }
-
-  this->visionInfo.obstacles.nPoints = i;
-
 }
 
 // Search for obstacles
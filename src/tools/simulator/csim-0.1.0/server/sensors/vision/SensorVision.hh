@@ -35,6 +35,7 @@
 
 #include "Body.hh"
 #include "Sensor.hh"
+#include "SensorSnapshot.hh"
 #include "Field.hh"
 
 // CAMBADA include
@@ -81,8 +82,17 @@ class SensorVision : public Sensor
   /// \brief Initialize the camera
   protected: virtual void InitChild();
 
-  /// \brief Update the sensor information
-  protected: virtual void UpdateChild();
+  /// \brief The vision splits its update in compute and commit
+  public: virtual bool IsParallel() const { return true; }
+
+  /// \brief Add the ball and the obstacles to the snapshot
+  protected: virtual void SnapshotChild( SensorSnapshot &snapshot );
+
+  /// \brief Detect ball, obstacles and white points from the snapshot
+  protected: virtual void ComputeChild( const SensorSnapshot &snapshot );
+
+  /// \brief Add noise, send the vision information and awake the agent
+  protected: virtual void CommitChild();
 
   /// Finalize the camera
   protected: virtual void FiniChild();
@@ -90,10 +100,10 @@ class SensorVision : public Sensor
   //
   private:
     
-    void DetectOcclusions();
-    void DetectBall();
-    void DetectWhite();
-    void DetectObstacle();
+    void DetectOcclusions(const SensorSnapshot &snapshot);
+    void DetectBall(const SensorSnapshot &snapshot);
+    void DetectWhite(const SensorSnapshot &snapshot);
+    void DetectObstacle(const SensorSnapshot &snapshot);
     
     void FillObstacleList();
     bool OnOcclusionArea(Vector3 position);
@@ -115,6 +125,15 @@ class SensorVision : public Sensor
 
     // Vision information..
     VisionInfo      visionInfo;
+
+    // Output of the compute stage, noise free and relative to the robot.
+    // Noise is only added on commit, so the random sequence is drawn in
+    // the same order whatever thread computed the detection.
+    std::vector<Vec>     rawObstacles;
+    std::vector<Vector3> rawWhite;
+    Vector3              rawBall;
+    bool                 rawBallChecked;
+    bool                 rawBallVisible;
     
     std::string ballModelName;
     Body* ball;
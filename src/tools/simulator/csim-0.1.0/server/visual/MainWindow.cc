@@ -44,6 +44,9 @@ MainWindow::MainWindow( QWidget* parent ) : QMainWindow(parent) {
   this->sb->addPermanentWidget(this->m_Status);
 
   this->shouldQuit = false;
+  this->simPaused  = false;
+  this->frames     = 0;
+  this->fps        = 0;
 
   connect( this->OGL, SIGNAL(actionInfo(QString, int)), this->sb, SLOT(showMessage(QString, int)) );
 
@@ -56,7 +59,7 @@ void MainWindow::closeEvent( QCloseEvent* event ){
 
 void MainWindow::updateVisual(){
   this->OGL->updateGL();
-
+  this->frames++;
 
 
   if (  (Simulator::Instance()->GetRealTime() - this->lasUpdate ).Double() < 0.05 )
@@ -70,6 +73,8 @@ void MainWindow::updateVisual(){
   Time simTime  = Simulator::Instance()->GetSimTime();
 
   this->percent = ((simTime - this->lastSimTime) / (realTime - this->lastRealTime)).Double();
+  this->fps     = this->frames / (realTime - this->lastRealTime).Double();
+  this->frames  = 0;
   this->lastSimTime = simTime;
   this->lastRealTime= realTime;
 
@@ -127,7 +132,8 @@ void MainWindow::updateVisual(){
   if ( this->simPaused )
       infoStr = QString("[Sim Paused]");
   else
-      infoStr = QString("[%1x]").arg( this->percent , 0, 'f', 2 );
+      infoStr = QString("[%1x] %2 fps").arg( this->percent , 0, 'f', 2 )
+                                       .arg( this->fps, 0, 'f', 0 );
 
 
   this->m_SimTime->setText( simStr );
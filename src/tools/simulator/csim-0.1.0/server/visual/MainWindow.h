@@ -40,6 +40,8 @@ namespace visual {
     gazebo::Time lastSimTime;
     gazebo::Time lasUpdate;
     double  percent;
+    int     frames;     // frames rendered since the last status update
+    double  fps;
 
   };
   
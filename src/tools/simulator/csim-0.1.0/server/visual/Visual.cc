@@ -1,9 +1,16 @@
 
 #include <iostream>
+#include <cstring>
 
 #include <boost/thread/recursive_mutex.hpp>
 
 #include "Model.hh"
+#include "Body.hh"
+#include "Geom.hh"
+#include "Shape.hh"
+#include "SphereShape.hh"
+#include "BoxShape.hh"
+#include "CylinderShape.hh"
 #include "Simulator.hh"
 #include "World.hh"
 #include "PhysicsEngine.hh"
@@ -22,6 +29,16 @@ void VisualApp::Load(XMLConfigNode *node){
     return;
     
   this->ballModelName = visualNode->GetString("ballModel", std::string(), 0);
+
+  this->renderRate   = visualNode->GetDouble("renderRate", 50.0, 0);
+  this->renderEveryN = visualNode->GetInt("renderEveryN", 1, 0);
+  this->nullRenderer =
+    ( visualNode->GetString("renderer", std::string("gl"), 0) == "null" );
+
+  if ( this->renderRate <= 0 )
+    this->renderRate = 50.0;
+  if ( this->renderEveryN < 1 )
+    this->renderEveryN = 1;
   
 }
 
@@ -42,17 +59,164 @@ void VisualApp::Init( ){
     // I assume there is only one body, makes no sense otherwise.
     this->ball = ballModel->GetBody();
   }
+
+  this->startTime = Time::GetWallTime();
+  this->enabled = true;
+
+  // The null renderer only takes the frames, for headless runs and to
+  // measure the cost of the capture alone
+  if ( this->nullRenderer )
+    return;
   
   this->QTapp = new QApplication(argc, argv);
   this->mw    = new MainWindow();
   
   this->mw->show();
-  this->enabled = true;
   
 }
 
 void VisualApp::Fini( ){
 
+  if ( this->enabled )
+    this->PrintStats();
+
+}
+
+void VisualApp::Capture( ){
+
+  if ( this->enabled == false )
+    return;
+
+  this->stepCount++;
+  if ( this->stepCount % this->renderEveryN != 0 )
+    return;
+
+  Time start = Time::GetWallTime();
+
+  VisualFrame& frame = this->frames.GetBack();
+  const std::vector<Model*>& models = World::Instance()->GetModels();
+  std::vector<Model*>::const_iterator m_iter;
+
+  // clear() keeps the capacity, steady state capture does not allocate
+  frame.geoms.clear();
+  frame.models.clear();
+
+  for ( m_iter = models.begin(); m_iter != models.end(); m_iter++ ){
+
+    Model* m = *m_iter;
+    Body* canonical = m->GetCanonicalBody();
+
+    VisualModel vm;
+    vm.model = m;
+    strncpy( vm.name, m->GetName().c_str(), sizeof(vm.name) - 1 );
+    vm.name[sizeof(vm.name) - 1] = '\0';
+    vm.pose = m->GetAbsPose();
+    vm.bodyPose = canonical ? canonical->GetAbsPose() : vm.pose;
+    frame.models.push_back( vm );
+
+    if ( m->GetType().compare("empty") == 0 ) continue;
+
+    const std::map< std::string, Body* > *bodies = m->GetBodies();
+    std::map< std::string, Body* >::const_iterator b_iter;
+
+    for ( b_iter = bodies->begin(); b_iter != bodies->end(); b_iter++ ){
+
+      const std::map<std::string, Geom*> *geoms = b_iter->second->GetGeoms();
+      std::map<std::string, Geom*>::const_iterator g_iter;
+
+      for ( g_iter = geoms->begin(); g_iter != geoms->end(); g_iter++ ){
+
+        Geom* geom = g_iter->second;
+        Shape* shape = geom->GetShape();
+        VisualGeom vg;
+
+        vg.type = shape->GetType();
+        vg.size[0] = vg.size[1] = vg.size[2] = 0;
+
+        switch ( vg.type ){
+          case Shape::SPHERE:
+            vg.size[0] = ((SphereShape*)shape)->GetSize();
+            break;
+
+          case Shape::CYLINDER:
+          {
+            Vector2<double> cyldim = ((CylinderShape*)shape)->GetSize();
+            vg.size[0] = cyldim.x;
+            vg.size[1] = cyldim.y;
+          }
+            break;
+
+          case Shape::BOX:
+          {
+            Vector3 v = ((BoxShape*)shape)->GetSize();
+            vg.size[0] = v.x;
+            vg.size[1] = v.y;
+            vg.size[2] = v.z;
+          }
+            break;
+
+          default:
+            continue;
+        }
+
+        Vector3 rgb = geom->GetPigment();
+        vg.color[0] = rgb.x;
+        vg.color[1] = rgb.y;
+        vg.color[2] = rgb.z;
+
+        Pose3d pose = geom->GetAbsPose();
+        vg.pos[0] = pose.pos.x;
+        vg.pos[1] = pose.pos.y;
+        vg.pos[2] = pose.pos.z;
+        vg.rot[0] = pose.rot.u;
+        vg.rot[1] = pose.rot.x;
+        vg.rot[2] = pose.rot.y;
+        vg.rot[3] = pose.rot.z;
+
+        frame.geoms.push_back( vg );
+      }
+    }
+  }
+
+  frame.hasBall = ( this->ball != NULL );
+  if ( this->ball != NULL )
+    frame.ballPose = this->ball->GetAbsPose();
+
+  frame.step = this->stepCount;
+  frame.simTime = Simulator::Instance()->GetSimTime();
+
+  this->frames.Publish();
+
+  this->captureCount++;
+  this->captureTime += Time::GetWallTime() - start;
+}
+
+double VisualApp::GetUpdateRate( ) const{
+  return this->renderRate;
+}
+
+void VisualApp::PrintStats( ){
+
+  double elapsed = ( Time::GetWallTime() - this->startTime ).Double();
+  if ( elapsed <= 0 )
+    elapsed = 1;
+
+  std::cout << "Visual: " << this->stepCount << " steps ("
+            << this->stepCount / elapsed << "/s), "
+            << this->captureCount << " captured, "
+            << this->renderCount << " rendered ("
+            << this->renderCount / elapsed << "/s), "
+            << this->frames.GetOverwritten() << " dropped" << std::endl;
+
+  if ( this->captureCount > 0 )
+    std::cout << "Visual: capture "
+              << 1e6 * this->captureTime.Double() / this->captureCount
+              << " us/frame";
+  if ( this->renderCount > 0 )
+    std::cout << ", render "
+              << 1e6 * this->renderTime.Double() / this->renderCount
+              << " us/frame";
+  std::cout << std::endl;
 }
 
 void VisualApp::SetEnabled(bool enabled){
@@ -63,22 +227,39 @@ void VisualApp::ProcessEvents( ){
   
   if ( this->enabled == false)
     return;
-    
-  // maybe try try_lock here instead
-  boost::recursive_mutex::scoped_lock lock(
-        *Simulator::Instance()->GetMRMutex());
 
-  if ( this->QTapp->hasPendingEvents() )
-    this->QTapp->processEvents();
-    
-  // Render
-  this->mw->updateVisual();
+  if ( !this->nullRenderer )
+  {
+    // The input handlers move models, they need the world
+    boost::recursive_mutex::scoped_lock lock(
+          *Simulator::Instance()->GetMRMutex());
+
+    if ( this->QTapp->hasPendingEvents() )
+      this->QTapp->processEvents();
+  }
+
+  Time now = Time::GetWallTime();
+  if ( (now - this->lastRender).Double() < 1.0 / this->renderRate )
+    return;
+
+  // Nothing new since the last frame
+  if ( !this->frames.Acquire() )
+    return;
+
+  this->lastRender = now;
+
+  // Render, from the frame only: physics keeps running meanwhile
+  if ( !this->nullRenderer )
+    this->mw->updateVisual();
+
+  this->renderCount++;
+  this->renderTime += Time::GetWallTime() - now;
   
 }
 
 bool VisualApp::UserQuit(){
   
-  if ( this->enabled == false)
+  if ( this->enabled == false || this->nullRenderer )
     return false;
     
   return this->mw->UserClosedWindow();
@@ -91,6 +272,15 @@ VisualApp::VisualApp( ){
   QTapp = NULL;
   mw    = NULL;
   ball  = NULL;
+
+  enabled      = false;
+  nullRenderer = false;
+  renderRate   = 50.0;
+  renderEveryN = 1;
+
+  stepCount    = 0;
+  captureCount = 0;
+  renderCount  = 0;
 }
 
 // Destructor
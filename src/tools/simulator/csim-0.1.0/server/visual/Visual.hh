@@ -3,6 +3,8 @@
 
 #include "SingletonT.hh"
 #include "XMLConfig.hh"
+#include "Time.hh"
+#include "VisualFrame.hh"
 
 
 class QApplication;
@@ -24,6 +26,18 @@ namespace visual {
     void SetEnabled(bool enabled);
     void ProcessEvents();
     bool UserQuit();
+
+    // Copy the scene for the renderer (physics thread, once per step)
+    void Capture();
+
+    // Latest frame taken by the renderer
+    const VisualFrame& GetFrame() const { return this->frames.GetFront(); };
+
+    // Rate at which ProcessEvents should be called
+    double GetUpdateRate() const;
+
+    // Print the capture and render counters
+    void PrintStats();
     
     Body* GetBall(){ return this->ball; };
    
@@ -33,6 +47,21 @@ namespace visual {
     virtual ~VisualApp();
     
     bool enabled;
+    bool nullRenderer;
+
+    double renderRate;          // maximum frames per second
+    unsigned int renderEveryN;  // capture one step out of N
+    gazebo::Time lastRender;
+
+    TripleBuffer<VisualFrame> frames;
+
+    // Counters
+    unsigned long stepCount;
+    unsigned long captureCount;
+    unsigned long renderCount;
+    gazebo::Time  captureTime;
+    gazebo::Time  renderTime;
+    gazebo::Time  startTime;
     
     QApplication*  QTapp;
     MainWindow*    mw;
@@ -0,0 +1,134 @@
+/*
+ *  CSim - CAMBADA Simulator
+ *  Copyright (C) 2010  Universidade de Aveiro
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ *  @Desc   Pose snapshot handed from the physics thread to the renderer
+ *
+ */
+
+#ifndef _VISUALFRAME_HH_
+#define _VISUALFRAME_HH_
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/thread/mutex.hpp>
+
+#include "Pose3d.hh"
+#include "Time.hh"
+
+namespace visual {
+
+  /// \brief Everything needed to draw a geom, without touching the world
+  struct VisualGeom {
+    int    type;      // gazebo::Shape::Type
+    double size[3];
+    float  color[3];
+    double pos[3];
+    double rot[4];    // u, x, y, z
+  };
+
+  /// \brief Pose of a model, used by the camera and the selection
+  struct VisualModel {
+    const void*     model;  // identity only, never dereferenced
+    char            name[32];
+    gazebo::Pose3d  pose;       // absolute pose of the model
+    gazebo::Pose3d  bodyPose;   // absolute pose of the canonical body
+  };
+
+  /// \brief One frame of the scene
+  struct VisualFrame {
+    unsigned long              step;
+    gazebo::Time               simTime;
+    bool                       hasBall;
+    gazebo::Pose3d             ballPose;
+    std::vector<VisualGeom>    geoms;
+    std::vector<VisualModel>   models;
+
+    VisualFrame() : step(0), hasBall(false) {}
+
+    /// \brief Find the model record of a model, NULL if not in the frame
+    const VisualModel* FindModel( const void* model ) const {
+      for ( unsigned int i = 0; i < models.size(); i++ )
+        if ( models[i].model == model )
+          return &models[i];
+      return NULL;
+    }
+  };
+
+  /// \brief Triple buffer between one writer and one reader
+  /*
+   * The writer fills the back buffer and publishes it, the reader takes
+   * the latest published buffer. Neither side ever waits for the other
+   * to finish with a buffer, the lock only covers the index swap.
+   */
+  template<typename T>
+  class TripleBuffer {
+
+  public:
+
+    TripleBuffer() : back(0), middle(1), front(2), fresh(false),
+                     overwritten(0) {}
+
+    /// \brief Buffer owned by the writer
+    T& GetBack(){ return this->buffers[this->back]; }
+
+    /// \brief Buffer owned by the reader
+    const T& GetFront() const { return this->buffers[this->front]; }
+
+    /// \brief Make the back buffer the latest one
+    void Publish(){
+      boost::mutex::scoped_lock lock(this->mutex);
+      std::swap( this->back, this->middle );
+      if ( this->fresh )
+        this->overwritten++;
+      this->fresh = true;
+    }
+
+    /// \brief Move the latest buffer to the front
+    /// \return false if nothing was published since the last call
+    bool Acquire(){
+      boost::mutex::scoped_lock lock(this->mutex);
+      if ( !this->fresh )
+        return false;
+      std::swap( this->front, this->middle );
+      this->fresh = false;
+      return true;
+    }
+
+    /// \brief Number of buffers published and never acquired
+    unsigned long GetOverwritten(){
+      boost::mutex::scoped_lock lock(this->mutex);
+      return this->overwritten;
+    }
+
+  private:
+
+    T buffers[3];
+    int back, middle, front;
+    bool fresh;
+    unsigned long overwritten;
+    boost::mutex mutex;
+
+  };
+
+}
+
+#endif /* end of include guard: _VISUALFRAME_HH_ */
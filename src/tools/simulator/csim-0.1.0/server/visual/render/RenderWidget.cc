@@ -113,84 +113,55 @@ void RenderWidget::paintGL()
   dsDrawFrame( this->w, this->h );
   HandleView();
   
-  std::vector<Model*> models = World::Instance()->GetModels();
-  std::vector<Model*>::const_iterator m_iter = models.begin();
-  
-  const std::map< std::string, Body* > *bodies;
-  const std::map<std::string, Geom*> *geoms;
-  Model* m     = NULL;
-  Geom* geom   = NULL;
-  Shape* shape = NULL;
+  // Draw from the frame taken by VisualApp, not from the world, so
+  // that physics does not wait for the renderer
+  const VisualFrame& frame = VisualApp::Instance()->GetFrame();
+  std::vector<VisualGeom>::const_iterator g_iter = frame.geoms.begin();
   
   dReal p[3];
   dReal r[12];
   dReal q[4];
   
-  for ( ; m_iter != models.end(); m_iter++ ){
+  for ( ; g_iter != frame.geoms.end(); g_iter++ ){
     
-    m = *m_iter;
-    if ( m->GetType().compare("empty") == 0 ) continue;
+    const VisualGeom& geom = *g_iter;
     
-    // Find all Bodies
-    bodies = m->GetBodies();
-    std::map< std::string, Body* >::const_iterator b_iter = bodies->begin();
+    dsSetColor( geom.color[0], geom.color[1], geom.color[2] );
     
-    for ( ; b_iter != bodies->end(); b_iter++ ){
-      geoms = b_iter->second->GetGeoms();
-      std::map<std::string, Geom*>::const_iterator g_iter = geoms->begin();
-      
-      for ( ; g_iter != geoms->end(); g_iter++ ){
-        geom = g_iter->second;
-        
-        Vector3 rgb = geom->GetPigment();
-        dsSetColor( rgb.x, rgb.y, rgb.z );
-        
-        shape= geom->GetShape();
-        // Body Pose
-        Pose3d pose = geom->GetAbsPose();
-        
-        p[0] = pose.pos.x;
-        p[1] = pose.pos.y;
-        p[2] = pose.pos.z;
-        
-        q[0] = pose.rot.u;
-        q[1] = pose.rot.x;
-        q[2] = pose.rot.y;
-        q[3] = pose.rot.z;
-        
-        dQtoR( q, r );
+    p[0] = geom.pos[0];
+    p[1] = geom.pos[1];
+    p[2] = geom.pos[2];
+    
+    q[0] = geom.rot[0];
+    q[1] = geom.rot[1];
+    q[2] = geom.rot[2];
+    q[3] = geom.rot[3];
+    
+    dQtoR( q, r );
+    
+    switch ( geom.type ){
+      case Shape::SPHERE:
+        dsDrawSphere( p, r , geom.size[0]);
+        break;
         
-        switch ( shape->GetType() ){
-          case Shape::SPHERE:
-            dsDrawSphere( p, r , ((SphereShape*)shape)->GetSize());
-            break;
-            
-          case Shape::CYLINDER:
-          {
-            //cylinder dimension
-            Vector2<double>  cyldim = ((CylinderShape*)shape)->GetSize();
-            dsDrawCylinder( p, r, cyldim.y, cyldim.x );
-          }
-            break;
-            
-          case Shape::BOX:
-          {
-            float s[3];
-            Vector3 v = ((BoxShape*)shape)->GetSize();
-            s[0] = v.x; s[1] = v.y; s[2] = v.z;
-            dsDrawBox( p, r, s);
-          }
-            break;
-          
-          default:
-            break;
-        }// end Switch geom
+      case Shape::CYLINDER:
+        //cylinder dimension
+        dsDrawCylinder( p, r, geom.size[1], geom.size[0] );
+        break;
         
-      } // end for geom..
+      case Shape::BOX:
+      {
+        float s[3];
+        s[0] = geom.size[0]; s[1] = geom.size[1]; s[2] = geom.size[2];
+        dsDrawBox( p, r, s);
+      }
+        break;
       
-    } // end for bodies
+      default:
+        break;
+    }// end Switch geom
     
-  } // end for models 
+  } // end for geoms
   
   //dsSetColor (1, 1, 1);
 
@@ -609,16 +580,17 @@ void RenderWidget::HandleView(){
         dReal dpos[3];
         dReal dlook[4];
         
+        const VisualFrame& frame = VisualApp::Instance()->GetFrame();
         std::stringstream ss;
         ss << "robbie_" << this->watchThisRobot;
-        Model* m = World::Instance()->GetModelByName( ss.str() );
-        if ( m == NULL ){
-            // default to ball
-            m = VisualApp::Instance()->GetBall()->GetParentModel() ;
-        }
 
-        Body* body = m->GetCanonicalBody();
-        Pose3d bpose = body->GetAbsPose();
+        Pose3d bpose = frame.ballPose;   // default to ball
+        for ( unsigned int i = 0; i < frame.models.size(); i++ ){
+          if ( ss.str() == frame.models[i].name ){
+            bpose = frame.models[i].bodyPose;
+            break;
+          }
+        }
         
         double rotation = bpose.rot.GetYaw();
 
@@ -651,11 +623,11 @@ void RenderWidget::HandleView(){
   case RenderWidget::kBallView:
   { 
     // Ball position
-    Body* ball = VisualApp::Instance()->GetBall();
-    if ( ball != NULL ){
+    const VisualFrame& frame = VisualApp::Instance()->GetFrame();
+    if ( frame.hasBall ){
       dReal dpos[3];
       dReal dlook[4];
-      Pose3d bpose = ball->GetAbsPose();
+      Pose3d bpose = frame.ballPose;
       
       dpos[0] = bpose.pos.x;
       dpos[1] = bpose.pos.y;
@@ -704,14 +676,18 @@ void RenderWidget::DrawField(){
   float lh = 0.03;
   float a[3];
   float b[3];
+
+  // Pose of the selected model, as seen in the frame
+  const VisualModel* selected =
+    VisualApp::Instance()->GetFrame().FindModel( this->selectedModel );
   
     // not quite on the ground
   a[2] = b[2] = lh;
   
     // should this been done here ???
-  if ( (this->dragMode == true) && (this->selectedModel) ){
+  if ( (this->dragMode == true) && (selected) ){
 
-    Pose3d mpos = this->selectedModel->GetAbsPose();
+    Pose3d mpos = selected->pose;
     a[0] = mpos.pos.x; a[1] = mpos.pos.y;
     b[0] = this->fx; b[1] = this->fy; 
     
@@ -720,8 +696,8 @@ void RenderWidget::DrawField(){
   }
   
     // should this been done here ???
-  if ( (this->rotateMode == true) && (this->selectedModel) ){
-    Pose3d mpos  = this->selectedModel->GetAbsPose();
+  if ( (this->rotateMode == true) && (selected) ){
+    Pose3d mpos  = selected->pose;
     a[0] = mpos.pos.x; a[1] = mpos.pos.y; // Model center
     b[0] = this->fx;
     b[1] = this->fy;    
@@ -730,8 +706,8 @@ void RenderWidget::DrawField(){
   }
   
       // should this been done here ???
-  if ( (this->speedMode == true) && (this->selectedModel) ){
-    Pose3d mpos  = this->selectedModel->GetAbsPose();
+  if ( (this->speedMode == true) && (selected) ){
+    Pose3d mpos  = selected->pose;
     a[0] = mpos.pos.x; a[1] = mpos.pos.y; // Model center
     b[0] = this->fx;
     b[1] = this->fy;    
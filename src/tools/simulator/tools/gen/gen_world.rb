@@ -90,6 +90,9 @@ XMLDATA = <<ENDDATA
   
   <visual:qt4>
     <ballModel><%= simconf['ball_of_game']['name'] %></ballModel>
+    <renderer>gl</renderer>
+    <renderRate>50</renderRate>
+    <renderEveryN>1</renderEveryN>
   </visual:qt4>
 
   <field:msl>
@@ -117,6 +120,7 @@ XMLDATA = <<ENDDATA
     <controller:comm name="comm">
       <updateRate>10</updateRate>
       <withIFace>false</withIFace>
+      <sharedView>true</sharedView>
     </controller:comm>
   </model:empty>
 
@@ -48,16 +48,6 @@ BallPositionKalman::BallPositionKalman( double readingDeviation )
 	
 	setNoise(readingDeviation);
 
-	covarMatrix[0][0]	= 1.0;
-	covarMatrix[0][1]	= 0.0;
-	covarMatrix[1][0]	= 0.0;
-	covarMatrix[1][1]	= 1.0;
-	
-	modelMatrix[0][0]	= 1.0;
-	modelMatrix[0][1]	= 0.0;
-	modelMatrix[1][0]	= 0.0;
-	modelMatrix[1][1]	= 1.0;
-	
 	lastCycleVisible	= false;
 	
 //	fprintf(stderr,"Constructor called\n");
@@ -72,11 +62,11 @@ void BallPositionKalman::setNoise( double readingDeviation )
 {
 	this->readingDeviation = readingDeviation;
 
-	R = readingDeviation * readingDeviation;
-	Q[0][0] = (readingDeviation/3) * (readingDeviation/3);
-	Q[0][1] = 0.0;
-	Q[1][0] = 0.0;
-	Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
+	kalman.R[0][0] = readingDeviation * readingDeviation;
+	kalman.Q[0][0] = (readingDeviation/3) * (readingDeviation/3);
+	kalman.Q[0][1] = 0.0;
+	kalman.Q[1][0] = 0.0;
+	kalman.Q[1][1] = (readingDeviation*2) * (readingDeviation*2);
 }
 
 
@@ -99,53 +89,24 @@ Vec BallPositionKalman::filterPosition( Vec readPosition, unsigned long instant
 //	fprintf(stderr,"deltaT: %f\n",deltaT);
 	
 	//refresh the model matrix with the correct deltaT
-	modelMatrix[0][1] = deltaT;
-	
-	//calculate the predicted position of the ball
-	Vec positionPrediction = modelMatrix[0][0]*lastMeasure + modelMatrix[0][1]*lastVel;
-	
-	//calculate the predicted velocity of the ball (with the base model is always the same)
-	Vec velocityPrediction = modelMatrix[1][0]*lastMeasure + modelMatrix[1][1]*lastVel;
-	
-	//calculate the predicted covariance matrix for the current sample F*P*F' + Q
-	double FP[2][2];	//F*P
-	FP[0][0] = modelMatrix[0][0]*covarMatrix[0][0] + modelMatrix[0][1]*covarMatrix[1][0];
-	FP[0][1] = modelMatrix[0][0]*covarMatrix[0][1] + modelMatrix[0][1]*covarMatrix[1][1];
-	FP[1][0] = modelMatrix[1][0]*covarMatrix[0][0] + modelMatrix[1][1]*covarMatrix[1][0];
-	FP[1][1] = modelMatrix[1][0]*covarMatrix[0][1] + modelMatrix[1][1]*covarMatrix[1][1];
-	
-	double predictedP[2][2];	//(F*P)*F' + Q
-	predictedP[0][0] = FP[0][0]*modelMatrix[0][0] + FP[0][1]*modelMatrix[0][1] + Q[0][0];
-	predictedP[0][1] = FP[0][0]*modelMatrix[1][0] + FP[0][1]*modelMatrix[1][1] + Q[0][1];
-	predictedP[1][0] = FP[1][0]*modelMatrix[0][0] + FP[1][1]*modelMatrix[0][1] + Q[1][0];
-	predictedP[1][1] = FP[1][0]*modelMatrix[1][0] + FP[1][1]*modelMatrix[1][1] + Q[1][1];
-	
-	//calculate innovation covariation S, based on the predicted P; S = H*P*H' + R (being H = [1 0], S = P[0][0] + R)
-	S = predictedP[0][0] + R;
+	kalman.F[0][1] = deltaT;
 	
-	//calculate the optimal kalman gain for this cycle K = predictedP*H'*inv(s)
-	kalmanGain[0] = predictedP[0][0] * 1/S;	//multiplication by H = [1 0]' is 1st column of tempP
-	kalmanGain[1] = predictedP[1][0] * 1/S;
+	//predict the position and velocity of the ball and their covariance F*P*F' + Q
+	kalman.predict();
 	
-	//calculate the measurement innovation
-	Vec residual = readPosition - positionPrediction;
-
-	//based on the kalman gain (and therefore the predicted covariance for the current cycle), refresh the base covariance matrix for next cycle; P = (I-K*H)*P
-	double tmp[2][2];	//I - K*H, K*H returns a [2][2] matrix with K in 1st column and zeros in 2nd
-	tmp[0][0] = 1.0 - kalmanGain[0];
-	tmp[0][1] = 0.0;	//I[0][1] 0.0 - K*H[0][1] 0.0
-	tmp[1][0] = 0.0 - kalmanGain[1];
-	tmp[1][1] = 1.0;	//I[0][1] 1.0 - K*H[0][1] 0.0
-	
-	//(I - K*H) * P
-	covarMatrix[0][0] = tmp[0][0]*predictedP[0][0] + tmp[0][1]*predictedP[1][0];
-	covarMatrix[0][1] = tmp[0][0]*predictedP[0][1] + tmp[0][1]*predictedP[1][1];
-	covarMatrix[1][0] = tmp[1][0]*predictedP[0][0] + tmp[1][1]*predictedP[1][0];
-	covarMatrix[1][1] = tmp[1][0]*predictedP[0][1] + tmp[1][1]*predictedP[1][1];
+	//correct them with the measured position (H = [1 0])
+	double measure[1][2] = { { readPosition.x, readPosition.y } };
+	if ( !kalman.updateDirect( measure ) )
+	{
+		//no usable covariance, restart from the measure
+		kalman.identity( kalman.P );
+		resetFilter( readPosition, instant );
+		return readPosition;
+	}
 
-	//finaly calculate the filtered position to return (and some residual velocity refresh), also used as base to the next cycle prediction
-	lastMeasure	= positionPrediction + kalmanGain[0]*residual;
-	lastVel		= velocityPrediction + kalmanGain[1]*residual;
+	//finaly take the filtered position to return (and some residual velocity refresh)
+	lastMeasure	= Vec( kalman.x[0][0], kalman.x[0][1] );
+	lastVel		= Vec( kalman.x[1][0], kalman.x[1][1] );
 
 	lastTime = instant;
 	
@@ -168,6 +129,10 @@ void BallPositionKalman::resetFilter( Vec setAsLast, unsigned long instant )
 {
 	lastMeasure	= setAsLast;
 	lastVel		= Vec::zero_vector;
+	kalman.x[0][0] = setAsLast.x;
+	kalman.x[0][1] = setAsLast.y;
+	kalman.x[1][0] = 0.0;
+	kalman.x[1][1] = 0.0;
 	
 // 	struct timeval tmpTime;
 // 	gettimeofday( &tmpTime , NULL );
@@ -175,12 +140,7 @@ void BallPositionKalman::resetFilter( Vec setAsLast, unsigned long instant )
 	unsigned long actualTime = instant;
 	
 	if ( (actualTime - lastTime) > 1000 )
-	{
-		covarMatrix[0][0]	= 1.0;
-		covarMatrix[0][1]	= 0.0;
-		covarMatrix[1][0]	= 0.0;
-		covarMatrix[1][1]	= 1.0;
-	}
+		kalman.identity( kalman.P );
 
 	lastTime = actualTime;
 	
@@ -24,12 +24,13 @@
 #define _BALLKALMAN_
 
 #include "Vec.h"
+#include "LinearKalman.h"
 #include <sys/time.h>
 
 namespace cambada {
 namespace util {
 
-/*! Filters a position based on a kalman filter. Built specifically for ball position, the model is hardcoded to minimize running time
+/*! Filters a position based on a kalman filter. Built specifically for ball position, on a (position, velocity) LinearKalman
 \brief Kalman filter implementation*/
 class BallPositionKalman
 {
@@ -76,13 +77,7 @@ private:
 
 	double readingDeviation;			/*!<The deviation of the measurements (vision sensor error, for sensor model).*/
 
-	double R;				//R = readingDeviation^2
-	double Q[2][2];			//Q = (readingDeviation/WHATEVER)^2 in main diagonal
-
-	double S;					//covariance innovation
-	double covarMatrix[2][2];	//P
-	double modelMatrix[2][2];	//F
-	double kalmanGain[2];		//K
+	LinearKalman<2, 1, 2> kalman;	/*!<(position, velocity) of x and y, only the position is measured.*/
 };
 
 }}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHECKREPORT_H_
+#define CHECKREPORT_H_
+
+#include <stdio.h>
+
+// Failure reporting shared by the check programs (the *-check make targets),
+// each one a single translation unit:
+//   CHECK(cond, "format", ...) counts a failed condition, the first ones are printed
+//   checkReport("what") prints the summary, its result is the exit status of main
+
+#define CHECK_PRINTED	20
+
+static int errors = 0;
+
+#define CHECK(cond, txt, par...) \
+	do { if (!(cond) && errors++ < CHECK_PRINTED) printf("FAIL: " txt "\n", ## par); } while (0)
+
+static inline int checkReport(const char* what)
+{
+	if (errors > 0)
+	{
+		printf("%d failures\n", errors);
+		return 1;
+	}
+
+	printf("%s: all checks passed\n", what);
+	return 0;
+}
+
+#endif /* CHECKREPORT_H_ */
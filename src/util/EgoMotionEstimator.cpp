@@ -31,8 +31,7 @@ namespace cambada {
 namespace util {
 
 EgoMotionEstimator::EgoMotionEstimator(int nSamples)
-	: xLinReg(), yLinReg(), thetaLinReg(), xWindow(nSamples),
-	  yWindow(nSamples), thetaWindow(nSamples), timeWindow(nSamples), timer(),
+	: xLinReg(), yLinReg(), thetaLinReg(), window(nSamples), timer(),
 	  linVel(Vec()), angVel(0.0f)
 {
 }
@@ -45,12 +44,12 @@ void EgoMotionEstimator::update()
 {
 	//TODO adaptive window resize policy
 
-	thetaLinReg.calculateParameters(timeWindow.getSamples(), thetaWindow.getSamples());
+	thetaLinReg.calculateParameters(window, 2);
 	if(thetaLinReg.getSlope() < 10e-3) //straight line
 	{
 		angVel = 0.0f;
-		xLinReg.calculateParameters(timeWindow.getSamples(), xWindow.getSamples());
-		yLinReg.calculateParameters(timeWindow.getSamples(), yWindow.getSamples());
+		xLinReg.calculateParameters(window, 0);
+		yLinReg.calculateParameters(window, 1);
 		linVel.x = xLinReg.getSlope();
 		linVel.y = yLinReg.getSlope();
 	}
@@ -58,7 +57,7 @@ void EgoMotionEstimator::update()
 	{
 		angVel = thetaLinReg.getSlope();
 
-		float n = (float) timeWindow.getNumSamples();
+		float n = (float) window.size();
 		float sumX = 0.0f;
 		float sumY = 0.0f;
 		float sumS = 0.0f;
@@ -69,13 +68,13 @@ void EgoMotionEstimator::update()
 		float sumCX = 0.0f;
 		float sumSY = 0.0f;
 		float sumCY = 0.0f;
-		float timeRef = timeWindow.getSample(n-1);
+		float timeRef = window.x(window.size()-1);
 
-		for (unsigned int i = 0; i < timeWindow.getNumSamples(); ++i)
+		for (unsigned int i = 0; i < window.size(); ++i)
 		{
-			float t = timeWindow.getSample(i) - timeRef;
-			float x = xWindow.getSample(i);
-			float y = yWindow.getSample(i);
+			float t = (float)window.x(i) - timeRef;
+			float x = window.y(i, 0);
+			float y = window.y(i, 1);
 			sumX += x;
 			sumY += y;
 			float s = sin(angVel*t);
@@ -122,13 +121,10 @@ void EgoMotionEstimator::addValue(Vec pos, float theta)
 
 void EgoMotionEstimator::addValue(float x, float y, float theta)
 {
-	xWindow.addValue(x);
-	yWindow.addValue(y);
-
 	//deal with angle discontinuity by angle unrolling
-	if(thetaWindow.getNumSamples() > 1)
+	if(window.size() > 1)
 	{
-		float lastTheta = thetaWindow.getSample(thetaWindow.getNumSamples()-1);
+		float lastTheta = window.y(window.size()-1, 2);
 		float diffTheta;
 		while(fabs(diffTheta = (theta - lastTheta)) > M_PI)
 		{
@@ -137,11 +133,10 @@ void EgoMotionEstimator::addValue(float x, float y, float theta)
 			theta -= sign * 2*M_PI;
 		}
 	}
-	thetaWindow.addValue(theta);
-
-	timeWindow.addValue(timer.elapsed()/1000.0f); //in seconds
+	double sample[3] = { x, y, theta };
+	window.push(timer.elapsed()/1000.0f, sample); //time in seconds
 
-	//fprintf(stderr,"EGOMOTION_DATA %f, %f, %f, %f, %d\n", timeWindow.getSample(timeWindow.getNumSamples()-1), xWindow.getSample(timeWindow.getNumSamples()-1), yWindow.getSample(timeWindow.getNumSamples()-1), thetaWindow.getSample(timeWindow.getNumSamples()-1), timeWindow.getNumSamples());
+	//fprintf(stderr,"EGOMOTION_DATA %f, %f, %f, %f, %d\n", window.x(window.size()-1), window.y(window.size()-1, 0), window.y(window.size()-1, 1), window.y(window.size()-1, 2), window.size());
 
 }
 
@@ -157,10 +152,7 @@ float EgoMotionEstimator::getAngularVelocity(void)
 
 void EgoMotionEstimator::reset()
 {
-	xWindow.clear();
-	yWindow.clear();
-	thetaWindow.clear();
-	timeWindow.clear();
+	window.clear();
 	xLinReg.reset();
 	yLinReg.reset();
 	thetaLinReg.reset();
@@ -23,11 +23,13 @@
 #ifndef EGOMOTIONESTIMATOR_H_
 #define EGOMOTIONESTIMATOR_H_
 
-#include "SlidingWindow.h"
+#include "RingBuffer.h"
 #include "LinRegression.h"
 #include "Vec.h"
 #include "Timer.h"
 
+#define EGOMOTION_MAX_SAMPLES	32	// largest nSamples
+
 namespace cambada {
 namespace util {
 using namespace geom;
@@ -46,7 +48,8 @@ public:
 
 private:
 	cambada::util::LinRegression xLinReg,yLinReg,thetaLinReg;
-	cambada::util::SlidingWindow xWindow, yWindow, thetaWindow, timeWindow;
+	// time (s) and x, y, theta of the last nSamples
+	cambada::util::RegressionWindow<3, EGOMOTION_MAX_SAMPLES> window;
 	Timer timer;
 	geom::Vec linVel;
 	float angVel;
@@ -20,6 +20,8 @@
  * along with this package.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+
 #include "HeightMap.h"
 
 using namespace cambada::geom;
@@ -30,6 +32,8 @@ namespace util {
 HeightMap::HeightMap() {
 	map = new TCODHeightMap(SAMPLE_SCREEN_WIDTH,SAMPLE_SCREEN_LENGTH);
 	map->clear();
+
+	memset(&rtdbView, 0, sizeof(rtdbView));
 }
 
 HeightMap::~HeightMap() {
@@ -78,20 +82,40 @@ void HeightMap::fillRtdb()
 {
 	if(Whoami() == 0)
 	{
-		GridView gv;
-		int count= 0;
+		GridView& gv = rtdbView;
+		bool first = (gv.count == 0);
+		bool changed = first;
+
+		if (first)
+		{
+			Vec origin = grid2world(0, 0);
+			gv.width = SAMPLE_SCREEN_WIDTH;
+			gv.length = SAMPLE_SCREEN_LENGTH;
+			gv.scale = SCALE;
+			gv.originX = origin.x;
+			gv.originY = origin.y;
+			gv.count = gv.width * gv.length;
+		}
 
+		// only the tiles with a changed value get a new version
 		for (int x=0; x < SAMPLE_SCREEN_WIDTH; x++ ) {
 			for (int y=0; y < SAMPLE_SCREEN_LENGTH; y++ ) {
-				gv.grid[count].pos = grid2world(x, y);
-				//fprintf(stderr, "FILL x %.2f %.2f\n", gv.grid[count].pos.x, gv.grid[count].pos.y);
-				gv.grid[count].val = map->getValue(x, y);
-				count++;
+				float val = map->getValue(x, y);
+				float& old = gv.val(x, y);
+				if (first || old != val)
+				{
+					gv.tileVersion[GridView::tileIndex(x, y)] = gv.version + 1;
+					old = val;
+					changed = true;
+				}
 			}
 		}
 
-		gv.count = count;
-		DB_put(GRIDVIEW, (void*)&gv);
+		if (changed)
+		{
+			gv.version++;
+			DB_put(GRIDVIEW, (void*)&gv);
+		}
 	}
 }
 
@@ -76,6 +76,9 @@ public:
 			const int *dy, const float *weight, float minLevel, float maxLevel);
 
 	TCODHeightMap* map;
+
+private:
+	GridView rtdbView;	// last map written by fillRtdb, to find the changed tiles
 };
 
 }
@@ -38,6 +38,7 @@ void KickerTable::addEntry(int distance, int power){
         distances.push_back(distance); // add entry in distances vector
 
     sort(distances.begin(), distances.end(), _distSort); // Sort distances table
+    compile();
 }
 
 void KickerTable::delEntry(int distance){
@@ -47,6 +48,13 @@ void KickerTable::delEntry(int distance){
     }
 
     sort(distances.begin(), distances.end(), _distSort); // Sort distances table
+    compile();
+}
+
+void KickerTable::clear(){
+    mapping.clear();
+    distances.clear();
+    compile();
 }
 
 int KickerTable::size(){
@@ -60,39 +68,39 @@ void KickerTable::print(FILE* fout) {
 }
 
 int KickerTable::getPower(int distance){
-    if(size() == 0)
+    if(powerByCm.empty())
         return 0;
-    if(size() == 1)
-        return mapping[distances.at(0)];
-    else if(find(distances.begin(), distances.end(), distance) != distances.end()) // If that distance exists in the table
-        return mapping[distance];
-    else {
-        if(distances.at(0) > distance)                       // If distance is less than the first distance in the table
-            return mapping[distances.at(0)];                 // return that distance
-
-        int leftDistIdx = 0;
-        while(leftDistIdx < size()-1 && distances.at(leftDistIdx+1) < distance)
-            leftDistIdx++;
-
-        if(leftDistIdx == size()-1)                         // check if we reached the end
-            return mapping[distances.at(leftDistIdx)];      // In that case return the power for the highes distance
-        else {                                              // Else, we still have points to the right
-            int rightDistIdx = leftDistIdx+1;               // Then this is the point to the right
-
-            float d1 = (float)distances.at(leftDistIdx);           // Distance 1
-            float d2 = (float)distances.at(rightDistIdx);          // Distance 2
-            float dDist = d2 - d1;                          // delta Distance
-            float dPow = (float)mapping[d2] - (float)mapping[d1]; // delta Power
-
-            float m = dPow/dDist;                           // Calc slope
-            float b = (float)mapping[d1] - m*d1;            // calc b of the line
-
-            return (int)(m*distance + b);                   // Return the value of the line in that distance
-        }
+    if(distance <= distances.front())                        // Before the first distance in the table
+        return powerByCm.front();
+    if(distance >= distances.back())                         // After the last one
+        return powerByCm.back();
+    return powerByCm[distance - distances.front()];
+}
+
+void KickerTable::compile(){
+    powerByCm.clear();
+    if(size() == 0)
+        return;
+
+    powerByCm.reserve(distances.back() - distances.front() + 1);
+    for(int i = 0; i < size()-1; i++){                       // For each pair of consecutive entries
+        int d1 = distances.at(i);                            // Distance 1
+        int d2 = distances.at(i+1);                          // Distance 2
+        float dDist = (float)d2 - (float)d1;                 // delta Distance
+        float dPow = (float)mapping[d2] - (float)mapping[d1]; // delta Power
+
+        float m = dPow/dDist;                                // Calc slope
+        float b = (float)mapping[d1] - m*d1;                 // calc b of the line
+
+        powerByCm.push_back(mapping[d1]);                    // The entry itself
+        for(int d = d1+1; d < d2; d++)                       // and the line up to the next one
+            powerByCm.push_back((int)(m*d + b));
     }
+    powerByCm.push_back(mapping[distances.back()]);
 }
 
 KickerConf::KickerConf(int agentNumber, char* file)
+	: xSpeedFactor(0.0, 1.0, 1.74, 0.5, 0.0, 1.0)
 {
 	if(agentNumber < 1 || agentNumber > 6){
 		fprintf(stderr,"ERROR : KickerConf invalid agent (given %d)\n", agentNumber);
@@ -109,6 +117,7 @@ KickerConf::KickerConf(int agentNumber, char* file)
 }
 
 KickerConf::KickerConf(WorldState* pointer, int agentNumber, char* file)
+	: xSpeedFactor(0.0, 1.0, 1.74, 0.5, 0.0, 1.0)
 {
 	if(agentNumber < 1 || agentNumber > 6){
 		fprintf(stderr,"ERROR : KickerConf invalid agent (given %d)\n", agentNumber);
@@ -137,8 +146,7 @@ bool KickerConf::load(char *file){
 
         if(fscanf(fp,"R%d %d\n", &robotNumber, &numEntries) == 2 && robotNumber != -1 && numEntries != -1){ // If valid values
             KickerTable* nowTable = &table[robotNumber-1];
-            nowTable->mapping.clear();
-            nowTable->distances.clear();
+            nowTable->clear();
             for(int e = 0; e < numEntries; e++){       // iterate through each entry in table
                 if(fscanf(fp,"%d %d\n",&d,&k) == 2)
                     nowTable->addEntry(d,k);
@@ -210,6 +218,7 @@ bool KickerConf::loadThroughParab(char* file)
 
 	fclose(fp);
 
+	vel.clear();
 	vel.push_back(vel15);
 	vel.push_back(vel20);
 	vel.push_back(vel25);
@@ -223,6 +232,21 @@ bool KickerConf::loadThroughParab(char* file)
 	angDeg = ang;
 	velRobotContribution = velContribution;
 
+	double teta = (angDeg * M_PI) / 180.0;
+	tanTeta = tan(teta);
+	sin2Teta = sin(2 * teta);
+	cosTeta = cos(teta);
+
+	// lines between the measured power levels, to get the power of a velocity
+	int i, kick;
+	for(i = 1, kick = KICK_MIN; i < N_VALS; i++, kick += KICK_STEP)
+	{
+		velSlope[i] = (vel.at(i)-vel.at(i-1)) / KICK_STEP;
+		velOffset[i] = vel.at(i-1) - velSlope[i] * kick;
+	}
+	velSlope[N_VALS] = (vel.at(vel.size()-1)-vel.at(vel.size()-2)) / KICK_STEP;
+	velOffset[N_VALS] = vel.at(vel.size()-2) - velSlope[N_VALS] * kick;
+
 	return true;
 }
 
@@ -231,16 +255,13 @@ int KickerConf::getPowerThroughParab(float distance, float height)
 	int kickPower;
 	double distOrig = distance;
 	double g = 9.8067;
-	double teta = (angDeg * M_PI) / 180.0;
 	double v0, vkick;
-	double mm=0.0, bb=0.0;
-	int i, kick;
+	int i;
 
 	//HACK "Correct" height according to XX speed
-	ClippedRamp xSpeedFactor = ClippedRamp(0.0, 1.0, 1.74, 0.5, 0.0, 1.0);
 	height *= xSpeedFactor.getValue(world->lowlevel.getVelX());
 
-	distance = distance + height / tan(teta); //for the ball to enter approx. height meters of the ground on the goal line
+	distance = distance + height / tanTeta; //for the ball to enter approx. height meters of the ground on the goal line
 
 	// for kicking purposes, directly use the odometry measured velocity
 	double vRobot_y;
@@ -254,27 +275,14 @@ int KickerConf::getPowerThroughParab(float distance, float height)
 
 	distance -= 0.27;	//0.27 is the robotCenter->ballCenter (following calcs are for the ball arc)
 
-	v0 = sqrt(distance * g / sin(2 * teta));
-	vkick = v0 - vRobot_y * cos(teta);
+	v0 = sqrt(distance * g / sin2Teta);
+	vkick = v0 - vRobot_y * cosTeta;
 
-	bool afterLast = true;
-	for(i = 1, kick = KICK_MIN; i < N_VALS; i++, kick += KICK_STEP)
-	{
-		if(vkick < vel.at(i))
-		{
-			mm = (vel.at(i)-vel.at(i-1)) / KICK_STEP;
-			bb = vel.at(i-1) - mm * kick;
-			afterLast = false;
+	for(i = 1; i < N_VALS; i++)		// i == N_VALS after the last level
+		if(vkick < vel[i])
 			break;
-		}
-	}
-	if(afterLast)
-	{
-		mm = (vel.at(vel.size()-1)-vel.at(vel.size()-2)) / KICK_STEP;
-		bb = vel.at(vel.size()-2) - mm * kick;
-	}
 
-	kickPower = (int)((vkick - bb) / mm);
+	kickPower = (int)((vkick - velOffset[i]) / velSlope[i]);
 
 #if false
 	printf("KICK_CALC dist=%5.3f / %5.3f, V0=%5.2f, vkick=%5.2f, vRobot=%5.3f (vX=%5.2f), KickPow=%d, justK:%d\n",
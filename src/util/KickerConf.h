@@ -42,17 +42,24 @@ public:
     KickerTable(){}
     void addEntry(int distance, int power);
     void delEntry(int distance);
+    void clear();               // remove every entry
     int size(); // number of entries in the table
     int getPower(int distance); // get the power from a certain distance
     void print(FILE* fout = stderr);
 
     std::vector<int> distances;
-    std::map<int,int> mapping;
+    std::map<int,int> mapping;  // change through addEntry/delEntry/clear only
 
 private:
+    void compile();             // rebuild powerByCm from the entries
+
     struct distSort {
       bool operator() (int i,int j) { return (i<j);}
     } _distSort;
+
+    /* getPower for every cm from distances.front() to distances.back(),
+     * the queries outside of it are clipped to the ends */
+    std::vector<int> powerByCm;
 };
 
 class KickerConf
@@ -78,6 +85,10 @@ private:
 
 	std::vector<double> vel;		/*!<Velocity setPoints of measured power levels*/
 	double angDeg;					/*!<Ball kick exit angle (mean of powers 25:50)*/
+	double tanTeta, sin2Teta, cosTeta;	/*!<Of the exit angle, computed on load*/
+	double velSlope[N_VALS+1];		/*!<Line power->velocity used below vel[i], [N_VALS] past the last level*/
+	double velOffset[N_VALS+1];
+	ClippedRamp xSpeedFactor;		/*!<Height correction by the robot front velocity*/
 	static double defaultHeight;	/*!<Height to which we want to kick (defined on config file and can be defined on the function call*/
 	double velRobotContribution;	/*!<Percentage of robot front velocity that contributes to ball exit velocity (default 0.5 on IRIS field)*/
 };
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Check of the compiled kicker tables against the old getPower path (copied
+// below as Legacy*), on the calibration of ../config:
+//   the table of every robot, every cm from before the first entry to past
+//   the last one, and KickerConf::getPower over the same range in meters
+//   tables after random additions and removals of entries
+//   tables emptied or rewritten by a second load
+//   getPowerThroughParab swept over distances and heights, with the robot
+//   standing, driving forward and backing off
+// Run it from bin/, as the agent
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "KickerConf.h"
+#include "ConfigXML.h"
+#include "MersenneTwister.h"
+#include "CheckReport.h"
+
+using namespace std;
+using namespace cambada;
+
+MTRand randomGenerator(2015);
+
+// The old table, a linear search and the line between the entries per query
+class LegacyKickerTable
+{
+public:
+	void addEntry(int distance, int power)
+	{
+		if (distance < 0)
+			return;
+		mapping[distance] = power;
+		if (find(distances.begin(), distances.end(), distance) == distances.end())
+			distances.push_back(distance);
+		sort(distances.begin(), distances.end());
+	}
+
+	void delEntry(int distance)
+	{
+		if (mapping.count(distance) > 0)
+		{
+			distances.erase(remove(distances.begin(), distances.end(), distance), distances.end());
+			mapping.erase(distance);
+		}
+	}
+
+	int size() { return distances.size(); }
+
+	int getPower(int distance)
+	{
+		if (size() == 0)
+			return 0;
+		if (size() == 1)
+			return mapping[distances.at(0)];
+		else if (find(distances.begin(), distances.end(), distance) != distances.end())
+			return mapping[distance];
+		else
+		{
+			if (distances.at(0) > distance)
+				return mapping[distances.at(0)];
+
+			int leftDistIdx = 0;
+			while (leftDistIdx < size()-1 && distances.at(leftDistIdx+1) < distance)
+				leftDistIdx++;
+
+			if (leftDistIdx == size()-1)
+				return mapping[distances.at(leftDistIdx)];
+
+			float d1 = (float)distances.at(leftDistIdx);
+			float d2 = (float)distances.at(leftDistIdx+1);
+			float dDist = d2 - d1;
+			float dPow = (float)mapping[d2] - (float)mapping[d1];
+
+			float m = dPow/dDist;
+			float b = (float)mapping[d1] - m*d1;
+
+			return (int)(m*distance + b);
+		}
+	}
+
+	std::vector<int> distances;
+	std::map<int,int> mapping;
+};
+
+// The old getPowerThroughParab, everything computed per call
+class LegacyParab
+{
+public:
+	bool load(char* file = (char*)"../config/kicker.map")
+	{
+		FILE *fp = fopen(file, "r");
+		char trash[100];
+
+		if (fp == NULL)
+			return false;
+
+		float velContribution, v[N_VALS], ang, height;
+		for (int i = 0; i < Whoami()-1; i++)
+			fgets(trash, 100, fp);
+		fscanf(fp, "%f %f %f %f %f %f %f %f %f %f %f", &velContribution, &v[0], &v[1], &v[2], &v[3],
+			&v[4], &v[5], &v[6], &v[7], &ang, &height);
+		fclose(fp);
+
+		vel.assign(v, v + N_VALS);
+		defaultHeight = height;
+		angDeg = ang;
+		velRobotContribution = velContribution;
+		return true;
+	}
+
+	int getPower(WorldState* world, float distance, float height)
+	{
+		double g = 9.8067;
+		double teta = (angDeg * M_PI) / 180.0;
+		double v0, vkick;
+		double mm = 0.0, bb = 0.0;
+		int i, kick;
+
+		ClippedRamp xSpeedFactor = ClippedRamp(0.0, 1.0, 1.74, 0.5, 0.0, 1.0);
+		height *= xSpeedFactor.getValue(world->lowlevel.getVelX());
+
+		distance = distance + height / tan(teta);
+
+		double vRobot_y = (world->lowlevel.getDY()/(MOTION_TICK/1000.0)) * velRobotContribution;
+		if (vRobot_y < 0.0)
+			vRobot_y *= 0.5;
+
+		distance -= 0.27;
+
+		v0 = sqrt(distance * g / sin(2 * teta));
+		vkick = v0 - vRobot_y * cos(teta);
+
+		bool afterLast = true;
+		for (i = 1, kick = KICK_MIN; i < N_VALS; i++, kick += KICK_STEP)
+		{
+			if (vkick < vel.at(i))
+			{
+				mm = (vel.at(i)-vel.at(i-1)) / KICK_STEP;
+				bb = vel.at(i-1) - mm * kick;
+				afterLast = false;
+				break;
+			}
+		}
+		if (afterLast)
+		{
+			mm = (vel.at(vel.size()-1)-vel.at(vel.size()-2)) / KICK_STEP;
+			bb = vel.at(vel.size()-2) - mm * kick;
+		}
+
+		return (int)((vkick - bb) / mm);
+	}
+
+	double defaultHeight;
+
+private:
+	std::vector<double> vel;
+	double angDeg;
+	double velRobotContribution;
+};
+
+static void copyTable(KickerTable* table, LegacyKickerTable& legacy)
+{
+	for (int e = 0; e < table->size(); e++)
+		legacy.addEntry(table->distances[e], table->mapping[table->distances[e]]);
+}
+
+static void checkTables(KickerConf& kicker)
+{
+	for (int agent = 1; agent <= 6; agent++)
+	{
+		kicker.setAgent(agent);
+		KickerTable* table = kicker.getTablePtr();
+		LegacyKickerTable legacy;
+		copyTable(table, legacy);
+
+		int last = table->size() > 0 ? table->distances.back() : 0;
+		for (int d = -100; d < last + 100; d++)
+		{
+			int a = table->getPower(d), b = legacy.getPower(d);
+			CHECK(a == b, "robot %d at %d cm: power %d, legacy %d", agent, d, a, b);
+		}
+
+		for (float m = -1.0; m < last / 100.0 + 1.0; m += 0.0037f)
+		{
+			int a = kicker.getPower(m), b = legacy.getPower((int)(floor(m*100.0 + 0.5)));
+			CHECK(a == b, "robot %d at %f m: power %d, legacy %d", agent, m, a, b);
+		}
+	}
+}
+
+static void checkEdits()
+{
+	KickerTable table;
+	LegacyKickerTable legacy;
+
+	CHECK(table.getPower(100) == legacy.getPower(100), "empty table: power differs");
+
+	for (int i = 0; i < 2000; i++)
+	{
+		if (randomGenerator.randInt(2) != 0 || table.size() == 0)
+		{
+			// a few collisions with the existing entries, and some negative ones
+			int d = (int)randomGenerator.randInt(1600) - 20, p = randomGenerator.randInt(100);
+			table.addEntry(d, p);
+			legacy.addEntry(d, p);
+		}
+		else
+		{
+			int d = table.distances[randomGenerator.randInt(table.size() - 1)];
+			table.delEntry(d);
+			legacy.delEntry(d);
+		}
+
+		CHECK(table.size() == legacy.size(), "edit %d: %d entries, legacy %d", i, table.size(), legacy.size());
+		for (int d = -10; d < 1620; d += 1 + randomGenerator.randInt(12))
+		{
+			int a = table.getPower(d), b = legacy.getPower(d);
+			CHECK(a == b, "edit %d at %d cm: power %d, legacy %d", i, d, a, b);
+		}
+	}
+}
+
+// A second load over the calibration: robot 1 with no entries, robot 2
+// with new ones, the others as they were
+static void checkReload(KickerConf& kicker)
+{
+	char file[] = "/tmp/kicker-conf-check.XXXXXX";
+	int fd = mkstemp(file);
+	FILE* fp = fd < 0 ? NULL : fdopen(fd, "w");
+	if (fp == NULL)
+	{
+		CHECK(false, "cannot write %s", file);
+		return;
+	}
+
+	LegacyKickerTable legacy[6];
+	for (int agent = 3; agent <= 6; agent++)
+	{
+		kicker.setAgent(agent);
+		copyTable(kicker.getTablePtr(), legacy[agent-1]);
+	}
+	legacy[1].addEntry(150, 30);
+	legacy[1].addEntry(400, 70);
+	fprintf(fp, "R1 0\nR2 2\n150 30\n400 70\n");
+	fclose(fp);
+
+	CHECK(kicker.load(file), "cannot load %s", file);
+	unlink(file);
+
+	for (int agent = 1; agent <= 6; agent++)
+	{
+		kicker.setAgent(agent);
+		KickerTable* table = kicker.getTablePtr();
+		CHECK(table->size() == legacy[agent-1].size(), "reloaded robot %d: %d entries, legacy %d",
+			agent, table->size(), legacy[agent-1].size());
+		for (int d = -100; d < 1700; d++)
+		{
+			int a = table->getPower(d), b = legacy[agent-1].getPower(d);
+			CHECK(a == b, "reloaded robot %d at %d cm: power %d, legacy %d", agent, d, a, b);
+		}
+	}
+}
+
+static void checkParab(KickerConf& kicker, WorldState& world)
+{
+	LegacyParab legacy;
+
+	if (!legacy.load())
+	{
+		CHECK(false, "kicker.map not found");
+		return;
+	}
+
+	// standing, driving forward and backing off, fast and slow
+	static const float dx[] = { 0.0, 0.01, 0.02, 0.04 };
+	static const float dy[] = { 0.0, 0.005, 0.02, -0.005, -0.02 };
+
+	for (unsigned int x = 0; x < sizeof(dx) / sizeof(dx[0]); x++)
+		for (unsigned int y = 0; y < sizeof(dy) / sizeof(dy[0]); y++)
+		{
+			world.lowlevel.realDx = dx[x];
+			world.lowlevel.realDy = dy[y];
+
+			for (float distance = 0.5; distance < 14.0; distance += 0.013f)
+			{
+				int a = kicker.getPowerThroughParab(distance);
+				int b = legacy.getPower(&world, distance, legacy.defaultHeight);
+				CHECK(a == b, "dx %g dy %g, %f m at the default height: power %d, legacy %d",
+					dx[x], dy[y], distance, a, b);
+
+				for (float height = 0.0; height <= 2.0; height += 0.05f)
+				{
+					a = kicker.getPowerThroughParab(distance, height);
+					b = legacy.getPower(&world, distance, height);
+					CHECK(a == b, "dx %g dy %g, %f m high %f: power %d, legacy %d",
+						dx[x], dy[y], distance, height, a, b);
+				}
+			}
+		}
+}
+
+int main()
+{
+	ConfigXML config;
+	if (!config.parse("../config/cambada.conf.xml"))
+	{
+		printf("FAIL: ../config/cambada.conf.xml not found, run it from bin/\n");
+		return 1;
+	}
+
+	WorldState world(&config);
+	KickerConf kicker(&world, 1);
+
+	checkTables(kicker);
+	checkEdits();
+	checkReload(kicker);
+	kicker.setAgent(1);
+	checkParab(kicker, world);
+
+	return checkReport("kicker tables");
+}
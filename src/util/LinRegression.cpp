@@ -49,7 +49,7 @@ cambada::util::LinRegression::~LinRegression()
 //	return xSamples.getNumSamples();
 //}
 
-void cambada::util::LinRegression::calculateParameters(std::deque<float> xSamples, std::deque<float> ySamples)
+void cambada::util::LinRegression::calculateParameters(const std::deque<float>& xSamples, const std::deque<float>& ySamples)
 {
 	assert(xSamples.size() == ySamples.size());
 	if(xSamples.size() < 2)
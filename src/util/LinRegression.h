@@ -25,6 +25,8 @@
 
 #include <deque>
 
+#include "RingBuffer.h"
+
 namespace cambada
 {
 
@@ -39,7 +41,15 @@ public:
 //	void addPair(Vec);
 //	Vec getPair(int index);
 //	unsigned int getNumPairs();
-	void calculateParameters(std::deque<float> xSamples, std::deque<float> ySamples);
+	void calculateParameters(const std::deque<float>& xSamples, const std::deque<float>& ySamples);
+
+	/* Same, for y[k] of a RegressionWindow, from its running sums */
+	template<unsigned int D, unsigned int N>
+	void calculateParameters(const RegressionWindow<D, N>& window, unsigned int k)
+	{
+		slope = window.slope(k);
+		origin = window.valueAt(k, 0.0);
+	}
 	float getSlope(void);
 	float getOrigin(void);
 	void reset();
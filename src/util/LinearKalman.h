@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LINEARKALMAN_H_
+#define LINEARKALMAN_H_
+
+#include <string.h>
+#include <math.h>
+
+namespace cambada
+{
+
+namespace util
+{
+
+/* Linear Kalman filter with N states and M measures, on fixed size arrays.
+ *
+ * The state has C columns that share the model and the covariance, as
+ * the x and y axes of the (position, velocity) trackers: they are
+ * filtered together at the cost of one.
+ *
+ *   predict:  x = F x + u,  P = F P F' + Q
+ *   update:   y = z - H x,  S = H P H' + R,  K = P H' inv(S)
+ *             x = x + K y,  P = (I - K H) P (I - K H)' + K R K'
+ *
+ * The covariance update is the Joseph form, which keeps P positive for
+ * any K. P and Q are symmetric, only their upper triangle is computed.
+ * The model matrices are public, set them before predict/update.
+ * By default F = I, Q = 0, H = [I 0], R = I, P = I.
+ *
+ * When the first M states are measured directly, H = [I 0], updateDirect()
+ * skips the products by H: K H only has its first M columns, and the Joseph
+ * form reduces to B + (K R - B1) K', with B = (I - K H) P = P - K P1 and
+ * P1, B1 the first M rows of P and columns of B. */
+template<unsigned int N, unsigned int M, unsigned int C = 1>
+class LinearKalman
+{
+public:
+	double x[N][C];		// state
+	double P[N][N];		// state covariance
+	double F[N][N];		// model
+	double Q[N][N];		// model noise
+	double H[M][N];		// measure
+	double R[M][M];		// measure noise
+
+	LinearKalman()
+	{
+		memset(x, 0, sizeof(x));
+		identity(P);
+		identity(F);
+		memset(Q, 0, sizeof(Q));
+		memset(H, 0, sizeof(H));
+		for (unsigned int i = 0; i < M && i < N; i++)
+			H[i][i] = 1.0;
+		identity(R);
+	}
+
+	template<unsigned int D>
+	static void identity(double (&A)[D][D])
+	{
+		memset(A, 0, sizeof(A));
+		for (unsigned int i = 0; i < D; i++)
+			A[i][i] = 1.0;
+	}
+
+	void predict()
+	{
+		double Fx[N][C];
+		mul(F, x, Fx);
+		memcpy(x, Fx, sizeof(x));
+		predictCovariance(P);
+	}
+
+	/* With P = F P0 F' + Q, from a covariance kept by the caller */
+	void predictFrom(const double (&P0)[N][N])
+	{
+		double Fx[N][C];
+		mul(F, x, Fx);
+		memcpy(x, Fx, sizeof(x));
+		predictCovariance(P0);
+	}
+
+	/* With a known state change (odometry) */
+	void predict(const double (&u)[N][C])
+	{
+		double Fx[N][C];
+		mul(F, x, Fx);
+		for (unsigned int i = 0; i < N; i++)
+			for (unsigned int c = 0; c < C; c++)
+				x[i][c] = Fx[i][c] + u[i][c];
+		predictCovariance(P);
+	}
+
+	/* Output: false if S is singular, nothing is changed then */
+	bool update(const double (&z)[M][C])
+	{
+		double Hx[M][C], y[M][C];
+		mul(H, x, Hx);
+		for (unsigned int i = 0; i < M; i++)
+			for (unsigned int c = 0; c < C; c++)
+				y[i][c] = z[i][c] - Hx[i][c];
+		return updateInnovation(y);
+	}
+
+	/* With the innovation y = z - H x already computed, as for angles
+	 * that have to be wrapped.
+	 * Output: false if S is singular, nothing is changed then */
+	bool updateInnovation(const double (&y)[M][C])
+	{
+		double PHt[N][M], S[M][M], Si[M][M], K[N][M];
+		unsigned int i, j, k;
+
+		// S = H P H' + R
+		for (i = 0; i < N; i++)
+			for (j = 0; j < M; j++)
+			{
+				PHt[i][j] = 0.0;
+				for (k = 0; k < N; k++)
+					PHt[i][j] += P[i][k] * H[j][k];
+			}
+		for (i = 0; i < M; i++)
+			for (j = 0; j < M; j++)
+			{
+				S[i][j] = R[i][j];
+				for (k = 0; k < N; k++)
+					S[i][j] += H[i][k] * PHt[k][j];
+			}
+
+		if (!invert(S, Si))
+			return false;
+
+		// K = P H' inv(S)
+		mul(PHt, Si, K);
+
+		// x = x + K y
+		double Ky[N][C];
+		mul(K, y, Ky);
+		for (i = 0; i < N; i++)
+			for (unsigned int c = 0; c < C; c++)
+				x[i][c] += Ky[i][c];
+
+		// P = (I - K H) P (I - K H)' + K R K'
+		double IKH[N][N], A[N][N], KR[N][M];
+		for (i = 0; i < N; i++)
+			for (j = 0; j < N; j++)
+			{
+				IKH[i][j] = (i == j) ? 1.0 : 0.0;
+				for (k = 0; k < M; k++)
+					IKH[i][j] -= K[i][k] * H[k][j];
+			}
+		mul(IKH, P, A);
+		mul(K, R, KR);
+		for (i = 0; i < N; i++)
+			for (j = i; j < N; j++)
+			{
+				double v = 0.0;
+				for (k = 0; k < N; k++)
+					v += A[i][k] * IKH[j][k];
+				for (k = 0; k < M; k++)
+					v += KR[i][k] * K[j][k];
+				P[i][j] = P[j][i] = v;
+			}
+
+		return true;
+	}
+
+	/* update() for H = [I 0], H is not read */
+	bool updateDirect(const double (&z)[M][C])
+	{
+		double y[M][C];
+		for (unsigned int i = 0; i < M; i++)
+			for (unsigned int c = 0; c < C; c++)
+				y[i][c] = z[i][c] - x[i][c];
+		return updateDirectInnovation(y);
+	}
+
+	/* updateInnovation() for H = [I 0], H is not read */
+	bool updateDirectInnovation(const double (&y)[M][C])
+	{
+		double S[M][M], Si[M][M], K[N][M], B[N][N];
+		unsigned int i, j, k;
+
+		// S = P11 + R, P11 the measured block of P
+		for (i = 0; i < M; i++)
+			for (j = 0; j < M; j++)
+				S[i][j] = P[i][j] + R[i][j];
+
+		if (!invert(S, Si))
+			return false;
+
+		// K = P H' inv(S), P H' being the first M columns of P
+		for (i = 0; i < N; i++)
+			for (j = 0; j < M; j++)
+			{
+				double v = 0.0;
+				for (k = 0; k < M; k++)
+					v += P[i][k] * Si[k][j];
+				K[i][j] = v;
+			}
+
+		// x = x + K y
+		for (i = 0; i < N; i++)
+			for (unsigned int c = 0; c < C; c++)
+			{
+				double v = x[i][c];
+				for (k = 0; k < M; k++)
+					v += K[i][k] * y[k][c];
+				x[i][c] = v;
+			}
+
+		// B = (I - K H) P = P - K P1, P1 the first M rows of P
+		for (i = 0; i < N; i++)
+			for (j = 0; j < N; j++)
+			{
+				double v = P[i][j];
+				for (k = 0; k < M; k++)
+					v -= K[i][k] * P[k][j];
+				B[i][j] = v;
+			}
+
+		// P = B (I - K H)' + K R K' = B + (K R - B1) K', B1 the first M columns of B
+		double KRB[N][M];
+		for (i = 0; i < N; i++)
+			for (j = 0; j < M; j++)
+			{
+				double v = -B[i][j];
+				for (k = 0; k < M; k++)
+					v += K[i][k] * R[k][j];
+				KRB[i][j] = v;
+			}
+		for (i = 0; i < N; i++)
+			for (j = i; j < N; j++)
+			{
+				double v = B[i][j];
+				for (k = 0; k < M; k++)
+					v += KRB[i][k] * K[j][k];
+				P[i][j] = P[j][i] = v;
+			}
+
+		return true;
+	}
+
+private:
+	void predictCovariance(const double (&P0)[N][N])
+	{
+		double FP[N][N];
+		unsigned int i, j, k;
+
+		mul(F, P0, FP);
+		for (i = 0; i < N; i++)
+			for (j = i; j < N; j++)
+			{
+				double v = Q[i][j];
+				for (k = 0; k < N; k++)
+					v += FP[i][k] * F[j][k];
+				P[i][j] = P[j][i] = v;
+			}
+	}
+
+	// C = A B, the sizes fixed so that the loops unroll
+	template<unsigned int I, unsigned int J, unsigned int K>
+	static void mul(const double (&A)[I][J], const double (&B)[J][K], double (&AB)[I][K])
+	{
+		for (unsigned int i = 0; i < I; i++)
+			for (unsigned int k = 0; k < K; k++)
+			{
+				double v = 0.0;
+				for (unsigned int j = 0; j < J; j++)
+					v += A[i][j] * B[j][k];
+				AB[i][k] = v;
+			}
+	}
+
+	// Gauss-Jordan with partial pivoting, M is small
+	static bool invert(const double (&S)[M][M], double (&Si)[M][M])
+	{
+		double A[M][M];
+		unsigned int i, j, k, p;
+
+		if (M == 1)
+		{
+			if (S[0][0] == 0.0)
+				return false;
+			Si[0][0] = 1.0 / S[0][0];
+			return true;
+		}
+
+		memcpy(A, S, sizeof(A));
+		identity(Si);
+		for (i = 0; i < M; i++)
+		{
+			p = i;
+			for (j = i + 1; j < M; j++)
+				if (fabs(A[j][i]) > fabs(A[p][i]))
+					p = j;
+			if (A[p][i] == 0.0)
+				return false;
+			if (p != i)
+				for (k = 0; k < M; k++)
+				{
+					double t = A[i][k]; A[i][k] = A[p][k]; A[p][k] = t;
+					t = Si[i][k]; Si[i][k] = Si[p][k]; Si[p][k] = t;
+				}
+			double d = 1.0 / A[i][i];
+			for (k = 0; k < M; k++)
+			{
+				A[i][k] *= d;
+				Si[i][k] *= d;
+			}
+			for (j = 0; j < M; j++)
+				if (j != i && A[j][i] != 0.0)
+				{
+					double f = A[j][i];
+					for (k = 0; k < M; k++)
+					{
+						A[j][k] -= f * A[i][k];
+						Si[j][k] -= f * Si[i][k];
+					}
+				}
+		}
+		return true;
+	}
+};
+
+}  // namespace util
+
+}  // namespace cambada
+
+#endif /* LINEARKALMAN_H_ */
@@ -0,0 +1,663 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Check of the running sum windows against the implementations they replaced:
+//   SlidingWindow sum and mean, through wraparound, resets and setSample
+//   LinRegression slope and origin, from deques and from a RegressionWindow
+//   EgoMotionEstimator velocities on straight lines and arcs
+//   VelocityRegression velocities and origin
+// Every window is checked while partly filled and after it wrapped around.
+// The old fits summed in float, so old and new are both compared with an
+// exact long double fit of the same samples: the new result must be close
+// to it and never further from it than the old one.
+// The time comes from the Clock below, stepped by the test.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#include <deque>
+
+#include "Clock.h"
+#include "SlidingWindow.h"
+#include "LinRegression.h"
+#include "EgoMotionEstimator.h"
+#include "VelocityRegression.h"
+
+#include "MersenneTwister.h"
+#include "CheckReport.h"
+
+using namespace cambada;
+using namespace cambada::geom;
+
+MTRand randomGenerator(2015);
+
+/* Timer reads this clock, in ms */
+static float clockNow = 0.0f;
+
+util::Clock::Clock() {}
+util::Clock::~Clock() {}
+float util::Clock::now() { return clockNow; }
+
+/* Relative difference, absolute below 1 */
+static bool near(double a, double b, double tolerance)
+{
+	return fabs(a - b) <= tolerance * (fabs(b) > 1.0 ? fabs(b) : 1.0);
+}
+
+/* Distance of a from the exact value, scaled as in near() */
+static double error(double a, long double exact)
+{
+	if (!finite(a))
+		return HUGE_VAL;
+	return fabs(a - exact) / (fabsl(exact) > 1.0 ? fabsl(exact) : 1.0);
+}
+
+/* a is finite and not further from the exact value than the old result, within tolerance */
+static bool noWorse(double a, double legacy, long double exact, double tolerance)
+{
+	return finite(a) && error(a, exact) <= error(legacy, exact) + tolerance;
+}
+
+struct Fit
+{
+	long double slope, origin;
+};
+
+/* Least squares fit of y against x in long double */
+static Fit exactFit(const std::deque<float>& xs, const std::deque<float>& ys)
+{
+	Fit fit = { 0.0, 0.0 };
+	long double n = xs.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+
+	if (xs.size() < 2)
+		return fit;
+
+	for (unsigned int i = 0; i < xs.size(); i++)
+	{
+		sx += xs[i];
+		sy += ys[i];
+		sxx += (long double)xs[i] * xs[i];
+		sxy += (long double)xs[i] * ys[i];
+	}
+
+	fit.slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+	fit.origin = (sy - fit.slope * sx) / n;
+	return fit;
+}
+
+/* The previous SlidingWindow: a deque summed on every call */
+class LegacySlidingWindow
+{
+public:
+	LegacySlidingWindow(unsigned int n) : maxSamples(n) {}
+
+	void addValue(float v)
+	{
+		samples.push_back(v);
+		if (samples.size() > maxSamples)
+			samples.pop_front();
+	}
+
+	void resetSamples(unsigned int n)
+	{
+		if (samples.size() > n)
+			samples.erase(samples.begin(), samples.begin() + samples.size() - n);
+	}
+
+	float sum()
+	{
+		float sum = 0.0f;
+		for (unsigned int i = 0; i < samples.size(); ++i)
+			sum += samples[i];
+		return sum;
+	}
+
+	float mean() { return sum() / samples.size(); }
+	void setSample(unsigned int index, float v) { samples[index] = v; }
+	void clear() { samples.clear(); }
+
+	const unsigned int maxSamples;
+	std::deque<float> samples;
+};
+
+/* The previous LinRegression: fit of two deques */
+class LegacyLinRegression
+{
+public:
+	LegacyLinRegression() : slope(0), origin(0) {}
+
+	void calculateParameters(const std::deque<float>& xSamples, const std::deque<float>& ySamples)
+	{
+		if (xSamples.size() < 2)
+		{
+			slope = 0.0f;
+			origin = 0.0f;
+			return;
+		}
+
+		float M = xSamples.size();
+		float sumY = 0.0f, sumX = 0.0f, sumXY = 0.0f, sumXX = 0.0f;
+
+		for (int i = 0; i < M; ++i)
+		{
+			float x = xSamples[i];
+			float y = ySamples[i];
+			sumX += x;
+			sumY += y;
+			sumXY += x*y;
+			sumXX += x*x;
+		}
+
+		slope = (M*sumXY - sumX*sumY)/(M*sumXX - sumX*sumX);
+		origin = (1/M) * sumY - (slope/M) * sumX;
+	}
+
+	void reset() { slope = origin = 0.0f; }
+
+	float slope, origin;
+};
+
+/* The previous EgoMotionEstimator: four sliding windows refitted on every update */
+class LegacyEgoMotionEstimator
+{
+public:
+	LegacyEgoMotionEstimator(int nSamples)
+		: xWindow(nSamples), yWindow(nSamples), thetaWindow(nSamples), timeWindow(nSamples), angVel(0.0f) {}
+
+	void update()
+	{
+		thetaLinReg.calculateParameters(timeWindow.samples, thetaWindow.samples);
+		if(thetaLinReg.slope < 10e-3) //straight line
+		{
+			angVel = 0.0f;
+			xLinReg.calculateParameters(timeWindow.samples, xWindow.samples);
+			yLinReg.calculateParameters(timeWindow.samples, yWindow.samples);
+			linVel.x = xLinReg.slope;
+			linVel.y = yLinReg.slope;
+			return;
+		}
+
+		angVel = thetaLinReg.slope;
+
+		float n = (float) timeWindow.samples.size();
+		float sumX = 0.0f, sumY = 0.0f, sumS = 0.0f, sumC = 0.0f, sumSS = 0.0f;
+		float sumCC = 0.0f, sumSX = 0.0f, sumCX = 0.0f, sumSY = 0.0f, sumCY = 0.0f;
+		float timeRef = timeWindow.samples[n-1];
+
+		for (unsigned int i = 0; i < timeWindow.samples.size(); ++i)
+		{
+			float t = timeWindow.samples[i] - timeRef;
+			float x = xWindow.samples[i];
+			float y = yWindow.samples[i];
+			sumX += x;
+			sumY += y;
+			float s = sin(angVel*t);
+			float c = (cos(angVel*t)-1);
+			sumS += s;
+			sumC += c;
+			sumSS += s*s;
+			sumCC += c*c;
+			sumSX += s*x;
+			sumCX += c*x;
+			sumSY += s*y;
+			sumCY += c*y;
+		}
+		sumS /= angVel;
+		sumC /= angVel;
+		sumSS /= (angVel*angVel);
+		sumCC /= (angVel*angVel);
+		sumSX /= angVel;
+		sumCX /= angVel;
+		sumSY /= angVel;
+		sumCY /= angVel;
+
+		float d = n*(sumSS+sumCC) - sumS*sumS - sumC*sumC;
+		if(d < 10e-2)
+		{
+			linVel.x = 0.0f;
+			linVel.y = 0.0f;
+		}
+		else
+		{
+			linVel.x = (-sumS*sumX + sumC*sumY + n*(sumSX -sumCY))/d;
+			linVel.y = (-sumC*sumX - sumS*sumY + n*(sumCX + sumSY))/d;
+		}
+	}
+
+	void addValue(float x, float y, float theta)
+	{
+		xWindow.addValue(x);
+		yWindow.addValue(y);
+
+		//deal with angle discontinuity by angle unrolling
+		if(thetaWindow.samples.size() > 1)
+		{
+			float lastTheta = thetaWindow.samples.back();
+			float diffTheta;
+			while(fabs(diffTheta = (theta - lastTheta)) > M_PI)
+			{
+				float sign = (diffTheta >= 0) ? 1.0f : -1.0f;
+				theta -= sign * 2*M_PI;
+			}
+		}
+		thetaWindow.addValue(theta);
+
+		timeWindow.addValue(timer.elapsed()/1000.0f); //in seconds
+	}
+
+	void reset()
+	{
+		xWindow.clear();
+		yWindow.clear();
+		thetaWindow.clear();
+		timeWindow.clear();
+		xLinReg.reset();
+		yLinReg.reset();
+		thetaLinReg.reset();
+		timer.restart();
+	}
+
+	LegacyLinRegression xLinReg, yLinReg, thetaLinReg;
+	LegacySlidingWindow xWindow, yWindow, thetaWindow, timeWindow;
+	util::Timer timer;
+	Vec linVel;
+	float angVel;
+};
+
+/* EgoMotionEstimator::update() in long double, on the samples of the old estimator */
+static void exactEgoMotion(const LegacyEgoMotionEstimator& legacy, long double& angVel, long double& vx, long double& vy)
+{
+	const std::deque<float>& ts = legacy.timeWindow.samples;
+	const std::deque<float>& xs = legacy.xWindow.samples;
+	const std::deque<float>& ys = legacy.yWindow.samples;
+
+	angVel = exactFit(ts, legacy.thetaWindow.samples).slope;
+	if (angVel < 10e-3)
+	{
+		angVel = 0.0;
+		vx = exactFit(ts, xs).slope;
+		vy = exactFit(ts, ys).slope;
+		return;
+	}
+
+	long double n = ts.size(), sumX = 0, sumY = 0, sumS = 0, sumC = 0, sumSS = 0;
+	long double sumCC = 0, sumSX = 0, sumCX = 0, sumSY = 0, sumCY = 0;
+
+	for (unsigned int i = 0; i < ts.size(); i++)
+	{
+		long double t = (long double)ts[i] - ts.back();
+		long double s = sinl(angVel * t) / angVel;
+		long double c = (cosl(angVel * t) - 1) / angVel;
+		sumX += xs[i];
+		sumY += ys[i];
+		sumS += s;
+		sumC += c;
+		sumSS += s * s;
+		sumCC += c * c;
+		sumSX += s * xs[i];
+		sumCX += c * xs[i];
+		sumSY += s * ys[i];
+		sumCY += c * ys[i];
+	}
+
+	long double d = n * (sumSS + sumCC) - sumS * sumS - sumC * sumC;
+	if (d < 10e-2)
+	{
+		vx = vy = 0.0;
+		return;
+	}
+	vx = (-sumS * sumX + sumC * sumY + n * (sumSX - sumCY)) / d;
+	vy = (-sumC * sumX - sumS * sumY + n * (sumCX + sumSY)) / d;
+}
+
+/* The previous VelocityRegression: the buffers summed on every call */
+class LegacyVelocityRegression
+{
+public:
+	LegacyVelocityRegression(unsigned int maxSize) : MAXSIZE(maxSize) {}
+
+	void putNewValues(Vec pos, float ori, struct timeval instantIn)
+	{
+		instant = instantIn;
+		posBuffer.push_back(pos);
+		oriBuffer.push_back(ori);
+		timeBuffer.push_back(instantIn);
+		if (posBuffer.size() > MAXSIZE)
+		{
+			posBuffer.pop_front();
+			oriBuffer.pop_front();
+			timeBuffer.pop_front();
+		}
+	}
+
+	double tau(unsigned int i)
+	{
+		return -(instant.tv_sec*1000 + instant.tv_usec/1000)
+			+ (timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
+	}
+
+	Vec getLinearVelocity()
+	{
+		if (posBuffer.size()<2)
+			return Vec(0,0);
+
+		double sum_ts = 0.0, sum_ts2 = 0.0;
+		Vec sum_pos(0,0), sum_ts_pos(0,0);
+
+		for (unsigned int i = 0; i < posBuffer.size(); i++)
+		{
+			double t = tau(i);
+			sum_pos += posBuffer[i];
+			sum_ts += t;
+			sum_ts2 += t*t;
+			sum_ts_pos += t*posBuffer[i];
+		}
+
+		double det = (double)posBuffer.size() * sum_ts2 - sum_ts * sum_ts;
+		if (fabs(det) < 1e-5)
+			return Vec::zero_vector;
+		return (-sum_ts*sum_pos + (double)posBuffer.size()*sum_ts_pos) / det;
+	}
+
+	float getAngularVelocity()
+	{
+		if (oriBuffer.size()<2)
+			return 0.0;
+
+		double sum_ts = 0.0, sum_ts2 = 0.0, sum_pos = 0.0, sum_ts_pos = 0.0;
+
+		for (unsigned int i = 0; i < oriBuffer.size(); i++)
+		{
+			double t = tau(i);
+			sum_pos += oriBuffer[i];
+			sum_ts += t;
+			sum_ts2 += t*t;
+			sum_ts_pos += t*oriBuffer[i];
+		}
+
+		double det = (double)oriBuffer.size() * sum_ts2 - sum_ts * sum_ts;
+		if (fabs(det) < 1e-5)
+			return 0.0;
+		return (-sum_ts*sum_pos + (double)oriBuffer.size()*sum_ts_pos) / det;
+	}
+
+	Vec getPointInOrig()
+	{
+		double sum_ts = 0.0, sum_ts2 = 0.0;
+		Vec sum_pos(0,0), sum_ts_pos(0,0);
+
+		for (unsigned int i = 0; i < posBuffer.size(); i++)
+		{
+			double t = tau(i);
+			sum_pos += posBuffer[i];
+			sum_ts += t;
+			sum_ts2 += t*t;
+			sum_ts_pos += t*posBuffer[i];
+		}
+
+		double det = (double)posBuffer.size() * sum_ts2 - sum_ts * sum_ts;
+		if (fabs(det) < 1e-5)
+			return Vec::zero_vector;
+		return (sum_ts2 * sum_pos - sum_ts_pos * sum_ts) / det;
+	}
+
+	unsigned int MAXSIZE;
+	struct timeval instant;
+	std::deque<Vec> posBuffer;
+	std::deque<float> oriBuffer;
+	std::deque<struct timeval> timeBuffer;
+};
+
+static void checkSlidingWindow()
+{
+	for (int run = 0; run < 200; run++)
+	{
+		unsigned int n = 2 + randomGenerator.randInt(SLIDING_WINDOW_CAPACITY - 2);
+		util::SlidingWindow window(n);
+		LegacySlidingWindow legacy(n);
+
+		for (int i = 0; i < 2000; i++)
+		{
+			float v = randomGenerator.randNorm(5, 3);
+			window.addValue(v);
+			legacy.addValue(v);
+
+			if (randomGenerator.randInt(100) == 0)
+			{
+				unsigned int k = randomGenerator.randInt(n - 1);
+				window.resetSamples(k);
+				legacy.resetSamples(k);
+			}
+			if (randomGenerator.randInt(50) == 0 && !legacy.samples.empty())
+			{
+				unsigned int k = randomGenerator.randInt(legacy.samples.size() - 1);
+				window.setSample(k, v * 2);
+				legacy.setSample(k, v * 2);
+			}
+
+			CHECK(window.getNumSamples() == legacy.samples.size(),
+				"window %u, sample %d: %u samples, legacy %u", n, i,
+				window.getNumSamples(), (unsigned int)legacy.samples.size());
+			CHECK(near(window.sum(), legacy.sum(), 1e-5),
+				"window %u, sample %d: sum %.9g, legacy %.9g", n, i, window.sum(), legacy.sum());
+			if (!legacy.samples.empty())
+				CHECK(near(window.mean(), legacy.mean(), 1e-5),
+					"window %u, sample %d: mean %.9g, legacy %.9g", n, i, window.mean(), legacy.mean());
+		}
+	}
+}
+
+static void checkLinRegression()
+{
+	for (int run = 0; run < 200; run++)
+	{
+		unsigned int n = 1 + randomGenerator.randInt(31);
+		util::RegressionWindow<1, 32> window(n);
+		std::deque<float> xs, ys;
+		float slope = randomGenerator.randNorm(0, 2);
+		float t = randomGenerator.rand(1);	// seconds since a reset, as the estimators use it
+
+		for (int i = 0; i < 200; i++)
+		{
+			t += 0.03 + randomGenerator.rand(0.01);
+			double y = (float)(10 + slope * t + randomGenerator.randNorm(0, 0.05));
+			window.push(t, &y);
+			xs.push_back(t);
+			ys.push_back(y);
+			if (xs.size() > n)
+			{
+				xs.pop_front();
+				ys.pop_front();
+			}
+
+			util::LinRegression fromDeques, fromWindow;
+			LegacyLinRegression legacy;
+			fromDeques.calculateParameters(xs, ys);
+			fromWindow.calculateParameters(window, 0);
+			legacy.calculateParameters(xs, ys);
+
+			Fit exact = exactFit(xs, ys);
+
+			CHECK(fromDeques.getSlope() == legacy.slope && fromDeques.getOrigin() == legacy.origin,
+				"run %d, sample %d: deque fit changed", run, i);
+			CHECK(error(fromWindow.getSlope(), exact.slope) < 1e-5 && error(fromWindow.getOrigin(), exact.origin) < 1e-5,
+				"run %d, sample %d: fit (%.9g, %.9g), exact (%.9Lg, %.9Lg)", run, i,
+				fromWindow.getSlope(), fromWindow.getOrigin(), exact.slope, exact.origin);
+			CHECK(noWorse(fromWindow.getSlope(), legacy.slope, exact.slope, 1e-6),
+				"run %d, sample %d: slope %.9g, legacy %.9g, exact %.9Lg", run, i,
+				fromWindow.getSlope(), legacy.slope, exact.slope);
+			CHECK(noWorse(fromWindow.getOrigin(), legacy.origin, exact.origin, 1e-6),
+				"run %d, sample %d: origin %.9g, legacy %.9g, exact %.9Lg", run, i,
+				fromWindow.getOrigin(), legacy.origin, exact.origin);
+		}
+	}
+}
+
+static void checkEgoMotion()
+{
+	for (int run = 0; run < 200; run++)
+	{
+		clockNow = 0.0f;
+		int n = 2 + randomGenerator.randInt(EGOMOTION_MAX_SAMPLES - 2);
+		util::EgoMotionEstimator estimator(n);
+		LegacyEgoMotionEstimator legacy(n);
+
+		// straight lines on even runs, arcs on odd ones
+		float x = 0, y = 0, theta = randomGenerator.rand(6);
+		float vx = randomGenerator.randNorm(0, 1), vy = randomGenerator.randNorm(0, 1);
+		float w = (run & 1) ? randomGenerator.randNorm(0, 2) : 0;
+
+		for (int i = 0; i < 3000; i++)
+		{
+			clockNow += 30 + randomGenerator.randInt(10);
+			x += vx * 0.035;
+			y += vy * 0.035;
+			theta += w * 0.035;
+
+			float wrapped = fmod(theta + 100 * M_PI, 2 * M_PI);
+			float nx = x + randomGenerator.randNorm(0, 0.01);
+			float ny = y + randomGenerator.randNorm(0, 0.01);
+
+			estimator.addValue(nx, ny, wrapped);
+			legacy.addValue(nx, ny, wrapped);
+			estimator.update();
+			legacy.update();
+
+			long double angVel, vx, vy;
+			exactEgoMotion(legacy, angVel, vx, vy);
+			Vec v = estimator.getLinearVelocity();
+
+			CHECK(noWorse(estimator.getAngularVelocity(), legacy.angVel, angVel, 1e-4),
+				"run %d, sample %d: angular velocity %.9g, legacy %.9g, exact %.9Lg",
+				run, i, estimator.getAngularVelocity(), legacy.angVel, angVel);
+			// the arc fit still sums in float, as it did
+			CHECK(noWorse(v.x, legacy.linVel.x, vx, 1e-3)
+				&& noWorse(v.y, legacy.linVel.y, vy, 1e-3),
+				"run %d, sample %d: velocity (%.9g, %.9g), legacy (%.9g, %.9g), exact (%.9Lg, %.9Lg)",
+				run, i, v.x, v.y, legacy.linVel.x, legacy.linVel.y, vx, vy);
+
+			if (randomGenerator.randInt(500) == 0)
+			{
+				estimator.reset();
+				legacy.reset();
+			}
+		}
+	}
+}
+
+static void checkVelocityRegression()
+{
+	for (int run = 0; run < 200; run++)
+	{
+		unsigned int size = 3 + randomGenerator.randInt(VELOCITY_REGRESSION_MAX_SIZE - 3);
+		util::VelocityRegression regression(size);
+		LegacyVelocityRegression legacy(size);
+		std::deque<long double> ts, xs, ys, os;
+
+		struct timeval tv;
+		tv.tv_sec = 1400000000 + randomGenerator.randInt(1000);
+		tv.tv_usec = 0;
+		float x = 0, y = 0;
+		float vx = randomGenerator.randNorm(0, 1), vy = randomGenerator.randNorm(0, 1);
+
+		for (int i = 0; i < 3000; i++)
+		{
+			tv.tv_usec += 30000 + randomGenerator.randInt(10000);
+			if (tv.tv_usec >= 1000000)
+			{
+				tv.tv_sec++;
+				tv.tv_usec -= 1000000;
+			}
+			x += vx * 0.035;
+			y += vy * 0.035;
+
+			Vec p(x * 1000 + randomGenerator.randNorm(0, 10), y * 1000 + randomGenerator.randNorm(0, 10));
+			float o = randomGenerator.rand(6);
+			regression.putNewValues(p, o, tv);
+			legacy.putNewValues(p, o, tv);
+
+			ts.push_back(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+			xs.push_back(p.x);
+			ys.push_back(p.y);
+			os.push_back(o);
+			if (ts.size() > size)
+			{
+				ts.pop_front();
+				xs.pop_front();
+				ys.pop_front();
+				os.pop_front();
+			}
+
+			if (ts.size() < 2)
+				continue;
+
+			// exact fit, times relative to the newest sample as in the old code
+			long double st = 0, stt = 0, sx = 0, sy = 0, so = 0, stx = 0, sty = 0, sto = 0;
+			long double nn = ts.size();
+			for (unsigned int j = 0; j < ts.size(); j++)
+			{
+				long double t = ts[j] - ts.back();
+				st += t;
+				stt += t * t;
+				sx += xs[j];
+				sy += ys[j];
+				so += os[j];
+				stx += t * xs[j];
+				sty += t * ys[j];
+				sto += t * os[j];
+			}
+			long double det = nn * stt - st * st;
+
+			Vec v = regression.getLinearVelocity();
+			Vec origin = regression.getPointInOrig();
+			float w = regression.getAngularVelocity();
+
+			CHECK(near(v.x, (nn * stx - st * sx) / det, 1e-5) && near(v.y, (nn * sty - st * sy) / det, 1e-5),
+				"run %d, sample %d: velocity off the exact fit", run, i);
+			CHECK(near(w, (nn * sto - st * so) / det, 1e-5),
+				"run %d, sample %d: angular velocity off the exact fit", run, i);
+			CHECK(near(origin.x, (stt * sx - stx * st) / det, 1e-5) && near(origin.y, (stt * sy - sty * st) / det, 1e-5),
+				"run %d, sample %d: origin off the exact fit", run, i);
+
+			// the old code summed the positions in float, off by up to ~0.2%
+			Vec lv = legacy.getLinearVelocity();
+			Vec lo = legacy.getPointInOrig();
+			CHECK(near(v.x, lv.x, 1e-2) && near(v.y, lv.y, 1e-2),
+				"run %d, sample %d: velocity (%.9g, %.9g), legacy (%.9g, %.9g)", run, i, v.x, v.y, lv.x, lv.y);
+			CHECK(near(w, legacy.getAngularVelocity(), 1e-4),
+				"run %d, sample %d: angular velocity %.9g, legacy %.9g", run, i, w, legacy.getAngularVelocity());
+			CHECK(near(origin.x, lo.x, 1e-4) && near(origin.y, lo.y, 1e-4),
+				"run %d, sample %d: origin (%.9g, %.9g), legacy (%.9g, %.9g)", run, i, origin.x, origin.y, lo.x, lo.y);
+		}
+	}
+}
+
+int main()
+{
+	checkSlidingWindow();
+	checkLinRegression();
+	checkEgoMotion();
+	checkVelocityRegression();
+
+	return checkReport("regression windows");
+}
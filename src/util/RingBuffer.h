@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <cassert>
+
+namespace cambada
+{
+
+namespace util
+{
+
+/* Fixed capacity FIFO in a plain array: pushing on a full buffer drops the
+ * oldest sample. Index 0 is the oldest sample, size()-1 the newest. */
+template<typename T, unsigned int N>
+class RingBuffer
+{
+public:
+	RingBuffer() : first(0), count(0) {}
+
+	static unsigned int capacity() { return N; }
+	unsigned int size() const { return count; }
+	bool empty() const { return count == 0; }
+	bool full() const { return count == N; }
+
+	T& operator[](unsigned int index) { assert(index < count); return samples[(first + index) % N]; }
+	const T& operator[](unsigned int index) const { assert(index < count); return samples[(first + index) % N]; }
+	T& front() { return (*this)[0]; }
+	T& back() { return (*this)[count - 1]; }
+
+	void push_back(const T& v)
+	{
+		if (count == N)
+		{
+			samples[first] = v;
+			first = (first + 1) % N;
+		}
+		else
+		{
+			samples[(first + count) % N] = v;
+			count++;
+		}
+	}
+
+	void pop_front()
+	{
+		assert(count > 0);
+		first = (first + 1) % N;
+		count--;
+	}
+
+	/* Drop the oldest samples, keeping the last n */
+	void keepLast(unsigned int n)
+	{
+		if (count > n)
+		{
+			first = (first + count - n) % N;
+			count = n;
+		}
+	}
+
+	void clear() { first = count = 0; }
+
+private:
+	T samples[N];
+	unsigned int first, count;
+};
+
+/* Sliding window of samples (x, y[0..D-1]) with the least squares sums of
+ * each y against x kept up to date as samples come and go, so that
+ * slope() and valueAt() are O(1).
+ *
+ * The sums are of x - origin, origin being an x of the window, and are
+ * recomputed from the samples every N updates, which bounds the rounding
+ * left by the additions and subtractions. */
+template<unsigned int D, unsigned int N>
+class RegressionWindow
+{
+public:
+	RegressionWindow(unsigned int maxSamples = N) : limit(maxSamples)
+	{
+		assert(maxSamples > 0 && maxSamples <= N);
+		clear();
+	}
+
+	unsigned int size() const { return xs.size(); }
+	unsigned int getMaxSamples() const { return limit; }
+	double x(unsigned int index) const { return xs[index]; }
+	double y(unsigned int index, unsigned int k) const { return ys[index].v[k]; }
+
+	void push(double x, const double* y)
+	{
+		if (xs.size() == limit)
+			removeOldest();
+
+		if (xs.empty())
+			origin = x;
+
+		Sample s;
+		double dx = x - origin;
+		sx += dx;
+		sxx += dx * dx;
+		for (unsigned int k = 0; k < D; k++)
+		{
+			s.v[k] = y[k];
+			sy[k] += y[k];
+			sxy[k] += dx * y[k];
+		}
+		xs.push_back(x);
+		ys.push_back(s);
+
+		if (++updates >= N)
+			refresh();
+	}
+
+	/* Change y[k] of one sample */
+	void setY(unsigned int index, unsigned int k, double v)
+	{
+		double delta = v - ys[index].v[k];
+		ys[index].v[k] = v;
+		sy[k] += delta;
+		sxy[k] += (xs[index] - origin) * delta;
+	}
+
+	/* Add delta to y[k] of all the samples */
+	void shiftY(unsigned int k, double delta)
+	{
+		for (unsigned int i = 0; i < ys.size(); i++)
+			ys[i].v[k] += delta;
+		sy[k] += xs.size() * delta;
+		sxy[k] += sx * delta;
+	}
+
+	void keepLast(unsigned int n)
+	{
+		while (xs.size() > n)
+			removeOldest();
+	}
+
+	void clear()
+	{
+		xs.clear();
+		ys.clear();
+		origin = 0.0;
+		reset();
+	}
+
+	/* n * sum(x^2) - sum(x)^2: 0 when all the x are the same */
+	double det() const
+	{
+		return xs.size() * sxx - sx * sx;
+	}
+
+	/* Least squares slope of y[k], 0 with less than two samples */
+	double slope(unsigned int k) const
+	{
+		if (xs.size() < 2)
+			return 0.0;
+		return (xs.size() * sxy[k] - sx * sy[k]) / det();
+	}
+
+	/* Value of the fitted line of y[k] at x */
+	double valueAt(unsigned int k, double x) const
+	{
+		if (xs.size() < 2)
+			return 0.0;
+		double b = slope(k);
+		return (sy[k] - b * sx) / xs.size() + b * (x - origin);
+	}
+
+	double mean(unsigned int k) const { return sy[k] / xs.size(); }
+
+private:
+	struct Sample { double v[D]; };
+
+	void removeOldest()
+	{
+		double dx = xs[0] - origin;
+		sx -= dx;
+		sxx -= dx * dx;
+		for (unsigned int k = 0; k < D; k++)
+		{
+			sy[k] -= ys[0].v[k];
+			sxy[k] -= dx * ys[0].v[k];
+		}
+		xs.pop_front();
+		ys.pop_front();
+	}
+
+	void reset()
+	{
+		sx = sxx = 0.0;
+		for (unsigned int k = 0; k < D; k++)
+			sy[k] = sxy[k] = 0.0;
+		updates = 0;
+	}
+
+	void refresh()
+	{
+		reset();
+		origin = xs.back();
+		for (unsigned int i = 0; i < xs.size(); i++)
+		{
+			double dx = xs[i] - origin;
+			sx += dx;
+			sxx += dx * dx;
+			for (unsigned int k = 0; k < D; k++)
+			{
+				sy[k] += ys[i].v[k];
+				sxy[k] += dx * ys[i].v[k];
+			}
+		}
+	}
+
+	unsigned int limit;
+	RingBuffer<double, N> xs;
+	RingBuffer<Sample, N> ys;
+	double origin;
+	double sx, sxx, sy[D], sxy[D];
+	unsigned int updates;
+};
+
+}  // namespace util
+
+}  // namespace cambada
+
+#endif /* RINGBUFFER_H_ */
@@ -22,159 +22,159 @@
 
 #include "SharedTimer.h"
 
-#include <sys/time.h>
+#include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
-#include <assert.h>
+#include <sched.h>
 #include <sys/ipc.h>
-#include <sys/sem.h>
 #include <sys/shm.h>
 #include <errno.h>
 
+#define SHARED_TIMER_MAGIC 0x53544d31  // "STM1"
+
 namespace cambada
 {
 namespace util
 {
 
 /**
- *      Se os processos morrem e o semáforo fica criado e a zero
- *      o sistema bloqueia. É preciso, neste momento eliminar o
- *      semáforo 0x777777.
- *      É preciso resolver este problema.
+ *      There is no semaphore anymore: a process that dies while attached
+ *      only leaves the counter too high, and the segment is then kept
+ *      until removed by hand (ipcrm -M 0x777777), but nobody blocks.
  */
-SharedTimer::SharedTimer()
+SharedTimer::SharedTimer(int key)
 {
-    /* try create the semaphore */
-    assert((semid = semget(KEY, 1, 0666 | IPC_CREAT | IPC_EXCL)) != -1  ||  errno == EEXIST);
-
-    if (semid != -1) // I'm the creator
+    /* try create the shared memory */
+    if ((shmid = shmget(key, sizeof(struct shmData), 0666 | IPC_CREAT | IPC_EXCL)) != -1)
     {
         fprintf(stderr, "I'm the creator\n");
 
-        /* create the shared memory */
-        assert((shmid = shmget(KEY, sizeof(struct shmData), 0666 | IPC_CREAT)) != -1);
-
-        /* attach shared memory */
-        assert((data = (shmData*)shmat(shmid, 0, 0)) != NULL);
-
-        /* init shared memory */
-        data->cnt = 1; // I'm the first process
-        gettimeofday(&data->baseTime, NULL);
+        if ((data = (shmData*)shmat(shmid, 0, 0)) == (void*)-1)
+        {
+            perror("SharedTimer: shmat");
+            abort();
+        }
+
+        /* init shared memory, then make it visible to the others */
+        data->cnt = 0;
+        data->seq = 0;
+        data->baseTime[0] = now();
+        __sync_synchronize();
+        data->magic = SHARED_TIMER_MAGIC;
     }
 
-    else // I'm not the creator
+    else if (errno == EEXIST) // I'm not the creator
     {
         fprintf(stderr, "I'm not the creator\n");
 
-        /* get semaphore id */
-        assert((semid = semget(KEY, 0, 0)) != -1);
-
-        /* gain mutual exclusion access */
-        adquireAcess();
-
-        /* get shared memory id */
-        assert((shmid = shmget(KEY, 0, 0)) != -1);
-
-        /* attach shared memory */
-        assert((data = (shmData*)shmat(shmid, 0, 0)) != NULL);
+        if ((shmid = shmget(key, sizeof(struct shmData), 0666)) == -1)
+        {
+            /* EINVAL: a segment of an older SharedTimer, remove it with ipcrm */
+            perror("SharedTimer: shmget");
+            abort();
+        }
+
+        if ((data = (shmData*)shmat(shmid, 0, 0)) == (void*)-1)
+        {
+            perror("SharedTimer: shmat");
+            abort();
+        }
+
+        /* the creator may still be initializing it */
+        while (data->magic != SHARED_TIMER_MAGIC)
+            sched_yield();
+        __sync_synchronize();
+    }
 
-        /* inc process counter */
-        data->cnt++;
+    else
+    {
+        perror("SharedTimer: shmget");
+        abort();
     }
 
+    /* inc process counter */
+    __sync_add_and_fetch(&data->cnt, 1);
+
     /* init local data */
-    gettimeofday(&savedTime, NULL);
+    savedTime = now();
 
     /* print shared data */
     fprintf(stderr, "cnt = %d\n", data->cnt);
-
-    /* release access and quit */
-    releaseAccess();
 }
 
 SharedTimer::~SharedTimer()
 {
-    /* gain exclusive access */
-    adquireAcess();
-
-    /* decrement process count and save value for future use */
-    data->cnt--;
-    int cnt = data->cnt;
-
-    /* detach memory */
-    shmdt(data);
-
-    /* mark memory to be destroyed */
-    shmctl(shmid, IPC_RMID, NULL);
-
-    /* destroy semaphore if last process */
-    if (cnt == 0)
+    /* decrement process count, the last one removes the memory */
+    if (__sync_sub_and_fetch(&data->cnt, 1) == 0)
     {
-        fprintf(stderr, "SharedTimer: I'm destroying the sempahore\n");
-        semctl(semid, 0, IPC_RMID);
+        fprintf(stderr, "SharedTimer: I'm destroying the shared memory\n");
+        shmctl(shmid, IPC_RMID, NULL);
     }
 
-    /* otherwise release access */
-    else
-    {
-        releaseAccess();
-    }
+    /* detach memory */
+    shmdt((void*)data);
 }
 
 void SharedTimer::resetTime()
 {
-    /* gain exclusive access */
-    adquireAcess();
+    unsigned int seq;
+
+    /* take the writer side: make the sequence odd */
+    do
+    {
+        seq = data->seq & ~1u;
+    } while (!__sync_bool_compare_and_swap(&data->seq, seq, seq + 1));
 
-    /* init times */
-    gettimeofday(&data->baseTime, NULL);
-    savedTime = data->baseTime;
+    /* init times, in the bank the readers are not using */
+    savedTime = now();
+    data->baseTime[((seq >> 1) + 1) & 1] = savedTime;
 
-    /* release exclusive access */
-    releaseAccess();
+    /* even again, and the new bank is the current one */
+    __sync_synchronize();
+    data->seq = seq + 2;
 }
 
 void SharedTimer::saveCurrentTime()
 {
-    gettimeofday(&savedTime, NULL);
+    savedTime = now();
 }
 
 int SharedTimer::getLongTermTime()
 {
-    /* gain exclusive access */
-    adquireAcess();
-
-    /* get time */
-    struct timeval t;
-    gettimeofday(&t, NULL);
-    int ret= (t.tv_sec - data->baseTime.tv_sec)*1000 + 
-            rint((t.tv_usec - data->baseTime.tv_usec)/1000.0);
-
-    /* release exclusive access */
-    releaseAccess();
-
-    /* return time */
-    return ret;
+    long long base = getBaseTime();
+    return (int)((now() - base + 500000) / 1000000);
 }
 
 int SharedTimer::getShortTermTime()
 {
-    struct timeval t;
-    gettimeofday(&t, NULL);
-    return (t.tv_sec - savedTime.tv_sec)*1000 + rint((t.tv_usec - savedTime.tv_usec)/1000.0);
+    return (int)((now() - savedTime + 500000) / 1000000);
 }
 
-void SharedTimer::adquireAcess()
+long long SharedTimer::getBaseTime()
 {
-    struct sembuf sb = { 0, -1, 0 };
-    assert(semop(semid, &sb, 1) != -1);
+    unsigned int seq;
+    long long base;
+
+    /* a resetTime writes the other bank, so the read is only torn if a
+       second one started meanwhile; retry in that case */
+    do
+    {
+        seq = data->seq;
+        __sync_synchronize();
+
+        base = data->baseTime[(seq >> 1) & 1];
+
+        __sync_synchronize();
+    } while ((data->seq - (seq & ~1u)) > 2);
+
+    return base;
 }
 
-void SharedTimer::releaseAccess()
+long long SharedTimer::now()
 {
-    struct sembuf sb = { 0, +1, 0 };
-    assert(semop(semid, &sb, 1) != -1);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
 }
 
 }
@@ -23,34 +23,41 @@
 #ifndef _SHARED_TIMER_
 #define _SHARED_TIMER_
 
-#include <sys/time.h>
-
 #define KEY 0x777777
 
 namespace cambada
 {
 namespace util
 {
+/**
+ *      Milliseconds since an epoch shared by all the processes that use
+ *      the same key, on CLOCK_MONOTONIC. The epoch is in shared memory
+ *      in two banks under a sequence counter, as the RtDB records:
+ *      resetTime writes the other bank and then switches, so reading the
+ *      time is a few loads and a clock_gettime (vDSO), without system
+ *      calls and without waiting for a preempted resetTime.
+ */
 class SharedTimer
 {
 private:
     struct shmData
     {
-        int cnt;
-        struct timeval baseTime;
+        volatile unsigned int magic;    // set once the creator initialized it
+        volatile int cnt;               // attached processes
+        volatile unsigned int seq;      // odd: resetTime in progress
+        volatile long long baseTime[2]; // epoch (ns), current one at (seq / 2) % 2
     };
 
     struct shmData* data;
-    struct timeval savedTime;
+    long long savedTime;
 
     int shmid;
-    int semid;
 
-    void adquireAcess();
-    void releaseAccess();
+    long long getBaseTime();
+    static long long now();
 
 public:
-    SharedTimer();
+    SharedTimer(int key = KEY);
     ~SharedTimer();
 
     void resetTime();
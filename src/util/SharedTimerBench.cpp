@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2009-2015,
+ * Intelligent Robotics and Intelligent Systems (IRIS) Lab
+ * CAMBADA robotic soccer team – http://robotica.ua.pt/CAMBADA/
+ * University of Aveiro, Portugal
+ *
+ * This file is part of the CAMBADA UTILITIES
+ *
+ * CAMBADA UTILITIES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CAMBADA UTILITIES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * SharedTimer stress test and latency microbenchmark
+ *
+ * stress: readers in several processes call elapsed() while one process
+ * keeps calling resetTime(); every reading must be between 0 and the time
+ * since the start of the test (a torn epoch would be far outside).
+ *
+ * latency: cost of elapsed() alone and while other processes read and
+ * reset the same timer, for SharedTimer and for the semaphore based
+ * implementation it replaced (kept here as LegacyTimer).
+ *
+ * Both use their own keys, not the one of the running agents.
+ *
+ * Usage: shared-timer-bench [seconds] [processes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <vector>
+
+#include "SharedTimer.h"
+
+using namespace cambada::util;
+
+#define BENCH_KEY	0x777778
+#define LEGACY_KEY	0x777779
+#define SAMPLES		100000
+
+/* The previous SharedTimer: epoch from gettimeofday, every read under a SysV semaphore */
+class LegacyTimer
+{
+private:
+    struct shmData
+    {
+        int cnt;
+        struct timeval baseTime;
+    };
+
+    struct shmData* data;
+    int shmid;
+    int semid;
+
+    void semOp(int op)
+    {
+        struct sembuf sb = { 0, (short)op, 0 };
+        while (semop(semid, &sb, 1) == -1 && errno == EINTR)
+            ;
+    }
+
+public:
+    LegacyTimer(bool create)
+    {
+        if (create)
+        {
+            semid = semget(LEGACY_KEY, 1, 0666 | IPC_CREAT);
+            shmid = shmget(LEGACY_KEY, sizeof(struct shmData), 0666 | IPC_CREAT);
+            data = (shmData*)shmat(shmid, 0, 0);
+            gettimeofday(&data->baseTime, NULL);
+            semctl(semid, 0, SETVAL, 1);
+        }
+        else
+        {
+            semid = semget(LEGACY_KEY, 0, 0);
+            shmid = shmget(LEGACY_KEY, 0, 0);
+            data = (shmData*)shmat(shmid, 0, 0);
+        }
+    }
+
+    void remove()
+    {
+        shmdt(data);
+        shmctl(shmid, IPC_RMID, NULL);
+        semctl(semid, 0, IPC_RMID);
+    }
+
+    void resetTime()
+    {
+        semOp(-1);
+        gettimeofday(&data->baseTime, NULL);
+        semOp(+1);
+    }
+
+    int elapsed()
+    {
+        semOp(-1);
+        struct timeval t;
+        gettimeofday(&t, NULL);
+        int ret = (t.tv_sec - data->baseTime.tv_sec)*1000 +
+                rint((t.tv_usec - data->baseTime.tv_usec)/1000.0);
+        semOp(+1);
+        return ret;
+    }
+};
+
+static long long now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Children that read (and one that resets) the timer until killed */
+template<typename Timer>
+static void startLoad(Timer& timer, int nprocs, std::vector<pid_t>& pids)
+{
+    volatile int sink = 0;
+
+    for (int i = 0; i < nprocs; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            for (;;)
+            {
+                if (i == 0)
+                    timer.resetTime();
+                else
+                    sink += timer.elapsed();
+            }
+        }
+        pids.push_back(pid);
+    }
+}
+
+static void stopLoad(std::vector<pid_t>& pids)
+{
+    for (unsigned int i = 0; i < pids.size(); i++)
+        kill(pids[i], SIGKILL);
+    for (unsigned int i = 0; i < pids.size(); i++)
+        waitpid(pids[i], NULL, 0);
+    pids.clear();
+}
+
+template<typename Timer>
+static void latency(const char* name, Timer& timer, int nprocs)
+{
+    std::vector<pid_t> pids;
+    std::vector<long long> samples(SAMPLES);
+    volatile int sink = 0;
+    long long t0, t1;
+    int i;
+
+    if (nprocs > 0)
+    {
+        startLoad(timer, nprocs, pids);
+        usleep(100000);
+    }
+
+    t0 = now_ns();
+    for (i = 0; i < SAMPLES; i++)
+        sink += timer.elapsed();
+    t1 = now_ns();
+
+    for (i = 0; i < SAMPLES; i++)
+    {
+        long long t = now_ns();
+        sink += timer.elapsed();
+        samples[i] = now_ns() - t;
+    }
+
+    stopLoad(pids);
+
+    std::sort(samples.begin(), samples.end());
+    printf("%-11s %2d other processes: %9.1f ns/call, p50 %7lld ns, p99 %8lld ns, max %9lld ns\n",
+            name, nprocs, (double)(t1 - t0) / SAMPLES, samples[SAMPLES / 2],
+            samples[SAMPLES * 99 / 100], samples[SAMPLES - 1]);
+}
+
+static int stress(int seconds, int nprocs)
+{
+    SharedTimer timer(BENCH_KEY);
+    std::vector<pid_t> pids;
+    long long start = now_ns(), end = start + seconds * 1000000000LL;
+    int failed = 0;
+
+    for (int i = 0; i < nprocs; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            long long n = 0, bad = 0;
+
+            while (now_ns() < end)
+            {
+                if (i == 0)
+                {
+                    timer.resetTime();
+                }
+                else
+                {
+                    int t = timer.elapsed();
+                    if (t < 0 || t > (now_ns() - start) / 1000000 + 1)
+                    {
+                        if (bad++ < 10)
+                            fprintf(stderr, "stress: process %d read %d ms\n", i, t);
+                    }
+                }
+                n++;
+            }
+            printf("stress: process %d: %lld %s, %lld bad\n", i, n, i == 0 ? "resets" : "reads", bad);
+            _exit(bad ? 1 : 0);
+        }
+        pids.push_back(pid);
+    }
+
+    for (unsigned int i = 0; i < pids.size(); i++)
+    {
+        int status;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            failed++;
+    }
+
+    printf("stress: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+int main(int argc, char* argv[])
+{
+    int seconds = argc > 1 ? atoi(argv[1]) : 5;
+    int nprocs = argc > 2 ? atoi(argv[2]) : 4;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (stress(seconds, nprocs))
+        return EXIT_FAILURE;
+
+    {
+        SharedTimer timer(BENCH_KEY);
+        latency("SharedTimer", timer, 0);
+        latency("SharedTimer", timer, nprocs);
+    }
+
+    LegacyTimer legacy(true);
+    latency("semaphore", legacy, 0);
+    latency("semaphore", legacy, nprocs);
+    legacy.remove();
+
+    return EXIT_SUCCESS;
+}
@@ -27,16 +27,18 @@
 
 
 cambada::util::SlidingWindow::SlidingWindow(int n)
-	: maxSamples(n)
+	: maxSamples(n), total(0.0), updates(0)
 {
+	assert(n > 0 && n <= SLIDING_WINDOW_CAPACITY);
 }
 
 cambada::util::SlidingWindow::SlidingWindow(std::deque<float> samples,unsigned int n)
-	: maxSamples(n)
+	: maxSamples(n), total(0.0), updates(0)
 {
-	assert(n >= samples.size());
+	assert(n >= samples.size() && n <= SLIDING_WINDOW_CAPACITY);
 	for (unsigned int i = 0; i < samples.size(); ++i)
 		this->samples.push_back(samples[i]);
+	updateSum();
 }
 
 cambada::util::SlidingWindow::~SlidingWindow()
@@ -45,28 +47,29 @@ cambada::util::SlidingWindow::~SlidingWindow()
 
 void cambada::util::SlidingWindow::addValue(float v)
 {
-	samples.push_back(v);
-	if(getNumSamples() > maxSamples)
+	if(getNumSamples() == maxSamples)
+	{
+		total -= samples.front();
 		samples.pop_front();
+	}
+	samples.push_back(v);
+	total += v;
+
+	// the additions and subtractions leave rounding errors, start again now and then
+	if(++updates >= SLIDING_WINDOW_CAPACITY)
+		updateSum();
 }
 
 void cambada::util::SlidingWindow::resetSamples(unsigned int n)
 {
 	assert(n < maxSamples);
-	if(getNumSamples() > n)
-		samples.erase(samples.begin(), samples.begin() + samples.size() - n);
-	//while(samples.size() > n)
-	//	samples.pop_front();
+	samples.keepLast(n);
+	updateSum();
 }
 
 float cambada::util::SlidingWindow::sum(void)
 {
-	float sum = 0.0f;
-	for (unsigned int i = 0; i < samples.size(); ++i)
-	{
-		sum += samples[i];
-	}
-	return sum;
+	return total;
 }
 
 float cambada::util::SlidingWindow::mean(void)
@@ -88,17 +91,23 @@ float cambada::util::SlidingWindow::getSample(unsigned int index)
 void cambada::util::SlidingWindow::setSample(unsigned int index, float v)
 {
 	assert(index < getNumSamples());
+	total += (double)v - samples[index];
 	samples[index] = v;
 }
 
 std::deque<float> cambada::util::SlidingWindow::getSamples()
 {
-	return samples;
+	std::deque<float> copy;
+	for (unsigned int i = 0; i < samples.size(); ++i)
+		copy.push_back(samples[i]);
+	return copy;
 }
 
 void cambada::util::SlidingWindow::clear(void)
 {
 	samples.clear();
+	total = 0.0;
+	updates = 0;
 }
 
 unsigned int cambada::util::SlidingWindow::getMaxSamples() const
@@ -110,3 +119,11 @@ bool cambada::util::SlidingWindow::isFull()
 {
 	return getNumSamples() == getMaxSamples();
 }
+
+void cambada::util::SlidingWindow::updateSum()
+{
+	total = 0.0;
+	for (unsigned int i = 0; i < samples.size(); ++i)
+		total += samples[i];
+	updates = 0;
+}
@@ -25,6 +25,10 @@
 
 #include <deque>
 
+#include "RingBuffer.h"
+
+#define SLIDING_WINDOW_CAPACITY	64	// largest n of a SlidingWindow
+
 namespace cambada
 {
 
@@ -50,8 +54,12 @@ public:
     bool isFull(void);
 
 private:
+	void updateSum();
+
 	const unsigned int maxSamples;
-	std::deque<float> samples;
+	RingBuffer<float, SLIDING_WINDOW_CAPACITY> samples;
+	double total;			// running sum of the samples
+	unsigned int updates;	// since the last full sum
 
 };
 
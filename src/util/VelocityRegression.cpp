@@ -28,15 +28,19 @@ using namespace cambada::geom;
 namespace cambada {
 namespace util {
 
-VelocityRegression::VelocityRegression()
+static double timeMs(const struct timeval& t)
 {
-	MAXSIZE = 9;
+	return t.tv_sec*1000 + t.tv_usec/1000;
 }
 
 
-VelocityRegression::VelocityRegression( int maxSize)
+VelocityRegression::VelocityRegression() : buffer(9)
+{
+}
+
+
+VelocityRegression::VelocityRegression( int maxSize) : buffer(maxSize)
 {
-	MAXSIZE = maxSize;
 }
 
 
@@ -49,174 +53,93 @@ void VelocityRegression::putNewValues( Vec pos, float ori, struct timeval instan
 	
 	instant = instantIn;	//changes the comparison time instant to the one being currently added
 	
-	posBuffer.push_back( pos );
-	oriBuffer.push_back( ori );
-	timeBuffer.push_back( instantIn );
-//fprintf(stderr,"DATA IN POSBUFFER TO INSERT X: %f, Y: %f\n",position.x, position.y);
-//fprintf(stderr,"DATA BUFF MAXSIZE: %d\n",MAXSIZE);
-	if( posBuffer.size() > MAXSIZE )
-	{
-		posBuffer.pop_front();
-		oriBuffer.pop_front();
-		timeBuffer.pop_front();
-	}
-/*	
-	for(unsigned int i = 0 ; i < posBuffer.size() ; i++ )
-	{		
-fprintf(stderr,"DATA VALUES IN BUFFER x:%f, y:%f\n",posBuffer[i].x,posBuffer[i].y);
-	}
-*/
+	double sample[3] = { pos.x, pos.y, ori };
+	buffer.push( timeMs(instantIn), sample );
 }
 
 
 void VelocityRegression::clearBuffs()
 {
-	posBuffer.clear();
-	timeBuffer.clear();
+	buffer.clear();
 }
 
 
 Vec VelocityRegression::getLinearVelocity()
 {
-	if (posBuffer.size()<2)
+	if (buffer.size()<2)
 		return Vec(0,0);
 
-	double sum_ts = 0.0, sum_ts2 = 0.0;
-	Vec sum_pos = Vec(0,0);
-	Vec sum_ts_pos(0,0);
-
-	for(unsigned int i = 0 ; i < posBuffer.size() ; i++ )
-	{
-		double tau = -(instant.tv_sec*1000 + instant.tv_usec/1000) 
-						+ ( timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
-
-		sum_pos += posBuffer[i];
-		sum_ts += tau;
-		sum_ts2 += tau*tau;
-		sum_ts_pos += tau*posBuffer[i];
-		
-//fprintf(stderr,"DATA VALUES IN BUFFER x:%f, y:%f\n",posBuffer[i].x,posBuffer[i].y);
-	}
-//fprintf(stderr,"DATA BuffSize: %d\n",posBuffer.size());
-	double det = (double)posBuffer.size() * sum_ts2 - sum_ts * sum_ts;	//DENOMINADOR DA REGRESSAO LINEAR
-
-	if(  fabs(det) < 1e-5 )
+	if(  fabs(buffer.det()) < 1e-5 )	//DENOMINADOR DA REGRESSAO LINEAR
 	{
-//fprintf(stderr,"DATA ERROR DET MUITO PEQUENO\n");
 		return (Vec::zero_vector);
 	}
 	else
 	{
-		return (( -sum_ts*sum_pos + (double)posBuffer.size()*sum_ts_pos) / det);
+		return Vec(buffer.slope(0), buffer.slope(1));
 	}
 }
 
 
 float VelocityRegression::getAngularVelocity()
 {
-	if (oriBuffer.size()<2)
+	if (buffer.size()<2)
 		return 0.0;
 
-	double sum_ts = 0.0, sum_ts2 = 0.0;
-	double sum_pos = 0.0;
-	double sum_ts_pos = 0.0;
-
-	for(unsigned int i = 0 ; i < oriBuffer.size() ; i++ )
-	{
-		double tau = -(instant.tv_sec*1000 + instant.tv_usec/1000) 
-						+ ( timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
-
-		sum_pos += oriBuffer[i];
-		sum_ts += tau;
-		sum_ts2 += tau*tau;
-		sum_ts_pos += tau*oriBuffer[i];
-		
-//fprintf(stderr,"DATA VALUES IN BUFFER x:%f, y:%f\n",posBuffer[i].x,posBuffer[i].y);
-	}
-//fprintf(stderr,"DATA BuffSize: %d\n",posBuffer.size());
-	double det = (double)oriBuffer.size() * sum_ts2 - sum_ts * sum_ts;	//DENOMINADOR DA REGRESSAO LINEAR
-
-	if(  fabs(det) < 1e-5 )
+	if(  fabs(buffer.det()) < 1e-5 )
 	{
-//fprintf(stderr,"DATA ERROR DET MUITO PEQUENO\n");
 		return 0.0;
 	}
 	else
 	{
-		return (( -sum_ts*sum_pos + (double)oriBuffer.size()*sum_ts_pos) / det);
+		return buffer.slope(2);
 	}
 }
 
 
 Vec VelocityRegression::getPointInOrig()
 {
-	double sum_ts = 0.0, sum_ts2 = 0.0;
-	Vec sum_pos = Vec(0,0);
-	Vec sum_ts_pos(0,0);
-
-	for(unsigned int i = 0 ; i < posBuffer.size() ; i++ )
-	{
-		double tau = -(instant.tv_sec*1000 + instant.tv_usec/1000) 
-						+ ( timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
-						
-		sum_pos += posBuffer[i];
-		sum_ts += tau;
-		sum_ts2 += tau*tau;
-		sum_ts_pos += tau*posBuffer[i];	
-	}
-
-	double det = (double)posBuffer.size() * sum_ts2 - sum_ts * sum_ts;	//DENOMINADOR DA REGRESSAO LINEAR
-
-	if(  fabs(det) < 1e-5 )
+	if(  fabs(buffer.det()) < 1e-5 )
 	{
 		return (Vec::zero_vector);	
 	}
 	else
 	{
-		return (( sum_ts2 * sum_pos - sum_ts_pos * sum_ts ) / det);
+		return Vec(buffer.valueAt(0, timeMs(instant)), buffer.valueAt(1, timeMs(instant)));
 	}
 }
 
 
 void VelocityRegression::printPosBuff()
 {
-	for(unsigned int i = 0 ; i < posBuffer.size() ; i++ )
+	for(unsigned int i = 0 ; i < buffer.size() ; i++ )
 	{		
-		fprintf(stderr,"DATA VALUES IN BUFFER x:%f, y:%f\n", posBuffer[i].x, posBuffer[i].y);
+		fprintf(stderr,"DATA VALUES IN BUFFER x:%f, y:%f\n", buffer.y(i, 0), buffer.y(i, 1));
 	}
 }
 
 
 void VelocityRegression::printOriBuff()
 {
-	for(unsigned int i = 0 ; i < oriBuffer.size() ; i++ )
+	for(unsigned int i = 0 ; i < buffer.size() ; i++ )
 	{		
-		fprintf(stderr,"DATA VALUES IN BUFFER ori:%f\n", oriBuffer[i]);
+		fprintf(stderr,"DATA VALUES IN BUFFER ori:%f\n", buffer.y(i, 2));
 	}
 }
 
 
 void VelocityRegression::printTimeBuff()
 {
-	for(unsigned int i = 0 ; i < timeBuffer.size() ; i++ )
+	for(unsigned int i = 0 ; i < buffer.size() ; i++ )
 	{		
-		fprintf(stderr,"DATA VALUES IN BUFFER time:%ld\n", timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
+		fprintf(stderr,"DATA VALUES IN BUFFER time:%ld\n", (long)buffer.x(i));
 	}
 }
 
 
 void VelocityRegression::resetToNSamples( unsigned int nSamples )
 {
-	if( posBuffer.size() > nSamples )
-	{
-		int toDelete = posBuffer.size() - nSamples;
-		for (int count = 0; count < toDelete; count++)
-		{
-			posBuffer.pop_front();
-			timeBuffer.pop_front();
-		}
-	}
-	fprintf(stderr,"INTEGRATOR VELOCITY RESET TO %d ELEMENTS\n",posBuffer.size());
+	buffer.keepLast(nSamples);
+	fprintf(stderr,"INTEGRATOR VELOCITY RESET TO %d ELEMENTS\n",buffer.size());
 }
 
 
@@ -227,31 +150,28 @@ void VelocityRegression::collision(float t, Vec collisionPos, Vec newVel)
 printPosBuff();
 printTimeBuff();	
 
-	float referencial = instant.tv_sec*1000 + instant.tv_usec/1000 + t;
-	unsigned int size = posBuffer.size();
-	for(unsigned int i = 0 ; i < size ; i++ )
+	// the positions become the predicted ones after the collision, at the same instants
+	float referencial = timeMs(instant) + t;
+	for(unsigned int i = 0 ; i < buffer.size() ; i++ )
 	{
 //fprintf(stderr," Iteração = %d\n",i);
-		double relT = - referencial + ( timeBuffer[i].tv_sec*1000 + timeBuffer[i].tv_usec/1000);
-		Vec newPos(collisionPos.x + newVel.x*relT,collisionPos.y + newVel.y*relT);
-		posBuffer.push_back(newPos);
-		timeBuffer.push_back(timeBuffer[i]);
+		double relT = - referencial + buffer.x(i);
+		buffer.setY(i, 0, collisionPos.x + newVel.x*relT);
+		buffer.setY(i, 1, collisionPos.y + newVel.y*relT);
 	}
-	resetToNSamples(3);
 //printPosBuff();
 //printTimeBuff();	
 }
 
 void VelocityRegression::checkAngleDiscontinuity(float newAngle)
 {
-	if (posBuffer.size() == 0)
+	if (buffer.size() == 0)
 		return;
-	if(Angle(posBuffer[posBuffer.size()-1].x/1000).in_between(Angle(0),Angle(M_PI/2)) && Angle(newAngle/1000).in_between(Angle(3*M_PI/2),Angle(2*M_PI)))
-		for(unsigned int i=0;i<posBuffer.size();i++)
-			posBuffer[i].x+=2*M_PI*1000;
-	else if(Angle(posBuffer[posBuffer.size()-1].x/1000).in_between(Angle(3*M_PI/2),Angle(2*M_PI)) && Angle(newAngle/1000).in_between(Angle(0),Angle(M_PI/2)))
-		for(unsigned int i=0;i<posBuffer.size();i++)
-			posBuffer[i].x-=2*M_PI*1000;
+	float last = buffer.y(buffer.size()-1, 0);
+	if(Angle(last/1000).in_between(Angle(0),Angle(M_PI/2)) && Angle(newAngle/1000).in_between(Angle(3*M_PI/2),Angle(2*M_PI)))
+		buffer.shiftY(0, 2*M_PI*1000);
+	else if(Angle(last/1000).in_between(Angle(3*M_PI/2),Angle(2*M_PI)) && Angle(newAngle/1000).in_between(Angle(0),Angle(M_PI/2)))
+		buffer.shiftY(0, -2*M_PI*1000);
 
 }
 
@@ -28,7 +28,9 @@
 #include "WorldStateDefs.h"
 #include "Vec.h"
 #include "sys/time.h"
-#include <deque>
+#include "RingBuffer.h"
+
+#define VELOCITY_REGRESSION_MAX_SIZE	32	/*!<largest maxSize of a VelocityRegression.*/
 
 namespace cambada {
 namespace util {
@@ -38,11 +40,8 @@ namespace util {
 class VelocityRegression
 {
 private:
-	unsigned int MAXSIZE;				/*!<maximum size of the buffers.*/
 	struct timeval instant;				/*!<current cycle time instant.*/
-	deque<Vec> posBuffer;				/*!<buffer of object position.*/
-	deque<float> oriBuffer;				/*!<buffer of object orientation.*/
-	deque<struct timeval> timeBuffer;	/*!<buffer of time instants.*/
+	RegressionWindow<3, VELOCITY_REGRESSION_MAX_SIZE> buffer;	/*!<time instants (ms) with object position x, y and orientation.*/
 	float lastXcommand;					/*!<The last command sent to the robot for the X linear velocity component (desired velocity).*/
 	float lastYcommand;					/*!<The last command sent to the robot for the Y linear velocity component (desired velocity).*/
 	float lastAcommand;					/*!<The last command sent to the robot for the angular velocity component (desired velocity).*/
@@ -52,7 +51,7 @@ public:
 	VelocityRegression();
 
 	/*! Main constructor
-	\param maxSize maximum size for the buffers*/
+	\param maxSize maximum size for the buffers, up to VELOCITY_REGRESSION_MAX_SIZE*/
 	VelocityRegression( int maxSize );
 
 	/*! Class destructor*/